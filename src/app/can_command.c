@@ -0,0 +1,127 @@
+/**
+ * @file
+ * @brief See can_command.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "app/can_command.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Application. */
+#include "app/led_fsm.h"
+
+/* ECU. */
+#include "ecu/asserter.h"
+
+/* BSP. */
+#include "bsp/bsp.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- STATIC ASSERTS -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Head and tail are 8 bit free running counters. */
+ECU_STATIC_ASSERT( ((CAN_COMMAND_QUEUE_SIZE & (CAN_COMMAND_QUEUE_SIZE - 1U)) == 0) );
+ECU_STATIC_ASSERT( (CAN_COMMAND_QUEUE_SIZE <= 128U) );
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void can_command_ctor(struct can_command *me, uint8_t leds_0)
+{
+    ECU_RUNTIME_ASSERT( (me && (leds_0 > 0) && (leds_0 <= CAN_COMMAND_LEDS_MAX)), BSP_ASSERT_FUNCTOR );
+
+    me->leds        = leds_0;
+    me->head        = 0;
+    me->tail        = 0;
+    me->commands    = 0;
+    me->repeats     = 0;
+    me->malformed   = 0;
+    me->overflows   = 0;
+
+    for (uint8_t i = 0; i < CAN_COMMAND_LEDS_MAX; i++)
+    {
+        me->pressed[i] = false;
+    }
+}
+
+
+void can_command_post(struct can_command *me,
+                      uint8_t led,
+                      const uint8_t *data,
+                      uint8_t len,
+                      uint32_t time)
+{
+    uint8_t head = 0;
+    bool pressed = false;
+    ECU_RUNTIME_ASSERT( (me && (data || (len == 0))), BSP_ASSERT_FUNCTOR );
+
+    if ((led >= me->leds) || (len == 0) ||
+        ((data[0] != CAN_COMMAND_PRESSED) && (data[0] != CAN_COMMAND_RELEASED)))
+    {
+        me->malformed++;
+        return;
+    }
+
+    pressed = (data[0] == CAN_COMMAND_PRESSED);
+    if (pressed == me->pressed[led])
+    {
+        me->repeats++;
+        return;
+    }
+
+    head = me->head;
+    if ((uint8_t)(head - me->tail) >= CAN_COMMAND_QUEUE_SIZE)
+    {
+        me->overflows++;
+        return;
+    }
+
+    me->pressed[led] = pressed;
+    me->queue[head & (CAN_COMMAND_QUEUE_SIZE - 1U)].time = time;
+    me->queue[head & (CAN_COMMAND_QUEUE_SIZE - 1U)].led = led;
+    me->queue[head & (CAN_COMMAND_QUEUE_SIZE - 1U)].pressed = pressed;
+    me->commands++;
+
+    /* Published last. */
+    me->head = (uint8_t)(head + 1U);
+}
+
+
+bool can_command_take(struct can_command *me, struct can_command_event *evt)
+{
+    uint8_t tail = 0;
+    ECU_RUNTIME_ASSERT( (me && evt), BSP_ASSERT_FUNCTOR );
+
+    tail = me->tail;
+    if (tail == me->head)
+    {
+        return false;
+    }
+
+    evt->time = me->queue[tail & (CAN_COMMAND_QUEUE_SIZE - 1U)].time;
+    evt->led = me->queue[tail & (CAN_COMMAND_QUEUE_SIZE - 1U)].led;
+    evt->signal = (me->queue[tail & (CAN_COMMAND_QUEUE_SIZE - 1U)].pressed) ?
+                  LED_FSM_SWITCH_PRESSED_EVT : LED_FSM_SWITCH_RELEASED_EVT;
+    me->tail = (uint8_t)(tail + 1U);
+    return true;
+}
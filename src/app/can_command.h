@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @brief Remote switch commands for the LEDs from the vehicle bus, turned
+ * into the same switch events led_fsm takes from its switches.
+ *
+ * A command is a data frame whose first byte is CAN_COMMAND_PRESSED or
+ * CAN_COMMAND_RELEASED. Which LED it is for is the route it was posted
+ * with, i.e. the index of the acceptance filter that let it through, so
+ * no ID is compared here. Empty frames and other values are counted as
+ * malformed and dropped.
+ *
+ * Bus messages are usually sent cyclically whether they changed or not.
+ * A command that repeats the state last posted for its LED is dropped
+ * in interrupt context, so only changes reach the main loop. A command
+ * lost to a full queue is not remembered as posted, so the next repeat
+ * of it gets through.
+ *
+ * Usage:
+ *
+ *     // Receive interrupt.
+ *     can_command_post(&cmds, frame->filter, frame->data, frame->len, cycles);
+ *
+ *     // Main loop.
+ *     while (can_command_take(&cmds, &evt)) { ... }
+ *
+ * The queue has one producer, the receive interrupts, and one consumer,
+ * the main loop. Receive interrupts must not preempt each other.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef CAN_COMMAND_H_
+#define CAN_COMMAND_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Application. */
+#include "app/led_fsm.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- DEFINES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define CAN_COMMAND_LEDS_MAX                    (8U)
+
+/**
+ * @brief Power of two. Only changes are queued, so this covers every LED
+ * changing twice between takes.
+ */
+#define CAN_COMMAND_QUEUE_SIZE                  (16U)
+
+/**
+ * @brief First data byte of a command.
+ */
+#define CAN_COMMAND_RELEASED                    (0U)
+#define CAN_COMMAND_PRESSED                     (1U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- CAN COMMAND DATA STRUCTURES ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct can_command_event
+{
+    uint32_t time;                  /* As posted. */
+    uint8_t led;
+    enum led_fsm_event_signals signal;
+};
+
+
+struct can_command_entry
+{
+    uint32_t time;
+    uint8_t led;
+    bool pressed;
+};
+
+
+struct can_command
+{
+    /* Private. */
+    uint8_t leds;
+    bool pressed[CAN_COMMAND_LEDS_MAX];             /* State last queued. Interrupt only. */
+
+    volatile struct can_command_entry queue[CAN_COMMAND_QUEUE_SIZE];
+    volatile uint8_t head;          /* Written by can_command_post() only. */
+    volatile uint8_t tail;          /* Written by can_command_take() only. */
+
+    /* Commands queued, dropped as repeats, dropped as malformed and lost
+    to a full queue. */
+    volatile uint32_t commands;
+    volatile uint32_t repeats;
+    volatile uint32_t malformed;
+    volatile uint32_t overflows;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief LEDs 0 to @p leds_0 - 1 start out released, like led_fsm.
+ */
+extern void can_command_ctor(struct can_command *me, uint8_t leds_0);
+
+/**
+ * @brief Interrupt context. @p data is the frame's payload of @p len
+ * bytes and @p time when it was received. Routes past the last LED are
+ * counted as malformed.
+ */
+extern void can_command_post(struct can_command *me,
+                             uint8_t led,
+                             const uint8_t *data,
+                             uint8_t len,
+                             uint32_t time);
+
+/**
+ * @brief Main loop. Returns the oldest queued command as a switch event
+ * for its LED. Returns false when there is none.
+ */
+extern bool can_command_take(struct can_command *me, struct can_command_event *evt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAN_COMMAND_H_ */
@@ -0,0 +1,595 @@
+/**
+ * @file
+ * @brief See config_store.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "app/config_store.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* ECU. */
+#include "ecu/asserter.h"
+
+/* BSP. */
+#include "bsp/bsp.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- FILE SCOPE DEFINES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define PAGE_MAGIC                              (0x464E4F43U)      /* "CONF". */
+#define ERASED_BYTE                             (0xFFU)
+#define KEY_ERASED                              (0xFFFFU)
+
+#define CRC16_INIT                              (0xFFFFU)
+#define CRC16_POLY                              (0x1021U)
+
+#define RECORD_SIZE(len) \
+    (CONFIG_STORE_ALIGN + ((((uint32_t)(len)) + CONFIG_STORE_ALIGN - 1U) & ~(CONFIG_STORE_ALIGN - 1U)))
+
+#define RECORD_SIZE_MAX                         RECORD_SIZE(CONFIG_STORE_VALUE_MAX)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE TYPES ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+enum record_status
+{
+    RECORD_VALID,
+    RECORD_BAD,                     /* Torn or corrupt, but its size can be trusted. Skip it. */
+    RECORD_END                      /* Erased, or nothing after it can be trusted. */
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- STATIC FUNCTION DECLARATIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint16_t crc16(uint16_t crc, const uint8_t *data, uint32_t len);
+static uint16_t get_u16(const uint8_t *in);
+static uint32_t get_u32(const uint8_t *in);
+static void put_u16(uint8_t *out, uint16_t value);
+static void put_u32(uint8_t *out, uint32_t value);
+static bool page_erased(const struct config_store *me, uint8_t page);
+static void page_erase_blocking(struct config_store *me, uint8_t page);
+static uint8_t page_next_erased(const struct config_store *me);
+static bool page_open(struct config_store *me);
+static enum record_status record_check(const struct config_store *me, uint32_t offset, uint32_t *size);
+static uint32_t page_scan(struct config_store *me, uint8_t page);
+static bool record_program(struct config_store *me, const uint8_t *record, uint32_t size, uint16_t key);
+static void compaction_start(struct config_store *me);
+static void compaction_step(struct config_store *me);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint16_t crc16(uint16_t crc, const uint8_t *data, uint32_t len)
+{
+    ECU_RUNTIME_ASSERT( (data || (len == 0)), BSP_ASSERT_FUNCTOR );
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)((uint16_t)data[i] << 8);
+        for (uint8_t bit = 0; bit < 8U; bit++)
+        {
+            crc = (crc & 0x8000U) ? (uint16_t)((crc << 1) ^ CRC16_POLY) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+
+static uint16_t get_u16(const uint8_t *in)
+{
+    return (uint16_t)((uint16_t)in[0] | (uint16_t)((uint16_t)in[1] << 8));
+}
+
+
+static uint32_t get_u32(const uint8_t *in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+
+static void put_u16(uint8_t *out, uint16_t value)
+{
+    out[0] = (uint8_t)(value & 0xFFU);
+    out[1] = (uint8_t)(value >> 8);
+}
+
+
+static void put_u32(uint8_t *out, uint32_t value)
+{
+    out[0] = (uint8_t)(value & 0xFFU);
+    out[1] = (uint8_t)((value >> 8) & 0xFFU);
+    out[2] = (uint8_t)((value >> 16) & 0xFFU);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+
+static bool page_erased(const struct config_store *me, uint8_t page)
+{
+    const uint8_t *p = (const uint8_t *)0;
+    ECU_RUNTIME_ASSERT( (me && (page < me->page_count)), BSP_ASSERT_FUNCTOR );
+
+    p = &me->base[(uint32_t)page * me->page_size];
+    for (uint32_t i = 0; i < me->page_size; i++)
+    {
+        if (p[i] != ERASED_BYTE)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static void page_erase_blocking(struct config_store *me, uint8_t page)
+{
+    ECU_RUNTIME_ASSERT( (me && (page < me->page_count)), BSP_ASSERT_FUNCTOR );
+
+    do
+    {
+        (*me->i_erase_start)(me->i_obj, page);
+        me->stats.erases++;
+        while ((*me->i_busy)(me->i_obj))
+        {
+            /* Only at boot, after a reset cut an erase short. */
+        }
+    } while (!page_erased(me, page));
+}
+
+
+static uint8_t page_next_erased(const struct config_store *me)
+{
+    uint8_t page = 0;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    /* In ring order after the head, so every page takes its turn. */
+    for (uint8_t i = 1; i <= me->page_count; i++)
+    {
+        page = (uint8_t)((me->head_page + i) % me->page_count);
+        if (me->page_seq[page] == 0)
+        {
+            return page;
+        }
+    }
+
+    return me->page_count;
+}
+
+
+static bool page_open(struct config_store *me)
+{
+    uint8_t header[CONFIG_STORE_ALIGN];
+    uint8_t page = 0;
+    uint32_t seq = 0;
+    bool ok = false;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    page = page_next_erased(me);
+    ECU_RUNTIME_ASSERT( (page < me->page_count), BSP_ASSERT_FUNCTOR );
+
+    /* Sequence 1 on an empty store. */
+    seq = (me->page_seq[me->head_page] == 0) ? 1U : (me->page_seq[me->head_page] + 1U);
+    put_u32(&header[0], PAGE_MAGIC);
+    put_u32(&header[4], seq);
+    ok = (*me->i_program)(me->i_obj, (uint32_t)page * me->page_size, header, sizeof(header));
+    me->stats.flash_bytes += sizeof(header);
+
+    /* A page whose header failed is no longer erased either. It gets a
+    sequence number all the same and is reclaimed like any other. */
+    me->page_seq[page] = seq;
+    me->erased_pages--;
+    me->head_page = page;
+    me->head_offset = (ok) ? CONFIG_STORE_ALIGN : me->page_size;
+    return ok;
+}
+
+
+static enum record_status record_check(const struct config_store *me, uint32_t offset, uint32_t *size)
+{
+    const uint8_t *record = (const uint8_t *)0;
+    uint32_t page_end = 0;
+    uint16_t key = 0;
+    uint16_t len = 0;
+    uint16_t crc = 0;
+    ECU_RUNTIME_ASSERT( (me && size), BSP_ASSERT_FUNCTOR );
+
+    page_end = ((offset / me->page_size) + 1U) * me->page_size;
+    if ((offset + CONFIG_STORE_ALIGN) > page_end)
+    {
+        return RECORD_END;
+    }
+
+    record = &me->base[offset];
+    key = get_u16(&record[0]);
+    len = get_u16(&record[2]);
+    if (key == KEY_ERASED)
+    {
+        return RECORD_END;
+    }
+
+    /* The header is one programming unit, so it is either all there or
+    not. One that fails this was not written by config_store_set(). */
+    if (((get_u16(&record[6]) ^ key) != 0xFFFFU) || (len > CONFIG_STORE_VALUE_MAX) ||
+        ((offset + RECORD_SIZE(len)) > page_end))
+    {
+        return RECORD_END;
+    }
+
+    *size = RECORD_SIZE(len);
+    crc = crc16(CRC16_INIT, &record[0], 4U);
+    crc = crc16(crc, &record[CONFIG_STORE_ALIGN], len);
+    if ((key >= CONFIG_STORE_KEYS) || (get_u16(&record[4]) != crc))
+    {
+        return RECORD_BAD;
+    }
+
+    return RECORD_VALID;
+}
+
+
+static uint32_t page_scan(struct config_store *me, uint8_t page)
+{
+    uint32_t offset = 0;
+    uint32_t size = 0;
+    enum record_status status = RECORD_VALID;
+    ECU_RUNTIME_ASSERT( (me && (page < me->page_count)), BSP_ASSERT_FUNCTOR );
+
+    offset = ((uint32_t)page * me->page_size) + CONFIG_STORE_ALIGN;
+    while ((status = record_check(me, offset, &size)) != RECORD_END)
+    {
+        if (status == RECORD_VALID)
+        {
+            me->index[get_u16(&me->base[offset])] = offset;
+        }
+        else
+        {
+            me->stats.records_bad++;
+        }
+        offset += size;
+    }
+
+    /* Free space starts after the last record. Anything else past it
+    cannot be trusted, so the page is treated as full. */
+    if ((offset % me->page_size) != 0)
+    {
+        for (uint32_t i = offset; i < (((uint32_t)page + 1U) * me->page_size); i++)
+        {
+            if (me->base[i] != ERASED_BYTE)
+            {
+                return me->page_size;
+            }
+        }
+    }
+
+    return offset - ((uint32_t)page * me->page_size);
+}
+
+
+static bool record_program(struct config_store *me, const uint8_t *record, uint32_t size, uint16_t key)
+{
+    uint32_t offset = 0;
+    bool ok = false;
+    ECU_RUNTIME_ASSERT( (me && record && ((me->head_offset + size) <= me->page_size)), BSP_ASSERT_FUNCTOR );
+
+    /* Header first. A reset partway leaves a header whose CRC fails and
+    whose size still says where the next record goes. */
+    offset = ((uint32_t)me->head_page * me->page_size) + me->head_offset;
+    ok = (*me->i_program)(me->i_obj, offset, record, size);
+    me->head_offset += size;
+    me->stats.flash_bytes += size;
+
+    if (ok)
+    {
+        me->index[key] = offset;
+    }
+
+    return ok;
+}
+
+
+static void compaction_start(struct config_store *me)
+{
+    uint8_t victim = 0;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    /* Oldest page other than the head. */
+    victim = me->page_count;
+    for (uint8_t page = 0; page < me->page_count; page++)
+    {
+        if ((page != me->head_page) && (me->page_seq[page] != 0) &&
+            ((victim == me->page_count) || (me->page_seq[page] < me->page_seq[victim])))
+        {
+            victim = page;
+        }
+    }
+
+    /* With only the head in use, compact the head itself once it is nearly
+    full. Its live records move to the spare page, which becomes the head. */
+    if (victim == me->page_count)
+    {
+        if ((me->head_offset + RECORD_SIZE_MAX) <= me->page_size)
+        {
+            return;
+        }
+        victim = me->head_page;
+        (void)page_open(me);
+    }
+
+    me->compacting = true;
+    me->victim = victim;
+    me->victim_offset = ((uint32_t)victim * me->page_size) + CONFIG_STORE_ALIGN;
+}
+
+
+static void compaction_step(struct config_store *me)
+{
+    uint32_t size = 0;
+    uint16_t key = 0;
+    enum record_status status = RECORD_VALID;
+    ECU_RUNTIME_ASSERT( (me && me->compacting && !me->erasing), BSP_ASSERT_FUNCTOR );
+
+    /* Skip over dead records without touching flash. Stop after one copy. */
+    while ((status = record_check(me, me->victim_offset, &size)) != RECORD_END)
+    {
+        key = get_u16(&me->base[me->victim_offset]);
+        if ((status == RECORD_VALID) && (me->index[key] == me->victim_offset))
+        {
+            if ((me->head_offset + size) > me->page_size)
+            {
+                (void)page_open(me);
+                if ((me->head_offset + size) > me->page_size)
+                {
+                    return;
+                }
+            }
+
+            if (record_program(me, &me->base[me->victim_offset], size, key))
+            {
+                me->stats.records_moved++;
+                me->victim_offset += size;
+            }
+            return;
+        }
+        me->victim_offset += size;
+    }
+
+    /* Nothing live is left in the victim. */
+    (*me->i_erase_start)(me->i_obj, me->victim);
+    me->stats.erases++;
+    me->erasing = true;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC FUNCTIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void config_store_ctor(struct config_store *me,
+                       const uint8_t *base_0,
+                       uint32_t page_size_0,
+                       uint8_t page_count_0,
+                       void *i_obj_0,
+                       bool (*i_program_0)(void *i_obj, uint32_t offset, const void *data, uint32_t len),
+                       void (*i_erase_start_0)(void *i_obj, uint8_t page),
+                       bool (*i_busy_0)(void *i_obj))
+{
+    uint8_t header[CONFIG_STORE_ALIGN];
+    uint32_t scanned_seq = 0;
+    uint8_t next = 0;
+    ECU_RUNTIME_ASSERT( (me && base_0 && i_program_0 && i_erase_start_0 && i_busy_0), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( ((page_count_0 >= 2U) && (page_count_0 <= CONFIG_STORE_PAGES_MAX)), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( ((page_size_0 % CONFIG_STORE_ALIGN) == 0), BSP_ASSERT_FUNCTOR );
+
+    /* Compaction relies on every key's newest record fitting in one page,
+    with room for one more so a compacted head is never nearly full. */
+    ECU_RUNTIME_ASSERT( ((CONFIG_STORE_ALIGN + ((CONFIG_STORE_KEYS + 1U) * RECORD_SIZE_MAX)) <= page_size_0), BSP_ASSERT_FUNCTOR );
+
+    memset(me, 0, sizeof(*me));
+    me->base            = base_0;
+    me->page_size       = page_size_0;
+    me->page_count      = page_count_0;
+    me->i_obj           = i_obj_0;
+    me->i_program       = i_program_0;
+    me->i_erase_start   = i_erase_start_0;
+    me->i_busy          = i_busy_0;
+
+    /* Classify pages by their header. Anything that is neither a valid
+    header nor a fully erased page was cut short by a reset. */
+    for (uint8_t page = 0; page < me->page_count; page++)
+    {
+        memcpy(header, &me->base[(uint32_t)page * me->page_size], sizeof(header));
+        if ((get_u32(&header[0]) == PAGE_MAGIC) && (get_u32(&header[4]) != 0) && (get_u32(&header[4]) != 0xFFFFFFFFU))
+        {
+            me->page_seq[page] = get_u32(&header[4]);
+            continue;
+        }
+
+        if (!page_erased(me, page))
+        {
+            page_erase_blocking(me, page);
+        }
+        me->page_seq[page] = 0;
+        me->erased_pages++;
+    }
+
+    /* Oldest page first so newer records overwrite older ones in the index. */
+    do
+    {
+        next = me->page_count;
+        for (uint8_t page = 0; page < me->page_count; page++)
+        {
+            if ((me->page_seq[page] > scanned_seq) &&
+                ((next == me->page_count) || (me->page_seq[page] < me->page_seq[next])))
+            {
+                next = page;
+            }
+        }
+
+        if (next < me->page_count)
+        {
+            scanned_seq = me->page_seq[next];
+            me->head_page = next;
+            me->head_offset = page_scan(me, next);
+        }
+    } while (next < me->page_count);
+
+    if (me->erased_pages == me->page_count)
+    {
+        me->head_page = (uint8_t)(me->page_count - 1U);
+        (void)page_open(me);
+    }
+}
+
+
+const uint8_t *config_store_get(const struct config_store *me, uint16_t key, uint16_t *len)
+{
+    const uint8_t *record = (const uint8_t *)0;
+    ECU_RUNTIME_ASSERT( (me && (key < CONFIG_STORE_KEYS)), BSP_ASSERT_FUNCTOR );
+
+    if (me->index[key] == 0)
+    {
+        return (const uint8_t *)0;
+    }
+
+    record = &me->base[me->index[key]];
+    if (len)
+    {
+        *len = get_u16(&record[2]);
+    }
+
+    return &record[CONFIG_STORE_ALIGN];
+}
+
+
+bool config_store_set(struct config_store *me, uint16_t key, const void *value, uint16_t len)
+{
+    uint8_t record[RECORD_SIZE_MAX];
+    const uint8_t *stored = (const uint8_t *)0;
+    uint16_t stored_len = 0;
+    uint16_t crc = 0;
+    uint32_t size = RECORD_SIZE(len);
+    ECU_RUNTIME_ASSERT( (me && (key < CONFIG_STORE_KEYS) && (len <= CONFIG_STORE_VALUE_MAX)), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (value || (len == 0)), BSP_ASSERT_FUNCTOR );
+
+    stored = config_store_get(me, key, &stored_len);
+    if (stored && (stored_len == len) && ((len == 0) || (memcmp(stored, value, len) == 0)))
+    {
+        me->stats.sets++;
+        me->stats.sets_unchanged++;
+        return true;
+    }
+
+    /* The spare page is for compaction. Once compaction has started
+    filling it, what is left of it belongs to the records still to move. */
+    if ((me->compacting && (me->erased_pages == 0)) ||
+        (((me->head_offset + size) > me->page_size) && (me->erased_pages < 2U)))
+    {
+        return false;
+    }
+
+    if ((me->head_offset + size) > me->page_size)
+    {
+        (void)page_open(me);
+        if ((me->head_offset + size) > me->page_size)
+        {
+            return false;
+        }
+    }
+
+    memset(record, 0, sizeof(record));
+    put_u16(&record[0], key);
+    put_u16(&record[2], len);
+    put_u16(&record[6], (uint16_t)~key);
+    if (len > 0)
+    {
+        memcpy(&record[CONFIG_STORE_ALIGN], value, len);
+    }
+    crc = crc16(CRC16_INIT, &record[0], 4U);
+    crc = crc16(crc, &record[CONFIG_STORE_ALIGN], len);
+    put_u16(&record[4], crc);
+
+    if (!record_program(me, record, size, key))
+    {
+        return false;
+    }
+
+    me->stats.sets++;
+    me->stats.value_bytes += len;
+    return true;
+}
+
+
+void config_store_run(struct config_store *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    if (me->erasing)
+    {
+        if ((*me->i_busy)(me->i_obj))
+        {
+            return;
+        }
+
+        me->erasing = false;
+        if (!page_erased(me, me->victim))
+        {
+            (*me->i_erase_start)(me->i_obj, me->victim);
+            me->stats.erases++;
+            me->erasing = true;
+            return;
+        }
+
+        me->page_seq[me->victim] = 0;
+        me->erased_pages++;
+        me->compacting = false;
+        return;
+    }
+
+    if (!me->compacting)
+    {
+        if (me->erased_pages >= 2U)
+        {
+            return;
+        }
+        compaction_start(me);
+        return;
+    }
+
+    compaction_step(me);
+}
+
+
+const struct config_store_stats *config_store_stats(const struct config_store *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    return &me->stats;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file
+ * @brief Configuration values kept in flash across resets. Every write
+ * appends a record to a log that spans a few flash pages. The newest
+ * record of a key wins. Nothing is ever rewritten in place, so writes
+ * spread over all pages and a write torn by a reset is simply ignored at
+ * the next boot.
+ *
+ * Boot reads the log once and keeps the address of each key's newest
+ * record in RAM. @ref config_store_get is then a table lookup that
+ * returns a pointer straight into flash.
+ *
+ * Layout. Each page starts with an 8 byte header holding a magic number
+ * and a sequence number that orders the pages. Records follow:
+ *
+ *     [key u16][len u16][crc u16][~key u16][value, padded to 8 bytes]
+ *
+ * The CRC is CRC-16/CCITT-FALSE over key, len and value. Sizes are
+ * multiples of the 8 byte flash programming unit.
+ *
+ * Compaction. One page is always kept erased. When no other page is
+ * free, @ref config_store_run copies the live records out of the oldest
+ * page, one per call, then erases it without waiting. Writes that need
+ * a new page, or would land in the spare page once compaction has opened
+ * it, are refused until it is done, so the spare page can always take
+ * everything still live. The live data of every key must therefore fit
+ * in one page, which the constructor checks.
+ *
+ * Flash is reached through the interface passed to the constructor, so
+ * the same code runs against a RAM model on the host.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef CONFIG_STORE_H_
+#define CONFIG_STORE_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- DEFINES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Keys are 0 to CONFIG_STORE_KEYS - 1.
+ */
+#define CONFIG_STORE_KEYS                       (16U)
+#define CONFIG_STORE_VALUE_MAX                  (32U)
+#define CONFIG_STORE_PAGES_MAX                  (8U)
+
+/**
+ * @brief Flash programming unit. Record and page header size.
+ */
+#define CONFIG_STORE_ALIGN                      (8U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- CONFIG STORE DATA STRUCTURES ---------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct config_store_stats
+{
+    uint32_t sets;                  /* Calls to config_store_set() that returned true. */
+    uint32_t sets_unchanged;        /* Of those, ones that matched the stored value. */
+    uint32_t value_bytes;           /* Value bytes of the sets that were written. */
+    uint32_t flash_bytes;           /* Everything programmed. Headers, padding and copies. */
+    uint32_t records_moved;
+    uint32_t erases;
+    uint32_t records_bad;           /* Torn or corrupt records skipped at boot. */
+};
+
+
+struct config_store
+{
+    /* Private. */
+    const uint8_t *base;
+    uint32_t page_size;
+    uint8_t page_count;
+
+    /* 0 if the page is erased. Sequence numbers start at 1. */
+    uint32_t page_seq[CONFIG_STORE_PAGES_MAX];
+    uint8_t erased_pages;
+    uint8_t head_page;
+    uint32_t head_offset;           /* Next free byte in the head page. */
+
+    /* Offset from base of each key's newest record. 0 if there is none. */
+    uint32_t index[CONFIG_STORE_KEYS];
+
+    bool compacting;
+    bool erasing;
+    uint8_t victim;
+    uint32_t victim_offset;
+
+    struct config_store_stats stats;
+
+    void *i_obj;
+    bool (*i_program)(void *i_obj, uint32_t offset, const void *data, uint32_t len);
+    void (*i_erase_start)(void *i_obj, uint8_t page);
+    bool (*i_busy)(void *i_obj);
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Mounts the log in @p page_count_0 pages of @p page_size_0 bytes
+ * at @p base_0, which must be readable memory. Builds the index in one
+ * pass. Pages left half erased by a reset are erased again here, which
+ * blocks. An empty region is formatted.
+ *
+ * i_program programs len bytes at offset from base_0. Both are multiples
+ * of CONFIG_STORE_ALIGN. i_erase_start starts erasing a page and i_busy
+ * is true until it is done.
+ */
+extern void config_store_ctor(struct config_store *me,
+                              const uint8_t *base_0,
+                              uint32_t page_size_0,
+                              uint8_t page_count_0,
+                              void *i_obj_0,
+                              bool (*i_program_0)(void *i_obj, uint32_t offset, const void *data, uint32_t len),
+                              void (*i_erase_start_0)(void *i_obj, uint8_t page),
+                              bool (*i_busy_0)(void *i_obj));
+
+/**
+ * @brief Newest value of @p key, in flash, or null if it was never set.
+ * @p len is optional.
+ */
+extern const uint8_t *config_store_get(const struct config_store *me, uint16_t key, uint16_t *len);
+
+/**
+ * @brief Appends a record unless the value is already stored. Returns
+ * false if it cannot be written right now because compaction is running
+ * or the flash reported an error. Try again on a later pass.
+ */
+extern bool config_store_set(struct config_store *me, uint16_t key, const void *value, uint16_t len);
+
+/**
+ * @brief Call once per main loop pass. Does at most one flash operation.
+ */
+extern void config_store_run(struct config_store *me);
+
+extern const struct config_store_stats *config_store_stats(const struct config_store *me);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_STORE_H_ */
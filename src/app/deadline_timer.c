@@ -0,0 +1,243 @@
+/**
+ * @file
+ * @brief See deadline_timer.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "app/deadline_timer.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ECU. */
+#include "ecu/asserter.h"
+
+/* BSP. */
+#include "bsp/bsp.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static bool is_due(uint32_t now, uint32_t deadline);
+static void armed_list_insert(struct deadline_timer_collection *col, struct deadline_timer *me);
+static struct deadline_timer *collect_due(struct deadline_timer_collection *me, uint32_t now);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static bool is_due(uint32_t now, uint32_t deadline)
+{
+    /* Wrap safe as long as deadlines are less than 2^31 ticks away. */
+    return ((int32_t)(now - deadline) >= 0);
+}
+
+
+static void armed_list_insert(struct deadline_timer_collection *col, struct deadline_timer *me)
+{
+    ECU_RUNTIME_ASSERT( (col && me), BSP_ASSERT_FUNCTOR );
+
+    /* Disarmed timers stay linked until the next tick unlinks them, so
+    arming one again only has to flip its flag. */
+    if (!me->linked)
+    {
+        me->next = col->armed;
+        col->armed = me;
+        me->linked = true;
+    }
+}
+
+
+static struct deadline_timer *collect_due(struct deadline_timer_collection *me, uint32_t now)
+{
+    struct deadline_timer **link_ptr = &me->armed;
+    struct deadline_timer *due = (struct deadline_timer *)0;
+    struct deadline_timer **due_tail = &due;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    while (*link_ptr)
+    {
+        struct deadline_timer *t = *link_ptr;
+
+        if (!t->armed)
+        {
+            /* Lazily unlink timers disarmed since the last tick. */
+            *link_ptr = t->next;
+            t->next = (struct deadline_timer *)0;
+            t->linked = false;
+            continue;
+        }
+
+        if (is_due(now, t->deadline))
+        {
+            if (t->period == 0)
+            {
+                t->pending = 1;
+                t->armed = false;
+            }
+            else
+            {
+                /* Deadlines that passed, including the one that made it due.
+                The next deadline stays on the original period grid. */
+                uint32_t passed = ((now - t->deadline) / t->period) + 1U;
+                uint32_t fires = 1;
+
+                if ((t->policy == DEADLINE_TIMER_CATCH_UP) && (passed > 1U))
+                {
+                    fires = (passed < t->max_catch_up) ? passed : t->max_catch_up;
+                }
+
+                t->pending = fires;
+                t->missed += passed - fires;
+                t->deadline += passed * t->period;
+            }
+
+            t->due_next = (struct deadline_timer *)0;
+            *due_tail = t;
+            due_tail = &t->due_next;
+        }
+
+        link_ptr = &t->next;
+    }
+
+    return due;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void deadline_timer_collection_ctor(struct deadline_timer_collection *me,
+                                    void *i_obj_0,
+                                    uint32_t (*i_get_ticks_0)(void *i_obj))
+{
+    /* i_obj_0 is optional. */
+    ECU_RUNTIME_ASSERT( (me && i_get_ticks_0), BSP_ASSERT_FUNCTOR );
+    me->armed       = (struct deadline_timer *)0;
+    me->i_obj       = i_obj_0;
+    me->i_get_ticks = i_get_ticks_0;
+}
+
+
+void deadline_timer_ctor(struct deadline_timer *me,
+                         void *obj_0,
+                         void (*callback_0)(void *obj))
+{
+    /* obj_0 is optional. */
+    ECU_RUNTIME_ASSERT( (me && callback_0), BSP_ASSERT_FUNCTOR );
+    me->next            = (struct deadline_timer *)0;
+    me->due_next        = (struct deadline_timer *)0;
+    me->linked          = false;
+    me->armed           = false;
+    me->deadline        = 0;
+    me->period          = 0;
+    me->policy          = DEADLINE_TIMER_FIRE_ONCE;
+    me->max_catch_up    = 1;
+    me->pending         = 0;
+    me->missed          = 0;
+    me->obj             = obj_0;
+    me->callback        = callback_0;
+}
+
+
+void deadline_timer_arm(struct deadline_timer_collection *col,
+                        struct deadline_timer *me,
+                        uint32_t ticks)
+{
+    ECU_RUNTIME_ASSERT( (col && me), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (ticks < 0x80000000U), BSP_ASSERT_FUNCTOR );
+
+    me->deadline    = (*col->i_get_ticks)(col->i_obj) + ticks;
+    me->period      = 0;
+    me->pending     = 0;
+    me->armed       = true;
+    armed_list_insert(col, me);
+}
+
+
+void deadline_timer_arm_periodic(struct deadline_timer_collection *col,
+                                 struct deadline_timer *me,
+                                 uint32_t period,
+                                 enum deadline_timer_late_policy policy,
+                                 uint32_t max_catch_up)
+{
+    ECU_RUNTIME_ASSERT( (col && me), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( ((period > 0) && (period < 0x80000000U)), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( ((policy == DEADLINE_TIMER_FIRE_ONCE) || (policy == DEADLINE_TIMER_CATCH_UP)), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( ((policy != DEADLINE_TIMER_CATCH_UP) || (max_catch_up > 0)), BSP_ASSERT_FUNCTOR );
+
+    me->deadline        = (*col->i_get_ticks)(col->i_obj) + period;
+    me->period          = period;
+    me->policy          = policy;
+    me->max_catch_up    = max_catch_up;
+    me->pending         = 0;
+    me->missed          = 0;
+    me->armed           = true;
+    armed_list_insert(col, me);
+}
+
+
+void deadline_timer_disarm(struct deadline_timer *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    me->armed   = false;
+    me->pending = 0;
+}
+
+
+bool deadline_timer_is_armed(const struct deadline_timer *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    return me->armed;
+}
+
+
+uint32_t deadline_timer_collection_tick(struct deadline_timer_collection *me)
+{
+    uint32_t now = 0;
+    uint32_t count = 0;
+    struct deadline_timer *due = (struct deadline_timer *)0;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    /* Step 1: Read the time once and collect every due timer. Deadlines
+    are advanced here so callbacks can rearm or disarm any timer. */
+    now = (*me->i_get_ticks)(me->i_obj);
+    due = collect_due(me, now);
+
+    /* Step 2: Dispatch. A callback that disarms or rearms a timer clears
+    its pending count, which cancels whatever is left of its batch. */
+    while (due)
+    {
+        struct deadline_timer *t = due;
+        due = t->due_next;
+        t->due_next = (struct deadline_timer *)0;
+
+        while (t->pending > 0)
+        {
+            t->pending--;
+            count++;
+            (*t->callback)(t->obj);
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file
+ * @brief Timers with absolute deadlines. A periodic timer computes each
+ * expiry from its previous deadline instead of from when its callback
+ * happened to run, so loop latency never accumulates as drift and timers
+ * armed together with the same period stay in phase.
+ *
+ * deadline_timer_collection_tick() reads the tick source once, collects
+ * every timer that is due and only then runs their callbacks so all
+ * timers due on the same tick see the same time. If the loop ran late and
+ * a periodic timer missed expiries, its late policy decides whether the
+ * callback runs once or catches up. Ticks are unsigned 32-bit and may
+ * wrap. Deadlines must be less than 2^31 ticks away.
+ *
+ * Not thread or interrupt safe. Arm, disarm and tick from the same context.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef DEADLINE_TIMER_H_
+#define DEADLINE_TIMER_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- DEADLINE TIMER DATA STRUCTURES --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief What a periodic timer does when the collection is ticked after
+ * more than one of its deadlines passed. Either way the next deadline
+ * stays on the original period grid.
+ */
+enum deadline_timer_late_policy
+{
+    /* Run the callback once. Skipped expiries are counted in missed. */
+    DEADLINE_TIMER_FIRE_ONCE,
+
+    /* Run the callback once per passed deadline, at most max_catch_up times.
+    Expiries beyond that are counted in missed. */
+    DEADLINE_TIMER_CATCH_UP
+};
+
+
+struct deadline_timer
+{
+    /* Private. Links in the collection's armed list and in the list of timers due this tick. */
+    struct deadline_timer *next;
+    struct deadline_timer *due_next;
+    bool linked;
+
+    bool armed;
+    uint32_t deadline;
+    uint32_t period;                            /* 0 for one-shot timers. */
+    enum deadline_timer_late_policy policy;
+    uint32_t max_catch_up;
+
+    /* Callbacks still to run in the current tick. */
+    uint32_t pending;
+
+    /* Expiries that were dropped because the loop ran late. */
+    uint32_t missed;
+
+    void *obj;
+    void (*callback)(void *obj);
+};
+
+
+struct deadline_timer_collection
+{
+    struct deadline_timer *armed;
+
+    void *i_obj;
+    uint32_t (*i_get_ticks)(void *i_obj);
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern void deadline_timer_collection_ctor(struct deadline_timer_collection *me,
+                                           void *i_obj_0,
+                                           uint32_t (*i_get_ticks_0)(void *i_obj));
+
+extern void deadline_timer_ctor(struct deadline_timer *me,
+                                void *obj_0,
+                                void (*callback_0)(void *obj));
+
+/**
+ * @brief One-shot. Expires ticks from now.
+ */
+extern void deadline_timer_arm(struct deadline_timer_collection *col,
+                               struct deadline_timer *me,
+                               uint32_t ticks);
+
+/**
+ * @brief First expiry is period ticks from now. Every following deadline
+ * is the previous deadline plus period. max_catch_up is only used by
+ * DEADLINE_TIMER_CATCH_UP and must be at least 1.
+ */
+extern void deadline_timer_arm_periodic(struct deadline_timer_collection *col,
+                                        struct deadline_timer *me,
+                                        uint32_t period,
+                                        enum deadline_timer_late_policy policy,
+                                        uint32_t max_catch_up);
+
+/**
+ * @brief Safe to call from any callback, including on timers that are
+ * due in the same tick. Their remaining callbacks are cancelled.
+ */
+extern void deadline_timer_disarm(struct deadline_timer *me);
+
+extern bool deadline_timer_is_armed(const struct deadline_timer *me);
+
+/**
+ * @brief Runs the callback of every timer that is due. Must not be called
+ * from a callback. Returns how many callbacks ran.
+ */
+extern uint32_t deadline_timer_collection_tick(struct deadline_timer_collection *me);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEADLINE_TIMER_H_ */
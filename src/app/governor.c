@@ -0,0 +1,186 @@
+/**
+ * @file
+ * @brief See governor.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "app/governor.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ECU. */
+#include "ecu/asserter.h"
+
+/* BSP. */
+#include "bsp/bsp.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void window_reset(struct governor *me);
+static void level_change(struct governor *me, uint8_t level);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void window_reset(struct governor *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    me->window_cycles   = 0;
+    me->busy_cycles     = 0;
+    me->backlog_max     = 0;
+}
+
+
+static void level_change(struct governor *me, uint8_t level)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (level < me->config->levels), BSP_ASSERT_FUNCTOR );
+
+    if (level != me->level)
+    {
+        me->level = level;
+        me->low_windows = 0;
+        me->switches++;
+        (*me->i_level_set)(me->i_obj, level);
+
+        /* Cycles counted so far were at the old clock. */
+        window_reset(me);
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void governor_ctor(struct governor *me,
+                   const struct governor_config *config_0,
+                   uint8_t level_0,
+                   void *i_obj_0,
+                   void (*i_level_set_0)(void *i_obj, uint8_t level))
+{
+    ECU_RUNTIME_ASSERT( (me && config_0 && i_level_set_0), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( ((config_0->levels > 0) && (level_0 < config_0->levels)), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( ((config_0->down_windows > 0) && (config_0->down_permille <= config_0->up_permille)), BSP_ASSERT_FUNCTOR );
+
+    me->config              = config_0;
+    me->level               = level_0;
+    me->low_windows         = 0;
+    me->busy_permille       = 0;
+    me->last_backlog_max    = 0;
+    me->switches            = 0;
+    me->i_obj               = i_obj_0;
+    me->i_level_set         = i_level_set_0;
+    window_reset(me);
+}
+
+
+void governor_pass(struct governor *me, uint32_t cycles, uint32_t backlog)
+{
+    uint8_t top = 0;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    me->window_cycles += cycles;
+    if (backlog > 0)
+    {
+        me->busy_cycles += cycles;
+    }
+
+    if (backlog > me->backlog_max)
+    {
+        me->backlog_max = backlog;
+    }
+
+    top = (uint8_t)(me->config->levels - 1U);
+    if ((me->config->policy != GOVERNOR_FIXED) && (me->config->backlog_boost > 0) &&
+        (backlog >= me->config->backlog_boost) && (me->level != top))
+    {
+        level_change(me, top);
+    }
+}
+
+
+void governor_evaluate(struct governor *me)
+{
+    uint8_t top = 0;
+    uint8_t level = 0;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    top = (uint8_t)(me->config->levels - 1U);
+    level = me->level;
+    me->busy_permille = (me->window_cycles > 0) ?
+                        (uint16_t)(((uint64_t)me->busy_cycles * 1000U) / me->window_cycles) : 0;
+    me->last_backlog_max = me->backlog_max;
+    window_reset(me);
+
+    switch (me->config->policy)
+    {
+        case GOVERNOR_FIXED:
+        {
+            break;
+        }
+
+        case GOVERNOR_ONDEMAND:
+        case GOVERNOR_CONSERVATIVE:
+        {
+            if (me->busy_permille >= me->config->up_permille)
+            {
+                me->low_windows = 0;
+                if (level < top)
+                {
+                    level = (me->config->policy == GOVERNOR_ONDEMAND) ? top : (uint8_t)(level + 1U);
+                }
+            }
+            else if (me->busy_permille < me->config->down_permille)
+            {
+                me->low_windows++;
+                if ((me->low_windows >= me->config->down_windows) && (level > 0))
+                {
+                    me->low_windows = 0;
+                    level--;
+                }
+            }
+            else
+            {
+                me->low_windows = 0;
+            }
+            break;
+        }
+
+        default:
+        {
+            ECU_RUNTIME_ASSERT( (false), BSP_ASSERT_FUNCTOR );
+            break;
+        }
+    }
+
+    level_change(me, level);
+}
+
+
+uint8_t governor_level(const struct governor *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    return me->level;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file
+ * @brief Picks a performance level from main loop load. Levels are
+ * numbered from 0 (slowest) to levels - 1 (fastest). What a level means
+ * (clock tree, voltage range) is up to whoever implements i_level_set.
+ *
+ * The load is fed in once per main loop pass with @ref governor_pass:
+ * how many cycles the pass took and how many events it found waiting.
+ * Passes that found events count as busy. @ref governor_evaluate is
+ * called at the end of every window (i.e. from a periodic timer) and
+ * moves the level according to the busy ratio of that window. A single
+ * pass with a large enough backlog jumps straight to the top level
+ * without waiting for the window to end, so bursts are not handled at
+ * the slow clock.
+ *
+ * Cycle counts must be in core clock cycles of the level the pass ran
+ * at. Only their ratio within a window is used and every level change
+ * starts a new window, so the clock change does not skew it.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef GOVERNOR_H_
+#define GOVERNOR_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ GOVERNOR DATA STRUCTURES -----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+enum governor_policy
+{
+    /* Stays on the level it was constructed with. */
+    GOVERNOR_FIXED,
+
+    /* Jumps to the top level when busy. Steps down one level at a time
+    once load has been low for down_windows windows. */
+    GOVERNOR_ONDEMAND,
+
+    /* Steps one level up when busy and one level down once load has been
+    low for down_windows windows. */
+    GOVERNOR_CONSERVATIVE
+};
+
+
+struct governor_config
+{
+    enum governor_policy policy;
+    uint8_t levels;                 /* Number of levels. At least 1. */
+    uint16_t up_permille;           /* Busy ratio at or above which a window speeds up. */
+    uint16_t down_permille;         /* Busy ratio below which a window counts as low load. */
+    uint8_t down_windows;           /* Low load windows in a row before stepping down. At least 1. */
+    uint32_t backlog_boost;         /* Backlog that jumps to the top level right away. 0 disables. */
+};
+
+
+struct governor
+{
+    const struct governor_config *config;
+    uint8_t level;
+    uint8_t low_windows;
+
+    /* Current window. */
+    uint32_t window_cycles;
+    uint32_t busy_cycles;
+    uint32_t backlog_max;
+
+    /* Busy ratio and peak backlog of the last window evaluated. */
+    uint16_t busy_permille;
+    uint32_t last_backlog_max;
+
+    /* Level changes since construction. */
+    uint32_t switches;
+
+    void *i_obj;
+    void (*i_level_set)(void *i_obj, uint8_t level);
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief level_0 is the level the hardware already runs at. i_level_set_0
+ * is not called for it. i_obj_0 is optional. config_0 must outlive me.
+ */
+extern void governor_ctor(struct governor *me,
+                          const struct governor_config *config_0,
+                          uint8_t level_0,
+                          void *i_obj_0,
+                          void (*i_level_set_0)(void *i_obj, uint8_t level));
+
+/**
+ * @brief Records one main loop pass. @p backlog is the number of events
+ * the pass found waiting. May call i_level_set if backlog_boost is
+ * reached. A window must not add up to more than 2^32 cycles.
+ */
+extern void governor_pass(struct governor *me, uint32_t cycles, uint32_t backlog);
+
+/**
+ * @brief Ends the current window and moves the level. May call
+ * i_level_set.
+ */
+extern void governor_evaluate(struct governor *me);
+
+extern uint8_t governor_level(const struct governor *me);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GOVERNOR_H_ */
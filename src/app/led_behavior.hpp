@@ -0,0 +1,388 @@
+/**
+ * @file
+ * @brief C++20 coroutine runtime for LED behaviors. A behavior is written
+ * as one coroutine that awaits switch and timer events instead of a
+ * hand-coded state chart. All state the behavior needs lives in its
+ * coroutine frame. Frames come from a fixed static pool so nothing is
+ * allocated from the heap.
+ *
+ * Example. Same behavior as led_fsm.c:
+ *
+ *     app::led_behavior led0 = app::press_and_hold<led0_config, led0_outputs, led0_timer>();
+ *     led0.dispatch(LED_FSM_SWITCH_PRESSED_EVT);
+ *
+ * Config, Outputs and Timer are the same types app::led_fsm takes. See
+ * led_fsm.hpp. Behaviors are resumed from dispatch() in the calling
+ * context, so dispatch() and behavior creation must not be called from
+ * interrupts.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef LED_BEHAVIOR_HPP_
+#define LED_BEHAVIOR_HPP_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+/* LED FSM. Event signals, LED states and concepts are shared. */
+#include "app/led_fsm.h"
+#include "app/led_fsm.hpp"
+
+/* ECU. */
+#include "ecu/asserter.h"
+#include "ecu/fsm.h"
+
+/* Board support package. */
+#include "bsp/bsp.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- DEFINES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Bytes in one frame pool block. Must be at least the largest
+ * coroutine frame. Frame sizes are only known to the compiler, so the
+ * bench reports the largest request seen to size this.
+ */
+#ifndef LED_BEHAVIOR_FRAME_BYTES
+#define LED_BEHAVIOR_FRAME_BYTES                (128U)
+#endif
+
+/**
+ * @brief Number of behaviors that can exist at once.
+ */
+#ifndef LED_BEHAVIOR_FRAME_COUNT
+#define LED_BEHAVIOR_FRAME_COUNT                (8U)
+#endif
+
+
+
+namespace app
+{
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- FRAME POOL ------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Fixed-size block allocator for coroutine frames. One bit per
+ * block marks it as used.
+ */
+class frame_pool
+{
+public:
+    static constexpr std::size_t block_bytes = LED_BEHAVIOR_FRAME_BYTES;
+    static constexpr std::size_t block_count = LED_BEHAVIOR_FRAME_COUNT;
+
+    static_assert((block_count > 0) && (block_count <= 32U), "Used blocks are tracked in a uint32_t.");
+    static_assert((block_bytes % alignof(std::max_align_t)) == 0, "Blocks must stay aligned.");
+
+    /**
+     * @brief Returns nullptr if size is larger than a block or every
+     * block is used.
+     */
+    static void *allocate(std::size_t size) noexcept
+    {
+        if (size > largest_request_)
+        {
+            largest_request_ = size;
+        }
+
+        if (size <= block_bytes)
+        {
+            for (std::size_t i = 0; i < block_count; i++)
+            {
+                if (!(used_ & (UINT32_C(1) << i)))
+                {
+                    used_ |= (UINT32_C(1) << i);
+                    return &storage_[i * block_bytes];
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
+    static void deallocate(void *block) noexcept
+    {
+        std::size_t offset = static_cast<std::size_t>(static_cast<std::byte *>(block) - &storage_[0]);
+        ECU_RUNTIME_ASSERT( (offset < sizeof(storage_)) && ((offset % block_bytes) == 0), BSP_ASSERT_FUNCTOR );
+        used_ &= ~(UINT32_C(1) << (offset / block_bytes));
+    }
+
+    /**
+     * @brief Largest frame ever requested, including failed requests.
+     */
+    static std::size_t largest_request() noexcept
+    {
+        return largest_request_;
+    }
+
+    static std::size_t blocks_used() noexcept
+    {
+        return static_cast<std::size_t>(__builtin_popcount(used_));
+    }
+
+private:
+    alignas(std::max_align_t) static inline std::byte storage_[block_count * block_bytes];
+    static inline std::uint32_t used_ = 0;
+    static inline std::size_t largest_request_ = 0;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- BEHAVIOR -------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Owns one running behavior coroutine. Move only.
+ */
+class led_behavior
+{
+public:
+    struct promise_type
+    {
+        /* Signals the behavior is currently waiting for. One bit per signal. */
+        std::uint32_t awaited = 0;
+        enum led_fsm_event_signals signal = LED_FSM_SWITCH_PRESSED_EVT;
+
+        static void *operator new(std::size_t size) noexcept
+        {
+            return frame_pool::allocate(size);
+        }
+
+        static void operator delete(void *frame) noexcept
+        {
+            frame_pool::deallocate(frame);
+        }
+
+        /* Returned instead when the frame pool is exhausted. */
+        static led_behavior get_return_object_on_allocation_failure() noexcept
+        {
+            return led_behavior{};
+        }
+
+        led_behavior get_return_object() noexcept
+        {
+            return led_behavior{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        /* Run to the first co_await when created, like the FSM entering its initial state. */
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+            /* Firmware builds without exceptions. */
+            ECU_RUNTIME_ASSERT( (false), BSP_ASSERT_FUNCTOR );
+        }
+    };
+
+    static constexpr std::uint32_t bit(enum led_fsm_event_signals signal)
+    {
+        return UINT32_C(1) << (static_cast<std::uint32_t>(signal) - static_cast<std::uint32_t>(LED_FSM_SWITCH_PRESSED_EVT));
+    }
+
+    led_behavior() noexcept = default;
+
+    led_behavior(led_behavior &&other) noexcept
+        : handle_(other.handle_)
+    {
+        other.handle_ = nullptr;
+    }
+
+    led_behavior &operator=(led_behavior &&other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    led_behavior(const led_behavior &) = delete;
+    led_behavior &operator=(const led_behavior &) = delete;
+
+    ~led_behavior()
+    {
+        destroy();
+    }
+
+    /**
+     * @brief False if the frame pool was exhausted when the behavior was
+     * created.
+     */
+    bool valid() const noexcept
+    {
+        return static_cast<bool>(handle_);
+    }
+
+    /**
+     * @brief Resumes the behavior if it is waiting for this signal.
+     * Returns ECU_FSM_EVENT_IGNORED otherwise, same as the FSM versions.
+     */
+    enum ecu_fsm_status dispatch(enum led_fsm_event_signals signal)
+    {
+        ECU_RUNTIME_ASSERT( (handle_), BSP_ASSERT_FUNCTOR );
+
+        promise_type &promise = handle_.promise();
+        if (handle_.done() || !(promise.awaited & bit(signal)))
+        {
+            return ECU_FSM_EVENT_IGNORED;
+        }
+
+        promise.awaited = 0;
+        promise.signal = signal;
+        handle_.resume();
+        return ECU_FSM_EVENT_HANDLED;
+    }
+
+    enum ecu_fsm_status dispatch(const struct led_fsm_event &evt)
+    {
+        return dispatch(static_cast<enum led_fsm_event_signals>(evt.base_event.id));
+    }
+
+private:
+    explicit led_behavior(std::coroutine_handle<promise_type> handle) noexcept
+        : handle_(handle)
+    {
+    }
+
+    void destroy() noexcept
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+
+/**
+ * @brief Awaitable. co_await until(...) suspends until one of the
+ * signals is dispatched and evaluates to that signal.
+ */
+struct until
+{
+    std::uint32_t mask;
+
+    template<typename... Signals>
+    explicit constexpr until(Signals... signals)
+        : mask((led_behavior::bit(signals) | ...))
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<led_behavior::promise_type> handle) noexcept
+    {
+        promise_ = &handle.promise();
+        promise_->awaited = mask;
+    }
+
+    enum led_fsm_event_signals await_resume() const noexcept
+    {
+        return promise_->signal;
+    }
+
+private:
+    led_behavior::promise_type *promise_ = nullptr;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- BEHAVIORS ------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief LED on while the switch is pressed. Held longer than hold_time_ms
+ * toggles every toggle_time_ms until released. Same as led_fsm.c. Starts
+ * with the LED off and the timer disarmed, like the FSM entering its off
+ * state. If Outputs can toggle in hardware, toggling while held is handed
+ * to toggle_start() and toggle_stop() and the timer is not used for it.
+ */
+/* GCC lowers coroutines to a switch without a default case. */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wswitch-default"
+template<led_fsm_config Config, led_fsm_outputs Outputs, led_fsm_timer Timer>
+led_behavior press_and_hold()
+{
+    enum led_fsm_led_state led = LED_FSM_LED_STATE_OFF;
+
+    Outputs::led_set(led);
+    Timer::disarm();
+
+    for (;;)
+    {
+        co_await until{LED_FSM_SWITCH_PRESSED_EVT};
+        led = LED_FSM_LED_STATE_ON;
+        Outputs::led_set(led);
+        Timer::arm(Config::hold_time_ms);
+
+        if (co_await until{LED_FSM_SWITCH_RELEASED_EVT, LED_FSM_TIMEOUT_EVT} == LED_FSM_TIMEOUT_EVT)
+        {
+            if constexpr (led_fsm_hw_toggle_outputs<Outputs>)
+            {
+                /* Timeouts are not awaited, so a stray one is ignored like in the FSM. */
+                Outputs::toggle_start(led, Config::toggle_time_ms);
+                co_await until{LED_FSM_SWITCH_RELEASED_EVT};
+                led = Outputs::toggle_stop();
+            }
+            else
+            {
+                Timer::arm(Config::toggle_time_ms);
+                while (co_await until{LED_FSM_SWITCH_RELEASED_EVT, LED_FSM_TIMEOUT_EVT} == LED_FSM_TIMEOUT_EVT)
+                {
+                    led = (led == LED_FSM_LED_STATE_ON) ? LED_FSM_LED_STATE_OFF : LED_FSM_LED_STATE_ON;
+                    Outputs::led_set(led);
+                    Timer::arm(Config::toggle_time_ms);
+                }
+            }
+        }
+
+        led = LED_FSM_LED_STATE_OFF;
+        Outputs::led_set(led);
+        Timer::disarm();
+    }
+}
+#pragma GCC diagnostic pop
+
+} /* namespace app */
+
+#endif /* LED_BEHAVIOR_HPP_ */
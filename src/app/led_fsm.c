@@ -46,6 +46,8 @@ ECU_STATIC_ASSERT( (offsetof(struct led_fsm_event, base_event) == 0) );
 /*-------------------------------------------------------------------------------------*/
 
 static bool is_constructed(struct led_fsm *me);
+static bool uses_hw_toggle(const struct led_fsm *me);
+static bool uses_periodic_timer(const struct led_fsm *me);
 
 
 
@@ -74,6 +76,7 @@ static enum ecu_fsm_status on_state_handler(struct led_fsm *me,
 /*-------------------------------------------------------------------------------------*/
 
 static enum ecu_fsm_status held_down_state_on_entry(struct led_fsm *me);
+static void held_down_state_on_exit(struct led_fsm *me);
 static enum ecu_fsm_status held_down_state_handler(struct led_fsm *me, 
                                                    const struct led_fsm_event *evt);
 
@@ -103,7 +106,7 @@ static const struct ecu_fsm_state held_down_state =
 {
     .handler    = (ecu_fsm_state_handler)&held_down_state_handler,
     .on_entry   = (ecu_fsm_on_entry_handler)&held_down_state_on_entry,
-    .on_exit    = (ecu_fsm_on_exit_handler)0
+    .on_exit    = (ecu_fsm_on_exit_handler)&held_down_state_on_exit
 };
 
 
@@ -131,6 +134,20 @@ static bool is_constructed(struct led_fsm *me)
 }
 
 
+static bool uses_hw_toggle(const struct led_fsm *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    return ((me->api.i_toggle_start) && (me->api.i_toggle_stop));
+}
+
+
+static bool uses_periodic_timer(const struct led_fsm *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    return (me->api.i_timer_arm_periodic != 0);
+}
+
+
 
 /*-------------------------------------------------------------------------------------*/
 /*----------------------- STATIC FUNCTION DEFINITIONS - OFF STATE ---------------------*/
@@ -144,6 +161,8 @@ static enum ecu_fsm_status off_state_on_entry(struct led_fsm *me)
     me->led_state = LED_FSM_LED_STATE_OFF;
     (*me->api.i_led_set)(me->api.i_obj, LED_FSM_LED_STATE_OFF);
     (*me->api.i_timer_disarm)(me->api.i_obj);
+
+    return ECU_FSM_EVENT_HANDLED;
 }
 
 
@@ -186,6 +205,8 @@ static enum ecu_fsm_status on_state_on_entry(struct led_fsm *me)
     me->led_state = LED_FSM_LED_STATE_ON;
     (*me->api.i_led_set)(me->api.i_obj, LED_FSM_LED_STATE_ON);
     (*me->api.i_timer_arm)(me->api.i_obj, me->hold_time_ms);
+
+    return ECU_FSM_EVENT_HANDLED;
 }
 
 
@@ -230,7 +251,38 @@ static enum ecu_fsm_status held_down_state_on_entry(struct led_fsm *me)
 {
     ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
     ECU_RUNTIME_ASSERT( (is_constructed(me)), BSP_ASSERT_FUNCTOR );
-    (*me->api.i_timer_arm)(me->api.i_obj, me->toggle_time_ms);
+
+    if (uses_hw_toggle(me))
+    {
+        /* Hardware toggles the LED from here on. The hold timer already
+        expired so no software timer is left running. */
+        (*me->api.i_toggle_start)(me->api.i_obj, me->led_state, me->toggle_time_ms);
+    }
+    else if (uses_periodic_timer(me))
+    {
+        /* Armed once. Expiries stay on the period grid from here on. */
+        (*me->api.i_timer_arm_periodic)(me->api.i_obj, me->toggle_time_ms);
+    }
+    else
+    {
+        (*me->api.i_timer_arm)(me->api.i_obj, me->toggle_time_ms);
+    }
+
+    return ECU_FSM_EVENT_HANDLED;
+}
+
+
+static void held_down_state_on_exit(struct led_fsm *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (is_constructed(me)), BSP_ASSERT_FUNCTOR );
+
+    if (uses_hw_toggle(me))
+    {
+        /* Take the LED back from hardware. Keep led_state in sync with 
+        whatever level the pin was left at. */
+        me->led_state = (*me->api.i_toggle_stop)(me->api.i_obj);
+    }
 }
 
 
@@ -251,7 +303,14 @@ static enum ecu_fsm_status held_down_state_handler(struct led_fsm *me,
 
         case LED_FSM_TIMEOUT_EVT:
         {
-            /* Toggle the LED and rearm the toggle timer. */
+            /* Hardware toggles the LED on its own. No timer is armed in this mode. */
+            if (uses_hw_toggle(me))
+            {
+                status = ECU_FSM_EVENT_IGNORED;
+                break;
+            }
+
+            /* Toggle the LED. Rearm the toggle timer unless it is periodic. */
             if (me->led_state == LED_FSM_LED_STATE_ON)
             {
                 me->led_state = LED_FSM_LED_STATE_OFF;
@@ -263,7 +322,10 @@ static enum ecu_fsm_status held_down_state_handler(struct led_fsm *me,
                 (*me->api.i_led_set)(me->api.i_obj, LED_FSM_LED_STATE_ON);
             }
 
-            (*me->api.i_timer_arm)(me->api.i_obj, me->toggle_time_ms);
+            if (!uses_periodic_timer(me))
+            {
+                (*me->api.i_timer_arm)(me->api.i_obj, me->toggle_time_ms);
+            }
             break;
         }
 
@@ -292,7 +354,7 @@ void led_fsm_ctor(struct led_fsm *me,
                   void (*i_timer_disarm_0)(void *i_obj))
 {
     /* i_obj_0 is optional. */
-    ECU_RUNTIME_ASSERT( ((hold_time_ms_0 > 0) && (toggle_time_ms_0 > 0)), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (led_fsm_timing_valid(hold_time_ms_0, toggle_time_ms_0)), BSP_ASSERT_FUNCTOR );
     ECU_RUNTIME_ASSERT( (me && i_led_set_0 && i_timer_arm_0 && i_timer_disarm_0), BSP_ASSERT_FUNCTOR );
 
     ecu_fsm_ctor((struct ecu_fsm *)me, &off_state);
@@ -303,4 +365,40 @@ void led_fsm_ctor(struct led_fsm *me,
     me->api.i_led_set       = i_led_set_0;
     me->api.i_timer_arm     = i_timer_arm_0;
     me->api.i_timer_disarm  = i_timer_disarm_0;
+    me->api.i_toggle_start  = 0;
+    me->api.i_toggle_stop   = 0;
+    me->api.i_timer_arm_periodic = 0;
+}
+
+
+void led_fsm_hw_toggle_set(struct led_fsm *me,
+                           void (*i_toggle_start_0)(void *i_obj, enum led_fsm_led_state state, uint32_t period_ms),
+                           enum led_fsm_led_state (*i_toggle_stop_0)(void *i_obj))
+{
+    ECU_RUNTIME_ASSERT( (me && i_toggle_start_0 && i_toggle_stop_0), BSP_ASSERT_FUNCTOR );
+    me->api.i_toggle_start  = i_toggle_start_0;
+    me->api.i_toggle_stop   = i_toggle_stop_0;
+}
+
+
+void led_fsm_periodic_timer_set(struct led_fsm *me,
+                                void (*i_timer_arm_periodic_0)(void *i_obj, uint32_t period_ms))
+{
+    ECU_RUNTIME_ASSERT( (me && i_timer_arm_periodic_0), BSP_ASSERT_FUNCTOR );
+    me->api.i_timer_arm_periodic = i_timer_arm_periodic_0;
+}
+
+
+bool led_fsm_timing_valid(uint32_t hold_time_ms, uint32_t toggle_time_ms)
+{
+    return ((hold_time_ms > 0) && (hold_time_ms <= LED_FSM_HOLD_TIME_MS_MAX) &&
+            (toggle_time_ms > 0) && (toggle_time_ms <= LED_FSM_TOGGLE_TIME_MS_MAX));
+}
+
+
+void led_fsm_timing_set(struct led_fsm *me, uint32_t hold_time_ms, uint32_t toggle_time_ms)
+{
+    ECU_RUNTIME_ASSERT( (me && led_fsm_timing_valid(hold_time_ms, toggle_time_ms)), BSP_ASSERT_FUNCTOR );
+    me->hold_time_ms    = hold_time_ms;
+    me->toggle_time_ms  = toggle_time_ms;
 }
@@ -19,6 +19,7 @@
 /*-------------------------------------------------------------------------------------*/
 
 /* STDLib. */
+#include <stdbool.h>
 #include <stdint.h>
 
 /* ECU. */
@@ -26,6 +27,20 @@
 
 
 
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- DEFINES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Longest times the timers behind the interface can take, 1 ms
+ * ticks. Deadline timers are armed less than 2^31 ticks ahead and the
+ * hardware toggle timer counts 10 per ms in 32 bits.
+ */
+#define LED_FSM_HOLD_TIME_MS_MAX                (0x7FFFFFFFU)
+#define LED_FSM_TOGGLE_TIME_MS_MAX              (UINT32_MAX / 10U)
+
+
+
 /*-------------------------------------------------------------------------------------*/
 /*------------------------------- LED FSM DATA STRUCTURES -----------------------------*/
 /*-------------------------------------------------------------------------------------*/
@@ -60,6 +75,13 @@ struct led_fsm
         void (*i_led_set)(void *i_obj, enum led_fsm_led_state state);
         void (*i_timer_arm)(void *i_obj, uint32_t ms);
         void (*i_timer_disarm)(void *i_obj);
+
+        /* Optional. Hardware toggling used in the held down state. See led_fsm_hw_toggle_set(). */
+        void (*i_toggle_start)(void *i_obj, enum led_fsm_led_state state, uint32_t period_ms);
+        enum led_fsm_led_state (*i_toggle_stop)(void *i_obj);
+
+        /* Optional. Periodic toggle timer used in the held down state. See led_fsm_periodic_timer_set(). */
+        void (*i_timer_arm_periodic)(void *i_obj, uint32_t period_ms);
     } api;
 };
 
@@ -87,6 +109,44 @@ extern void led_fsm_ctor(struct led_fsm *me,
                          void (*i_timer_arm_0)(void *i_obj, uint32_t ms),
                          void (*i_timer_disarm_0)(void *i_obj));
 
+/**
+ * @brief Optional. Offloads toggling in the held down state to hardware
+ * (i.e. a timer output compare channel) so the CPU is not woken up on
+ * every toggle. On entry to the held down state i_toggle_start_0 is 
+ * called with the current LED state and the toggle period. The hardware 
+ * must hold that state until the first toggle. On exit i_toggle_stop_0 
+ * must stop toggling and return the state the LED was left in. The toggle 
+ * timer is not armed while hardware toggling is used.
+ */
+extern void led_fsm_hw_toggle_set(struct led_fsm *me,
+                                  void (*i_toggle_start_0)(void *i_obj, enum led_fsm_led_state state, uint32_t period_ms),
+                                  enum led_fsm_led_state (*i_toggle_stop_0)(void *i_obj));
+
+/**
+ * @brief Optional. On entry to the held down state the toggle timer is 
+ * armed once with i_timer_arm_periodic_0 instead of being rearmed on 
+ * every timeout. The timer must keep expiring every period_ms, measured 
+ * from its previous deadline so toggling does not drift, until 
+ * i_timer_disarm or i_timer_arm is called. Not used if hardware toggling
+ * is set.
+ */
+extern void led_fsm_periodic_timer_set(struct led_fsm *me,
+                                       void (*i_timer_arm_periodic_0)(void *i_obj, uint32_t period_ms));
+
+/**
+ * @brief True if @p hold_time_ms and @p toggle_time_ms are non-zero and
+ * within LED_FSM_HOLD_TIME_MS_MAX and LED_FSM_TOGGLE_TIME_MS_MAX. Check
+ * times that come from outside the firmware with it before setting them.
+ */
+extern bool led_fsm_timing_valid(uint32_t hold_time_ms, uint32_t toggle_time_ms);
+
+/**
+ * @brief Changes the hold and toggle times at runtime. Both must be valid.
+ * A hold or toggle period already running finishes with the old time. The
+ * new times are used from the next time a timer is armed.
+ */
+extern void led_fsm_timing_set(struct led_fsm *me, uint32_t hold_time_ms, uint32_t toggle_time_ms);
+
 #ifdef __cplusplus
 }
 #endif
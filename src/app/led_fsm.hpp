@@ -0,0 +1,262 @@
+/**
+ * @file
+ * @brief Header-only C++20 version of the LED FSM in led_fsm.c. States,
+ * actions and timing are resolved at compile time. The hold and toggle
+ * times come from Config and the LED and timer actions are static member
+ * functions of Outputs and Timer, so every call can be inlined and
+ * dispatch has no indirect calls. Behavior matches led_fsm.c transition
+ * for transition and it consumes the same led_fsm_event signals.
+ *
+ * Example:
+ *
+ *     struct led0_config { static constexpr uint32_t hold_time_ms = 3000;
+ *                          static constexpr uint32_t toggle_time_ms = 1000; };
+ *     struct led0_outputs { static void led_set(led_fsm_led_state state); };
+ *     struct led0_timer { static void arm(uint32_t ms); static void disarm(); };
+ *
+ *     app::led_fsm<led0_config, led0_outputs, led0_timer> led0;
+ *     led0.dispatch(LED_FSM_SWITCH_PRESSED_EVT);
+ *
+ * Outputs may also provide static toggle_start(led_fsm_led_state, uint32_t)
+ * and static toggle_stop() -> led_fsm_led_state. If it does, toggling in
+ * the held down state is offloaded to hardware. See led_fsm_hw_toggle_set().
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef LED_FSM_HPP_
+#define LED_FSM_HPP_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <concepts>
+#include <cstdint>
+
+/* C LED FSM. Event signals and LED states are shared. */
+#include "app/led_fsm.h"
+
+/* ECU. */
+#include "ecu/fsm.h"
+
+
+
+namespace app
+{
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- CONCEPTS -------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+template<typename T>
+concept led_fsm_config = requires
+{
+    { T::hold_time_ms } -> std::convertible_to<std::uint32_t>;
+    { T::toggle_time_ms } -> std::convertible_to<std::uint32_t>;
+} && (T::hold_time_ms > 0) && (T::toggle_time_ms > 0);
+
+
+template<typename T>
+concept led_fsm_outputs = requires(led_fsm_led_state state)
+{
+    { T::led_set(state) };
+};
+
+
+template<typename T>
+concept led_fsm_hw_toggle_outputs = led_fsm_outputs<T> && requires(led_fsm_led_state state, std::uint32_t ms)
+{
+    { T::toggle_start(state, ms) };
+    { T::toggle_stop() } -> std::same_as<led_fsm_led_state>;
+};
+
+
+template<typename T>
+concept led_fsm_timer = requires(std::uint32_t ms)
+{
+    { T::arm(ms) };
+    { T::disarm() };
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------ LED FSM CLASS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+template<led_fsm_config Config, led_fsm_outputs Outputs, led_fsm_timer Timer>
+class led_fsm
+{
+public:
+    enum class state : std::uint8_t
+    {
+        off,
+        on,
+        held_down
+    };
+
+    /**
+     * @brief Starts in the off state with the LED off, same as led_fsm_ctor().
+     */
+    constexpr led_fsm() = default;
+
+    /**
+     * @brief Accepts the same signals as the C FSM. Returns
+     * ECU_FSM_EVENT_IGNORED for signals the current state does not handle.
+     */
+    enum ecu_fsm_status dispatch(enum led_fsm_event_signals signal)
+    {
+        enum ecu_fsm_status status = ECU_FSM_EVENT_HANDLED;
+
+        switch (state_)
+        {
+            case state::off:
+            {
+                if (signal == LED_FSM_SWITCH_PRESSED_EVT)
+                {
+                    transition(state::on);
+                }
+                else
+                {
+                    status = ECU_FSM_EVENT_IGNORED;
+                }
+                break;
+            }
+
+            case state::on:
+            {
+                if (signal == LED_FSM_SWITCH_RELEASED_EVT)
+                {
+                    transition(state::off);
+                }
+                else if (signal == LED_FSM_TIMEOUT_EVT)
+                {
+                    transition(state::held_down);
+                }
+                else
+                {
+                    status = ECU_FSM_EVENT_IGNORED;
+                }
+                break;
+            }
+
+            case state::held_down:
+            {
+                if (signal == LED_FSM_SWITCH_RELEASED_EVT)
+                {
+                    transition(state::off);
+                }
+                else if ((signal == LED_FSM_TIMEOUT_EVT) && (!hw_toggle))
+                {
+                    /* Toggle the LED and rearm the toggle timer. */
+                    led_set((led_state_ == LED_FSM_LED_STATE_ON) ? LED_FSM_LED_STATE_OFF : LED_FSM_LED_STATE_ON);
+                    Timer::arm(Config::toggle_time_ms);
+                }
+                else
+                {
+                    status = ECU_FSM_EVENT_IGNORED;
+                }
+                break;
+            }
+
+            default:
+            {
+                status = ECU_FSM_EVENT_IGNORED;
+                break;
+            }
+        }
+
+        return status;
+    }
+
+    /**
+     * @brief Interoperates with code that passes the C event struct around.
+     */
+    enum ecu_fsm_status dispatch(const struct led_fsm_event &evt)
+    {
+        return dispatch(static_cast<enum led_fsm_event_signals>(evt.base_event.id));
+    }
+
+    state current_state() const
+    {
+        return state_;
+    }
+
+    enum led_fsm_led_state led_state() const
+    {
+        return led_state_;
+    }
+
+private:
+    static constexpr bool hw_toggle = led_fsm_hw_toggle_outputs<Outputs>;
+
+    void led_set(enum led_fsm_led_state s)
+    {
+        led_state_ = s;
+        Outputs::led_set(s);
+    }
+
+    void transition(state next)
+    {
+        /* Exit. Only the held down state has an exit action. */
+        if constexpr (hw_toggle)
+        {
+            if (state_ == state::held_down)
+            {
+                led_state_ = Outputs::toggle_stop();
+            }
+        }
+
+        /* Entry. */
+        state_ = next;
+        switch (next)
+        {
+            case state::off:
+            {
+                led_set(LED_FSM_LED_STATE_OFF);
+                Timer::disarm();
+                break;
+            }
+
+            case state::on:
+            {
+                led_set(LED_FSM_LED_STATE_ON);
+                Timer::arm(Config::hold_time_ms);
+                break;
+            }
+
+            case state::held_down:
+            {
+                if constexpr (hw_toggle)
+                {
+                    Outputs::toggle_start(led_state_, Config::toggle_time_ms);
+                }
+                else
+                {
+                    Timer::arm(Config::toggle_time_ms);
+                }
+                break;
+            }
+
+            default:
+            {
+                break;
+            }
+        }
+    }
+
+    state state_ = state::off;
+    enum led_fsm_led_state led_state_ = LED_FSM_LED_STATE_OFF;
+};
+
+} /* namespace app */
+
+#endif /* LED_FSM_HPP_ */
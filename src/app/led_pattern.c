@@ -0,0 +1,379 @@
+/**
+ * @file
+ * @brief See led_pattern.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "app/led_pattern.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* External libraries. ECU. */
+#include "ecu/asserter.h"
+
+/* Board support package. Asserts. */
+#include "bsp/bsp.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- STATIC ASSERTS -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+ECU_STATIC_ASSERT( (sizeof(led_pattern_step) == 2U) );
+ECU_STATIC_ASSERT( (LED_PATTERN_EVENT_MASK == LED_PATTERN_NO_EVENT) );
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- STATIC FUNCTION DECLARATIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static bool is_valid(const struct led_pattern *pattern);
+static void due_update(struct led_pattern_engine *me, uint32_t deadline);
+static void level_set(struct led_pattern_engine *me, uint16_t channel, bool on);
+static void execute(struct led_pattern_engine *me, uint16_t channel, uint32_t base);
+static void restart(struct led_pattern_engine *me, uint16_t channel);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static bool is_valid(const struct led_pattern *pattern)
+{
+    led_pattern_step step = 0;
+    uint32_t back = 0;
+    bool blocks = false;
+
+    if (!pattern || !pattern->steps || (pattern->count == 0))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < pattern->count; i++)
+    {
+        step = pattern->steps[i];
+        switch (step & LED_PATTERN_OP_MASK)
+        {
+            case LED_PATTERN_OP_LEVEL:
+            {
+                break;
+            }
+
+            case LED_PATTERN_OP_WAIT:
+            {
+                if ((step & LED_PATTERN_EVENT_MASK) == LED_PATTERN_NO_EVENT)
+                {
+                    return false;
+                }
+                break;
+            }
+
+            case LED_PATTERN_OP_LOOP:
+            {
+                /* The body must stop somewhere or the engine would spin
+                on it forever within one pass. */
+                back = (step & LED_PATTERN_BACK_MASK) >> LED_PATTERN_BACK_OFFSET;
+                if ((back == 0) || (back > i))
+                {
+                    return false;
+                }
+
+                blocks = false;
+                for (uint32_t j = i - back; j < i; j++)
+                {
+                    switch (pattern->steps[j] & LED_PATTERN_OP_MASK)
+                    {
+                        case LED_PATTERN_OP_LEVEL:
+                        {
+                            blocks = blocks || ((pattern->steps[j] & LED_PATTERN_DURATION_MASK) > 0);
+                            break;
+                        }
+
+                        case LED_PATTERN_OP_WAIT:
+                        {
+                            blocks = true;
+                            break;
+                        }
+
+                        default:
+                        {
+                            return false;
+                        }
+                    }
+                }
+
+                if (!blocks)
+                {
+                    return false;
+                }
+                break;
+            }
+
+            default:
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+static void due_update(struct led_pattern_engine *me, uint32_t deadline)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    if (!me->due_valid || ((int32_t)(deadline - me->next_due) < 0))
+    {
+        me->next_due = deadline;
+        me->due_valid = true;
+    }
+}
+
+
+static void level_set(struct led_pattern_engine *me, uint16_t channel, bool on)
+{
+    ECU_RUNTIME_ASSERT( (me && (channel < me->count)), BSP_ASSERT_FUNCTOR );
+
+    if (me->channels[channel].on != on)
+    {
+        me->channels[channel].on = on;
+        (*me->i_led_set)(me->i_obj, channel, on);
+    }
+}
+
+
+static void execute(struct led_pattern_engine *me, uint16_t channel, uint32_t base)
+{
+    struct led_pattern_channel *ch = (struct led_pattern_channel *)0;
+    led_pattern_step step = 0;
+    uint32_t count = 0;
+    bool blocked = false;
+    ECU_RUNTIME_ASSERT( (me && (channel < me->count)), BSP_ASSERT_FUNCTOR );
+
+    /* Takes steps starting at base until one waits. A level step with a
+    duration waits for its deadline, a wait step for its event. */
+    ch = &me->channels[channel];
+    while (!blocked && (ch->step < ch->pattern->count))
+    {
+        step = ch->pattern->steps[ch->step];
+        switch (step & LED_PATTERN_OP_MASK)
+        {
+            case LED_PATTERN_OP_LEVEL:
+            {
+                level_set(me, channel, ((step & LED_PATTERN_LEVEL_ON) != 0));
+                if ((step & LED_PATTERN_DURATION_MASK) > 0)
+                {
+                    ch->deadline = base + (step & LED_PATTERN_DURATION_MASK);
+                    due_update(me, ch->deadline);
+                    blocked = true;
+                }
+                else
+                {
+                    ch->step++;
+                }
+                break;
+            }
+
+            case LED_PATTERN_OP_WAIT:
+            {
+                blocked = true;
+                break;
+            }
+
+            case LED_PATTERN_OP_LOOP:
+            {
+                count = step & LED_PATTERN_COUNT_MASK;
+                if (count != LED_PATTERN_FOREVER)
+                {
+                    if (ch->loops == 0)
+                    {
+                        ch->loops = (uint8_t)count;
+                    }
+                    ch->loops--;
+                }
+
+                if ((count == LED_PATTERN_FOREVER) || (ch->loops > 0))
+                {
+                    ch->step = (uint8_t)(ch->step - ((step & LED_PATTERN_BACK_MASK) >> LED_PATTERN_BACK_OFFSET));
+                }
+                else
+                {
+                    ch->step++;
+                }
+                break;
+            }
+
+            default:
+            {
+                /* Rejected when the pattern was started. */
+                ECU_RUNTIME_ASSERT( (false), BSP_ASSERT_FUNCTOR );
+                break;
+            }
+        }
+    }
+}
+
+
+static void restart(struct led_pattern_engine *me, uint16_t channel)
+{
+    ECU_RUNTIME_ASSERT( (me && (channel < me->count)), BSP_ASSERT_FUNCTOR );
+
+    me->channels[channel].step = 0;
+    me->channels[channel].loops = 0;
+    execute(me, channel, (*me->i_get_ticks)(me->i_obj));
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC FUNCTIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void led_pattern_engine_ctor(struct led_pattern_engine *me,
+                             struct led_pattern_channel *channels_0,
+                             uint16_t count_0,
+                             void *i_obj_0,
+                             void (*i_led_set_0)(void *i_obj, uint16_t channel, bool on),
+                             uint32_t (*i_get_ticks_0)(void *i_obj))
+{
+    /* i_obj_0 is optional. */
+    ECU_RUNTIME_ASSERT( (me && channels_0 && (count_0 > 0)), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (i_led_set_0 && i_get_ticks_0), BSP_ASSERT_FUNCTOR );
+
+    me->channels    = channels_0;
+    me->count       = count_0;
+    me->next_due    = 0;
+    me->due_valid   = false;
+    me->i_obj       = i_obj_0;
+    me->i_led_set   = i_led_set_0;
+    me->i_get_ticks = i_get_ticks_0;
+
+    for (uint16_t i = 0; i < count_0; i++)
+    {
+        me->channels[i].pattern     = (const struct led_pattern *)0;
+        me->channels[i].deadline    = 0;
+        me->channels[i].step        = 0;
+        me->channels[i].loops       = 0;
+        me->channels[i].on          = false;
+    }
+}
+
+
+void led_pattern_start(struct led_pattern_engine *me,
+                       uint16_t channel,
+                       const struct led_pattern *pattern)
+{
+    ECU_RUNTIME_ASSERT( (me && (channel < me->count)), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (is_valid(pattern)), BSP_ASSERT_FUNCTOR );
+
+    me->channels[channel].pattern = pattern;
+    restart(me, channel);
+}
+
+
+bool led_pattern_post(struct led_pattern_engine *me, uint16_t channel, uint8_t event)
+{
+    struct led_pattern_channel *ch = (struct led_pattern_channel *)0;
+    led_pattern_step step = 0;
+    bool handled = false;
+    ECU_RUNTIME_ASSERT( (me && (channel < me->count)), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (event != LED_PATTERN_NO_EVENT), BSP_ASSERT_FUNCTOR );
+
+    ch = &me->channels[channel];
+    if (!ch->pattern)
+    {
+        return false;
+    }
+
+    if (event == ch->pattern->restart_event)
+    {
+        restart(me, channel);
+        handled = true;
+    }
+    else if (ch->step < ch->pattern->count)
+    {
+        step = ch->pattern->steps[ch->step];
+        if (((step & LED_PATTERN_OP_MASK) == LED_PATTERN_OP_WAIT) &&
+            ((step & LED_PATTERN_EVENT_MASK) == event))
+        {
+            ch->step++;
+            execute(me, channel, (*me->i_get_ticks)(me->i_obj));
+            handled = true;
+        }
+    }
+
+    return handled;
+}
+
+
+uint32_t led_pattern_engine_run(struct led_pattern_engine *me)
+{
+    struct led_pattern_channel *ch = (struct led_pattern_channel *)0;
+    uint32_t now = 0;
+    uint32_t ended = 0;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    /* Most passes fall between deadlines. Those cost one compare instead
+    of a scan of every channel. */
+    now = (*me->i_get_ticks)(me->i_obj);
+    if (!me->due_valid || ((int32_t)(now - me->next_due) < 0))
+    {
+        return 0;
+    }
+
+    /* Rebuilt by the scan from every level step still waiting. */
+    me->due_valid = false;
+    for (uint16_t i = 0; i < me->count; i++)
+    {
+        ch = &me->channels[i];
+        if (!ch->pattern)
+        {
+            continue;
+        }
+
+        /* A level step that is due ends at its deadline, so the next
+        step starts on the grid even if this pass is late. Loops until
+        the channel catches up with now. */
+        while ((ch->step < ch->pattern->count) &&
+               ((ch->pattern->steps[ch->step] & LED_PATTERN_OP_MASK) == LED_PATTERN_OP_LEVEL))
+        {
+            if ((int32_t)(now - ch->deadline) < 0)
+            {
+                due_update(me, ch->deadline);
+                break;
+            }
+
+            ch->step++;
+            execute(me, i, ch->deadline);
+            ended++;
+        }
+    }
+
+    return ended;
+}
+
+
+bool led_pattern_is_running(const struct led_pattern_engine *me, uint16_t channel)
+{
+    ECU_RUNTIME_ASSERT( (me && (channel < me->count)), BSP_ASSERT_FUNCTOR );
+    return (me->channels[channel].pattern != (const struct led_pattern *)0) &&
+           (me->channels[channel].step < me->channels[channel].pattern->count);
+}
@@ -0,0 +1,240 @@
+/**
+ * @file
+ * @brief Pattern sequencer for LED behaviors. A behavior is a const table
+ * of 16-bit steps that lives in flash. One engine runs the tables of every
+ * channel, so a new behavior is a new table instead of a new state chart,
+ * and each LED only costs a struct led_pattern_channel of RAM.
+ *
+ * Example. Same behavior as led_fsm.c with a 3000 ms hold and 1000 ms
+ * toggle time:
+ *
+ *     static const led_pattern_step press_and_hold_steps[] =
+ *     {
+ *         LED_PATTERN_OFF(0),                     // Released. LED off.
+ *         LED_PATTERN_WAIT(LED_FSM_SWITCH_PRESSED_EVT),
+ *         LED_PATTERN_ON(3000),                   // Hold time.
+ *         LED_PATTERN_ON(1000),                   // Toggle from here on.
+ *         LED_PATTERN_OFF(1000),
+ *         LED_PATTERN_LOOP(2, LED_PATTERN_FOREVER)
+ *     };
+ *
+ *     static const struct led_pattern press_and_hold =
+ *     {
+ *         .steps = press_and_hold_steps,
+ *         .count = 6,
+ *         .restart_event = LED_FSM_SWITCH_RELEASED_EVT
+ *     };
+ *
+ * A level step drives the LED and waits its duration. The next step is
+ * due duration ticks after the previous deadline, not after the pass that
+ * noticed it, so patterns do not drift when the loop runs late. A wait
+ * step holds the channel until its event is posted. Posting the pattern's
+ * restart event starts it over from step 0 at any step. Other events are
+ * ignored. A channel that runs past its last step stops and keeps its
+ * level.
+ *
+ * Loops do not nest. The body of a loop must not contain another loop and
+ * must contain a wait or a level step with a non-zero duration. Both are
+ * checked when a pattern is started. Ticks are unsigned 32-bit and may
+ * wrap.
+ *
+ * Not thread or interrupt safe. Start, post and run from the same context.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef LED_PATTERN_H_
+#define LED_PATTERN_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- DEFINES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Step layout. Bits 15-14 are the opcode. Level steps keep the
+ * level in bit 13 and the duration in bits 12-0. Wait steps keep the
+ * event in bits 7-0. Loop steps keep how many steps to jump back in bits
+ * 13-8 and the total number of times the body runs in bits 7-0.
+ */
+#define LED_PATTERN_OP_OFFSET                   (14U)
+#define LED_PATTERN_OP_MASK                     (0x3U << LED_PATTERN_OP_OFFSET)
+#define LED_PATTERN_OP_LEVEL                    (0x0U << LED_PATTERN_OP_OFFSET)
+#define LED_PATTERN_OP_WAIT                     (0x1U << LED_PATTERN_OP_OFFSET)
+#define LED_PATTERN_OP_LOOP                     (0x2U << LED_PATTERN_OP_OFFSET)
+
+#define LED_PATTERN_LEVEL_ON                    (1U << 13)
+#define LED_PATTERN_DURATION_MASK               (0x1FFFU)
+#define LED_PATTERN_EVENT_MASK                  (0xFFU)
+#define LED_PATTERN_BACK_OFFSET                 (8U)
+#define LED_PATTERN_BACK_MASK                   (0x3FU << LED_PATTERN_BACK_OFFSET)
+#define LED_PATTERN_COUNT_MASK                  (0xFFU)
+
+/**
+ * @brief Longest duration of one level step. Longer levels take several
+ * steps.
+ */
+#define LED_PATTERN_DURATION_MAX                (LED_PATTERN_DURATION_MASK)
+
+/**
+ * @brief Loop count that repeats the body until the pattern is restarted.
+ */
+#define LED_PATTERN_FOREVER                     (0U)
+
+/**
+ * @brief restart_event of a pattern that can only be restarted by
+ * starting it again.
+ */
+#define LED_PATTERN_NO_EVENT                    (0xFFU)
+
+/**
+ * @brief 0, or a compile error if @p cond is false. @p cond must be a
+ * constant expression. Usable in static initializers, unlike a static
+ * assert.
+ */
+#ifdef __cplusplus
+#define LED_PATTERN_CHECK(cond) \
+    (0U * sizeof(char[(cond) ? 1 : -1]))
+#else
+#define LED_PATTERN_CHECK(cond) \
+    (0U * sizeof(struct { unsigned int led_pattern_check : ((cond) ? 1 : -1); }))
+#endif
+
+/**
+ * @brief Step constructors. Arguments must be constants. Out of range
+ * arguments do not compile, so keep ticks at most LED_PATTERN_DURATION_MAX,
+ * events below LED_PATTERN_NO_EVENT, back 1 to 63 and count at most 255.
+ */
+#define LED_PATTERN_ON(ticks) \
+    ((led_pattern_step)(LED_PATTERN_CHECK((ticks) <= LED_PATTERN_DURATION_MAX) + \
+                        (LED_PATTERN_OP_LEVEL | LED_PATTERN_LEVEL_ON | (ticks))))
+
+#define LED_PATTERN_OFF(ticks) \
+    ((led_pattern_step)(LED_PATTERN_CHECK((ticks) <= LED_PATTERN_DURATION_MAX) + \
+                        (LED_PATTERN_OP_LEVEL | (ticks))))
+
+#define LED_PATTERN_WAIT(event) \
+    ((led_pattern_step)(LED_PATTERN_CHECK((event) < LED_PATTERN_NO_EVENT) + \
+                        (LED_PATTERN_OP_WAIT | (event))))
+
+#define LED_PATTERN_LOOP(back, count) \
+    ((led_pattern_step)(LED_PATTERN_CHECK(((back) >= 1U) && ((back) <= (LED_PATTERN_BACK_MASK >> LED_PATTERN_BACK_OFFSET))) + \
+                        LED_PATTERN_CHECK((count) <= LED_PATTERN_COUNT_MASK) + \
+                        (LED_PATTERN_OP_LOOP | ((back) << LED_PATTERN_BACK_OFFSET) | (count))))
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- LED PATTERN DATA STRUCTURES ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+typedef uint16_t led_pattern_step;
+
+
+/**
+ * @brief Meant to be const so it stays in flash with its steps.
+ */
+struct led_pattern
+{
+    const led_pattern_step *steps;
+    uint8_t count;                              /* 1 to 255 steps. */
+    uint8_t restart_event;                      /* Or LED_PATTERN_NO_EVENT. */
+};
+
+
+/**
+ * @brief Per LED state. Private to the engine.
+ */
+struct led_pattern_channel
+{
+    const struct led_pattern *pattern;          /* 0 if never started. */
+    uint32_t deadline;                          /* Of the current level step. */
+    uint8_t step;                               /* Equal to count once the pattern ended. */
+    uint8_t loops;                              /* Body runs left in a counted loop. 0 if not in one. */
+    bool on;
+};
+
+
+struct led_pattern_engine
+{
+    struct led_pattern_channel *channels;
+    uint16_t count;
+
+    /* Earliest deadline of any level step. Passes before it skip the
+    channel scan. May be stale early, never late. Only valid if due_valid. */
+    uint32_t next_due;
+    bool due_valid;
+
+    void *i_obj;
+    void (*i_led_set)(void *i_obj, uint16_t channel, bool on);
+    uint32_t (*i_get_ticks)(void *i_obj);
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief channels_0 is storage for count_0 channels. Every channel starts
+ * with no pattern and is assumed to be off. i_led_set_0 is only called
+ * when a channel's level changes.
+ */
+extern void led_pattern_engine_ctor(struct led_pattern_engine *me,
+                                    struct led_pattern_channel *channels_0,
+                                    uint16_t count_0,
+                                    void *i_obj_0,
+                                    void (*i_led_set_0)(void *i_obj, uint16_t channel, bool on),
+                                    uint32_t (*i_get_ticks_0)(void *i_obj));
+
+/**
+ * @brief Runs @p pattern on @p channel from step 0, replacing whatever it
+ * ran before. Steps due right away are taken before returning.
+ */
+extern void led_pattern_start(struct led_pattern_engine *me,
+                              uint16_t channel,
+                              const struct led_pattern *pattern);
+
+/**
+ * @brief Returns true if the event restarted the pattern or ended the
+ * wait step the channel is at. False if it was ignored.
+ */
+extern bool led_pattern_post(struct led_pattern_engine *me, uint16_t channel, uint8_t event);
+
+/**
+ * @brief Takes every step that is due on every channel. Returns how many
+ * level steps ended.
+ */
+extern uint32_t led_pattern_engine_run(struct led_pattern_engine *me);
+
+/**
+ * @brief False once the pattern ran past its last step or if none was
+ * started. A channel at a wait step is running.
+ */
+extern bool led_pattern_is_running(const struct led_pattern_engine *me, uint16_t channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LED_PATTERN_H_ */
@@ -0,0 +1,184 @@
+/**
+ * @file
+ * @brief See loop_monitor.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "app/loop_monitor.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* ECU. */
+#include "ecu/asserter.h"
+
+/* BSP. */
+#include "bsp/bsp.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- STATIC FUNCTION DECLARATIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint32_t elapsed(uint32_t from, uint32_t to);
+static void sample(struct loop_monitor *me,
+                   uint32_t *bins,
+                   struct loop_monitor_worst *worst,
+                   uint32_t time);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint32_t elapsed(uint32_t from, uint32_t to)
+{
+    /* A ready time stamped after the monitor read the time (i.e. by an
+    interrupt in between) has not waited at all. */
+    uint32_t diff = to - from;
+    return (diff >= 0x80000000U) ? 0U : diff;
+}
+
+
+static void sample(struct loop_monitor *me,
+                   uint32_t *bins,
+                   struct loop_monitor_worst *worst,
+                   uint32_t time)
+{
+    ECU_RUNTIME_ASSERT( (me && bins && worst), BSP_ASSERT_FUNCTOR );
+
+    bins[loop_monitor_bin(time)]++;
+    if (time > worst->time)
+    {
+        worst->time = time;
+        worst->tick = (*me->i_get_ticks)(me->i_obj);
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC FUNCTIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void loop_monitor_ctor(struct loop_monitor *me,
+                       uint32_t deadline_0,
+                       void *i_obj_0,
+                       uint32_t (*i_get_time_0)(void *i_obj),
+                       uint32_t (*i_get_ticks_0)(void *i_obj),
+                       void (*i_watchdog_refresh_0)(void *i_obj))
+{
+    ECU_RUNTIME_ASSERT( (me && i_get_time_0 && i_get_ticks_0), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (deadline_0 > 0), BSP_ASSERT_FUNCTOR );
+
+    me->deadline            = deadline_0;
+    me->in_iteration        = false;
+    me->i_obj               = i_obj_0;
+    me->i_get_time          = i_get_time_0;
+    me->i_get_ticks         = i_get_ticks_0;
+    me->i_watchdog_refresh  = i_watchdog_refresh_0;
+    me->begin               = (*me->i_get_time)(me->i_obj);
+    me->previous_begin      = me->begin;
+    loop_monitor_stats_reset(me);
+}
+
+
+void loop_monitor_begin(struct loop_monitor *me)
+{
+    ECU_RUNTIME_ASSERT( (me && !me->in_iteration), BSP_ASSERT_FUNCTOR );
+
+    me->previous_begin = me->begin;
+    me->begin = (*me->i_get_time)(me->i_obj);
+    me->in_iteration = true;
+}
+
+
+void loop_monitor_event(struct loop_monitor *me, uint32_t ready)
+{
+    ECU_RUNTIME_ASSERT( (me && me->in_iteration), BSP_ASSERT_FUNCTOR );
+
+    me->stats.events++;
+    sample(me, me->stats.ready_bins, &me->stats.worst_ready,
+           elapsed(ready, (*me->i_get_time)(me->i_obj)));
+}
+
+
+void loop_monitor_end(struct loop_monitor *me)
+{
+    uint32_t duration = 0;
+    ECU_RUNTIME_ASSERT( (me && me->in_iteration), BSP_ASSERT_FUNCTOR );
+
+    duration = elapsed(me->begin, (*me->i_get_time)(me->i_obj));
+    me->in_iteration = false;
+    me->stats.iterations++;
+    sample(me, me->stats.iteration_bins, &me->stats.worst_iteration, duration);
+
+    if (duration <= me->deadline)
+    {
+        if (me->i_watchdog_refresh)
+        {
+            (*me->i_watchdog_refresh)(me->i_obj);
+        }
+    }
+    else
+    {
+        me->stats.misses++;
+    }
+}
+
+
+uint32_t loop_monitor_previous_begin(const struct loop_monitor *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    return me->previous_begin;
+}
+
+
+const struct loop_monitor_stats *loop_monitor_stats(const struct loop_monitor *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    return &me->stats;
+}
+
+
+void loop_monitor_stats_reset(struct loop_monitor *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    memset((void *)&me->stats, 0, sizeof(me->stats));
+}
+
+
+uint8_t loop_monitor_bin(uint32_t time)
+{
+    uint8_t bin = 0;
+
+    while ((time > 0) && (bin < (LOOP_MONITOR_HISTOGRAM_BINS - 1U)))
+    {
+        time >>= 1;
+        bin++;
+    }
+
+    return bin;
+}
+
+
+uint32_t loop_monitor_bin_floor(uint8_t bin)
+{
+    ECU_RUNTIME_ASSERT( (bin < LOOP_MONITOR_HISTOGRAM_BINS), BSP_ASSERT_FUNCTOR );
+    return (bin == 0) ? 0U : (1U << (bin - 1U));
+}
@@ -0,0 +1,162 @@
+/**
+ * @file
+ * @brief Measures the main loop. Every iteration is bracketed with
+ * @ref loop_monitor_begin and @ref loop_monitor_end, and every event the
+ * iteration handles is reported with @ref loop_monitor_event. The monitor
+ * keeps log2 histograms of iteration time and of how long events waited
+ * between becoming ready and being handled, plus the worst case of each
+ * with the tick it happened on.
+ *
+ * An iteration that finishes within the deadline refreshes the watchdog.
+ * One that overruns it is counted as a miss and does not, so a loop that
+ * keeps missing its deadline is reset instead of limping along.
+ *
+ * Times are in whatever unit i_get_time returns (i.e. microseconds). It
+ * must count up and may wrap. Intervals must be less than 2^31 units.
+ * Ticks are only recorded next to the worst cases so they can be matched
+ * against other logs.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef LOOP_MONITOR_H_
+#define LOOP_MONITOR_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- DEFINES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Bin 0 counts 0. Bin n counts [2^(n-1), 2^n). The last bin also
+ * counts everything above its range.
+ */
+#define LOOP_MONITOR_HISTOGRAM_BINS             (24U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- LOOP MONITOR DATA STRUCTURES ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct loop_monitor_worst
+{
+    uint32_t time;                  /* 0 until the first sample. */
+    uint32_t tick;                  /* Tick the sample was taken on. */
+};
+
+
+struct loop_monitor_stats
+{
+    uint32_t iterations;
+    uint32_t misses;                /* Iterations that overran the deadline. */
+    uint32_t events;
+
+    uint32_t iteration_bins[LOOP_MONITOR_HISTOGRAM_BINS];
+    uint32_t ready_bins[LOOP_MONITOR_HISTOGRAM_BINS];
+
+    struct loop_monitor_worst worst_iteration;
+    struct loop_monitor_worst worst_ready;
+};
+
+
+struct loop_monitor
+{
+    /* Private. */
+    uint32_t deadline;
+    bool in_iteration;
+    uint32_t begin;
+    uint32_t previous_begin;
+
+    struct loop_monitor_stats stats;
+
+    void *i_obj;
+    uint32_t (*i_get_time)(void *i_obj);
+    uint32_t (*i_get_ticks)(void *i_obj);
+    void (*i_watchdog_refresh)(void *i_obj);
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC FUNCTIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief @p deadline_0 is the longest iteration, in time units, that still
+ * refreshes the watchdog. i_obj_0 and i_watchdog_refresh_0 are optional.
+ */
+extern void loop_monitor_ctor(struct loop_monitor *me,
+                              uint32_t deadline_0,
+                              void *i_obj_0,
+                              uint32_t (*i_get_time_0)(void *i_obj),
+                              uint32_t (*i_get_ticks_0)(void *i_obj),
+                              void (*i_watchdog_refresh_0)(void *i_obj));
+
+/**
+ * @brief Call first thing in an iteration, before polling for events.
+ */
+extern void loop_monitor_begin(struct loop_monitor *me);
+
+/**
+ * @brief Call once per event handled by the current iteration. @p ready
+ * is when the event became ready, in time units. Pass
+ * @ref loop_monitor_previous_begin if that is not known.
+ */
+extern void loop_monitor_event(struct loop_monitor *me, uint32_t ready);
+
+/**
+ * @brief Call last thing in an iteration. Refreshes the watchdog if the
+ * iteration met the deadline.
+ */
+extern void loop_monitor_end(struct loop_monitor *me);
+
+/**
+ * @brief Start of the previous iteration. An event first seen by the
+ * current iteration was not ready when the previous one polled, so this
+ * is the earliest it can have become ready. Using it as the ready time
+ * overestimates the wait by at most one iteration.
+ */
+extern uint32_t loop_monitor_previous_begin(const struct loop_monitor *me);
+
+extern const struct loop_monitor_stats *loop_monitor_stats(const struct loop_monitor *me);
+
+/**
+ * @brief Clears the statistics. The deadline and interfaces are kept.
+ */
+extern void loop_monitor_stats_reset(struct loop_monitor *me);
+
+/**
+ * @brief Histogram bin @p time is counted in.
+ */
+extern uint8_t loop_monitor_bin(uint32_t time);
+
+/**
+ * @brief Smallest time counted in bin @p bin.
+ */
+extern uint32_t loop_monitor_bin_floor(uint8_t bin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOOP_MONITOR_H_ */
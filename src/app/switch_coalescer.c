@@ -0,0 +1,92 @@
+/**
+ * @file
+ * @brief See switch_coalescer.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "app/switch_coalescer.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* LED FSM. */
+#include "app/led_fsm.h"
+
+/* ECU. */
+#include "ecu/asserter.h"
+
+/* BSP. */
+#include "bsp/bsp.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void switch_coalescer_ctor(struct switch_coalescer *me, bool pressed_0)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    me->delivered_pressed   = pressed_0;
+    me->pending_pressed     = pressed_0;
+    me->posted_this_pass    = false;
+    me->posted              = 0;
+    me->delivered           = 0;
+    me->dropped             = 0;
+}
+
+
+void switch_coalescer_post(struct switch_coalescer *me, enum led_fsm_event_signals signal)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( ((signal == LED_FSM_SWITCH_PRESSED_EVT) || (signal == LED_FSM_SWITCH_RELEASED_EVT)), BSP_ASSERT_FUNCTOR );
+
+    /* Only the newest level matters. Everything posted before it this pass
+    is either cancelled by it or repeats it. */
+    me->pending_pressed = (signal == LED_FSM_SWITCH_PRESSED_EVT);
+    me->posted_this_pass = true;
+    me->posted++;
+}
+
+
+bool switch_coalescer_take(struct switch_coalescer *me, enum led_fsm_event_signals *signal)
+{
+    uint32_t posted_this_pass = 0;
+    bool deliver = false;
+    ECU_RUNTIME_ASSERT( (me && signal), BSP_ASSERT_FUNCTOR );
+
+    if (!me->posted_this_pass)
+    {
+        return false;
+    }
+
+    deliver = (me->pending_pressed != me->delivered_pressed);
+    posted_this_pass = me->posted - (me->delivered + me->dropped);
+    me->posted_this_pass = false;
+
+    if (deliver)
+    {
+        me->delivered_pressed = me->pending_pressed;
+        me->delivered++;
+        me->dropped += posted_this_pass - 1U;
+        *signal = (me->pending_pressed) ? LED_FSM_SWITCH_PRESSED_EVT : LED_FSM_SWITCH_RELEASED_EVT;
+    }
+    else
+    {
+        me->dropped += posted_this_pass;
+    }
+
+    return deliver;
+}
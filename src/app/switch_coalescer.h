@@ -0,0 +1,94 @@
+/**
+ * @file
+ * @brief Coalesces switch events between input sampling and FSM dispatch.
+ * Events posted for one switch during a run pass collapse to at most one
+ * net event. Opposite events cancel each other and repeats of the level
+ * the FSM already saw are dropped, so chatter never reaches dispatch or
+ * churns timers in the FSM's entry actions.
+ *
+ * Usage per run pass:
+ *
+ *     switch_coalescer_post(&sw, LED_FSM_SWITCH_PRESSED_EVT);   // Any number of times.
+ *     ...
+ *     if (switch_coalescer_take(&sw, &signal)) { dispatch signal }
+ *
+ * Not interrupt safe. Post from the same context that takes.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef SWITCH_COALESCER_H_
+#define SWITCH_COALESCER_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* LED FSM. Switch event signals. */
+#include "app/led_fsm.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------- SWITCH COALESCER DATA STRUCTURES -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct switch_coalescer
+{
+    /* Level the FSM last received. */
+    bool delivered_pressed;
+
+    /* Level of the newest event posted this pass. Only valid if posted_this_pass. */
+    bool pending_pressed;
+    bool posted_this_pass;
+
+    /* Events posted, events dispatched and events cancelled or dropped as redundant. */
+    uint32_t posted;
+    uint32_t delivered;
+    uint32_t dropped;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief pressed_0 is the level the FSM starts out assuming. False for
+ * led_fsm, which starts in the off state.
+ */
+extern void switch_coalescer_ctor(struct switch_coalescer *me, bool pressed_0);
+
+/**
+ * @brief signal must be LED_FSM_SWITCH_PRESSED_EVT or
+ * LED_FSM_SWITCH_RELEASED_EVT.
+ */
+extern void switch_coalescer_post(struct switch_coalescer *me, enum led_fsm_event_signals signal);
+
+/**
+ * @brief Ends the pass. Returns true and stores the net event in signal if
+ * the newest posted level differs from the level last delivered. Every
+ * other event posted this pass is counted as dropped.
+ */
+extern bool switch_coalescer_take(struct switch_coalescer *me, enum led_fsm_event_signals *signal);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWITCH_COALESCER_H_ */
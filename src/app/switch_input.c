@@ -0,0 +1,191 @@
+/**
+ * @file
+ * @brief See switch_input.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "app/switch_input.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ECU. */
+#include "ecu/asserter.h"
+
+/* BSP. */
+#include "bsp/bsp.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- STATIC ASSERTS -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Head and tail are 8 bit free running counters. */
+ECU_STATIC_ASSERT( ((SWITCH_INPUT_QUEUE_SIZE & (SWITCH_INPUT_QUEUE_SIZE - 1U)) == 0) );
+ECU_STATIC_ASSERT( (SWITCH_INPUT_QUEUE_SIZE <= 128U) );
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static bool window_end(struct switch_input *me, uint8_t sw, uint32_t now, struct switch_input_event *evt);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static bool window_end(struct switch_input *me, uint8_t sw, uint32_t now, struct switch_input_event *evt)
+{
+    struct switch_input_switch *s = &me->switches[sw];
+    bool pressed = false;
+
+    /* The switch is masked, so nothing else touches its state. */
+    pressed = (*me->i_level)(me->i_obj, sw);
+    if (pressed != s->pressed)
+    {
+        /* Changed again inside the window. When is unknown, so it counts
+        from now, and it may still be bouncing. */
+        s->pressed = pressed;
+        s->window_start = now;
+        me->short_presses++;
+        evt->time = now;
+        evt->sw = sw;
+        evt->pressed = pressed;
+        return true;
+    }
+
+    s->debouncing = false;
+    (*me->i_unmask)(me->i_obj, sw);
+    return false;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void switch_input_ctor(struct switch_input *me,
+                       uint8_t count_0,
+                       uint32_t debounce_0,
+                       void *i_obj_0,
+                       uint32_t (*i_get_time_0)(void *i_obj),
+                       bool (*i_level_0)(void *i_obj, uint8_t sw),
+                       void (*i_unmask_0)(void *i_obj, uint8_t sw))
+{
+    uint32_t now = 0;
+    ECU_RUNTIME_ASSERT( (me && i_get_time_0 && i_level_0 && i_unmask_0), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( ((count_0 > 0) && (count_0 <= SWITCH_INPUT_SWITCHES_MAX)), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (debounce_0 < 0x80000000U), BSP_ASSERT_FUNCTOR );
+
+    me->count           = count_0;
+    me->debounce        = debounce_0;
+    me->head            = 0;
+    me->tail            = 0;
+    me->edges           = 0;
+    me->short_presses   = 0;
+    me->overflows       = 0;
+    me->i_obj           = i_obj_0;
+    me->i_get_time      = i_get_time_0;
+    me->i_level         = i_level_0;
+    me->i_unmask        = i_unmask_0;
+
+    now = (*me->i_get_time)(me->i_obj);
+    for (uint8_t i = 0; i < SWITCH_INPUT_SWITCHES_MAX; i++)
+    {
+        me->switches[i].pressed = false;
+        me->switches[i].debouncing = (i < count_0);
+        me->switches[i].window_start = now - debounce_0;
+    }
+}
+
+
+void switch_input_debounce_set(struct switch_input *me, uint32_t debounce)
+{
+    ECU_RUNTIME_ASSERT( (me && (debounce < 0x80000000U)), BSP_ASSERT_FUNCTOR );
+    me->debounce = debounce;
+}
+
+
+void switch_input_edge(struct switch_input *me, uint8_t sw, uint32_t time)
+{
+    struct switch_input_switch *s = (struct switch_input_switch *)0;
+    uint8_t head = 0;
+    ECU_RUNTIME_ASSERT( (me && (sw < me->count)), BSP_ASSERT_FUNCTOR );
+
+    s = &me->switches[sw];
+    head = me->head;
+    me->edges++;
+
+    /* An edge always means the contact left the state last posted,
+    whatever the pin reads by now. */
+    if ((uint8_t)(head - me->tail) < SWITCH_INPUT_QUEUE_SIZE)
+    {
+        s->pressed = !s->pressed;
+        me->queue[head & (SWITCH_INPUT_QUEUE_SIZE - 1U)].time = time;
+        me->queue[head & (SWITCH_INPUT_QUEUE_SIZE - 1U)].sw = sw;
+        me->queue[head & (SWITCH_INPUT_QUEUE_SIZE - 1U)].pressed = s->pressed;
+        me->head = (uint8_t)(head + 1U);
+    }
+    else
+    {
+        /* State is left as posted. The end of the window sees the change. */
+        me->overflows++;
+    }
+
+    /* Published last. The main loop owns the switch from here. */
+    s->window_start = time;
+    s->debouncing = true;
+}
+
+
+bool switch_input_take(struct switch_input *me, struct switch_input_event *evt)
+{
+    uint8_t tail = 0;
+    uint32_t now = 0;
+    ECU_RUNTIME_ASSERT( (me && evt), BSP_ASSERT_FUNCTOR );
+
+    tail = me->tail;
+    if (tail != me->head)
+    {
+        evt->time = me->queue[tail & (SWITCH_INPUT_QUEUE_SIZE - 1U)].time;
+        evt->sw = me->queue[tail & (SWITCH_INPUT_QUEUE_SIZE - 1U)].sw;
+        evt->pressed = me->queue[tail & (SWITCH_INPUT_QUEUE_SIZE - 1U)].pressed;
+        me->tail = (uint8_t)(tail + 1U);
+        return true;
+    }
+
+    /* Queue is empty, so no edge of a masked switch is still waiting in
+    it and an event found here is newer than every one taken. Signed, as
+    an edge after now starts a window that is not over. A window
+    restarted here ends on a later take. */
+    now = (*me->i_get_time)(me->i_obj);
+    for (uint8_t i = 0; i < me->count; i++)
+    {
+        if (me->switches[i].debouncing &&
+            ((int32_t)(now - me->switches[i].window_start) >= (int32_t)me->debounce) &&
+            window_end(me, i, now, evt))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file
+ * @brief Interrupt driven switch input. Edge interrupts report a switch
+ * the moment its contact first moves. Events are stamped with the edge
+ * time and queued for the main loop, so a press is seen with the latency
+ * of one interrupt instead of one loop pass plus a debounce period.
+ *
+ * Debouncing is leading edge. The first edge toggles the switch state,
+ * posts an event and masks the switch's interrupt for the debounce
+ * window, so the bounces that follow cost nothing. When the window ends
+ * the main loop samples the switch. If it no longer matches the state
+ * last posted, i.e. the press was shorter than the window, an event is
+ * posted for that too and a new window starts. Otherwise the switch is
+ * unmasked.
+ *
+ * Usage:
+ *
+ *     // Interrupt context. The interrupt has already masked the switch.
+ *     switch_input_edge(&in, sw, time);
+ *
+ *     // Main loop.
+ *     while (switch_input_take(&in, &evt)) { ... }
+ *
+ * The queue has one producer, the edge interrupts, and one consumer, the
+ * main loop. Edge interrupts must not preempt each other. While a switch
+ * is masked its state belongs to the main loop, otherwise to the
+ * interrupt.
+ *
+ * Times are in whatever unit i_get_time returns. It must count up and may
+ * wrap. The debounce window must be less than 2^31 units.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef SWITCH_INPUT_H_
+#define SWITCH_INPUT_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- DEFINES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define SWITCH_INPUT_SWITCHES_MAX               (8U)
+
+/**
+ * @brief Power of two. A switch posts at most two events per debounce
+ * window, so this covers every switch changing twice between takes.
+ */
+#define SWITCH_INPUT_QUEUE_SIZE                 (16U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- SWITCH INPUT DATA STRUCTURES ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct switch_input_event
+{
+    uint32_t time;                  /* Edge time, or when a short press was found. */
+    uint8_t sw;
+    bool pressed;
+};
+
+
+struct switch_input_switch
+{
+    volatile bool pressed;          /* State last posted. */
+    volatile bool debouncing;       /* Masked. State belongs to the main loop. */
+    volatile uint32_t window_start;
+};
+
+
+struct switch_input
+{
+    /* Private. */
+    uint8_t count;
+    uint32_t debounce;
+    struct switch_input_switch switches[SWITCH_INPUT_SWITCHES_MAX];
+
+    volatile struct switch_input_event queue[SWITCH_INPUT_QUEUE_SIZE];
+    volatile uint8_t head;          /* Written by switch_input_edge() only. */
+    volatile uint8_t tail;          /* Written by switch_input_take() only. */
+
+    /* Edges reported, short presses found at the end of a window and edges
+    lost to a full queue. A lost edge is recovered when its window ends. */
+    volatile uint32_t edges;
+    uint32_t short_presses;
+    volatile uint32_t overflows;
+
+    void *i_obj;
+    uint32_t (*i_get_time)(void *i_obj);
+    bool (*i_level)(void *i_obj, uint8_t sw);
+    void (*i_unmask)(void *i_obj, uint8_t sw);
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Switches 0 to @p count_0 - 1 start out released and masked with
+ * their window already over, so the first take samples them, posts the
+ * ones held down and unmasks them all.
+ *
+ * i_level returns true if the switch is pressed. It must first discard
+ * edges latched while the switch was masked, so an edge after the sample
+ * is still reported once i_unmask runs.
+ */
+extern void switch_input_ctor(struct switch_input *me,
+                              uint8_t count_0,
+                              uint32_t debounce_0,
+                              void *i_obj_0,
+                              uint32_t (*i_get_time_0)(void *i_obj),
+                              bool (*i_level_0)(void *i_obj, uint8_t sw),
+                              void (*i_unmask_0)(void *i_obj, uint8_t sw));
+
+/**
+ * @brief Changes the debounce window, i.e. when the unit of time changes.
+ * Windows already running end on the new length.
+ */
+extern void switch_input_debounce_set(struct switch_input *me, uint32_t debounce);
+
+/**
+ * @brief Interrupt context. Switch @p sw had an edge at @p time and is now
+ * masked.
+ */
+extern void switch_input_edge(struct switch_input *me, uint8_t sw, uint32_t time);
+
+/**
+ * @brief Main loop. Returns the oldest queued event. Once the queue is
+ * empty, ends the debounce windows that are over and returns a short
+ * press if one of them found it. Returns false when there is nothing
+ * left.
+ */
+extern bool switch_input_take(struct switch_input *me, struct switch_input_event *evt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWITCH_INPUT_H_ */
@@ -0,0 +1,511 @@
+/**
+ * @file
+ * @brief See telemetry.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "app/telemetry.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Application. */
+#include "app/governor.h"
+#include "app/led_fsm.h"
+#include "app/loop_monitor.h"
+#include "app/telemetry_frame.h"
+#include "app/token_log.h"
+
+/* ECU. */
+#include "ecu/asserter.h"
+
+/* BSP. */
+#include "bsp/bsp.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- FILE SCOPE DEFINES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define LED_SET_PAYLOAD_SIZE                    (9U)
+#define GOVERNOR_LEVEL_NONE                     (0xFFU)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- STATIC ASSERTS -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* A response of any size must fit in an empty transmit ring, and a full
+histogram in one response. */
+ECU_STATIC_ASSERT( (TELEMETRY_TX_BUFFER_SIZE > TELEMETRY_FRAME_ENCODED_MAX) );
+ECU_STATIC_ASSERT( (((LOOP_MONITOR_HISTOGRAM_BINS * 4U) + 2U) <= TELEMETRY_FRAME_PAYLOAD_MAX) );
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- STATIC FUNCTION DECLARATIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint16_t put_u32(uint8_t *out, uint16_t pos, uint32_t value);
+static uint32_t get_u32(const uint8_t *in);
+static void respond(struct telemetry *me, uint8_t type, uint8_t seq, const uint8_t *payload, uint16_t len);
+static void nack(struct telemetry *me, const struct telemetry_frame *request, enum telemetry_frame_error error);
+static void stats_get(struct telemetry *me, const struct telemetry_frame *request);
+static void histogram_get(struct telemetry *me, const struct telemetry_frame *request);
+static void led_get(struct telemetry *me, const struct telemetry_frame *request, uint8_t led);
+static void led_set(struct telemetry *me, const struct telemetry_frame *request);
+static void log_read(struct telemetry *me, const struct telemetry_frame *request);
+static void frame_handle(struct telemetry *me, uint16_t start, uint16_t len);
+static void tx_kick(struct telemetry *me);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint16_t put_u32(uint8_t *out, uint16_t pos, uint32_t value)
+{
+    ECU_RUNTIME_ASSERT( (out), BSP_ASSERT_FUNCTOR );
+    out[pos]      = (uint8_t)(value & 0xFFU);
+    out[pos + 1U] = (uint8_t)((value >> 8) & 0xFFU);
+    out[pos + 2U] = (uint8_t)((value >> 16) & 0xFFU);
+    out[pos + 3U] = (uint8_t)(value >> 24);
+    return (uint16_t)(pos + 4U);
+}
+
+
+static uint32_t get_u32(const uint8_t *in)
+{
+    ECU_RUNTIME_ASSERT( (in), BSP_ASSERT_FUNCTOR );
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+
+static void respond(struct telemetry *me, uint8_t type, uint8_t seq, const uint8_t *payload, uint16_t len)
+{
+    uint16_t size = (uint16_t)TELEMETRY_FRAME_ENCODED_SIZE(len);
+    ECU_RUNTIME_ASSERT( (me && (len <= TELEMETRY_FRAME_PAYLOAD_MAX)), BSP_ASSERT_FUNCTOR );
+
+    /* Reserve size contiguous bytes. Wrapping leaves the rest of the end
+    unused. head may not catch up with tail, which would read as empty. */
+    if (me->tx_head >= me->tx_tail)
+    {
+        if ((uint16_t)(TELEMETRY_TX_BUFFER_SIZE - me->tx_head) < size)
+        {
+            if (me->tx_tail <= size)
+            {
+                me->counters.tx_dropped++;
+                return;
+            }
+            me->tx_wrap = me->tx_head;
+            me->tx_head = 0;
+        }
+    }
+    else if ((uint16_t)(me->tx_tail - me->tx_head) <= size)
+    {
+        me->counters.tx_dropped++;
+        return;
+    }
+
+    me->tx_head += telemetry_frame_encode(&me->tx_ring[me->tx_head], type, seq, payload, len);
+}
+
+
+static void nack(struct telemetry *me, const struct telemetry_frame *request, enum telemetry_frame_error error)
+{
+    uint8_t payload[2];
+    ECU_RUNTIME_ASSERT( (me && request), BSP_ASSERT_FUNCTOR );
+
+    payload[0] = request->type;
+    payload[1] = (uint8_t)error;
+    respond(me, TELEMETRY_FRAME_NACK, request->seq, payload, sizeof(payload));
+}
+
+
+static void stats_get(struct telemetry *me, const struct telemetry_frame *request)
+{
+    static const struct loop_monitor_stats no_stats;
+    const struct loop_monitor_stats *stats = &no_stats;
+    uint8_t payload[41];
+    uint16_t pos = 0;
+    ECU_RUNTIME_ASSERT( (me && request), BSP_ASSERT_FUNCTOR );
+
+    if (me->monitor)
+    {
+        stats = loop_monitor_stats(me->monitor);
+    }
+
+    pos = put_u32(payload, pos, stats->iterations);
+    pos = put_u32(payload, pos, stats->misses);
+    pos = put_u32(payload, pos, stats->events);
+    pos = put_u32(payload, pos, stats->worst_iteration.time);
+    pos = put_u32(payload, pos, stats->worst_iteration.tick);
+    pos = put_u32(payload, pos, stats->worst_ready.time);
+    pos = put_u32(payload, pos, stats->worst_ready.tick);
+    pos = put_u32(payload, pos, me->counters.frames_ok);
+    pos = put_u32(payload, pos, me->counters.frames_bad);
+    pos = put_u32(payload, pos, me->counters.tx_dropped);
+    payload[pos++] = (me->governor) ? governor_level(me->governor) : GOVERNOR_LEVEL_NONE;
+    ECU_RUNTIME_ASSERT( (pos == sizeof(payload)), BSP_ASSERT_FUNCTOR );
+
+    respond(me, (uint8_t)(request->type | TELEMETRY_FRAME_RESPONSE), request->seq, payload, pos);
+}
+
+
+static void histogram_get(struct telemetry *me, const struct telemetry_frame *request)
+{
+    static const struct loop_monitor_stats no_stats;
+    const struct loop_monitor_stats *stats = &no_stats;
+    const uint32_t *bins = (const uint32_t *)0;
+    uint8_t payload[(LOOP_MONITOR_HISTOGRAM_BINS * 4U) + 2U];
+    uint16_t pos = 0;
+    ECU_RUNTIME_ASSERT( (me && request), BSP_ASSERT_FUNCTOR );
+
+    if (request->len != 1U)
+    {
+        nack(me, request, TELEMETRY_FRAME_ERROR_LENGTH);
+        return;
+    }
+
+    if (me->monitor)
+    {
+        stats = loop_monitor_stats(me->monitor);
+    }
+
+    switch (request->payload[0])
+    {
+        case 0:
+        {
+            bins = stats->iteration_bins;
+            break;
+        }
+        case 1:
+        {
+            bins = stats->ready_bins;
+            break;
+        }
+        default:
+        {
+            nack(me, request, TELEMETRY_FRAME_ERROR_ARGUMENT);
+            return;
+        }
+    }
+
+    payload[pos++] = request->payload[0];
+    payload[pos++] = (uint8_t)LOOP_MONITOR_HISTOGRAM_BINS;
+    for (uint8_t i = 0; i < LOOP_MONITOR_HISTOGRAM_BINS; i++)
+    {
+        pos = put_u32(payload, pos, bins[i]);
+    }
+
+    respond(me, (uint8_t)(request->type | TELEMETRY_FRAME_RESPONSE), request->seq, payload, pos);
+}
+
+
+static void led_get(struct telemetry *me, const struct telemetry_frame *request, uint8_t led)
+{
+    const struct led_fsm *fsm = (const struct led_fsm *)0;
+    uint8_t payload[10];
+    uint16_t pos = 0;
+    ECU_RUNTIME_ASSERT( (me && request && (led < me->led_count)), BSP_ASSERT_FUNCTOR );
+
+    fsm = me->leds[led];
+    payload[pos++] = led;
+    payload[pos++] = (fsm->led_state == LED_FSM_LED_STATE_ON) ? 1U : 0U;
+    pos = put_u32(payload, pos, fsm->hold_time_ms);
+    pos = put_u32(payload, pos, fsm->toggle_time_ms);
+
+    respond(me, (uint8_t)(request->type | TELEMETRY_FRAME_RESPONSE), request->seq, payload, pos);
+}
+
+
+static void led_set(struct telemetry *me, const struct telemetry_frame *request)
+{
+    uint32_t hold_time_ms = 0;
+    uint32_t toggle_time_ms = 0;
+    ECU_RUNTIME_ASSERT( (me && request), BSP_ASSERT_FUNCTOR );
+
+    if (request->len != LED_SET_PAYLOAD_SIZE)
+    {
+        nack(me, request, TELEMETRY_FRAME_ERROR_LENGTH);
+        return;
+    }
+
+    hold_time_ms = get_u32(&request->payload[1]);
+    toggle_time_ms = get_u32(&request->payload[5]);
+    if ((request->payload[0] >= me->led_count) || !led_fsm_timing_valid(hold_time_ms, toggle_time_ms))
+    {
+        nack(me, request, TELEMETRY_FRAME_ERROR_ARGUMENT);
+        return;
+    }
+
+    led_fsm_timing_set(me->leds[request->payload[0]], hold_time_ms, toggle_time_ms);
+    led_get(me, request, request->payload[0]);
+}
+
+
+static void log_read(struct telemetry *me, const struct telemetry_frame *request)
+{
+    uint8_t payload[TELEMETRY_FRAME_PAYLOAD_MAX];
+    uint16_t len = 0;
+    ECU_RUNTIME_ASSERT( (me && request), BSP_ASSERT_FUNCTOR );
+
+    if (request->len != 0)
+    {
+        nack(me, request, TELEMETRY_FRAME_ERROR_LENGTH);
+        return;
+    }
+
+    if (me->log)
+    {
+        len = token_log_read(me->log, payload, sizeof(payload));
+    }
+
+    respond(me, (uint8_t)(request->type | TELEMETRY_FRAME_RESPONSE), request->seq, payload, len);
+}
+
+
+static void frame_handle(struct telemetry *me, uint16_t start, uint16_t len)
+{
+    struct telemetry_frame frame;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    if ((len >= TELEMETRY_FRAME_ENCODED_MAX) ||
+        (!telemetry_frame_decode(&frame, me->rx_ring, me->rx_size, start, len)))
+    {
+        me->counters.frames_bad++;
+        return;
+    }
+    me->counters.frames_ok++;
+
+    switch (frame.type)
+    {
+        case TELEMETRY_FRAME_STATS_GET:
+        {
+            stats_get(me, &frame);
+            break;
+        }
+        case TELEMETRY_FRAME_HISTOGRAM_GET:
+        {
+            histogram_get(me, &frame);
+            break;
+        }
+        case TELEMETRY_FRAME_LED_GET:
+        {
+            if (frame.len != 1U)
+            {
+                nack(me, &frame, TELEMETRY_FRAME_ERROR_LENGTH);
+            }
+            else if (frame.payload[0] >= me->led_count)
+            {
+                nack(me, &frame, TELEMETRY_FRAME_ERROR_ARGUMENT);
+            }
+            else
+            {
+                led_get(me, &frame, frame.payload[0]);
+            }
+            break;
+        }
+        case TELEMETRY_FRAME_LED_SET:
+        {
+            led_set(me, &frame);
+            break;
+        }
+        case TELEMETRY_FRAME_ECHO:
+        {
+            respond(me, (uint8_t)(frame.type | TELEMETRY_FRAME_RESPONSE), frame.seq, frame.payload, frame.len);
+            break;
+        }
+        case TELEMETRY_FRAME_LOG_READ:
+        {
+            log_read(me, &frame);
+            break;
+        }
+        default:
+        {
+            nack(me, &frame, TELEMETRY_FRAME_ERROR_TYPE);
+            break;
+        }
+    }
+}
+
+
+static void tx_kick(struct telemetry *me)
+{
+    uint16_t end = 0;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    if (me->tx_sending > 0)
+    {
+        if ((*me->i_tx_busy)(me->i_obj))
+        {
+            return;
+        }
+        me->tx_tail += me->tx_sending;
+        me->tx_sending = 0;
+    }
+
+    if ((me->tx_head < me->tx_tail) && (me->tx_tail == me->tx_wrap))
+    {
+        me->tx_tail = 0;
+    }
+
+    if (me->tx_head == me->tx_tail)
+    {
+        /* Empty. Start over so the next frames get the whole ring. */
+        me->tx_head = 0;
+        me->tx_tail = 0;
+        return;
+    }
+
+    end = (me->tx_head > me->tx_tail) ? me->tx_head : me->tx_wrap;
+    me->tx_sending = (uint16_t)(end - me->tx_tail);
+    (*me->i_tx_start)(me->i_obj, &me->tx_ring[me->tx_tail], me->tx_sending);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC FUNCTIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void telemetry_ctor(struct telemetry *me,
+                    const uint8_t *rx_ring_0,
+                    uint16_t rx_size_0,
+                    void *i_obj_0,
+                    uint16_t (*i_rx_head_0)(void *i_obj),
+                    uint32_t (*i_rx_delimiters_0)(void *i_obj),
+                    void (*i_tx_start_0)(void *i_obj, const uint8_t *data, uint16_t len),
+                    bool (*i_tx_busy_0)(void *i_obj))
+{
+    ECU_RUNTIME_ASSERT( (me && rx_ring_0 && (rx_size_0 > 0)), BSP_ASSERT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (i_rx_head_0 && i_rx_delimiters_0 && i_tx_start_0 && i_tx_busy_0), BSP_ASSERT_FUNCTOR );
+
+    me->rx_ring             = rx_ring_0;
+    me->rx_size             = rx_size_0;
+    me->i_obj               = i_obj_0;
+    me->i_rx_head           = i_rx_head_0;
+    me->i_rx_delimiters     = i_rx_delimiters_0;
+    me->i_tx_start          = i_tx_start_0;
+    me->i_tx_busy           = i_tx_busy_0;
+
+    /* Start from wherever the receiver is now. */
+    me->rx_tail             = (*me->i_rx_head)(me->i_obj);
+    me->rx_scan             = me->rx_tail;
+    me->rx_delimiters       = (*me->i_rx_delimiters)(me->i_obj);
+
+    me->tx_head             = 0;
+    me->tx_tail             = 0;
+    me->tx_wrap             = 0;
+    me->tx_sending          = 0;
+
+    me->leds                = (struct led_fsm *const *)0;
+    me->led_count           = 0;
+    me->monitor             = (const struct loop_monitor *)0;
+    me->governor            = (const struct governor *)0;
+    me->log                 = (struct token_log *)0;
+
+    me->counters.frames_ok  = 0;
+    me->counters.frames_bad = 0;
+    me->counters.tx_dropped = 0;
+}
+
+
+void telemetry_leds_set(struct telemetry *me, struct led_fsm *const *leds, uint8_t count)
+{
+    ECU_RUNTIME_ASSERT( (me && leds && (count > 0)), BSP_ASSERT_FUNCTOR );
+    me->leds = leds;
+    me->led_count = count;
+}
+
+
+void telemetry_loop_monitor_set(struct telemetry *me, const struct loop_monitor *monitor)
+{
+    ECU_RUNTIME_ASSERT( (me && monitor), BSP_ASSERT_FUNCTOR );
+    me->monitor = monitor;
+}
+
+
+void telemetry_governor_set(struct telemetry *me, const struct governor *governor)
+{
+    ECU_RUNTIME_ASSERT( (me && governor), BSP_ASSERT_FUNCTOR );
+    me->governor = governor;
+}
+
+
+void telemetry_token_log_set(struct telemetry *me, struct token_log *log)
+{
+    ECU_RUNTIME_ASSERT( (me && log), BSP_ASSERT_FUNCTOR );
+    me->log = log;
+}
+
+
+uint32_t telemetry_poll(struct telemetry *me)
+{
+    uint32_t delimiters = 0;
+    uint32_t found = 0;
+    uint32_t handled = 0;
+    uint16_t head = 0;
+    uint16_t len = 0;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    /* Nothing complete arrived. Partial frames are not looked at. */
+    delimiters = (*me->i_rx_delimiters)(me->i_obj);
+    if (delimiters != me->rx_delimiters)
+    {
+        /* Everything up to the DMA's write index, not as many delimiters
+        as were counted, so a lost count never leaves a frame behind. */
+        head = (*me->i_rx_head)(me->i_obj);
+        while (me->rx_scan != head)
+        {
+            if (me->rx_ring[me->rx_scan] == TELEMETRY_FRAME_DELIMITER)
+            {
+                /* Back to back delimiters are idle line, not frames. */
+                len = (uint16_t)((me->rx_scan >= me->rx_tail) ? (me->rx_scan - me->rx_tail) :
+                                                                (me->rx_size - me->rx_tail + me->rx_scan));
+                if (len > 0)
+                {
+                    frame_handle(me, me->rx_tail, len);
+                    handled++;
+                }
+                me->rx_tail = (uint16_t)((me->rx_scan + 1U == me->rx_size) ? 0U : (me->rx_scan + 1U));
+                found++;
+            }
+            me->rx_scan = (uint16_t)((me->rx_scan + 1U == me->rx_size) ? 0U : (me->rx_scan + 1U));
+        }
+
+        /* The count can run ahead of the DMA by a byte. A wake-up without
+        its delimiter in the ring yet stays pending for the next pass. More
+        delimiters than counts means counts were lost. */
+        me->rx_delimiters += found;
+        if ((int32_t)(delimiters - me->rx_delimiters) < 0)
+        {
+            me->rx_delimiters = delimiters;
+        }
+    }
+
+    tx_kick(me);
+    return handled;
+}
+
+
+const struct telemetry_counters *telemetry_counters(const struct telemetry *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    return &me->counters;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file
+ * @brief Telemetry and command channel over a byte stream that is
+ * received into a ring by DMA (see telemetry_frame.h for the framing).
+ *
+ * Received bytes are never copied out of the receive ring until a frame
+ * is known to be complete. The BSP reports how many delimiters arrived
+ * and @ref telemetry_poll does nothing until that count moves, so an
+ * idle line costs the main loop one read. The count is only a wake-up.
+ * Counts are lost when the receive interrupt is held off across two
+ * delimiters, so every delimiter found in the ring is handled, however
+ * many were counted. Each received byte is looked at once.
+ *
+ * Responses are encoded straight into a transmit ring and sent from it
+ * in contiguous blocks, one at a time. A frame is never split across the
+ * end of the ring, so every frame goes out in at most one block. If the
+ * ring is full the response is dropped and counted. The client sees a
+ * missing seq and retries.
+ *
+ * Response payloads:
+ *
+ * - STATS_GET: iterations, misses, events, worst iteration time and tick,
+ *   worst wait time and tick, frames ok, frames bad, responses dropped
+ *   (u32 each), then the governor level (u8, 0xFF if none).
+ * - HISTOGRAM_GET: [which][bins][bins x u32]. See loop_monitor.h.
+ * - LED_GET: [led][1 if on][hold ms u32][toggle ms u32].
+ * - LED_SET: as LED_GET, after the new timing was applied. Times
+ *   led_fsm_timing_valid() rejects are NACKed as ARGUMENT.
+ * - ECHO: the request payload.
+ * - LOG_READ: the oldest token_log records, as many whole ones as fit.
+ *   Empty if there are none. Reading them removes them from the log, so
+ *   a dropped LOG_READ response loses its records.
+ *
+ * All of it runs in the main loop. Only the BSP's rx and tx functions
+ * may touch interrupt state.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Application. */
+#include "app/governor.h"
+#include "app/led_fsm.h"
+#include "app/loop_monitor.h"
+#include "app/token_log.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- DEFINES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Holds a few of the largest responses. Must be more than
+ * TELEMETRY_FRAME_ENCODED_MAX.
+ */
+#define TELEMETRY_TX_BUFFER_SIZE                (512U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------- TELEMETRY DATA STRUCTURES -----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct telemetry_counters
+{
+    uint32_t frames_ok;
+    uint32_t frames_bad;            /* Failed COBS or CRC. */
+    uint32_t tx_dropped;            /* Responses that did not fit in the transmit ring. */
+};
+
+
+struct telemetry
+{
+    /* Private. */
+    const uint8_t *rx_ring;
+    uint16_t rx_size;
+    uint16_t rx_tail;               /* First byte of the next frame. */
+    uint16_t rx_scan;               /* First byte not yet looked at. */
+    uint32_t rx_delimiters;         /* Count up to which wake-ups were handled. */
+
+    /* Data is [tx_tail, tx_head), or [tx_tail, tx_wrap) then [0, tx_head) once wrapped. */
+    uint8_t tx_ring[TELEMETRY_TX_BUFFER_SIZE];
+    uint16_t tx_head;
+    uint16_t tx_tail;
+    uint16_t tx_wrap;
+    uint16_t tx_sending;            /* Size of the block in flight. 0 if none. */
+
+    struct led_fsm *const *leds;
+    uint8_t led_count;
+    const struct loop_monitor *monitor;
+    const struct governor *governor;
+    struct token_log *log;
+
+    struct telemetry_counters counters;
+
+    void *i_obj;
+    uint16_t (*i_rx_head)(void *i_obj);
+    uint32_t (*i_rx_delimiters)(void *i_obj);
+    void (*i_tx_start)(void *i_obj, const uint8_t *data, uint16_t len);
+    bool (*i_tx_busy)(void *i_obj);
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief rx_ring_0 is the ring the BSP receives into. i_rx_head returns
+ * the index written next and i_rx_delimiters how many delimiters have
+ * been received so far. The count may miss delimiters but must move
+ * after one arrives. i_tx_start sends a block without copying it and
+ * i_tx_busy is true until it has been sent.
+ */
+extern void telemetry_ctor(struct telemetry *me,
+                           const uint8_t *rx_ring_0,
+                           uint16_t rx_size_0,
+                           void *i_obj_0,
+                           uint16_t (*i_rx_head_0)(void *i_obj),
+                           uint32_t (*i_rx_delimiters_0)(void *i_obj),
+                           void (*i_tx_start_0)(void *i_obj, const uint8_t *data, uint16_t len),
+                           bool (*i_tx_busy_0)(void *i_obj));
+
+/**
+ * @brief Optional. LEDs addressed by index in LED_GET and LED_SET.
+ */
+extern void telemetry_leds_set(struct telemetry *me, struct led_fsm *const *leds, uint8_t count);
+
+/**
+ * @brief Optional. Source of STATS_GET and HISTOGRAM_GET. Zeros are
+ * reported without it.
+ */
+extern void telemetry_loop_monitor_set(struct telemetry *me, const struct loop_monitor *monitor);
+
+/**
+ * @brief Optional. Level reported by STATS_GET.
+ */
+extern void telemetry_governor_set(struct telemetry *me, const struct governor *governor);
+
+/**
+ * @brief Optional. Read by LOG_READ, which makes telemetry the log's
+ * consumer. Empty responses are sent without it.
+ */
+extern void telemetry_token_log_set(struct telemetry *me, struct token_log *log);
+
+/**
+ * @brief Call once per main loop pass. Handles every complete frame and
+ * starts the next transmit block. Returns the number of frames handled.
+ */
+extern uint32_t telemetry_poll(struct telemetry *me);
+
+extern const struct telemetry_counters *telemetry_counters(const struct telemetry *me);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,226 @@
+/**
+ * @file
+ * @brief See telemetry_frame.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "app/telemetry_frame.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ECU. */
+#include "ecu/asserter.h"
+
+/* BSP. */
+#include "bsp/bsp.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- FILE SCOPE DEFINES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define CRC16_INIT                              (0xFFFFU)
+#define CRC16_POLY                              (0x1021U)
+
+/**
+ * @brief Longest COBS block. The code byte is one more than its data bytes.
+ */
+#define COBS_CODE_MAX                           (0xFFU)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE TYPES ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct cobs_encoder
+{
+    uint8_t *out;
+    uint16_t size;                  /* Bytes written, code bytes included. */
+    uint16_t code;                  /* Index of the open block's code byte. */
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- STATIC FUNCTION DECLARATIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void cobs_begin(struct cobs_encoder *me, uint8_t *out);
+static void cobs_put(struct cobs_encoder *me, const uint8_t *data, uint16_t len);
+static uint16_t cobs_end(struct cobs_encoder *me);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void cobs_begin(struct cobs_encoder *me, uint8_t *out)
+{
+    ECU_RUNTIME_ASSERT( (me && out), BSP_ASSERT_FUNCTOR );
+    me->out = out;
+    me->code = 0;
+    me->size = 1;
+    me->out[0] = 1;
+}
+
+
+static void cobs_put(struct cobs_encoder *me, const uint8_t *data, uint16_t len)
+{
+    ECU_RUNTIME_ASSERT( (me && (data || (len == 0))), BSP_ASSERT_FUNCTOR );
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        if (data[i] != TELEMETRY_FRAME_DELIMITER)
+        {
+            me->out[me->size++] = data[i];
+            me->out[me->code]++;
+        }
+
+        /* A zero closes the block. So does a full one, without a zero. */
+        if ((data[i] == TELEMETRY_FRAME_DELIMITER) || (me->out[me->code] == COBS_CODE_MAX))
+        {
+            me->code = me->size++;
+            me->out[me->code] = 1;
+        }
+    }
+}
+
+
+static uint16_t cobs_end(struct cobs_encoder *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    me->out[me->size++] = TELEMETRY_FRAME_DELIMITER;
+    return me->size;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC FUNCTIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+uint16_t telemetry_frame_crc16(uint16_t crc, const uint8_t *data, uint16_t len)
+{
+    ECU_RUNTIME_ASSERT( (data || (len == 0)), BSP_ASSERT_FUNCTOR );
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)((uint16_t)data[i] << 8);
+        for (uint8_t bit = 0; bit < 8U; bit++)
+        {
+            crc = (crc & 0x8000U) ? (uint16_t)((crc << 1) ^ CRC16_POLY) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+
+uint16_t telemetry_frame_encode(uint8_t *out,
+                                uint8_t type,
+                                uint8_t seq,
+                                const uint8_t *payload,
+                                uint16_t len)
+{
+    struct cobs_encoder encoder;
+    uint8_t header[2];
+    uint8_t trailer[2];
+    uint16_t crc = CRC16_INIT;
+    ECU_RUNTIME_ASSERT( (out && (len <= TELEMETRY_FRAME_PAYLOAD_MAX)), BSP_ASSERT_FUNCTOR );
+
+    header[0] = type;
+    header[1] = seq;
+    crc = telemetry_frame_crc16(crc, header, sizeof(header));
+    crc = telemetry_frame_crc16(crc, payload, len);
+    trailer[0] = (uint8_t)(crc & 0xFFU);
+    trailer[1] = (uint8_t)(crc >> 8);
+
+    /* Encoded in one pass from the pieces. The unencoded frame never exists. */
+    cobs_begin(&encoder, out);
+    cobs_put(&encoder, header, sizeof(header));
+    cobs_put(&encoder, payload, len);
+    cobs_put(&encoder, trailer, sizeof(trailer));
+    return cobs_end(&encoder);
+}
+
+
+bool telemetry_frame_decode(struct telemetry_frame *frame,
+                            const uint8_t *ring,
+                            uint16_t ring_size,
+                            uint16_t start,
+                            uint16_t len)
+{
+    uint16_t pos = 0;
+    uint16_t size = 0;
+    uint16_t index = start;
+    uint8_t code = 0;
+    uint16_t crc = 0;
+    ECU_RUNTIME_ASSERT( (frame && ring && (ring_size > 0) && (start < ring_size)), BSP_ASSERT_FUNCTOR );
+
+    while (pos < len)
+    {
+        code = ring[index];
+        index = (uint16_t)((index + 1U == ring_size) ? 0U : (index + 1U));
+        pos++;
+
+        if ((code == TELEMETRY_FRAME_DELIMITER) || ((uint16_t)(code - 1U) > (uint16_t)(len - pos)) ||
+            ((uint16_t)(code - 1U) > (uint16_t)(TELEMETRY_FRAME_RAW_MAX - size)))
+        {
+            return false;
+        }
+
+        for (uint8_t i = 1; i < code; i++)
+        {
+            if (ring[index] == TELEMETRY_FRAME_DELIMITER)
+            {
+                return false;
+            }
+            frame->raw[size++] = ring[index];
+            index = (uint16_t)((index + 1U == ring_size) ? 0U : (index + 1U));
+            pos++;
+        }
+
+        /* Every block but a full one and the last ends in a zero. */
+        if ((code != COBS_CODE_MAX) && (pos < len))
+        {
+            if (size == TELEMETRY_FRAME_RAW_MAX)
+            {
+                return false;
+            }
+            frame->raw[size++] = 0;
+        }
+    }
+
+    if (size < TELEMETRY_FRAME_OVERHEAD)
+    {
+        return false;
+    }
+
+    crc = telemetry_frame_crc16(CRC16_INIT, frame->raw, (uint16_t)(size - 2U));
+    if ((frame->raw[size - 2U] != (uint8_t)(crc & 0xFFU)) || (frame->raw[size - 1U] != (uint8_t)(crc >> 8)))
+    {
+        return false;
+    }
+
+    frame->type = frame->raw[0];
+    frame->seq = frame->raw[1];
+    frame->len = (uint16_t)(size - TELEMETRY_FRAME_OVERHEAD);
+    frame->payload = &frame->raw[2];
+    return true;
+}
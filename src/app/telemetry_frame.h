@@ -0,0 +1,144 @@
+/**
+ * @file
+ * @brief Framing for the telemetry channel. Shared by the target and the
+ * host client.
+ *
+ * A frame before encoding is
+ *
+ *     [type][seq][payload 0 - TELEMETRY_FRAME_PAYLOAD_MAX bytes][CRC-16 LE]
+ *
+ * The CRC is CRC-16/CCITT-FALSE over type, seq and payload. The frame is
+ * then COBS encoded so it contains no zero bytes and is terminated by a
+ * single zero. A receiver resynchronises at the next zero after any
+ * corruption and can count complete frames by counting zeros, without
+ * looking at their contents.
+ *
+ * Multi-byte payload fields are little endian.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef TELEMETRY_FRAME_H_
+#define TELEMETRY_FRAME_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- DEFINES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define TELEMETRY_FRAME_DELIMITER               (0x00U)
+#define TELEMETRY_FRAME_PAYLOAD_MAX             (120U)
+
+/**
+ * @brief Type and seq in front, CRC behind.
+ */
+#define TELEMETRY_FRAME_OVERHEAD                (4U)
+#define TELEMETRY_FRAME_RAW_MAX                 (TELEMETRY_FRAME_PAYLOAD_MAX + TELEMETRY_FRAME_OVERHEAD)
+
+/**
+ * @brief Encoded size of a frame with @p payload_len payload bytes,
+ * delimiter included. COBS adds one byte per 254 and one up front.
+ */
+#define TELEMETRY_FRAME_ENCODED_SIZE(payload_len) \
+    ((payload_len) + TELEMETRY_FRAME_OVERHEAD + (((payload_len) + TELEMETRY_FRAME_OVERHEAD) / 254U) + 2U)
+
+#define TELEMETRY_FRAME_ENCODED_MAX             TELEMETRY_FRAME_ENCODED_SIZE(TELEMETRY_FRAME_PAYLOAD_MAX)
+
+/**
+ * @brief Responses set this bit in the request's type and echo its seq.
+ */
+#define TELEMETRY_FRAME_RESPONSE                (0x80U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------ FRAME TYPES ------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Request payloads. Responses are listed in telemetry.h.
+ */
+enum telemetry_frame_type
+{
+    TELEMETRY_FRAME_STATS_GET       = 0x01,     /* Empty. */
+    TELEMETRY_FRAME_HISTOGRAM_GET   = 0x02,     /* [which]. 0 iteration times, 1 event waits. */
+    TELEMETRY_FRAME_LED_GET         = 0x03,     /* [led]. */
+    TELEMETRY_FRAME_LED_SET         = 0x04,     /* [led][hold ms u32][toggle ms u32]. */
+    TELEMETRY_FRAME_ECHO            = 0x05,     /* Anything. Sent back unchanged. */
+    TELEMETRY_FRAME_LOG_READ        = 0x06,     /* Empty. */
+    TELEMETRY_FRAME_NACK            = 0xFF      /* Response only. [request type][telemetry_frame_error]. */
+};
+
+
+enum telemetry_frame_error
+{
+    TELEMETRY_FRAME_ERROR_TYPE      = 0x01,     /* Unknown request type. */
+    TELEMETRY_FRAME_ERROR_LENGTH    = 0x02,     /* Payload too short or too long for the type. */
+    TELEMETRY_FRAME_ERROR_ARGUMENT  = 0x03      /* Field out of range. */
+};
+
+
+struct telemetry_frame
+{
+    uint8_t type;
+    uint8_t seq;
+    uint16_t len;
+    const uint8_t *payload;         /* Points into raw. */
+    uint8_t raw[TELEMETRY_FRAME_RAW_MAX];
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern uint16_t telemetry_frame_crc16(uint16_t crc, const uint8_t *data, uint16_t len);
+
+/**
+ * @brief Encodes a frame into @p out, delimiter included, and returns its
+ * size. @p out must hold TELEMETRY_FRAME_ENCODED_SIZE(len) bytes.
+ */
+extern uint16_t telemetry_frame_encode(uint8_t *out,
+                                       uint8_t type,
+                                       uint8_t seq,
+                                       const uint8_t *payload,
+                                       uint16_t len);
+
+/**
+ * @brief Decodes the @p len encoded bytes starting at @p start in the
+ * ring @p ring of @p ring_size bytes. The delimiter is not part of them.
+ * Pass a linear buffer as a ring of its own size with @p start 0.
+ * Returns false if the bytes are not a well formed frame or the CRC does
+ * not match.
+ */
+extern bool telemetry_frame_decode(struct telemetry_frame *frame,
+                                   const uint8_t *ring,
+                                   uint16_t ring_size,
+                                   uint16_t start,
+                                   uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRY_FRAME_H_ */
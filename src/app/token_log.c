@@ -0,0 +1,159 @@
+/**
+ * @file
+ * @brief See token_log.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "app/token_log.h"
+
+/* STDLib. */
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ECU. */
+#include "ecu/asserter.h"
+
+/* BSP. */
+#include "bsp/bsp.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- STATIC ASSERTS -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+ECU_STATIC_ASSERT( ((TOKEN_LOG_RING_WORDS & (TOKEN_LOG_RING_WORDS - 1U)) == 0) );
+ECU_STATIC_ASSERT( (TOKEN_LOG_ARGS_MAX <= (TOKEN_LOG_HEADER_ARGS_MASK >> TOKEN_LOG_HEADER_ARGS_OFFSET)) );
+ECU_STATIC_ASSERT( (TOKEN_LOG_RING_WORDS > TOKEN_LOG_ARGS_MAX) );
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- FILE SCOPE VARIABLES -------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Start of the format strings. The linker script defines it on
+ * target and the linker does on host. Weak so that a program with no
+ * TOKEN_LOG() in it still links.
+ */
+extern const char __start_log_fmt[] __attribute__((weak));
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void token_log_ctor(struct token_log *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    for (uint32_t i = 0; i < TOKEN_LOG_RING_WORDS; i++)
+    {
+        atomic_init(&me->ring[i], 0U);
+    }
+    atomic_init(&me->head, 0U);
+    atomic_init(&me->tail, 0U);
+    atomic_init(&me->records, 0U);
+    atomic_init(&me->dropped, 0U);
+}
+
+
+void token_log_write(struct token_log *me, const char *fmt, const uint32_t *args, uint8_t nargs)
+{
+    uint32_t token = 0;
+    uint32_t words = (uint32_t)nargs + 1U;
+    uint32_t head = 0;
+    ECU_RUNTIME_ASSERT( (me && fmt && args && (nargs <= TOKEN_LOG_ARGS_MAX)), BSP_ASSERT_FUNCTOR );
+
+    token = (uint32_t)((uintptr_t)fmt - (uintptr_t)__start_log_fmt);
+    ECU_RUNTIME_ASSERT( ((token & ~TOKEN_LOG_HEADER_TOKEN_MASK) == 0), BSP_ASSERT_FUNCTOR );
+
+    /* Reserve. Acquire on the tail so the consumer is done clearing the
+    words before they are written again. */
+    head = atomic_load_explicit(&me->head, memory_order_relaxed);
+    do
+    {
+        if ((head + words - atomic_load_explicit(&me->tail, memory_order_acquire)) > TOKEN_LOG_RING_WORDS)
+        {
+            (void)atomic_fetch_add_explicit(&me->dropped, 1U, memory_order_relaxed);
+            return;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&me->head, &head, head + words,
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    /* Arguments first, then the header releases them to the consumer. */
+    for (uint32_t i = 0; i < nargs; i++)
+    {
+        atomic_store_explicit(&me->ring[(head + 1U + i) & (TOKEN_LOG_RING_WORDS - 1U)], args[i], memory_order_relaxed);
+    }
+    atomic_store_explicit(&me->ring[head & (TOKEN_LOG_RING_WORDS - 1U)],
+                          TOKEN_LOG_HEADER_VALID | ((uint32_t)nargs << TOKEN_LOG_HEADER_ARGS_OFFSET) | token,
+                          memory_order_release);
+    (void)atomic_fetch_add_explicit(&me->records, 1U, memory_order_relaxed);
+}
+
+
+uint16_t token_log_read(struct token_log *me, uint8_t *out, uint16_t size)
+{
+    uint32_t tail = 0;
+    uint32_t header = 0;
+    uint32_t word = 0;
+    uint32_t words = 0;
+    uint16_t len = 0;
+    ECU_RUNTIME_ASSERT( (me && out), BSP_ASSERT_FUNCTOR );
+
+    tail = atomic_load_explicit(&me->tail, memory_order_relaxed);
+    while (true)
+    {
+        /* 0 is a record still being written, or none. */
+        header = atomic_load_explicit(&me->ring[tail & (TOKEN_LOG_RING_WORDS - 1U)], memory_order_acquire);
+        words = ((header & TOKEN_LOG_HEADER_ARGS_MASK) >> TOKEN_LOG_HEADER_ARGS_OFFSET) + 1U;
+        if ((header == 0) || ((uint32_t)(size - len) < (words * 4U)))
+        {
+            break;
+        }
+
+        for (uint32_t i = 0; i < words; i++)
+        {
+            word = atomic_load_explicit(&me->ring[(tail + i) & (TOKEN_LOG_RING_WORDS - 1U)], memory_order_relaxed);
+            atomic_store_explicit(&me->ring[(tail + i) & (TOKEN_LOG_RING_WORDS - 1U)], 0U, memory_order_relaxed);
+            out[len++] = (uint8_t)(word & 0xFFU);
+            out[len++] = (uint8_t)((word >> 8) & 0xFFU);
+            out[len++] = (uint8_t)((word >> 16) & 0xFFU);
+            out[len++] = (uint8_t)(word >> 24);
+        }
+        tail += words;
+    }
+
+    /* Hands the cleared words back to the producers. */
+    atomic_store_explicit(&me->tail, tail, memory_order_release);
+    return len;
+}
+
+
+uint32_t token_log_records(struct token_log *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    return atomic_load_explicit(&me->records, memory_order_relaxed);
+}
+
+
+uint32_t token_log_dropped(struct token_log *me)
+{
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+    return atomic_load_explicit(&me->dropped, memory_order_relaxed);
+}
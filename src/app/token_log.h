@@ -0,0 +1,145 @@
+/**
+ * @file
+ * @brief Tokenized, deferred logging. A log call formats nothing. It
+ * writes a token for its format string and up to TOKEN_LOG_ARGS_MAX
+ * 32-bit arguments into a ring, and whoever drains the ring ships the
+ * raw records off the board. tools/log_decode turns them back into text
+ * with the format strings read out of the ELF file.
+ *
+ * TOKEN_LOG() places its format string in the log_fmt section and the
+ * token is the string's offset in that section. The linker script does
+ * not load the section, so format strings take no flash on target, and
+ * the offsets are fixed at link time. On host the section is an ordinary
+ * one and the offsets work the same. Format strings may use %d, %i, %u,
+ * %x, %X, %o, %c and %% with the '-' and '0' flags and a width. Signed
+ * arguments must be cast to uint32_t. %d and %i decode them as int32_t.
+ *
+ * Usage:
+ *
+ *     TOKEN_LOG(&log, "clock level %u", level);
+ *
+ *     // Main loop, when the link is idle.
+ *     len = token_log_read(&log, buffer, sizeof(buffer));
+ *
+ * A record is a header word, [1][arguments, 3 bits][token, 24 bits] from
+ * bit 31 down, followed by its arguments, all little-endian.
+ * token_log_read() only hands out whole records.
+ *
+ * Any number of producers, the main loop and interrupts at any priority,
+ * may log at the same time. A producer reserves its words with a compare
+ * and swap on the head and commits the record by writing its header
+ * last, so nothing is locked and no interrupt is masked. Records are read
+ * in the order they were reserved. One that is reserved but not committed
+ * yet, e.g. by the main loop while an interrupt logs, holds back the
+ * records behind it until it is. A record that does not fit is dropped
+ * and counted. There must be one consumer.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef TOKEN_LOG_H_
+#define TOKEN_LOG_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdatomic.h>
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- DEFINES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Power of two. Words, so about 40 records of two arguments.
+ */
+#define TOKEN_LOG_RING_WORDS                    (128U)
+
+#define TOKEN_LOG_ARGS_MAX                      (4U)
+
+/**
+ * @brief Record header fields. A header is never 0, which marks a word
+ * that has not been committed.
+ */
+#define TOKEN_LOG_HEADER_VALID                  (1U << 31)
+#define TOKEN_LOG_HEADER_ARGS_OFFSET            (24U)
+#define TOKEN_LOG_HEADER_ARGS_MASK              (0x7U << TOKEN_LOG_HEADER_ARGS_OFFSET)
+#define TOKEN_LOG_HEADER_TOKEN_MASK             (0x00FFFFFFU)
+
+/**
+ * @brief Logs @p fmt, a string literal, with up to TOKEN_LOG_ARGS_MAX
+ * arguments to @p me.
+ */
+#define TOKEN_LOG(me, fmt, ...)                                                             \
+    do                                                                                      \
+    {                                                                                       \
+        static const char token_log_fmt_[] __attribute__((section("log_fmt"), used)) = fmt; \
+        const uint32_t token_log_args_[] = { 0U __VA_OPT__(, __VA_ARGS__) };                \
+        token_log_write((me), token_log_fmt_, &token_log_args_[1],                          \
+                        (uint8_t)((sizeof(token_log_args_) / sizeof(uint32_t)) - 1U));      \
+    } while (0)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------- TOKEN LOG DATA STRUCTURES -----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct token_log
+{
+    /* Private. Words are 0 until a producer commits them and again once
+    they are read. head and tail are free running. */
+    _Atomic uint32_t ring[TOKEN_LOG_RING_WORDS];
+    _Atomic uint32_t head;          /* Next word to reserve. */
+    _Atomic uint32_t tail;          /* Next word to read. Written by token_log_read() only. */
+
+    _Atomic uint32_t records;       /* Committed. */
+    _Atomic uint32_t dropped;       /* Did not fit. */
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern void token_log_ctor(struct token_log *me);
+
+/**
+ * @brief Use TOKEN_LOG(). Any context. @p fmt must be in the log_fmt
+ * section.
+ */
+extern void token_log_write(struct token_log *me, const char *fmt, const uint32_t *args, uint8_t nargs);
+
+/**
+ * @brief One consumer only. Moves the oldest committed records, as many
+ * whole ones as fit in @p size bytes, to @p out. Returns the number of
+ * bytes written, 0 if there is nothing to read.
+ */
+extern uint16_t token_log_read(struct token_log *me, uint8_t *out, uint16_t size);
+
+/**
+ * @brief Records committed and records dropped since token_log_ctor().
+ */
+extern uint32_t token_log_records(struct token_log *me);
+extern uint32_t token_log_dropped(struct token_log *me);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TOKEN_LOG_H_ */
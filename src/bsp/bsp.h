@@ -15,6 +15,8 @@
 #include "ecu/asserter.h"
 
 
+struct loop_monitor_stats;
+
 extern struct ecu_assert_functor *const BSP_ASSERT_FUNCTOR;
 
 
@@ -22,9 +24,20 @@ extern struct ecu_assert_functor *const BSP_ASSERT_FUNCTOR;
 extern "C" {
 #endif
 
+/**
+ * @brief Runs from the startup code before main(). Brings up the clock
+ * tree and the tick source.
+ */
+extern void system_init(void);
+
 extern void led_fsms_init(void);
 extern void led_fsms_run(void);
 
+/**
+ * @brief Main loop timing collected by led_fsms_run(). See loop_monitor.h.
+ */
+extern const struct loop_monitor_stats *loop_stats(void);
+
 
 
 #ifdef __cplusplus
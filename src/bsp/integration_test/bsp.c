@@ -1,30 +1,930 @@
+/**
+ * @file
+ * @brief Host BSP. Runs the application on Linux at wall-clock speed so
+ * its timing can be checked without hardware. Switches are keys read
+ * from the terminal without waiting for enter:
+ *
+ * - '0' or '1' flips the switch of that LED between pressed and released.
+ * - 's' prints the loop and real-time statistics.
+ * - 'q' or Ctrl-C prints them and exits.
+ *
+ * Every event source is a file descriptor in one epoll set and
+ * led_fsms_run() blocks on it, so the process sleeps until a key, a timer
+ * or the telemetry port needs it instead of polling. Each LED timer is a
+ * timerfd armed on an absolute CLOCK_MONOTONIC deadline. Periodic timers
+ * use the timerfd interval, which stays on the period grid, and catch up
+ * on at most LED_TOGGLE_MAX_CATCH_UP missed expiries like the target.
+ * The loop also wakes every IDLE_WAKE_MS to refresh the watchdog.
+ *
+ * LED changes are logged with TOKEN_LOG() like the target logs, and the
+ * records are written to LOG_FILE in the working directory every pass.
+ * Nothing is formatted here. To watch them:
+ *
+ *     tail -c +1 -f integration_test.log | log_decode integration_test -
+ *
+ * The statistics add how long it took from the wake-up that read a key,
+ * or from a timer's deadline, until the LED changed, and how much CPU the
+ * process used since startup.
+ *
+ * Telemetry runs on a pseudo-terminal instead of the virtual COM port.
+ * Its path is printed at startup. Point tools/telemetry_client at it. The
+ * receive DMA is emulated by reading whatever the pty has into the ring
+ * when it becomes readable, so a client that sends more than the ring
+ * holds between passes overruns it the same way it would on target.
+ *
+ * The main loop is measured and watched the same way as on target. The
+ * watchdog is emulated. If the loop misses its deadline for longer than
+ * the watchdog timeout the statistics are printed and the program exits
+ * with an error.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
 
-// use linux.
 
 
-i_led_on()
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "bsp/bsp.h"
+
+/* STDLib. */
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* POSIX. */
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <termios.h>
+#include <unistd.h>
+
+/* Application. */
+#include "app/led_fsm.h"
+#include "app/loop_monitor.h"
+#include "app/switch_coalescer.h"
+#include "app/telemetry.h"
+#include "app/telemetry_frame.h"
+#include "app/token_log.h"
+
+/* External libraries. ECU. */
+#include "ecu/fsm.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- FILE SCOPE DEFINES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define LED0_HOLD_TIME_MS                       (3000)
+#define LED0_TOGGLE_TIME_MS                     (1000)
+#define LED1_HOLD_TIME_MS                       (6000)
+#define LED1_TOGGLE_TIME_MS                     (500)
+#define LED_TOGGLE_MAX_CATCH_UP                 (4U)
+
+/**
+ * @brief Looser than on target. The host scheduler can preempt the loop.
+ */
+#define LOOP_DEADLINE_US                        (10000U)
+#define WATCHDOG_TIMEOUT_US                     (500000U)
+
+/**
+ * @brief Longest the loop blocks with nothing to do. Well inside the
+ * watchdog timeout.
+ */
+#define IDLE_WAKE_MS                            (100)
+
+/**
+ * @brief Same size as on target.
+ */
+#define TELEMETRY_RX_BUFFER_SIZE                (256U)
+
+/**
+ * @brief Truncated at startup.
+ */
+#define LOG_FILE                                "integration_test.log"
+
+/**
+ * @brief epoll data of each event source. LED timers are SOURCE_LED_TIMER
+ * plus the LED index.
+ */
+#define SOURCE_KEYS                             (0U)
+#define SOURCE_SIGNALS                          (1U)
+#define SOURCE_TELEMETRY                        (2U)
+#define SOURCE_LED_TIMER                        (3U)
+#define MAX_EVENTS                              (8)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE TYPES ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief From when an event could first be seen until the LED changed.
+ */
+struct latency
+{
+    uint32_t count;
+    uint64_t total_us;
+    uint64_t worst_us;
+};
+
+
+struct led
+{
+    struct switch_coalescer input;
+    struct led_fsm fsm;
+    struct led_fsm_event evt;
+    bool pressed;
+    char name;
+
+    /* Absolute deadline of the next expiry, 0 if disarmed, and the
+    period, 0 if one-shot. */
+    int timer_fd;
+    uint64_t deadline_us;
+    uint64_t period_us;
+
+    /* What the FSM is handling right now, so led_set() can measure it. */
+    struct latency *cause;
+    uint64_t cause_us;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- STATIC FUNCTION DECLARATIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t monotonic_us(void);
+static uint32_t get_ticks(void *obj);
+static uint32_t get_time_us(void *obj);
+static void loop_watchdog_refresh(void *obj);
+static void loop_stats_print(void);
+static void latency_print(const char *name, const struct latency *latency);
+static void cpu_print(void);
+static void led_set(void *led, enum led_fsm_led_state state);
+static void led_timer_settime(struct led *me, uint64_t deadline_us, uint64_t period_us);
+static void led_timer_arm(void *led, uint32_t ms);
+static void led_timer_arm_periodic(void *led, uint32_t period_ms);
+static void led_timer_disarm(void *led);
+static void led_timer_read(struct led *me);
+static bool led_switch_dispatch(struct led *me, uint64_t wake_us);
+static void source_add(int fd, uint32_t events, uint32_t source);
+static void terminal_open(void);
+static void terminal_restore(void);
+static void keys_read(void);
+static void signals_open(void);
+static void signals_read(void);
+static void log_file_open(void);
+static void log_drain(void);
+static void telemetry_port_open(void);
+static void telemetry_port_poll(void);
+static void telemetry_port_watch(void);
+static uint16_t telemetry_rx_head(void *obj);
+static uint32_t telemetry_rx_delimiters(void *obj);
+static void telemetry_tx_start(void *obj, const uint8_t *data, uint16_t len);
+static bool telemetry_tx_busy(void *obj);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- GLOBAL VARIABLES ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Use ECU's default handler. */
+struct ecu_assert_functor *const BSP_ASSERT_FUNCTOR = (struct ecu_assert_functor *)0;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------- FILE SCOPE VARIABLES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t start_us;
+static uint64_t watchdog_refreshed_us;
+static int epoll_fd;
+static struct loop_monitor loop_monitor;
+static struct led leds[2];
+static struct led_fsm *const telemetry_leds[] = { &leds[0].fsm, &leds[1].fsm };
+
+
+/**
+ * @brief Keys. stdin_polled is false if stdin cannot be waited on (i.e.
+ * it is a regular file) and is read every pass instead. terminal_saved
+ * holds the settings to restore on exit if stdin is a terminal.
+ */
+static bool stdin_open;
+static bool stdin_polled;
+static bool terminal_raw;
+static struct termios terminal_saved;
+static int signal_fd;
+
+
+/**
+ * @brief Real-time statistics. See loop_stats_print().
+ */
+static struct latency key_latency;
+static struct latency timer_latency;
+
+
+/**
+ * @brief The pty stands in for USART2 and these for its DMA channels.
+ * The slave side is kept open so the master never reads a hangup while
+ * no client is connected.
+ */
+static struct telemetry telemetry;
+static int telemetry_master_fd;
+static int telemetry_slave_fd;
+static uint32_t telemetry_watched;
+static uint8_t telemetry_rx_ring[TELEMETRY_RX_BUFFER_SIZE];
+static uint16_t telemetry_rx_index;
+static uint32_t telemetry_rx_delimiter_count;
+static const uint8_t *telemetry_tx_data;
+static uint16_t telemetry_tx_len;
+
+
+static struct token_log event_log;
+static FILE *log_file;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000U) + ((uint64_t)ts.tv_nsec / 1000U);
+}
+
+
+static uint32_t get_ticks(void *obj)
+{
+    (void)obj;
+    return (uint32_t)((monotonic_us() - start_us) / 1000U);
+}
+
+
+static uint32_t get_time_us(void *obj)
+{
+    (void)obj;
+    return (uint32_t)(monotonic_us() - start_us);
+}
+
+
+static void loop_watchdog_refresh(void *obj)
+{
+    (void)obj;
+    watchdog_refreshed_us = monotonic_us();
+}
+
+
+static void loop_stats_print(void)
+{
+    const struct loop_monitor_stats *stats = loop_stats();
+
+    printf("iterations %u, deadline misses %u, events %u\n",
+           (unsigned)stats->iterations, (unsigned)stats->misses, (unsigned)stats->events);
+    printf("worst iteration %u us at tick %u, worst wait %u us at tick %u\n",
+           (unsigned)stats->worst_iteration.time, (unsigned)stats->worst_iteration.tick,
+           (unsigned)stats->worst_ready.time, (unsigned)stats->worst_ready.tick);
+    printf("%12s %12s %12s\n", "from us", "iterations", "waits");
+
+    for (uint8_t i = 0; i < LOOP_MONITOR_HISTOGRAM_BINS; i++)
+    {
+        if ((stats->iteration_bins[i] > 0) || (stats->ready_bins[i] > 0))
+        {
+            printf("%12u %12u %12u\n", (unsigned)loop_monitor_bin_floor(i),
+                   (unsigned)stats->iteration_bins[i], (unsigned)stats->ready_bins[i]);
+        }
+    }
+
+    latency_print("key to LED", &key_latency);
+    latency_print("timer to LED", &timer_latency);
+    cpu_print();
+    fflush(stdout);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------- REAL-TIME STATISTICS --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void latency_print(const char *name, const struct latency *latency)
+{
+    ECU_RUNTIME_ASSERT( (name && latency), BSP_ASSERT_FUNCTOR );
+
+    if (latency->count == 0)
+    {
+        printf("%-14s no samples\n", name);
+    }
+    else
+    {
+        printf("%-14s %u samples, mean %.1f us, worst %u us\n", name, (unsigned)latency->count,
+               (double)latency->total_us / (double)latency->count, (unsigned)latency->worst_us);
+    }
+}
+
+
+static void cpu_print(void)
+{
+    struct rusage usage;
+    int status = -1;
+    uint64_t cpu_us = 0;
+    uint64_t wall_us = monotonic_us() - start_us;
+    double busy = 0.0;
+
+    status = getrusage(RUSAGE_SELF, &usage);
+    ECU_RUNTIME_ASSERT( (status == 0), BSP_ASSERT_FUNCTOR );
+    cpu_us = ((uint64_t)usage.ru_utime.tv_sec * 1000000U) + (uint64_t)usage.ru_utime.tv_usec +
+             ((uint64_t)usage.ru_stime.tv_sec * 1000000U) + (uint64_t)usage.ru_stime.tv_usec;
+    busy = (wall_us > 0) ? (100.0 * (double)cpu_us / (double)wall_us) : 0.0;
+
+    printf("cpu %.3f s of %.3f s wall, %.2f%% busy, %.2f%% idle\n",
+           (double)cpu_us / 1e6, (double)wall_us / 1e6, busy, 100.0 - busy);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- LEDS ----------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void led_set(void *led, enum led_fsm_led_state state)
+{
+    struct led *me = (struct led *)0;
+    uint64_t latency_us = 0;
+    ECU_RUNTIME_ASSERT( (led), BSP_ASSERT_FUNCTOR );
+
+    me = (struct led *)led;
+    if (me->cause)
+    {
+        latency_us = monotonic_us() - me->cause_us;
+        me->cause->count++;
+        me->cause->total_us += latency_us;
+        if (latency_us > me->cause->worst_us)
+        {
+            me->cause->worst_us = latency_us;
+        }
+    }
+
+    if (state == LED_FSM_LED_STATE_ON)
+    {
+        TOKEN_LOG(&event_log, "%8u ms  LED%c ON", get_ticks((void *)0), (uint32_t)me->name);
+    }
+    else
+    {
+        TOKEN_LOG(&event_log, "%8u ms  LED%c OFF", get_ticks((void *)0), (uint32_t)me->name);
+    }
+}
+
+
+static void led_timer_settime(struct led *me, uint64_t deadline_us, uint64_t period_us)
+{
+    struct itimerspec spec;
+    int status = -1;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    /* Setting the timer also clears expiries not read yet, so a timeout
+    of the old setting is never handled after the FSM moved on. All zero
+    disarms. */
+    spec.it_value.tv_sec = (time_t)(deadline_us / 1000000U);
+    spec.it_value.tv_nsec = (long)((deadline_us % 1000000U) * 1000U);
+    spec.it_interval.tv_sec = (time_t)(period_us / 1000000U);
+    spec.it_interval.tv_nsec = (long)((period_us % 1000000U) * 1000U);
+    status = timerfd_settime(me->timer_fd, TFD_TIMER_ABSTIME, &spec, (struct itimerspec *)0);
+    ECU_RUNTIME_ASSERT( (status == 0), BSP_ASSERT_FUNCTOR );
+
+    me->deadline_us = deadline_us;
+    me->period_us = period_us;
+}
+
+
+static void led_timer_arm(void *led, uint32_t ms)
+{
+    ECU_RUNTIME_ASSERT( (led && (ms > 0)), BSP_ASSERT_FUNCTOR );
+    led_timer_settime((struct led *)led, monotonic_us() + ((uint64_t)ms * 1000U), 0);
+}
+
+
+static void led_timer_arm_periodic(void *led, uint32_t period_ms)
+{
+    ECU_RUNTIME_ASSERT( (led && (period_ms > 0)), BSP_ASSERT_FUNCTOR );
+    led_timer_settime((struct led *)led, monotonic_us() + ((uint64_t)period_ms * 1000U),
+                      (uint64_t)period_ms * 1000U);
+}
+
+
+static void led_timer_disarm(void *led)
+{
+    ECU_RUNTIME_ASSERT( (led), BSP_ASSERT_FUNCTOR );
+    led_timer_settime((struct led *)led, 0, 0);
+}
+
+
+static void led_timer_read(struct led *me)
+{
+    static const struct led_fsm_event timeout_evt =
+    {
+        .base_event.id = LED_FSM_TIMEOUT_EVT
+    };
+
+    uint64_t expiries = 0;
+    uint64_t runs = 0;
+    uint64_t deadline_us = 0;
+    uint64_t period_us = 0;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    /* Nothing to read if the timer was set again since epoll saw it
+    expire. */
+    if (read(me->timer_fd, &expiries, sizeof(expiries)) != (ssize_t)sizeof(expiries))
+    {
+        return;
+    }
+
+    runs = (me->period_us == 0) ? 1U : ((expiries < LED_TOGGLE_MAX_CATCH_UP) ? expiries : LED_TOGGLE_MAX_CATCH_UP);
+    for (uint64_t i = 0; i < runs; i++)
+    {
+        deadline_us = me->deadline_us;
+        period_us = me->period_us;
+
+        loop_monitor_event(&loop_monitor, (uint32_t)(deadline_us - start_us));
+        me->cause = &timer_latency;
+        me->cause_us = deadline_us;
+        ecu_fsm_dispatch((struct ecu_fsm *)(&me->fsm), (const struct ecu_event *)&timeout_evt);
+        me->cause = (struct latency *)0;
+
+        /* The FSM set the timer again. What is left belongs to the old
+        setting and is dropped. */
+        if ((me->deadline_us != deadline_us) || (me->period_us != period_us))
+        {
+            return;
+        }
+        me->deadline_us = (period_us == 0) ? 0 : (deadline_us + period_us);
+    }
+
+    /* Expiries beyond the catch up limit are dropped. The grid is kept. */
+    me->deadline_us += (expiries - runs) * me->period_us;
+}
+
+
+static bool led_switch_dispatch(struct led *me, uint64_t wake_us)
 {
-    print("LED TURNED ON");
+    enum led_fsm_event_signals signal = LED_FSM_SWITCH_PRESSED_EVT;
+    bool dispatched = false;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    /* A key counts as seen when the wake-up that read it started. */
+    dispatched = switch_coalescer_take(&me->input, &signal);
+    if (dispatched)
+    {
+        loop_monitor_event(&loop_monitor, (uint32_t)(wake_us - start_us));
+        me->evt.base_event.id = signal;
+        me->cause = &key_latency;
+        me->cause_us = wake_us;
+        ecu_fsm_dispatch((struct ecu_fsm *)(&me->fsm), (const struct ecu_event *)&me->evt);
+        me->cause = (struct latency *)0;
+    }
+
+    return dispatched;
 }
 
 
-i_led_off()
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------------- LOG ----------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void log_file_open(void)
 {
-    print("LED TURNED OFF");
+    int registered = -1;
+
+    token_log_ctor(&event_log);
+    log_file = fopen(LOG_FILE, "wb");
+    ECU_RUNTIME_ASSERT( (log_file), BSP_ASSERT_FUNCTOR );
+
+    /* exit() is the only way out, so the last records are never lost. */
+    registered = atexit(&log_drain);
+    ECU_RUNTIME_ASSERT( (registered == 0), BSP_ASSERT_FUNCTOR );
+
+    printf("log records in %s, decode with tools/log_decode\n", LOG_FILE);
+    fflush(stdout);
 }
 
 
-i_timer_arm()
+static void log_drain(void)
 {
-    // use standard OS (POSIX) clock
+    uint8_t buffer[256];
+    uint16_t len = 0;
+    size_t written = 0;
+
+    do
+    {
+        len = token_log_read(&event_log, buffer, sizeof(buffer));
+        written = fwrite(buffer, 1, len, log_file);
+        ECU_RUNTIME_ASSERT( (written == len), BSP_ASSERT_FUNCTOR );
+    } while (len > 0);
+
+    (void)fflush(log_file);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- EVENT SOURCES -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void source_add(int fd, uint32_t events, uint32_t source)
+{
+    struct epoll_event evt;
+    int status = -1;
+
+    evt.events = events;
+    evt.data.u64 = 0;
+    evt.data.u32 = source;
+    status = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &evt);
+    ECU_RUNTIME_ASSERT( (status == 0), BSP_ASSERT_FUNCTOR );
 }
 
 
-i_timer_disarm()
+static void terminal_open(void)
 {
-    // use standard OS (POSIX) clock
+    struct termios tio;
+    struct epoll_event evt;
+    int status = -1;
+    int registered = -1;
+
+    stdin_open = true;
+    (void)fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+
+    /* Keys arrive as they are typed and are not echoed. Signals stay on
+    so Ctrl-C still reaches signals_read(). */
+    terminal_raw = (isatty(STDIN_FILENO) == 1) && (tcgetattr(STDIN_FILENO, &terminal_saved) == 0);
+    if (terminal_raw)
+    {
+        tio = terminal_saved;
+        tio.c_lflag &= ~(tcflag_t)(ICANON | ECHO);
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        status = tcsetattr(STDIN_FILENO, TCSANOW, &tio);
+        ECU_RUNTIME_ASSERT( (status == 0), BSP_ASSERT_FUNCTOR );
+        registered = atexit(&terminal_restore);
+        ECU_RUNTIME_ASSERT( (registered == 0), BSP_ASSERT_FUNCTOR );
+    }
+
+    /* Regular files are always ready and epoll refuses them. */
+    evt.events = EPOLLIN;
+    evt.data.u64 = 0;
+    evt.data.u32 = SOURCE_KEYS;
+    stdin_polled = (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, STDIN_FILENO, &evt) == 0);
+    ECU_RUNTIME_ASSERT( (stdin_polled || (errno == EPERM)), BSP_ASSERT_FUNCTOR );
 }
 
 
-SWITCH_PRESSED_EVT = use keyboard key to register press;
-SWITCH_RELEASED_EVT = use keyboard key to register release;
+static void terminal_restore(void)
+{
+    if (terminal_raw)
+    {
+        (void)tcsetattr(STDIN_FILENO, TCSANOW, &terminal_saved);
+        terminal_raw = false;
+    }
+}
+
+
+static void keys_read(void)
+{
+    char key = 0;
+    ssize_t n = 0;
+
+    while (stdin_open)
+    {
+        n = read(STDIN_FILENO, &key, 1);
+        if (n == 0)
+        {
+            /* Keep running with the switches as they are. A closed pipe
+            stays readable, so stop waiting on it. */
+            stdin_open = false;
+            if (stdin_polled)
+            {
+                (void)epoll_ctl(epoll_fd, EPOLL_CTL_DEL, STDIN_FILENO, (struct epoll_event *)0);
+            }
+        }
+        else if (n < 0)
+        {
+            /* Nothing to read. */
+            break;
+        }
+        else if ((key == '0') || (key == '1'))
+        {
+            struct led *me = &leds[key - '0'];
+            me->pressed = !me->pressed;
+            switch_coalescer_post(&me->input, (me->pressed) ? LED_FSM_SWITCH_PRESSED_EVT : LED_FSM_SWITCH_RELEASED_EVT);
+        }
+        else if (key == 's')
+        {
+            loop_stats_print();
+        }
+        else if (key == 'q')
+        {
+            loop_stats_print();
+            exit(EXIT_SUCCESS);
+        }
+    }
+}
+
+
+static void signals_open(void)
+{
+    sigset_t mask;
+    int status = -1;
+
+    /* Handled in the loop like any other event, so exiting always goes
+    through exit() and the terminal is restored. */
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    status = sigprocmask(SIG_BLOCK, &mask, (sigset_t *)0);
+    ECU_RUNTIME_ASSERT( (status == 0), BSP_ASSERT_FUNCTOR );
+
+    signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    ECU_RUNTIME_ASSERT( (signal_fd >= 0), BSP_ASSERT_FUNCTOR );
+    source_add(signal_fd, EPOLLIN, SOURCE_SIGNALS);
+}
+
+
+static void signals_read(void)
+{
+    struct signalfd_siginfo info;
+
+    if (read(signal_fd, &info, sizeof(info)) == (ssize_t)sizeof(info))
+    {
+        printf("\n");
+        loop_stats_print();
+        exit(EXIT_SUCCESS);
+    }
+}
+
+
+static void telemetry_port_open(void)
+{
+    struct termios tio;
+    const char *path = (const char *)0;
+    int status = -1;
+
+    telemetry_master_fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    ECU_RUNTIME_ASSERT( (telemetry_master_fd >= 0), BSP_ASSERT_FUNCTOR );
+    status = grantpt(telemetry_master_fd);
+    ECU_RUNTIME_ASSERT( (status == 0), BSP_ASSERT_FUNCTOR );
+    status = unlockpt(telemetry_master_fd);
+    ECU_RUNTIME_ASSERT( (status == 0), BSP_ASSERT_FUNCTOR );
+
+    path = ptsname(telemetry_master_fd);
+    ECU_RUNTIME_ASSERT( (path), BSP_ASSERT_FUNCTOR );
+    telemetry_slave_fd = open(path, O_RDWR | O_NOCTTY);
+    ECU_RUNTIME_ASSERT( (telemetry_slave_fd >= 0), BSP_ASSERT_FUNCTOR );
+
+    /* Binary frames. No echo, no line editing, no newline translation. */
+    status = tcgetattr(telemetry_slave_fd, &tio);
+    ECU_RUNTIME_ASSERT( (status == 0), BSP_ASSERT_FUNCTOR );
+    cfmakeraw(&tio);
+    status = tcsetattr(telemetry_slave_fd, TCSANOW, &tio);
+    ECU_RUNTIME_ASSERT( (status == 0), BSP_ASSERT_FUNCTOR );
+
+    telemetry_watched = EPOLLIN;
+    source_add(telemetry_master_fd, telemetry_watched, SOURCE_TELEMETRY);
+
+    printf("telemetry on %s\n", path);
+    fflush(stdout);
+}
+
+
+static void telemetry_port_poll(void)
+{
+    ssize_t n = 0;
+
+    /* Receive DMA. Fills the ring in order and wraps, overwriting whatever
+    was not parsed yet. Character match counts delimiters. */
+    do
+    {
+        n = read(telemetry_master_fd, &telemetry_rx_ring[telemetry_rx_index],
+                 TELEMETRY_RX_BUFFER_SIZE - telemetry_rx_index);
+        for (ssize_t i = 0; i < n; i++)
+        {
+            if (telemetry_rx_ring[telemetry_rx_index] == TELEMETRY_FRAME_DELIMITER)
+            {
+                telemetry_rx_delimiter_count++;
+            }
+            telemetry_rx_index = (uint16_t)((telemetry_rx_index + 1U) % TELEMETRY_RX_BUFFER_SIZE);
+        }
+    } while (n > 0);
+
+    /* Transmit DMA. Done once the pty took the whole block. */
+    if (telemetry_tx_len > 0)
+    {
+        n = write(telemetry_master_fd, telemetry_tx_data, telemetry_tx_len);
+        if (n > 0)
+        {
+            telemetry_tx_data += n;
+            telemetry_tx_len = (uint16_t)(telemetry_tx_len - (uint16_t)n);
+        }
+    }
+}
+
+
+static void telemetry_port_watch(void)
+{
+    struct epoll_event evt;
+    int status = -1;
+    uint32_t wanted = (telemetry_tx_len > 0) ? (uint32_t)(EPOLLIN | EPOLLOUT) : (uint32_t)EPOLLIN;
+
+    /* Writable is only waited on while a block is left to send, otherwise
+    the loop would wake up for it all the time. */
+    if (wanted != telemetry_watched)
+    {
+        evt.events = wanted;
+        evt.data.u64 = 0;
+        evt.data.u32 = SOURCE_TELEMETRY;
+        status = epoll_ctl(epoll_fd, EPOLL_CTL_MOD, telemetry_master_fd, &evt);
+        ECU_RUNTIME_ASSERT( (status == 0), BSP_ASSERT_FUNCTOR );
+        telemetry_watched = wanted;
+    }
+}
+
+
+static uint16_t telemetry_rx_head(void *obj)
+{
+    (void)obj;
+    return telemetry_rx_index;
+}
+
+
+static uint32_t telemetry_rx_delimiters(void *obj)
+{
+    (void)obj;
+    return telemetry_rx_delimiter_count;
+}
+
+
+static void telemetry_tx_start(void *obj, const uint8_t *data, uint16_t len)
+{
+    (void)obj;
+    ECU_RUNTIME_ASSERT( ((telemetry_tx_len == 0) && data && (len > 0)), BSP_ASSERT_FUNCTOR );
+    telemetry_tx_data = data;
+    telemetry_tx_len = len;
+    telemetry_port_poll();
+}
+
+
+static bool telemetry_tx_busy(void *obj)
+{
+    (void)obj;
+    return (telemetry_tx_len > 0);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC FUNCTIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void system_init(void)
+{
+    /* Nothing to bring up on host. */
+}
+
+
+void led_fsms_init(void)
+{
+    start_us = monotonic_us();
+    watchdog_refreshed_us = start_us;
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    ECU_RUNTIME_ASSERT( (epoll_fd >= 0), BSP_ASSERT_FUNCTOR );
+    signals_open();
+    terminal_open();
+    log_file_open();
+
+    loop_monitor_ctor(&loop_monitor, LOOP_DEADLINE_US, (void *)0, &get_time_us, &get_ticks, &loop_watchdog_refresh);
+
+    for (size_t i = 0; i < (sizeof(leds) / sizeof(leds[0])); i++)
+    {
+        leds[i].pressed = false;
+        leds[i].name = (char)('0' + i);
+        leds[i].deadline_us = 0;
+        leds[i].period_us = 0;
+        leds[i].cause = (struct latency *)0;
+        leds[i].cause_us = 0;
+        leds[i].timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        ECU_RUNTIME_ASSERT( (leds[i].timer_fd >= 0), BSP_ASSERT_FUNCTOR );
+        source_add(leds[i].timer_fd, EPOLLIN, SOURCE_LED_TIMER + (uint32_t)i);
+        switch_coalescer_ctor(&leds[i].input, false);
+    }
+
+    led_fsm_ctor(&leds[0].fsm, LED0_HOLD_TIME_MS, LED0_TOGGLE_TIME_MS, (void *)&leds[0],
+                 &led_set, &led_timer_arm, &led_timer_disarm);
+    led_fsm_ctor(&leds[1].fsm, LED1_HOLD_TIME_MS, LED1_TOGGLE_TIME_MS, (void *)&leds[1],
+                 &led_set, &led_timer_arm, &led_timer_disarm);
+    led_fsm_periodic_timer_set(&leds[1].fsm, &led_timer_arm_periodic);
+
+    telemetry_port_open();
+    telemetry_ctor(&telemetry, telemetry_rx_ring, TELEMETRY_RX_BUFFER_SIZE, (void *)0,
+                   &telemetry_rx_head, &telemetry_rx_delimiters, &telemetry_tx_start, &telemetry_tx_busy);
+    telemetry_leds_set(&telemetry, telemetry_leds, (uint8_t)(sizeof(telemetry_leds) / sizeof(telemetry_leds[0])));
+    telemetry_loop_monitor_set(&telemetry, &loop_monitor);
+}
+
+
+void led_fsms_run(void)
+{
+    struct epoll_event events[MAX_EVENTS];
+    uint64_t wake_us = 0;
+    uint32_t frames = 0;
+    int n = 0;
+
+    /* Sleeping is not part of an iteration. The iteration starts when
+    something woke the loop up. */
+    n = epoll_wait(epoll_fd, events, MAX_EVENTS, IDLE_WAKE_MS);
+    ECU_RUNTIME_ASSERT( ((n >= 0) || (errno == EINTR)), BSP_ASSERT_FUNCTOR );
+    wake_us = monotonic_us();
+    loop_monitor_begin(&loop_monitor);
+
+    for (int i = 0; i < n; i++)
+    {
+        switch (events[i].data.u32)
+        {
+            case SOURCE_KEYS:
+            {
+                keys_read();
+                break;
+            }
+
+            case SOURCE_SIGNALS:
+            {
+                signals_read();
+                break;
+            }
+
+            case SOURCE_TELEMETRY:
+            {
+                telemetry_port_poll();
+                break;
+            }
+
+            default:
+            {
+                ECU_RUNTIME_ASSERT( ((events[i].data.u32 - SOURCE_LED_TIMER) < (sizeof(leds) / sizeof(leds[0]))), BSP_ASSERT_FUNCTOR );
+                led_timer_read(&leds[events[i].data.u32 - SOURCE_LED_TIMER]);
+                break;
+            }
+        }
+    }
+
+    if (!stdin_polled)
+    {
+        keys_read();
+    }
+
+    for (size_t i = 0; i < (sizeof(leds) / sizeof(leds[0])); i++)
+    {
+        (void)led_switch_dispatch(&leds[i], wake_us);
+    }
+
+    frames = telemetry_poll(&telemetry);
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        loop_monitor_event(&loop_monitor, (uint32_t)(wake_us - start_us));
+    }
+    telemetry_port_watch();
+    log_drain();
+
+    loop_monitor_end(&loop_monitor);
+
+    if ((monotonic_us() - watchdog_refreshed_us) > WATCHDOG_TIMEOUT_US)
+    {
+        printf("watchdog expired\n");
+        loop_stats_print();
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+const struct loop_monitor_stats *loop_stats(void)
+{
+    return loop_monitor_stats(&loop_monitor);
+}
@@ -17,13 +17,38 @@
 /* Translation unit. */
 #include "bsp/bsp.h"
 
-/* LED FSM. */
+/* STDLib. */
+#include <stddef.h>
+
+/* Application. */
+#include "app/can_command.h"
+#include "app/config_store.h"
+#include "app/deadline_timer.h"
+#include "app/governor.h"
 #include "app/led_fsm.h"
+#include "app/loop_monitor.h"
+#include "app/switch_coalescer.h"
+#include "app/switch_input.h"
+#include "app/telemetry.h"
+#include "app/telemetry_frame.h"
+#include "app/token_log.h"
+
+/* Drivers. */
+#include "can/can.h"
+#include "clock/clock.h"
+#include "cycle_counter/cycle_counter.h"
+#include "exti/exti.h"
+#include "flash/flash.h"
+#include "gpio/gpio.h"
+#include "irq/irq.h"
+#include "registers/registers.h"
+#include "systick/systick.h"
+#include "toggle_timer/toggle_timer.h"
+#include "uart/uart.h"
+#include "watchdog/watchdog.h"
 
 /* External libraries. ECU. */
 #include "ecu/fsm.h"
-#include "ecu/interface/itimer.h"
-#include "ecu/timer.h"
 
 
 
@@ -42,6 +67,71 @@
 #define LED1_HOLD_TIME_MS                       (6000)
 #define LED1_TOGGLE_TIME_MS                     (500)
 
+#define SYSTICK_HZ                              (1000U)
+
+/**
+ * @brief Load is evaluated over windows this long.
+ */
+#define GOVERNOR_WINDOW_MS                      (100U)
+
+/**
+ * @brief LED0 is the user LED LD3 on PB3. PB3 is also TIM2_CH2 (AF1)
+ * so LED0 toggles in hardware while its switch is held down.
+ */
+#define LED0_TOGGLE_TIMER_CHANNEL               (2U)
+#define LED0_TOGGLE_TIMER_AF                    (1U)
+
+/**
+ * @brief Toggles to replay if the loop ran late by more than a toggle
+ * period. Replaying keeps the LED level in phase with the period grid.
+ * Later misses are dropped.
+ */
+#define LED_TOGGLE_MAX_CATCH_UP                 (4U)
+
+/**
+ * @brief Switch n drives LED n. Switches short PA0 (A0) and PA1 (A1) to
+ * ground against the internal pull-ups. Contacts are ignored for this
+ * long after an edge.
+ */
+#define SWITCH_DEBOUNCE_US                      (20000U)
+
+/**
+ * @brief A main loop pass longer than this does not refresh the watchdog.
+ * Leaves room for a clock level change, which waits for the PLL to lock.
+ */
+#define LOOP_DEADLINE_US                        (2000U)
+
+/**
+ * @brief Passes can miss the deadline for this long before the MCU is
+ * reset. Must fit the WWDG at the fastest PCLK1 (26 ms at 80 MHz).
+ */
+#define WATCHDOG_TIMEOUT_US                     (20000U)
+
+/**
+ * @brief Telemetry runs on the ST-LINK virtual COM port. The receive ring
+ * holds two of the largest requests so one can be parsed while the next
+ * arrives.
+ */
+#define TELEMETRY_BAUD                          (115200U)
+#define TELEMETRY_RX_BUFFER_SIZE                (256U)
+
+/**
+ * @brief LED timings survive resets in the CONFIG region of stm32l432xc.ld.
+ * Key n holds the hold and toggle times of LED n as two little endian u32s.
+ * The defines above are used until a timing has been saved.
+ */
+#define CONFIG_KEY_LED_TIMING(n)                ((uint16_t)(n))
+#define CONFIG_LED_TIMING_SIZE                  (8U)
+
+/**
+ * @brief LED n also takes switch commands from the bus as standard data
+ * frames with ID CAN_LED_COMMAND_ID(n), see can_command.h. The filters
+ * drop all other traffic. PA11 (RX) and PA12 (TX) need an external
+ * transceiver. Every clock level divides down to this bitrate exactly.
+ */
+#define CAN_BITRATE                             (500000U)
+#define CAN_LED_COMMAND_ID(n)                   (0x300U + (uint32_t)(n))
+
 
 
 /*-------------------------------------------------------------------------------------*/
@@ -50,9 +140,13 @@
 
 struct led
 {
-    struct ecu_timer timer;
+    struct deadline_timer timer;
+    struct switch_coalescer input;
     struct led_fsm fsm;
     struct led_fsm_event evt;
+    uint32_t input_ready_us;        /* Edge time of the newest switch event posted. */
+    uint32_t saved_hold_time_ms;    /* Timing last written to the config store. */
+    uint32_t saved_toggle_time_ms;
 };
 
 
@@ -63,10 +157,35 @@ struct led
 
 static void led0_set(void *led, enum led_fsm_led_state state); // sets gpio connected to led0 for this board.
 static void led1_set(void *led, enum led_fsm_led_state state); // sets gpio connected to led1 for this board.
-static ecu_max_tick_size_t get_ticks(struct i_ecu_timer *me); // returns number of ticks from whatever time source is used for this board.
+static void led0_toggle_start(void *led, enum led_fsm_led_state state, uint32_t period_ms);
+static enum led_fsm_led_state led0_toggle_stop(void *led);
+static uint32_t get_ticks(void *obj); // returns number of ticks from whatever time source is used for this board.
+static uint32_t get_time_us(void *obj);
+static void loop_time_fold(uint32_t hclk_hz);
+static uint32_t cycles_to_time_us(uint32_t cycles);
+static void loop_watchdog_refresh(void *obj);
+static void watchdog_early_warning(void);
+static void clock_level_set(void *obj, uint8_t level);
+static void governor_window_callback(void *obj);
 static void led_timer_arm(void *led, uint32_t ms);
+static void led_timer_arm_periodic(void *led, uint32_t period_ms);
 static void led_timer_disarm(void *led);
-static bool led_timeout_callback(void *led);
+static void led_timeout_callback(void *led);
+static bool led_switch_dispatch(struct led *me);
+static void switch_edge(uint8_t line, uint32_t cycles);
+static uint32_t switch_get_time(void *obj);
+static bool switch_level(void *obj, uint8_t sw);
+static void switch_unmask(void *obj, uint8_t sw);
+static uint16_t telemetry_rx_head(void *obj);
+static uint32_t telemetry_rx_delimiters(void *obj);
+static void telemetry_tx_start(void *obj, const uint8_t *data, uint16_t len);
+static bool telemetry_tx_busy(void *obj);
+static bool config_program(void *obj, uint32_t offset, const void *data, uint32_t len);
+static void config_erase_start(void *obj, uint8_t page);
+static bool config_busy(void *obj);
+static void led_timing_load(struct led *me, uint16_t key);
+static void led_timing_save(struct led *me, uint16_t key);
+static void can_receive(const struct can_frame *frame, uint32_t cycles);
 
 
 
@@ -78,20 +197,166 @@ static bool led_timeout_callback(void *led);
 struct ecu_assert_functor *const BSP_ASSERT_FUNCTOR = (struct ecu_assert_functor *)0;
 
 
+/**
+ * @brief Page aligned CONFIG region reserved by stm32l432xc.ld.
+ */
+extern const uint8_t config_start_[];
+extern const uint8_t config_end_[];
+
+
 
 /*-------------------------------------------------------------------------------------*/
 /*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
 /*-------------------------------------------------------------------------------------*/
 
-static struct
+/**
+ * @brief Interrupt priorities, most urgent first. Everything else runs at
+ * IRQ_PRIORITY_LOWEST. The early warning shares no data, so it stays at 0
+ * where no critical section can hold it off. Switch edges come next so
+ * their timestamps only ever wait behind it. Both EXTI lines share a
+ * level so edge callbacks never preempt each other, and so do both CAN
+ * receive FIFOs.
+ */
+static const struct irq_priority irq_priorities[] =
 {
-    struct ecu_timer_collection timer_head;
-} led_collection;
+    { .irq = NVIC_IRQ_WWDG,             .priority = 0 },
+    { .irq = NVIC_IRQ_EXTI0,            .priority = 1 },
+    { .irq = NVIC_IRQ_EXTI0 + 1U,       .priority = 1 },
+    { .irq = IRQ_SYSTICK,               .priority = 2 },
+    { .irq = NVIC_IRQ_USART2,           .priority = 3 },
+    { .irq = NVIC_IRQ_DMA1_CH7,         .priority = 3 },
+    { .irq = NVIC_IRQ_CAN1_TX,          .priority = 3 },
+    { .irq = NVIC_IRQ_CAN1_RX0,         .priority = 3 },
+    { .irq = NVIC_IRQ_CAN1_RX1,         .priority = 3 },
+    { .irq = NVIC_IRQ_CAN1_SCE,         .priority = 3 },
+    { .irq = NVIC_IRQ_FLASH,            .priority = 4 }
+};
+
+
+/**
+ * @brief Governor levels, slowest first. All run the PLL from the 4 MHz
+ * MSI and divide PCLK1 down to the same 5 MHz, so CAN bit timing, the
+ * WWDG timeout and the 10 MHz TIM2 kernel clock never change and CAN
+ * stays on the bus across level changes. The top level is what the
+ * board boots into. Every level is a multiple of 1 kHz for SysTick.
+ */
+static const struct clock_config clock_levels[] =
+{
+    /* 10 MHz. Range 2, 1 wait state. */
+    { .voltage_range = CLOCK_VOLTAGE_RANGE_2, .msi_range = CLOCK_MSI_4MHZ, .sysclk_source = CLOCK_SYSCLK_PLL,
+      .pll_m = 1, .pll_n = 20, .pll_r = 8,
+      .ahb_div = 1, .apb1_div = 2, .apb2_div = 1, .prefetch = false, .icache = true, .dcache = true },
+
+    /* 20 MHz. Range 2, 3 wait states. */
+    { .voltage_range = CLOCK_VOLTAGE_RANGE_2, .msi_range = CLOCK_MSI_4MHZ, .sysclk_source = CLOCK_SYSCLK_PLL,
+      .pll_m = 1, .pll_n = 20, .pll_r = 4,
+      .ahb_div = 1, .apb1_div = 4, .apb2_div = 1, .prefetch = true, .icache = true, .dcache = true },
+
+    /* 40 MHz. Range 1, 2 wait states. */
+    { .voltage_range = CLOCK_VOLTAGE_RANGE_1, .msi_range = CLOCK_MSI_4MHZ, .sysclk_source = CLOCK_SYSCLK_PLL,
+      .pll_m = 1, .pll_n = 40, .pll_r = 4,
+      .ahb_div = 1, .apb1_div = 8, .apb2_div = 1, .prefetch = true, .icache = true, .dcache = true },
+
+    /* 80 MHz. Range 1, 4 wait states. */
+    { .voltage_range = CLOCK_VOLTAGE_RANGE_1, .msi_range = CLOCK_MSI_4MHZ, .sysclk_source = CLOCK_SYSCLK_PLL,
+      .pll_m = 1, .pll_n = 40, .pll_r = 2,
+      .ahb_div = 1, .apb1_div = 16, .apb2_div = 1, .prefetch = true, .icache = true, .dcache = true }
+};
+
+
+#define CLOCK_LEVEL_TOP                         ((uint8_t)((sizeof(clock_levels) / sizeof(clock_levels[0])) - 1U))
+
+
+/**
+ * @brief Speed up to the top level as soon as 2 events wait in one pass
+ * or a window is 60% busy. Step down a level after 5 windows (0.5 s)
+ * under 20% busy.
+ */
+static const struct governor_config governor_config =
+{
+    .policy         = GOVERNOR_ONDEMAND,
+    .levels         = (uint8_t)(sizeof(clock_levels) / sizeof(clock_levels[0])),
+    .up_permille    = 600,
+    .down_permille  = 200,
+    .down_windows   = 5,
+    .backlog_boost  = 2
+};
+
+
+static struct governor governor;
+static struct deadline_timer governor_window;
+
+
+static struct deadline_timer_collection led_timers;
 
 
 static struct led leds[2];
 
 
+/**
+ * @brief Microseconds since led_fsms_init(). Built from the cycle counter
+ * and folded into loop_time_us every time it is read, so cycles are
+ * always converted at the clock they were counted at.
+ */
+static struct loop_monitor loop_monitor;
+static uint32_t loop_time_us;
+static uint32_t loop_time_cycles;
+
+
+static const struct gpio_pin led0_pin =
+{
+    .port   = GPIOB,
+    .pin    = 3
+};
+
+
+static struct toggle_timer led0_toggle_timer;
+
+
+static const struct gpio_pin switch_pins[] =
+{
+    { .port = GPIOA, .pin = 0 },
+    { .port = GPIOA, .pin = 1 }
+};
+
+
+/**
+ * @brief Times are cycle counter values. The debounce window follows the
+ * clock level.
+ */
+static struct switch_input switches;
+
+
+/**
+ * @brief Written by DMA only. Read in place by telemetry.
+ */
+static uint8_t telemetry_rx_ring[TELEMETRY_RX_BUFFER_SIZE];
+static struct telemetry telemetry;
+static struct led_fsm *const telemetry_leds[] = { &leds[0].fsm, &leds[1].fsm };
+
+
+/**
+ * @brief Read out over telemetry with LOG_READ. Decode with tools/log_decode.
+ */
+static struct token_log event_log;
+
+
+static struct config_store config;
+
+
+/**
+ * @brief Filter i accepts the commands of LED i. The LEDs use different
+ * FIFOs so a burst for one cannot overrun the other's.
+ */
+static const struct can_filter can_filters[] =
+{
+    { .id = CAN_LED_COMMAND_ID(0), .mask = CAN_STD_ID_MASK, .extended = false, .fifo = 0 },
+    { .id = CAN_LED_COMMAND_ID(1), .mask = CAN_STD_ID_MASK, .extended = false, .fifo = 1 }
+};
+static struct can_filter_plan can_filter_plan;
+static struct can_command can_commands;
+
+
 
 /*-------------------------------------------------------------------------------------*/
 /*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
@@ -100,7 +365,7 @@ static struct led leds[2];
 static void led0_set(void *led, enum led_fsm_led_state state)
 {
     (void)led;
-    // TODO set gpio connected to led0
+    gpio_write(&led0_pin, (state == LED_FSM_LED_STATE_ON));
 }
 
 
@@ -111,13 +376,110 @@ static void led1_set(void *led, enum led_fsm_led_state state)
 }
 
 
-static ecu_max_tick_size_t get_ticks(struct i_ecu_timer *me)
+static void led0_toggle_start(void *led, enum led_fsm_led_state state, uint32_t period_ms)
+{
+    (void)led;
+    toggle_timer_start(&led0_toggle_timer, (state == LED_FSM_LED_STATE_ON), period_ms);
+}
+
+
+static enum led_fsm_led_state led0_toggle_stop(void *led)
+{
+    (void)led;
+    return (toggle_timer_stop(&led0_toggle_timer)) ? LED_FSM_LED_STATE_ON : LED_FSM_LED_STATE_OFF;
+}
+
+
+static uint32_t get_ticks(void *obj)
 {
     /* Wrapper function to accomodate any form the systick driver
     function may have. */
-    (void)me;
-    // TODO return systick_get_ticks();
-    return 0;
+    (void)obj;
+    return systick_get_ticks();
+}
+
+
+static uint32_t get_time_us(void *obj)
+{
+    (void)obj;
+    loop_time_fold(clock_hclk_hz());
+    return loop_time_us;
+}
+
+
+static void loop_time_fold(uint32_t hclk_hz)
+{
+    uint32_t cycles_per_us = hclk_hz / 1000000U;
+    uint32_t now = cycle_counter_get();
+    uint32_t us = 0;
+    ECU_RUNTIME_ASSERT( (cycles_per_us > 0), BSP_ASSERT_FUNCTOR );
+
+    /* Keep the remainder so no cycles are lost between reads. */
+    us = (now - loop_time_cycles) / cycles_per_us;
+    loop_time_us += us;
+    loop_time_cycles += us * cycles_per_us;
+}
+
+
+static uint32_t cycles_to_time_us(uint32_t cycles)
+{
+    uint32_t cycles_per_us = clock_hclk_hz() / 1000000U;
+    uint32_t age = 0;
+
+    /* An edge counted before the last clock change is converted at the
+    new clock. The error is bounded by the ratio of the two clocks and
+    only affects the pass the change happened in. */
+    loop_time_fold(clock_hclk_hz());
+    age = loop_time_cycles - cycles;
+    if ((int32_t)age <= 0)
+    {
+        return loop_time_us;
+    }
+
+    return loop_time_us - (age / cycles_per_us);
+}
+
+
+static void loop_watchdog_refresh(void *obj)
+{
+    (void)obj;
+    watchdog_refresh();
+}
+
+
+static void watchdog_early_warning(void)
+{
+    /* The main loop missed its deadline for WATCHDOG_TIMEOUT_US. Reset
+    follows one WWDG step later. Stop here so a debugger can inspect
+    loop_monitor before it is lost. */
+    ECU_RUNTIME_ASSERT( (false), BSP_ASSERT_FUNCTOR );
+}
+
+
+static void clock_level_set(void *obj, uint8_t level)
+{
+    uint32_t hclk_hz = clock_hclk_hz();
+    (void)obj;
+    ECU_RUNTIME_ASSERT( (level <= CLOCK_LEVEL_TOP), BSP_ASSERT_FUNCTOR );
+
+    /* Same PCLK1 on every level, so CAN, the WWDG and TIM2 are left alone. */
+    ECU_RUNTIME_ASSERT( (clock_config_pclk1_hz(&clock_levels[level]) == clock_pclk1_hz()), BSP_ASSERT_FUNCTOR );
+
+    /* Ticks stay 1 ms on every level so MS_TO_TICKS() holds. Loop time
+    counts the clock change itself at the old clock. */
+    clock_init(&clock_levels[level]);
+    loop_time_fold(hclk_hz);
+    systick_clock_set(clock_hclk_hz(), SYSTICK_HZ);
+    switch_input_debounce_set(&switches, SWITCH_DEBOUNCE_US * (clock_hclk_hz() / 1000000U));
+
+    TOKEN_LOG(&event_log, "clock level %u, HCLK %u Hz", level, clock_hclk_hz());
+}
+
+
+static void governor_window_callback(void *obj)
+{
+    (void)obj;
+    governor_evaluate(&governor);
 }
 
 
@@ -128,7 +490,18 @@ static void led_timer_arm(void *led, uint32_t ms)
     ECU_RUNTIME_ASSERT( (led), BSP_ASSERT_FUNCTOR );
 
     me = (struct led *)led;
-    ecu_timer_arm(&led_collection.timer_head, &me->timer, false, MS_TO_TICKS(ms));
+    deadline_timer_arm(&led_timers, &me->timer, MS_TO_TICKS(ms));
+}
+
+
+static void led_timer_arm_periodic(void *led, uint32_t period_ms)
+{
+    struct led *me = (struct led *)0;
+    ECU_RUNTIME_ASSERT( (led), BSP_ASSERT_FUNCTOR );
+
+    me = (struct led *)led;
+    deadline_timer_arm_periodic(&led_timers, &me->timer, MS_TO_TICKS(period_ms),
+                                DEADLINE_TIMER_CATCH_UP, LED_TOGGLE_MAX_CATCH_UP);
 }
 
 
@@ -138,11 +511,11 @@ static void led_timer_disarm(void *led)
     ECU_RUNTIME_ASSERT( (led), BSP_ASSERT_FUNCTOR );
 
     me = (struct led *)led;
-    ecu_timer_disarm(&me->timer);
+    deadline_timer_disarm(&me->timer);
 }
 
 
-static bool led_timeout_callback(void *led)
+static void led_timeout_callback(void *led)
 {
     static const struct led_fsm_event timeout_evt =
     {
@@ -153,8 +526,186 @@ static bool led_timeout_callback(void *led)
     ECU_RUNTIME_ASSERT( (led), BSP_ASSERT_FUNCTOR );
     me = (struct led *)led;
 
+    /* Deadlines are in ticks. When within the tick it became due is unknown. */
+    loop_monitor_event(&loop_monitor, loop_monitor_previous_begin(&loop_monitor));
     ecu_fsm_dispatch((struct ecu_fsm *)(&me->fsm), (const struct ecu_event *)&timeout_evt);
-    return true;
+}
+
+
+static bool led_switch_dispatch(struct led *me)
+{
+    enum led_fsm_event_signals signal = LED_FSM_SWITCH_PRESSED_EVT;
+    bool dispatched = false;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    /* At most one net switch event per LED per pass. Chatter was cancelled by the coalescer. */
+    dispatched = switch_coalescer_take(&me->input, &signal);
+    if (dispatched)
+    {
+        loop_monitor_event(&loop_monitor, me->input_ready_us);
+        me->evt.base_event.id = signal;
+        ecu_fsm_dispatch((struct ecu_fsm *)(&me->fsm), (const struct ecu_event *)&me->evt);
+    }
+
+    return dispatched;
+}
+
+
+static void switch_edge(uint8_t line, uint32_t cycles)
+{
+    for (uint8_t i = 0; i < (uint8_t)(sizeof(switch_pins) / sizeof(switch_pins[0])); i++)
+    {
+        if (switch_pins[i].pin == line)
+        {
+            switch_input_edge(&switches, i, cycles);
+            return;
+        }
+    }
+
+    ECU_RUNTIME_ASSERT( (false), BSP_ASSERT_FUNCTOR );
+}
+
+
+static uint32_t switch_get_time(void *obj)
+{
+    (void)obj;
+    return cycle_counter_get();
+}
+
+
+static bool switch_level(void *obj, uint8_t sw)
+{
+    (void)obj;
+    ECU_RUNTIME_ASSERT( (sw < (sizeof(switch_pins) / sizeof(switch_pins[0]))), BSP_ASSERT_FUNCTOR );
+
+    /* Active low. */
+    exti_pending_clear(switch_pins[sw].pin);
+    return !gpio_read(&switch_pins[sw]);
+}
+
+
+static void switch_unmask(void *obj, uint8_t sw)
+{
+    (void)obj;
+    ECU_RUNTIME_ASSERT( (sw < (sizeof(switch_pins) / sizeof(switch_pins[0]))), BSP_ASSERT_FUNCTOR );
+    exti_unmask(switch_pins[sw].pin);
+}
+
+
+static uint16_t telemetry_rx_head(void *obj)
+{
+    (void)obj;
+    return uart_rx_head();
+}
+
+
+static uint32_t telemetry_rx_delimiters(void *obj)
+{
+    (void)obj;
+    return uart_rx_delimiters();
+}
+
+
+static void telemetry_tx_start(void *obj, const uint8_t *data, uint16_t len)
+{
+    bool started = false;
+    (void)obj;
+
+    /* Telemetry only starts a block once the previous one is done. */
+    started = uart_tx_start(data, len);
+    ECU_RUNTIME_ASSERT( (started), BSP_ASSERT_FUNCTOR );
+}
+
+
+static bool telemetry_tx_busy(void *obj)
+{
+    (void)obj;
+    return uart_tx_busy();
+}
+
+
+static bool config_program(void *obj, uint32_t offset, const void *data, uint32_t len)
+{
+    (void)obj;
+    return flash_program((uintptr_t)config_start_ + offset, data, len);
+}
+
+
+static void config_erase_start(void *obj, uint8_t page)
+{
+    (void)obj;
+    flash_page_erase_start((uint32_t)(((uintptr_t)config_start_ - FLASH_BASE_ADDRESS) / FLASH_PAGE_SIZE) + page);
+}
+
+
+static bool config_busy(void *obj)
+{
+    (void)obj;
+    return flash_busy();
+}
+
+
+static void led_timing_load(struct led *me, uint16_t key)
+{
+    const uint8_t *value = (const uint8_t *)0;
+    uint16_t len = 0;
+    uint32_t hold_time_ms = 0;
+    uint32_t toggle_time_ms = 0;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    /* A record of another size was written by other firmware. Keep the defaults. */
+    value = config_store_get(&config, key, &len);
+    if (value && (len == CONFIG_LED_TIMING_SIZE))
+    {
+        hold_time_ms = (uint32_t)value[0] | ((uint32_t)value[1] << 8U) |
+                       ((uint32_t)value[2] << 16U) | ((uint32_t)value[3] << 24U);
+        toggle_time_ms = (uint32_t)value[4] | ((uint32_t)value[5] << 8U) |
+                         ((uint32_t)value[6] << 16U) | ((uint32_t)value[7] << 24U);
+
+        /* led_fsm asserts on times its timers cannot take. */
+        if (led_fsm_timing_valid(hold_time_ms, toggle_time_ms))
+        {
+            led_fsm_timing_set(&me->fsm, hold_time_ms, toggle_time_ms);
+        }
+    }
+
+    me->saved_hold_time_ms = me->fsm.hold_time_ms;
+    me->saved_toggle_time_ms = me->fsm.toggle_time_ms;
+}
+
+
+static void led_timing_save(struct led *me, uint16_t key)
+{
+    uint8_t value[CONFIG_LED_TIMING_SIZE];
+    uint32_t hold_time_ms = 0;
+    uint32_t toggle_time_ms = 0;
+    ECU_RUNTIME_ASSERT( (me), BSP_ASSERT_FUNCTOR );
+
+    hold_time_ms = me->fsm.hold_time_ms;
+    toggle_time_ms = me->fsm.toggle_time_ms;
+    if ((hold_time_ms == me->saved_hold_time_ms) && (toggle_time_ms == me->saved_toggle_time_ms))
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < 4U; i++)
+    {
+        value[i] = (uint8_t)(hold_time_ms >> (8U * i));
+        value[4U + i] = (uint8_t)(toggle_time_ms >> (8U * i));
+    }
+
+    /* Refused while the store compacts. Still dirty, so retried next pass. */
+    if (config_store_set(&config, key, value, (uint16_t)CONFIG_LED_TIMING_SIZE))
+    {
+        me->saved_hold_time_ms = hold_time_ms;
+        me->saved_toggle_time_ms = toggle_time_ms;
+    }
+}
+
+
+static void can_receive(const struct can_frame *frame, uint32_t cycles)
+{
+    can_command_post(&can_commands, frame->filter, frame->data, frame->len, cycles);
 }
 
 
@@ -163,28 +714,151 @@ static bool led_timeout_callback(void *led)
 /*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
 /*-------------------------------------------------------------------------------------*/
 
-void led_fsms_init(void)
+void system_init(void)
 {
-    static struct i_ecu_timer timer_api;
-    i_ecu_timer_ctor(&timer_api, sizeof(uint32_t), &get_ticks);
-    ecu_timer_collection_ctor(&led_collection.timer_head, &timer_api);
+    /* Before anything enables an interrupt. */
+    irq_init(irq_priorities, (uint8_t)(sizeof(irq_priorities) / sizeof(irq_priorities[0])));
+    clock_init(&clock_levels[CLOCK_LEVEL_TOP]);
+    systick_init(clock_hclk_hz(), SYSTICK_HZ);
+}
 
-    /* Construct LED #0 with board-specific settings. */
-    ecu_timer_ctor(&leds[0].timer, (void *)&leds[0], &led_timeout_callback);
+
+void led_fsms_init(void)
+{
+    bool can_planned = false;
+
+    /* First, anything after may log. */
+    token_log_ctor(&event_log);
+    deadline_timer_collection_ctor(&led_timers, (void *)0, &get_ticks);
+
+    /* Loop time and the governor both run off the cycle counter. */
+    cycle_counter_init();
+    loop_time_cycles = cycle_counter_get();
+    loop_monitor_ctor(&loop_monitor, LOOP_DEADLINE_US, (void *)0, &get_time_us, &get_ticks, &loop_watchdog_refresh);
+
+    /* Governor starts on the level system_init() booted into. */
+    governor_ctor(&governor, &governor_config, CLOCK_LEVEL_TOP, (void *)0, &clock_level_set);
+    deadline_timer_ctor(&governor_window, (void *)0, &governor_window_callback);
+    deadline_timer_arm_periodic(&led_timers, &governor_window, MS_TO_TICKS(GOVERNOR_WINDOW_MS),
+                                DEADLINE_TIMER_FIRE_ONCE, 1U);
+
+    /* Construct LED #0 with board-specific settings. Toggled by TIM2 in the held down state. */
+    gpio_output_init(&led0_pin, false);
+    toggle_timer_ctor(&led0_toggle_timer, TIM2, LED0_TOGGLE_TIMER_CHANNEL, &led0_pin, 
+                      LED0_TOGGLE_TIMER_AF, clock_apb1_timer_hz());
+    deadline_timer_ctor(&leds[0].timer, (void *)&leds[0], &led_timeout_callback);
+    switch_coalescer_ctor(&leds[0].input, false);
     led_fsm_ctor(&leds[0].fsm, LED0_HOLD_TIME_MS, LED0_TOGGLE_TIME_MS, (void *)&leds[0], 
                  &led0_set, &led_timer_arm, &led_timer_disarm);
+    led_fsm_hw_toggle_set(&leds[0].fsm, &led0_toggle_start, &led0_toggle_stop);
 
-    /* Construct LED #1 with board-specific settings. */
-    ecu_timer_ctor(&leds[1].timer, (void *)&leds[1], &led_timeout_callback);
+    /* Construct LED #1 with board-specific settings. Toggle timer keeps absolute deadlines. */
+    deadline_timer_ctor(&leds[1].timer, (void *)&leds[1], &led_timeout_callback);
+    switch_coalescer_ctor(&leds[1].input, false);
     led_fsm_ctor(&leds[1].fsm, LED1_HOLD_TIME_MS, LED1_TOGGLE_TIME_MS, (void *)&leds[1], 
                  &led1_set, &led_timer_arm, &led_timer_disarm);
+    led_fsm_periodic_timer_set(&leds[1].fsm, &led_timer_arm_periodic);
+
+    /* Saved LED timings replace the defaults. Mounting may block to erase pages torn by a reset,
+    so it is done before the watchdog starts. Erases after that are fed through by its handler. */
+    flash_init();
+    config_store_ctor(&config, config_start_, FLASH_PAGE_SIZE,
+                      (uint8_t)(((uintptr_t)config_end_ - (uintptr_t)config_start_) / FLASH_PAGE_SIZE),
+                      (void *)0, &config_program, &config_erase_start, &config_busy);
+    for (size_t i = 0; i < (sizeof(leds) / sizeof(leds[0])); i++)
+    {
+        led_timing_load(&leds[i], CONFIG_KEY_LED_TIMING(i));
+    }
+    watchdog_init(clock_pclk1_hz(), WATCHDOG_TIMEOUT_US, &watchdog_early_warning);
+
+    /* Switches interrupt on both edges. The first take samples them and unmasks them. */
+    exti_init(&switch_edge);
+    for (size_t i = 0; i < (sizeof(switch_pins) / sizeof(switch_pins[0])); i++)
+    {
+        exti_line_init(&switch_pins[i], GPIO_PUPDR_PULL_UP);
+    }
+    switch_input_ctor(&switches, (uint8_t)(sizeof(switch_pins) / sizeof(switch_pins[0])),
+                      SWITCH_DEBOUNCE_US * (clock_hclk_hz() / 1000000U), (void *)0,
+                      &switch_get_time, &switch_level, &switch_unmask);
+
+    /* Bus commands. Only the command IDs ever raise a receive interrupt. */
+    can_planned = can_filter_compile(can_filters, (uint8_t)(sizeof(can_filters) / sizeof(can_filters[0])),
+                                     &can_filter_plan);
+    ECU_RUNTIME_ASSERT( (can_planned), BSP_ASSERT_FUNCTOR );
+    can_command_ctor(&can_commands, (uint8_t)(sizeof(leds) / sizeof(leds[0])));
+    can_init(clock_pclk1_hz(), CAN_BITRATE, &can_filter_plan, &can_receive);
+
+    /* Telemetry. Polled from the main loop, so no transmit done callback. */
+    uart_init(TELEMETRY_BAUD, telemetry_rx_ring, TELEMETRY_RX_BUFFER_SIZE, TELEMETRY_FRAME_DELIMITER, (void (*)(void))0);
+    telemetry_ctor(&telemetry, telemetry_rx_ring, TELEMETRY_RX_BUFFER_SIZE, (void *)0,
+                   &telemetry_rx_head, &telemetry_rx_delimiters, &telemetry_tx_start, &telemetry_tx_busy);
+    telemetry_leds_set(&telemetry, telemetry_leds, (uint8_t)(sizeof(telemetry_leds) / sizeof(telemetry_leds[0])));
+    telemetry_loop_monitor_set(&telemetry, &loop_monitor);
+    telemetry_governor_set(&telemetry, &governor);
+    telemetry_token_log_set(&telemetry, &event_log);
 }
 
 
 void led_fsms_run(void)
 {
+    uint32_t start = 0;
+    uint32_t backlog = 0;
+    uint32_t frames = 0;
+    struct switch_input_event input = {0};
+    struct can_command_event command = {0};
+
+    loop_monitor_begin(&loop_monitor);
+    start = cycle_counter_get();
+
     /* Dispatch timeout events to relevant LED FSMs first. */
-    ecu_timer_collection_tick(&led_collection.timer_head);
+    backlog += deadline_timer_collection_tick(&led_timers);
 
-    // TODO: Get all switch inputs, debounce, dispatch SW_PRESSED and SW_RELEASED events.
+    /* Switch events carry the time of their edge, not of this pass. */
+    while (switch_input_take(&switches, &input))
+    {
+        leds[input.sw].input_ready_us = cycles_to_time_us(input.time);
+        switch_coalescer_post(&leds[input.sw].input,
+                              (input.pressed) ? LED_FSM_SWITCH_PRESSED_EVT : LED_FSM_SWITCH_RELEASED_EVT);
+    }
+
+    /* Bus commands carry the time their frame was received. */
+    while (can_command_take(&can_commands, &command))
+    {
+        leds[command.led].input_ready_us = cycles_to_time_us(command.time);
+        switch_coalescer_post(&leds[command.led].input, command.signal);
+        TOKEN_LOG(&event_log, "CAN LED%u pressed %u", command.led,
+                  (command.signal == LED_FSM_SWITCH_PRESSED_EVT) ? 1U : 0U);
+    }
+
+    for (size_t i = 0; i < (sizeof(leds) / sizeof(leds[0])); i++)
+    {
+        backlog += (led_switch_dispatch(&leds[i])) ? 1U : 0U;
+    }
+
+    /* Costs two register reads unless a whole frame arrived. */
+    frames = telemetry_poll(&telemetry);
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        loop_monitor_event(&loop_monitor, loop_monitor_previous_begin(&loop_monitor));
+    }
+    backlog += frames;
+
+    /* Timings changed over telemetry are saved. Compaction does one step per pass. */
+    for (size_t i = 0; i < (sizeof(leds) / sizeof(leds[0])); i++)
+    {
+        led_timing_save(&leds[i], CONFIG_KEY_LED_TIMING(i));
+    }
+    config_store_run(&config);
+
+    /* Everything this pass handled was waiting when it started. */
+    governor_pass(&governor, cycle_counter_get() - start, backlog);
+
+    /* Last so it covers a level change the governor made. */
+    loop_monitor_end(&loop_monitor);
+}
+
+
+const struct loop_monitor_stats *loop_stats(void)
+{
+    return loop_monitor_stats(&loop_monitor);
 }
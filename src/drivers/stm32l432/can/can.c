@@ -0,0 +1,519 @@
+/**
+ * @file
+ * @brief See can.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "can/can.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Drivers. */
+#include "cycle_counter/cycle_counter.h"
+#include "gpio/gpio.h"
+
+/* Register map. */
+#include "registers/registers.h"
+
+/* External libraries. ECU. */
+#include "ecu/asserter.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- FILE SCOPE DEFINES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define PIN_AF                                  (9U)
+
+/**
+ * @brief Time quanta per bit tried, most first. 16 or fewer keeps the
+ * first segment within its 16 quanta at an 87.5% sample point.
+ */
+#define QUANTA_MAX                              (16U)
+#define QUANTA_MIN                              (8U)
+
+/**
+ * @brief Filter kinds in the order banks are handed out within a FIFO.
+ */
+#define KIND_EXT_MASK                           (0U)
+#define KIND_EXT_LIST                           (1U)
+#define KIND_STD_MASK                           (2U)
+#define KIND_STD_LIST                           (3U)
+#define KINDS                                   (4U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- STATIC ASSERTS -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* All four interrupts are enabled with one write. */
+ECU_STATIC_ASSERT( ((NVIC_IRQ_CAN1_TX / 32U) == (NVIC_IRQ_CAN1_SCE / 32U)) );
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- STATIC FUNCTION DECLARATIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint32_t bit_timing(uint32_t pclk1_hz, uint32_t bitrate);
+static uint8_t filter_kind(const struct can_filter *filter);
+static void bank_setup(struct can_filter_plan *plan, uint8_t bank, uint8_t fifo, uint8_t kind);
+static void slot_write(struct can_filter_plan *plan, uint8_t bank, uint8_t kind, uint8_t slot, const struct can_filter *filter);
+static void filters_load(const struct can_filter_plan *plan);
+static uint32_t id_word(uint32_t id, bool extended);
+static void fifo_drain(uint8_t fifo, uint32_t cycles);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------- FILE SCOPE VARIABLES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static const struct gpio_pin rx_pin =
+{
+    .port   = GPIOA,
+    .pin    = 11
+};
+
+
+static const struct gpio_pin tx_pin =
+{
+    .port   = GPIOA,
+    .pin    = 12
+};
+
+
+static const uint8_t kind_slots[KINDS] = { 1U, 2U, 2U, 4U };
+
+static uint32_t can_bitrate;
+static const struct can_filter_plan *filter_plan;
+static void (*rx_fn)(const struct can_frame *frame, uint32_t cycles);
+static struct can_stats stats;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint32_t bit_timing(uint32_t pclk1_hz, uint32_t bitrate)
+{
+    uint32_t brp = 0;
+    uint32_t ts1 = 0;
+    uint32_t ts2 = 0;
+    ECU_RUNTIME_ASSERT( (bitrate > 0), ECU_DEFAULT_FUNCTOR );
+
+    /* Sample point at 87.5% (CiA 301) and a resync jump width of one
+    quantum. More quanta per bit place the sample point more finely. */
+    for (uint32_t quanta = QUANTA_MAX; quanta >= QUANTA_MIN; quanta--)
+    {
+        brp = pclk1_hz / (bitrate * quanta);
+        if (((pclk1_hz % (bitrate * quanta)) == 0) && (brp > 0) && (brp <= CAN_BTR_BRP_MAX))
+        {
+            ts2 = quanta - (((quanta * 7U) + 4U) / 8U);
+            ts1 = quanta - 1U - ts2;
+            return ((ts2 - 1U) << CAN_BTR_TS2_OFFSET) | ((ts1 - 1U) << CAN_BTR_TS1_OFFSET) | (brp - 1U);
+        }
+    }
+
+    ECU_RUNTIME_ASSERT( (false), ECU_DEFAULT_FUNCTOR );
+    return 0;
+}
+
+
+static uint8_t filter_kind(const struct can_filter *filter)
+{
+    ECU_RUNTIME_ASSERT( (filter), ECU_DEFAULT_FUNCTOR );
+
+    if (filter->extended)
+    {
+        return (filter->mask == CAN_EXT_ID_MASK) ? KIND_EXT_LIST : KIND_EXT_MASK;
+    }
+
+    return (filter->mask == CAN_STD_ID_MASK) ? KIND_STD_LIST : KIND_STD_MASK;
+}
+
+
+static void bank_setup(struct can_filter_plan *plan, uint8_t bank, uint8_t fifo, uint8_t kind)
+{
+    ECU_RUNTIME_ASSERT( (plan && (bank < CAN_FILTER_BANKS) && (fifo < CAN_FIFOS) && (kind < KINDS)), ECU_DEFAULT_FUNCTOR );
+
+    plan->fm1r |= ((kind == KIND_EXT_LIST) || (kind == KIND_STD_LIST)) ? (1U << bank) : 0U;
+    plan->fs1r |= ((kind == KIND_EXT_MASK) || (kind == KIND_EXT_LIST)) ? (1U << bank) : 0U;
+    plan->ffa1r |= (fifo == 1U) ? (1U << bank) : 0U;
+    plan->fa1r |= 1U << bank;
+}
+
+
+static void slot_write(struct can_filter_plan *plan, uint8_t bank, uint8_t kind, uint8_t slot, const struct can_filter *filter)
+{
+    uint32_t id16 = 0;
+    uint32_t mask16 = 0;
+    uint32_t shift = 0;
+    ECU_RUNTIME_ASSERT( (plan && filter && (bank < CAN_FILTER_BANKS) && (slot < 4U)), ECU_DEFAULT_FUNCTOR );
+
+    /* Remote frames and frames of the other ID format never match. */
+    id16 = filter->id << CAN_FILTER16_STID_OFFSET;
+    mask16 = (filter->mask << CAN_FILTER16_STID_OFFSET) | CAN_FILTER16_RTR | CAN_FILTER16_IDE;
+
+    switch (kind)
+    {
+        case KIND_EXT_MASK:
+        {
+            plan->fr[bank][0] = id_word(filter->id, true);
+            plan->fr[bank][1] = (filter->mask << CAN_IR_EXID_OFFSET) | CAN_IR_IDE | CAN_IR_RTR;
+            break;
+        }
+
+        case KIND_EXT_LIST:
+        {
+            plan->fr[bank][slot] = id_word(filter->id, true);
+            break;
+        }
+
+        case KIND_STD_MASK:
+        {
+            plan->fr[bank][slot] = (mask16 << 16U) | id16;
+            break;
+        }
+
+        case KIND_STD_LIST:
+        {
+            shift = 16U * (slot % 2U);
+            plan->fr[bank][slot / 2U] = (plan->fr[bank][slot / 2U] & ~(0xFFFFU << shift)) | (id16 << shift);
+            break;
+        }
+
+        default:
+        {
+            ECU_RUNTIME_ASSERT( (false), ECU_DEFAULT_FUNCTOR );
+            break;
+        }
+    }
+}
+
+
+static void filters_load(const struct can_filter_plan *plan)
+{
+    ECU_RUNTIME_ASSERT( (plan && (plan->banks <= CAN_FILTER_BANKS)), ECU_DEFAULT_FUNCTOR );
+
+    /* Banks are only written while inactive and in filter init mode. */
+    CAN1->FMR |= CAN_FMR_FINIT;
+    CAN1->FA1R = 0;
+    CAN1->FM1R = plan->fm1r;
+    CAN1->FS1R = plan->fs1r;
+    CAN1->FFA1R = plan->ffa1r;
+    for (uint8_t i = 0; i < plan->banks; i++)
+    {
+        CAN1->FILTER[i].FR1 = plan->fr[i][0];
+        CAN1->FILTER[i].FR2 = plan->fr[i][1];
+    }
+    CAN1->FA1R = plan->fa1r;
+    CAN1->FMR &= ~CAN_FMR_FINIT;
+}
+
+
+static uint32_t id_word(uint32_t id, bool extended)
+{
+    return (extended) ? ((id << CAN_IR_EXID_OFFSET) | CAN_IR_IDE) : (id << CAN_IR_STID_OFFSET);
+}
+
+
+static void fifo_drain(uint8_t fifo, uint32_t cycles)
+{
+    volatile uint32_t *rfr = (fifo == 0U) ? &CAN1->RF0R : &CAN1->RF1R;
+    struct stm32l432_can_rx_mailbox_regs *mailbox = &CAN1->RX[fifo];
+    struct can_frame frame;
+    uint32_t status = 0;
+    uint32_t rir = 0;
+    uint32_t rdtr = 0;
+    uint32_t rdlr = 0;
+    uint32_t rdhr = 0;
+    uint32_t fmi = 0;
+
+    stats.rx_interrupts[fifo]++;
+    status = *rfr;
+    while (status & CAN_RFR_FMP_MASK)
+    {
+        rir = mailbox->RIR;
+        rdtr = mailbox->RDTR;
+        rdlr = mailbox->RDLR;
+        rdhr = mailbox->RDHR;
+
+        /* Released before the frame is handed on so the FIFO has room
+        again as early as possible. The same write clears the full and
+        overrun flags read with it. */
+        stats.rx_overruns[fifo] += (status & CAN_RFR_FOVR) ? 1U : 0U;
+        *rfr = CAN_RFR_RFOM | (status & (CAN_RFR_FULL | CAN_RFR_FOVR));
+        do
+        {
+            STM32L432_POLL();
+        } while (*rfr & CAN_RFR_RFOM);
+
+        /* Filters only pass data frames. */
+        frame.extended = ((rir & CAN_IR_IDE) != 0);
+        frame.id = (frame.extended) ? (rir >> CAN_IR_EXID_OFFSET) : (rir >> CAN_IR_STID_OFFSET);
+        frame.len = (uint8_t)(rdtr & CAN_RDTR_DLC_MASK);
+        frame.len = (frame.len > 8U) ? 8U : frame.len;
+        for (uint8_t i = 0; i < 4U; i++)
+        {
+            frame.data[i] = (uint8_t)(rdlr >> (8U * i));
+            frame.data[4U + i] = (uint8_t)(rdhr >> (8U * i));
+        }
+
+        fmi = (rdtr & CAN_RDTR_FMI_MASK) >> CAN_RDTR_FMI_OFFSET;
+        ECU_RUNTIME_ASSERT( (fmi < filter_plan->fmi_count[fifo]), ECU_DEFAULT_FUNCTOR );
+        frame.filter = filter_plan->fmi_filter[fifo][fmi];
+
+        stats.rx_frames[fifo]++;
+        (*rx_fn)(&frame, cycles);
+        status = *rfr;
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC FUNCTIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+bool can_filter_compile(const struct can_filter *filters, uint8_t count, struct can_filter_plan *plan)
+{
+    uint8_t bank = 0;
+    uint8_t slot = 0;
+    uint8_t last = 0;
+    ECU_RUNTIME_ASSERT( (plan && (filters || (count == 0)) && (count <= CAN_FILTERS_MAX)), ECU_DEFAULT_FUNCTOR );
+
+    plan->fm1r = 0;
+    plan->fs1r = 0;
+    plan->ffa1r = 0;
+    plan->fa1r = 0;
+    plan->banks = 0;
+    for (uint8_t f = 0; f < CAN_FIFOS; f++)
+    {
+        plan->fmi_count[f] = 0;
+    }
+    for (uint8_t b = 0; b < CAN_FILTER_BANKS; b++)
+    {
+        plan->fr[b][0] = 0;
+        plan->fr[b][1] = 0;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        ECU_RUNTIME_ASSERT( (filters[i].fifo < CAN_FIFOS), ECU_DEFAULT_FUNCTOR );
+        ECU_RUNTIME_ASSERT( (filters[i].extended || ((filters[i].id | filters[i].mask) <= CAN_STD_ID_MASK)), ECU_DEFAULT_FUNCTOR );
+        ECU_RUNTIME_ASSERT( (!filters[i].extended || ((filters[i].id | filters[i].mask) <= CAN_EXT_ID_MASK)), ECU_DEFAULT_FUNCTOR );
+    }
+
+    /* Filter match indexes count up per FIFO in bank order, every slot of
+    a bank included. Banks are handed out in that order, so the slots
+    written are numbered as they are written. */
+    for (uint8_t fifo = 0; fifo < CAN_FIFOS; fifo++)
+    {
+        for (uint8_t kind = 0; kind < KINDS; kind++)
+        {
+            slot = 0;
+            for (uint8_t i = 0; i < count; i++)
+            {
+                if ((filters[i].fifo != fifo) || (filter_kind(&filters[i]) != kind))
+                {
+                    continue;
+                }
+
+                if (slot == 0)
+                {
+                    if (plan->banks == CAN_FILTER_BANKS)
+                    {
+                        return false;
+                    }
+                    bank = plan->banks++;
+                    bank_setup(plan, bank, fifo, kind);
+                }
+
+                slot_write(plan, bank, kind, slot, &filters[i]);
+                plan->fmi_filter[fifo][plan->fmi_count[fifo]++] = i;
+                last = i;
+                slot = (uint8_t)((slot + 1U) % kind_slots[kind]);
+            }
+
+            /* Slots left over repeat the last filter so they accept
+            nothing more. */
+            while (slot != 0)
+            {
+                slot_write(plan, bank, kind, slot, &filters[last]);
+                plan->fmi_filter[fifo][plan->fmi_count[fifo]++] = last;
+                slot = (uint8_t)((slot + 1U) % kind_slots[kind]);
+            }
+        }
+    }
+
+    return true;
+}
+
+
+void can_init(uint32_t pclk1_hz,
+              uint32_t bitrate,
+              const struct can_filter_plan *plan,
+              void (*rx)(const struct can_frame *frame, uint32_t cycles))
+{
+    ECU_RUNTIME_ASSERT( (plan && rx && (bitrate > 0)), ECU_DEFAULT_FUNCTOR );
+
+    can_bitrate = bitrate;
+    filter_plan = plan;
+    rx_fn = rx;
+    stats = (struct can_stats){0};
+
+    RCC->APB1ENR1 |= RCC_APB1ENR1_CAN1EN;
+    gpio_af_init(&rx_pin, PIN_AF);
+    gpio_af_init(&tx_pin, PIN_AF);
+
+    /* Out of sleep, which it resets into, and into initialization. */
+    CAN1->MCR = (CAN1->MCR & ~CAN_MCR_SLEEP) | CAN_MCR_INRQ;
+    do
+    {
+        STM32L432_POLL();
+    } while ((CAN1->MSR & (CAN_MSR_INAK | CAN_MSR_SLAK)) != CAN_MSR_INAK);
+
+    /* Bus off recovers by itself. Mailboxes go out in the order they were
+    queued instead of by ID. */
+    CAN1->MCR |= CAN_MCR_ABOM | CAN_MCR_TXFP;
+    CAN1->BTR = bit_timing(pclk1_hz, bitrate);
+    filters_load(plan);
+
+    CAN1->MSR = CAN_MSR_ERRI;
+    CAN1->IER = CAN_IER_FMPIE0 | CAN_IER_FOVIE0 | CAN_IER_FMPIE1 | CAN_IER_FOVIE1 |
+                CAN_IER_TMEIE | CAN_IER_EPVIE | CAN_IER_BOFIE | CAN_IER_ERRIE;
+    NVIC->ISER[NVIC_IRQ_CAN1_TX / 32U] = (1U << (NVIC_IRQ_CAN1_TX % 32U)) | (1U << (NVIC_IRQ_CAN1_RX0 % 32U)) |
+                                         (1U << (NVIC_IRQ_CAN1_RX1 % 32U)) | (1U << (NVIC_IRQ_CAN1_SCE % 32U));
+
+    /* Joins once it has seen the bus idle for 11 bits. */
+    CAN1->MCR &= ~CAN_MCR_INRQ;
+}
+
+
+void can_suspend(void)
+{
+    ECU_RUNTIME_ASSERT( (filter_plan), ECU_DEFAULT_FUNCTOR );
+
+    CAN1->MCR |= CAN_MCR_INRQ;
+    do
+    {
+        STM32L432_POLL();
+    } while (!(CAN1->MSR & CAN_MSR_INAK));
+}
+
+
+void can_resume(uint32_t pclk1_hz)
+{
+    ECU_RUNTIME_ASSERT( (filter_plan && (CAN1->MSR & CAN_MSR_INAK)), ECU_DEFAULT_FUNCTOR );
+
+    /* BTR only takes writes in initialization mode. */
+    CAN1->BTR = bit_timing(pclk1_hz, can_bitrate);
+    CAN1->MCR &= ~CAN_MCR_INRQ;
+}
+
+
+bool can_tx(const struct can_frame *frame)
+{
+    struct stm32l432_can_tx_mailbox_regs *mailbox = (struct stm32l432_can_tx_mailbox_regs *)0;
+    uint32_t tsr = CAN1->TSR;
+    uint32_t low = 0;
+    uint32_t high = 0;
+    ECU_RUNTIME_ASSERT( (frame && (frame->len <= 8U)), ECU_DEFAULT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (frame->id <= ((frame->extended) ? CAN_EXT_ID_MASK : CAN_STD_ID_MASK)), ECU_DEFAULT_FUNCTOR );
+
+    /* CODE is the next empty mailbox if any is empty. */
+    if (!(tsr & CAN_TSR_TME_MASK))
+    {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < 4U; i++)
+    {
+        low |= (uint32_t)frame->data[i] << (8U * i);
+        high |= (uint32_t)frame->data[4U + i] << (8U * i);
+    }
+
+    /* Requested last. The mailbox is sent from that write on. */
+    mailbox = &CAN1->TX[(tsr & CAN_TSR_CODE_MASK) >> CAN_TSR_CODE_OFFSET];
+    mailbox->TDTR = frame->len;
+    mailbox->TDLR = low;
+    mailbox->TDHR = high;
+    mailbox->TIR = id_word(frame->id, frame->extended) | CAN_IR_TXRQ;
+    return true;
+}
+
+
+const struct can_stats *can_stats(void)
+{
+    return &stats;
+}
+
+
+void can1_tx_isr_handler(void)
+{
+    uint32_t tsr = CAN1->TSR;
+    uint32_t done = 0;
+
+    for (uint8_t i = 0; i < 3U; i++)
+    {
+        if (tsr & CAN_TSR_RQCP(i))
+        {
+            done |= CAN_TSR_RQCP(i);
+            stats.tx_frames += (tsr & CAN_TSR_TXOK(i)) ? 1U : 0U;
+            stats.tx_failed += (tsr & CAN_TSR_TXOK(i)) ? 0U : 1U;
+        }
+    }
+
+    /* Write 1 to clear. Also clears the mailbox's result flags. */
+    CAN1->TSR = done;
+}
+
+
+/* Read the cycle counter first thing. Everything after it is latency
+the timestamp does not see. */
+void can1_rx0_isr_handler(void)
+{
+    fifo_drain(0U, cycle_counter_get());
+}
+
+
+void can1_rx1_isr_handler(void)
+{
+    fifo_drain(1U, cycle_counter_get());
+}
+
+
+void can1_sce_isr_handler(void)
+{
+    uint32_t esr = CAN1->ESR;
+
+    /* Raised when the controller becomes error passive and again when it
+    goes bus off. Bus off is error passive too, so it counts as bus off
+    only. */
+    CAN1->MSR = CAN_MSR_ERRI;
+    if (esr & CAN_ESR_BOFF)
+    {
+        stats.bus_off++;
+    }
+    else if (esr & CAN_ESR_EPVF)
+    {
+        stats.error_passive++;
+    }
+}
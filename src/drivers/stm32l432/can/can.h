@@ -0,0 +1,196 @@
+/**
+ * @file
+ * @brief bxCAN (CAN1) on PA11 (RX) and PA12 (TX) through an external
+ * transceiver.
+ *
+ * Acceptance filtering is done by the filter banks, so traffic nobody
+ * listens to never costs an interrupt. @ref can_filter_compile packs a
+ * list of filters into as few banks as their kinds allow:
+ *
+ *     standard, one ID        4 per bank      16-bit list
+ *     standard, masked        2 per bank      16-bit mask
+ *     extended, one ID        2 per bank      32-bit list
+ *     extended, masked        1 per bank      32-bit mask
+ *
+ * Every filter only accepts data frames of its own ID format. Each filter
+ * names the receive FIFO its frames go to. A received frame carries the
+ * index of the filter that accepted it, looked up from the filter match
+ * index the hardware stores with the frame, so the receiver can tell
+ * what the frame is without comparing IDs. A frame that matches several
+ * filters goes to the one the hardware prefers (RM0394 filter priority
+ * rules), so keep filters of different FIFOs apart.
+ *
+ * Each FIFO has its own interrupt. The handler drains every frame the
+ * FIFO holds, and any that arrive while it does, so a burst costs one
+ * interrupt instead of one per frame. Each mailbox is released before
+ * its frame is handed on, which frees room in the FIFO as early as
+ * possible. A FIFO holds three frames. A fourth arriving before the
+ * handler ran replaces the newest one and is counted as an overrun.
+ *
+ * Give both receive interrupts the same priority in the board's irq table
+ * so receive callbacks never preempt each other.
+ *
+ * Bit timing is taken from PCLK1. Boards that scale the system clock
+ * should keep PCLK1 constant with the APB1 prescaler. Otherwise take the
+ * controller off the bus with @ref can_suspend before the clock changes
+ * and put it back with @ref can_resume after. Frames sent to it in
+ * between are lost.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef CAN_H_
+#define CAN_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- DEFINES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define CAN_FILTER_BANKS                        (14U)
+#define CAN_FIFOS                               (2U)
+
+/**
+ * @brief A bank holds at most four filters.
+ */
+#define CAN_FILTERS_MAX                         (CAN_FILTER_BANKS * 4U)
+
+#define CAN_STD_ID_MASK                         (0x7FFU)
+#define CAN_EXT_ID_MASK                         (0x1FFFFFFFU)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- CAN DATA STRUCTURES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct can_frame
+{
+    uint32_t id;                    /* 11 or 29 bits. */
+    uint8_t data[8];
+    uint8_t len;                    /* 0 - 8. */
+    uint8_t filter;                 /* Received frames. Index of the filter that accepted it. */
+    bool extended;
+};
+
+
+/**
+ * @brief Accepts IDs where every bit set in @p mask equals that bit of
+ * @p id. A mask of all ones (CAN_STD_ID_MASK or CAN_EXT_ID_MASK) accepts
+ * one ID.
+ */
+struct can_filter
+{
+    uint32_t id;
+    uint32_t mask;
+    bool extended;
+    uint8_t fifo;                   /* 0 or 1. */
+};
+
+
+/**
+ * @brief Filter bank register values and the filter index of every filter
+ * match index. Made by @ref can_filter_compile. Private.
+ */
+struct can_filter_plan
+{
+    uint32_t fm1r;
+    uint32_t fs1r;
+    uint32_t ffa1r;
+    uint32_t fa1r;
+    uint32_t fr[CAN_FILTER_BANKS][2];
+    uint8_t fmi_filter[CAN_FIFOS][CAN_FILTERS_MAX];
+    uint8_t fmi_count[CAN_FIFOS];
+    uint8_t banks;
+};
+
+
+struct can_stats
+{
+    uint32_t rx_frames[CAN_FIFOS];
+    uint32_t rx_interrupts[CAN_FIFOS];      /* Frames per interrupt is the batch size. */
+    uint32_t rx_overruns[CAN_FIFOS];        /* Times a full FIFO lost frames. A run of lost frames counts once. */
+    uint32_t tx_frames;
+    uint32_t tx_failed;                     /* Lost arbitration or hit an error. */
+    uint32_t error_passive;                 /* Times the controller became error passive. */
+    uint32_t bus_off;                       /* Times it went bus off. It recovers by itself. */
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Packs @p count filters into @p plan. Filter i is reported as i.
+ * Returns false if they need more than CAN_FILTER_BANKS banks. Does not
+ * touch hardware.
+ */
+extern bool can_filter_compile(const struct can_filter *filters, uint8_t count, struct can_filter_plan *plan);
+
+/**
+ * @brief Joins the bus at @p bitrate with the filters in @p plan, which
+ * must stay valid. @p rx runs in interrupt context for every frame
+ * received, with the cycle counter value taken on handler entry. The
+ * cycle counter must already be running. The interrupt priorities must
+ * already be set, see irq_init(). Does not wait until the bus is idle
+ * long enough to join it.
+ */
+extern void can_init(uint32_t pclk1_hz,
+                     uint32_t bitrate,
+                     const struct can_filter_plan *plan,
+                     void (*rx)(const struct can_frame *frame, uint32_t cycles));
+
+/**
+ * @brief Leaves the bus once the frame on it is over. Frames received
+ * and frames waiting to be sent are kept.
+ */
+extern void can_suspend(void);
+
+/**
+ * @brief Joins the bus again with bit timing for @p pclk1_hz. Asserts if
+ * the bitrate cannot be hit exactly at that clock.
+ */
+extern void can_resume(uint32_t pclk1_hz);
+
+/**
+ * @brief Queues @p frame in an empty transmit mailbox. Returns false if
+ * all three are still in use. Frames go out in the order queued.
+ */
+extern bool can_tx(const struct can_frame *frame);
+
+extern const struct can_stats *can_stats(void);
+
+/**
+ * @brief Override the weak handlers in the startup code's vector table.
+ */
+extern void can1_tx_isr_handler(void);
+extern void can1_rx0_isr_handler(void);
+extern void can1_rx1_isr_handler(void);
+extern void can1_sce_isr_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAN_H_ */
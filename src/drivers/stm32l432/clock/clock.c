@@ -0,0 +1,422 @@
+/**
+ * @file
+ * @brief See clock.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "clock/clock.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Register map. */
+#include "registers/registers.h"
+
+/* External libraries. ECU. */
+#include "ecu/asserter.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- FILE SCOPE DEFINES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define RESET_CLOCK_HZ                          (4000000U)
+
+/* RM0394 section 6.2.3 and DS11451 PLL characteristics. */
+#define PLL_INPUT_MIN_HZ                        (4000000U)
+#define PLL_INPUT_MAX_HZ                        (16000000U)
+#define PLL_VCO_MIN_HZ                          (64000000U)
+#define PLL_VCO_MAX_HZ                          (344000000U)
+
+/* RM0394 section 5.1.8. */
+#define RANGE_1_MAX_HZ                          (80000000U)
+#define RANGE_2_MAX_HZ                          (26000000U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- STATIC FUNCTION DECLARATIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint32_t msi_hz(enum clock_msi_range range);
+static uint32_t range_max_hz(enum clock_voltage_range range);
+static uint32_t hpre_bits(uint16_t div);
+static uint32_t ppre_bits(uint8_t div);
+static void config_check(const struct clock_config *config);
+
+static enum clock_voltage_range voltage_range_get(void);
+static void voltage_range_set(enum clock_voltage_range range);
+static uint32_t flash_latency_get(void);
+static void flash_latency_set(uint32_t latency);
+static void sysclk_switch(uint32_t sw, uint32_t sws);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint32_t sysclk_hz = RESET_CLOCK_HZ;
+static uint32_t hclk_hz = RESET_CLOCK_HZ;
+static uint32_t pclk1_hz = RESET_CLOCK_HZ;
+static uint32_t pclk2_hz = RESET_CLOCK_HZ;
+static uint8_t apb1_div = 1;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint32_t msi_hz(enum clock_msi_range range)
+{
+    static const uint32_t table[] =
+    {
+        100000U, 200000U, 400000U, 800000U, 1000000U, 2000000U,
+        4000000U, 8000000U, 16000000U, 24000000U, 32000000U, 48000000U
+    };
+
+    ECU_RUNTIME_ASSERT( (((uint32_t)range) < (sizeof(table) / sizeof(table[0]))), ECU_DEFAULT_FUNCTOR );
+    return table[range];
+}
+
+
+static uint32_t range_max_hz(enum clock_voltage_range range)
+{
+    uint32_t max = 0;
+
+    switch (range)
+    {
+        case CLOCK_VOLTAGE_RANGE_1:
+        {
+            max = RANGE_1_MAX_HZ;
+            break;
+        }
+
+        case CLOCK_VOLTAGE_RANGE_2:
+        {
+            max = RANGE_2_MAX_HZ;
+            break;
+        }
+
+        default:
+        {
+            ECU_RUNTIME_ASSERT( (false), ECU_DEFAULT_FUNCTOR );
+            break;
+        }
+    }
+
+    return max;
+}
+
+
+static uint32_t hpre_bits(uint16_t div)
+{
+    uint32_t bits = 0;
+
+    switch (div)
+    {
+        case 1:     bits = 0x0U; break;
+        case 2:     bits = 0x8U; break;
+        case 4:     bits = 0x9U; break;
+        case 8:     bits = 0xAU; break;
+        case 16:    bits = 0xBU; break;
+        case 64:    bits = 0xCU; break;
+        case 128:   bits = 0xDU; break;
+        case 256:   bits = 0xEU; break;
+        case 512:   bits = 0xFU; break;
+
+        default:
+        {
+            ECU_RUNTIME_ASSERT( (false), ECU_DEFAULT_FUNCTOR );
+            break;
+        }
+    }
+
+    return bits;
+}
+
+
+static uint32_t ppre_bits(uint8_t div)
+{
+    uint32_t bits = 0;
+
+    switch (div)
+    {
+        case 1:     bits = 0x0U; break;
+        case 2:     bits = 0x4U; break;
+        case 4:     bits = 0x5U; break;
+        case 8:     bits = 0x6U; break;
+        case 16:    bits = 0x7U; break;
+
+        default:
+        {
+            ECU_RUNTIME_ASSERT( (false), ECU_DEFAULT_FUNCTOR );
+            break;
+        }
+    }
+
+    return bits;
+}
+
+
+static void config_check(const struct clock_config *config)
+{
+    ECU_RUNTIME_ASSERT( (config), ECU_DEFAULT_FUNCTOR );
+
+    if (config->sysclk_source == CLOCK_SYSCLK_PLL)
+    {
+        uint32_t input = msi_hz(config->msi_range) / config->pll_m;
+        ECU_RUNTIME_ASSERT( ((config->pll_m >= 1U) && (config->pll_m <= 8U)), ECU_DEFAULT_FUNCTOR );
+        ECU_RUNTIME_ASSERT( ((config->pll_n >= 8U) && (config->pll_n <= 86U)), ECU_DEFAULT_FUNCTOR );
+        ECU_RUNTIME_ASSERT( ((config->pll_r >= 2U) && (config->pll_r <= 8U) && ((config->pll_r % 2U) == 0)), ECU_DEFAULT_FUNCTOR );
+        ECU_RUNTIME_ASSERT( ((input >= PLL_INPUT_MIN_HZ) && (input <= PLL_INPUT_MAX_HZ)), ECU_DEFAULT_FUNCTOR );
+        ECU_RUNTIME_ASSERT( (((input * config->pll_n) >= PLL_VCO_MIN_HZ) && ((input * config->pll_n) <= PLL_VCO_MAX_HZ)), ECU_DEFAULT_FUNCTOR );
+    }
+    else
+    {
+        ECU_RUNTIME_ASSERT( (config->sysclk_source == CLOCK_SYSCLK_MSI), ECU_DEFAULT_FUNCTOR );
+    }
+
+    /* SYSCLK runs from MSI while the PLL locks so MSI must be legal in the
+    target range too. */
+    ECU_RUNTIME_ASSERT( (clock_config_sysclk_hz(config) <= range_max_hz(config->voltage_range)), ECU_DEFAULT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (msi_hz(config->msi_range) <= range_max_hz(config->voltage_range)), ECU_DEFAULT_FUNCTOR );
+    (void)hpre_bits(config->ahb_div);
+    (void)ppre_bits(config->apb1_div);
+    (void)ppre_bits(config->apb2_div);
+}
+
+
+static enum clock_voltage_range voltage_range_get(void)
+{
+    return ((PWR->CR1 & PWR_CR1_VOS_MASK) == ((uint32_t)CLOCK_VOLTAGE_RANGE_2 << PWR_CR1_VOS_OFFSET)) ?
+           CLOCK_VOLTAGE_RANGE_2 : CLOCK_VOLTAGE_RANGE_1;
+}
+
+
+static void voltage_range_set(enum clock_voltage_range range)
+{
+    PWR->CR1 = (PWR->CR1 & ~PWR_CR1_VOS_MASK) | ((uint32_t)range << PWR_CR1_VOS_OFFSET);
+    do
+    {
+        STM32L432_POLL();
+    } while (PWR->SR2 & PWR_SR2_VOSF);
+}
+
+
+static uint32_t flash_latency_get(void)
+{
+    return FLASH->ACR & FLASH_ACR_LATENCY_MASK;
+}
+
+
+static void flash_latency_set(uint32_t latency)
+{
+    /* New wait states are only in effect once they read back. */
+    FLASH->ACR = (FLASH->ACR & ~FLASH_ACR_LATENCY_MASK) | latency;
+    do
+    {
+        STM32L432_POLL();
+    } while (flash_latency_get() != latency);
+}
+
+
+static void sysclk_switch(uint32_t sw, uint32_t sws)
+{
+    RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW_MASK) | sw;
+    do
+    {
+        STM32L432_POLL();
+    } while ((RCC->CFGR & RCC_CFGR_SWS_MASK) != sws);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void clock_init(const struct clock_config *config)
+{
+    enum clock_voltage_range range = CLOCK_VOLTAGE_RANGE_1;
+    uint32_t target_hclk = 0;
+    uint32_t target_latency = 0;
+    uint32_t transition_latency = 0;
+    config_check(config);
+
+    target_hclk = clock_config_sysclk_hz(config) / config->ahb_div;
+    target_latency = clock_flash_latency(config->voltage_range, target_hclk);
+
+    /* Step 1: Raise the voltage range if needed. PWR is clocked off APB1. */
+    RCC->APB1ENR1 |= RCC_APB1ENR1_PWREN;
+    (void)RCC->APB1ENR1;
+    range = voltage_range_get();
+    if (config->voltage_range < range) /* Range 1 is the higher one. */
+    {
+        voltage_range_set(config->voltage_range);
+        range = config->voltage_range;
+    }
+
+    /* Step 2: Enough wait states for the current clock, the MSI clock the
+    core runs on while the PLL locks and the target clock. The undivided
+    MSI frequency bounds HCLK during the transition. */
+    transition_latency = clock_flash_latency(range, msi_hz(config->msi_range));
+    transition_latency = (target_latency > transition_latency) ? target_latency : transition_latency;
+    transition_latency = (flash_latency_get() > transition_latency) ? flash_latency_get() : transition_latency;
+    flash_latency_set(transition_latency);
+
+    /* Step 3: Park SYSCLK on MSI and stop the PLL so both can be reprogrammed. */
+    if ((RCC->CFGR & RCC_CFGR_SWS_MASK) != RCC_CFGR_SWS_MSI)
+    {
+        sysclk_switch(RCC_CFGR_SW_MSI, RCC_CFGR_SWS_MSI);
+    }
+
+    if (RCC->CR & RCC_CR_PLLON)
+    {
+        RCC->CR &= ~RCC_CR_PLLON;
+        do
+        {
+            STM32L432_POLL();
+        } while (RCC->CR & RCC_CR_PLLRDY);
+    }
+
+    /* Step 4: MSIRANGE may only change while MSI is ready. */
+    do
+    {
+        STM32L432_POLL();
+    } while (!(RCC->CR & RCC_CR_MSIRDY));
+    RCC->CR = (RCC->CR & ~RCC_CR_MSIRANGE_MASK) | RCC_CR_MSIRGSEL |
+              ((uint32_t)config->msi_range << RCC_CR_MSIRANGE_OFFSET);
+    do
+    {
+        STM32L432_POLL();
+    } while (!(RCC->CR & RCC_CR_MSIRDY));
+
+    /* Step 5: Bus prescalers before the switch so HCLK never overshoots. */
+    RCC->CFGR = (RCC->CFGR & ~(RCC_CFGR_HPRE_MASK | RCC_CFGR_PPRE1_MASK | RCC_CFGR_PPRE2_MASK)) |
+                (hpre_bits(config->ahb_div) << RCC_CFGR_HPRE_OFFSET) |
+                (ppre_bits(config->apb1_div) << RCC_CFGR_PPRE1_OFFSET) |
+                (ppre_bits(config->apb2_div) << RCC_CFGR_PPRE2_OFFSET);
+
+    /* Step 6: Lock the PLL and switch to it. */
+    if (config->sysclk_source == CLOCK_SYSCLK_PLL)
+    {
+        RCC->PLLCFGR = RCC_PLLCFGR_PLLSRC_MSI | RCC_PLLCFGR_PLLREN |
+                       ((uint32_t)(config->pll_m - 1U) << RCC_PLLCFGR_PLLM_OFFSET) |
+                       ((uint32_t)config->pll_n << RCC_PLLCFGR_PLLN_OFFSET) |
+                       ((uint32_t)((config->pll_r / 2U) - 1U) << RCC_PLLCFGR_PLLR_OFFSET);
+        RCC->CR |= RCC_CR_PLLON;
+        do
+        {
+            STM32L432_POLL();
+        } while (!(RCC->CR & RCC_CR_PLLRDY));
+
+        sysclk_switch(RCC_CFGR_SW_PLL, RCC_CFGR_SWS_PLL);
+    }
+
+    /* Step 7: Drop to the target wait states and range now that the clock is final. */
+    FLASH->ACR = (FLASH->ACR & ~(FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN)) |
+                 ((config->prefetch) ? FLASH_ACR_PRFTEN : 0U) |
+                 ((config->icache) ? FLASH_ACR_ICEN : 0U) |
+                 ((config->dcache) ? FLASH_ACR_DCEN : 0U);
+    flash_latency_set(target_latency);
+
+    if (config->voltage_range != range)
+    {
+        voltage_range_set(config->voltage_range);
+    }
+
+    sysclk_hz = clock_config_sysclk_hz(config);
+    hclk_hz = target_hclk;
+    pclk1_hz = hclk_hz / config->apb1_div;
+    pclk2_hz = hclk_hz / config->apb2_div;
+    apb1_div = config->apb1_div;
+}
+
+
+uint32_t clock_config_sysclk_hz(const struct clock_config *config)
+{
+    uint32_t hz = 0;
+    ECU_RUNTIME_ASSERT( (config), ECU_DEFAULT_FUNCTOR );
+
+    hz = msi_hz(config->msi_range);
+    if (config->sysclk_source == CLOCK_SYSCLK_PLL)
+    {
+        ECU_RUNTIME_ASSERT( ((config->pll_m > 0) && (config->pll_r > 0)), ECU_DEFAULT_FUNCTOR );
+        hz = ((hz / config->pll_m) * config->pll_n) / config->pll_r;
+    }
+
+    return hz;
+}
+
+
+uint32_t clock_config_pclk1_hz(const struct clock_config *config)
+{
+    ECU_RUNTIME_ASSERT( (config && (config->ahb_div > 0) && (config->apb1_div > 0)), ECU_DEFAULT_FUNCTOR );
+    return (clock_config_sysclk_hz(config) / config->ahb_div) / config->apb1_div;
+}
+
+
+uint32_t clock_flash_latency(enum clock_voltage_range range, uint32_t hz)
+{
+    /* Upper HCLK bound of 0, 1, 2, 3 and 4 wait states. */
+    static const uint32_t range_1[] = { 16000000U, 32000000U, 48000000U, 64000000U, 80000000U };
+    static const uint32_t range_2[] = { 6000000U, 12000000U, 18000000U, 26000000U };
+
+    const uint32_t *table = (range == CLOCK_VOLTAGE_RANGE_2) ? range_2 : range_1;
+    uint32_t count = (range == CLOCK_VOLTAGE_RANGE_2) ? (sizeof(range_2) / sizeof(range_2[0])) :
+                                                        (sizeof(range_1) / sizeof(range_1[0]));
+    uint32_t latency = 0;
+
+    ECU_RUNTIME_ASSERT( (hz <= range_max_hz(range)), ECU_DEFAULT_FUNCTOR );
+    while ((latency < (count - 1U)) && (hz > table[latency]))
+    {
+        latency++;
+    }
+
+    return latency;
+}
+
+
+uint32_t clock_sysclk_hz(void)
+{
+    return sysclk_hz;
+}
+
+
+uint32_t clock_hclk_hz(void)
+{
+    return hclk_hz;
+}
+
+
+uint32_t clock_pclk1_hz(void)
+{
+    return pclk1_hz;
+}
+
+
+uint32_t clock_pclk2_hz(void)
+{
+    return pclk2_hz;
+}
+
+
+uint32_t clock_apb1_timer_hz(void)
+{
+    return (apb1_div == 1U) ? pclk1_hz : (2U * pclk1_hz);
+}
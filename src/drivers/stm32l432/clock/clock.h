@@ -0,0 +1,156 @@
+/**
+ * @file
+ * @brief Clock tree, flash wait state and voltage range setup. The board
+ * describes the clock tree it wants with a struct clock_config and
+ * @ref clock_init applies it in an order that is safe from any clock the
+ * core currently runs on:
+ *
+ * 1. Voltage range and flash wait states are raised before SYSCLK gets
+ *    faster and lowered only after it got slower.
+ * 2. SYSCLK is parked on MSI while MSI and the PLL are reprogrammed. The
+ *    PLL is only configured while it is off.
+ * 3. Prefetch, instruction cache and data cache are set last.
+ *
+ * Only MSI and PLL (sourced from MSI) are supported as SYSCLK. Reaching
+ * 80 MHz requires voltage range 1. Range 2 caps SYSCLK at 26 MHz.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- CLOCK DATA STRUCTURES -----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Values are the MSIRANGE field encodings.
+ */
+enum clock_msi_range
+{
+    CLOCK_MSI_100KHZ = 0,
+    CLOCK_MSI_200KHZ,
+    CLOCK_MSI_400KHZ,
+    CLOCK_MSI_800KHZ,
+    CLOCK_MSI_1MHZ,
+    CLOCK_MSI_2MHZ,
+    CLOCK_MSI_4MHZ,
+    CLOCK_MSI_8MHZ,
+    CLOCK_MSI_16MHZ,
+    CLOCK_MSI_24MHZ,
+    CLOCK_MSI_32MHZ,
+    CLOCK_MSI_48MHZ
+};
+
+
+enum clock_sysclk_source
+{
+    CLOCK_SYSCLK_MSI,
+    CLOCK_SYSCLK_PLL
+};
+
+
+/**
+ * @brief Values are the PWR_CR1 VOS field encodings.
+ */
+enum clock_voltage_range
+{
+    CLOCK_VOLTAGE_RANGE_1 = 1,      /* High performance. Up to 80 MHz. */
+    CLOCK_VOLTAGE_RANGE_2 = 2       /* Low power. Up to 26 MHz. */
+};
+
+
+struct clock_config
+{
+    enum clock_voltage_range voltage_range;
+    enum clock_msi_range msi_range;
+    enum clock_sysclk_source sysclk_source;
+
+    /* PLL. Only used if sysclk_source is CLOCK_SYSCLK_PLL.
+    SYSCLK = ((MSI / pll_m) * pll_n) / pll_r. */
+    uint8_t pll_m;                  /* 1 - 8. PLL input must be 4 - 16 MHz. */
+    uint8_t pll_n;                  /* 8 - 86. VCO must be 64 - 344 MHz. */
+    uint8_t pll_r;                  /* 2, 4, 6 or 8. */
+
+    /* Bus prescalers. HCLK = SYSCLK / ahb_div, PCLKx = HCLK / apbx_div. */
+    uint16_t ahb_div;               /* 1, 2, 4, 8, 16, 64, 128, 256 or 512. */
+    uint8_t apb1_div;               /* 1, 2, 4, 8 or 16. */
+    uint8_t apb2_div;               /* 1, 2, 4, 8 or 16. */
+
+    /* Flash accelerator. */
+    bool prefetch;
+    bool icache;
+    bool dcache;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Applies @p config. Can be called again at runtime to change
+ * the clock tree. Blocks until every clock it switched to is ready.
+ * Asserts if @p config is out of the limits listed in struct clock_config
+ * or SYSCLK is too fast for the voltage range.
+ */
+extern void clock_init(const struct clock_config *config);
+
+/**
+ * @brief SYSCLK @p config would produce. Does not touch hardware.
+ */
+extern uint32_t clock_config_sysclk_hz(const struct clock_config *config);
+
+/**
+ * @brief PCLK1 @p config would produce. Does not touch hardware.
+ */
+extern uint32_t clock_config_pclk1_hz(const struct clock_config *config);
+
+/**
+ * @brief Minimum flash wait states for an HCLK of @p hz in @p range.
+ * RM0394 table 9.
+ */
+extern uint32_t clock_flash_latency(enum clock_voltage_range range, uint32_t hz);
+
+/**
+ * @brief Frequencies set by the last @ref clock_init. The reset clock
+ * (4 MHz MSI, no prescalers) before that.
+ */
+extern uint32_t clock_sysclk_hz(void);
+extern uint32_t clock_hclk_hz(void);
+extern uint32_t clock_pclk1_hz(void);
+extern uint32_t clock_pclk2_hz(void);
+
+/**
+ * @brief Kernel clock of the APB1 timers (TIM2, TIM6, TIM7). Twice PCLK1
+ * if APB1 is divided.
+ */
+extern uint32_t clock_apb1_timer_hz(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLOCK_H_ */
@@ -0,0 +1,44 @@
+/**
+ * @file
+ * @brief See cycle_counter.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "cycle_counter/cycle_counter.h"
+
+/* STDLib. */
+#include <stdint.h>
+
+/* Register map. */
+#include "registers/registers.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void cycle_counter_init(void)
+{
+    /* DWT is powered down until trace is enabled. */
+    COREDEBUG->DEMCR |= COREDEBUG_DEMCR_TRCENA;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA;
+}
+
+
+uint32_t cycle_counter_get(void)
+{
+    return DWT->CYCCNT;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file
+ * @brief Free running core clock cycle counter (DWT CYCCNT). Counts HCLK
+ * cycles, so a count only converts to time at the clock it was taken at.
+ * Wraps every 2^32 cycles, 53 s at 80 MHz. Subtract unsigned counts to
+ * get elapsed cycles across the wrap.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef CYCLE_COUNTER_H_
+#define CYCLE_COUNTER_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern void cycle_counter_init(void);
+
+extern uint32_t cycle_counter_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CYCLE_COUNTER_H_ */
@@ -0,0 +1,242 @@
+/**
+ * @file
+ * @brief See exti.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "exti/exti.h"
+
+/* STDLib. */
+#include <stdint.h>
+
+/* Drivers. */
+#include "cycle_counter/cycle_counter.h"
+#include "gpio/gpio.h"
+#include "irq/irq.h"
+
+/* Register map. */
+#include "registers/registers.h"
+
+/* External libraries. ECU. */
+#include "ecu/asserter.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- FILE SCOPE DEFINES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define LINES                                   (16U)
+
+/**
+ * @brief Lines each handler services.
+ */
+#define LINES_9_5                               (0x03E0U)
+#define LINES_15_10                             (0xFC00U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint8_t line_irq(uint8_t line);
+static void lines_service(uint32_t cycles, uint32_t lines);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------- FILE SCOPE VARIABLES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void (*edge_fn)(uint8_t line, uint32_t cycles);
+
+/* Priority of the most urgent EXTI interrupt enabled, i.e. the owner of
+IMR1. 0 until the first line is set up. */
+static uint8_t imr_ceiling;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint8_t line_irq(uint8_t line)
+{
+    uint8_t irq = 0;
+    ECU_RUNTIME_ASSERT( (line < LINES), ECU_DEFAULT_FUNCTOR );
+
+    if (line <= 4U)
+    {
+        irq = (uint8_t)(NVIC_IRQ_EXTI0 + line);
+    }
+    else if (line <= 9U)
+    {
+        irq = NVIC_IRQ_EXTI9_5;
+    }
+    else
+    {
+        irq = NVIC_IRQ_EXTI15_10;
+    }
+
+    return irq;
+}
+
+
+static void lines_service(uint32_t cycles, uint32_t lines)
+{
+    uint32_t pending = EXTI->PR1 & EXTI->IMR1 & lines;
+
+    /* Mask before clearing so the bounces that follow only latch. Other
+    handlers have the same priority and the main loop changes IMR1 at this
+    priority, so this read-modify-write cannot be torn. */
+    EXTI->IMR1 &= ~pending;
+    EXTI->PR1 = pending;
+
+    for (uint8_t line = 0; pending != 0; line++)
+    {
+        if (pending & (1U << line))
+        {
+            pending &= ~(1U << line);
+            (*edge_fn)(line, cycles);
+        }
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC FUNCTIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void exti_init(void (*edge)(uint8_t line, uint32_t cycles))
+{
+    ECU_RUNTIME_ASSERT( (edge), ECU_DEFAULT_FUNCTOR );
+
+    edge_fn = edge;
+    imr_ceiling = 0;
+    RCC->APB2ENR |= RCC_APB2ENR_SYSCFGEN;
+
+    /* No line is enabled yet, so no handler touches IMR1. */
+    EXTI->IMR1 &= ~((1U << LINES) - 1U);
+    EXTI->RTSR1 &= ~((1U << LINES) - 1U);
+    EXTI->FTSR1 &= ~((1U << LINES) - 1U);
+    EXTI->PR1 = (1U << LINES) - 1U;
+}
+
+
+void exti_line_init(const struct gpio_pin *pin, uint32_t pull)
+{
+    uint32_t port = SYSCFG_EXTICR_PORTC;
+    uint32_t shift = 0;
+    uint32_t line_bit = 0;
+    uint8_t irq = 0;
+    uint8_t priority = 0;
+    uint32_t key = 0;
+    ECU_RUNTIME_ASSERT( (pin && (pin->pin < LINES) && edge_fn), ECU_DEFAULT_FUNCTOR );
+
+    /* irq_lock() asserts on priority 0, so a line left unconfigured shows
+    up here instead of in the first unmask. */
+    irq = line_irq(pin->pin);
+    priority = irq_priority_get(irq);
+    ECU_RUNTIME_ASSERT( (priority > 0), ECU_DEFAULT_FUNCTOR );
+    imr_ceiling = ((imr_ceiling == 0) || (priority < imr_ceiling)) ? priority : imr_ceiling;
+
+    gpio_input_init(pin, pull);
+    if (pin->port == GPIOA)
+    {
+        port = SYSCFG_EXTICR_PORTA;
+    }
+    else if (pin->port == GPIOB)
+    {
+        port = SYSCFG_EXTICR_PORTB;
+    }
+
+    shift = (pin->pin % 4U) * 4U;
+    SYSCFG->EXTICR[pin->pin / 4U] = (SYSCFG->EXTICR[pin->pin / 4U] & ~(SYSCFG_EXTICR_MASK << shift)) |
+                                    (port << shift);
+
+    /* Whatever latched while the line was routed elsewhere is stale. */
+    line_bit = 1U << pin->pin;
+    key = irq_lock(imr_ceiling);
+    EXTI->IMR1 &= ~line_bit;
+    irq_unlock(key);
+    EXTI->RTSR1 |= line_bit;
+    EXTI->FTSR1 |= line_bit;
+    EXTI->PR1 = line_bit;
+
+    NVIC->ISER[irq / 32U] = (1U << (irq % 32U));
+}
+
+
+void exti_pending_clear(uint8_t line)
+{
+    ECU_RUNTIME_ASSERT( (line < LINES), ECU_DEFAULT_FUNCTOR );
+    EXTI->PR1 = 1U << line;
+}
+
+
+void exti_unmask(uint8_t line)
+{
+    uint32_t key = 0;
+    ECU_RUNTIME_ASSERT( ((line < LINES) && (imr_ceiling > 0)), ECU_DEFAULT_FUNCTOR );
+
+    key = irq_lock(imr_ceiling);
+    EXTI->IMR1 |= 1U << line;
+    irq_unlock(key);
+}
+
+
+/* Read the cycle counter first thing. Everything after it is latency
+the timestamp does not see. */
+void exti0_isr_handler(void)
+{
+    lines_service(cycle_counter_get(), 1U << 0);
+}
+
+
+void exti1_isr_handler(void)
+{
+    lines_service(cycle_counter_get(), 1U << 1);
+}
+
+
+void exti2_isr_handler(void)
+{
+    lines_service(cycle_counter_get(), 1U << 2);
+}
+
+
+void exti3_isr_handler(void)
+{
+    lines_service(cycle_counter_get(), 1U << 3);
+}
+
+
+void exti4_isr_handler(void)
+{
+    lines_service(cycle_counter_get(), 1U << 4);
+}
+
+
+void exti_9_5_isr_handler(void)
+{
+    lines_service(cycle_counter_get(), LINES_9_5);
+}
+
+
+void exti15_10_isr_handler(void)
+{
+    lines_service(cycle_counter_get(), LINES_15_10);
+}
@@ -0,0 +1,98 @@
+/**
+ * @file
+ * @brief Edge interrupts on GPIO pins through EXTI lines 0 - 15. Line n
+ * belongs to pin n of whichever port it is routed to, so two pins with
+ * the same number cannot both be used.
+ *
+ * Every handler reads the cycle counter before anything else and passes
+ * that timestamp to the edge callback of each line it services. The
+ * timestamp therefore trails the edge by the interrupt entry latency,
+ * which is fixed, plus any time the handler waited behind a higher
+ * priority interrupt.
+ *
+ * A line is masked as its edge is reported so a bouncing contact costs
+ * one interrupt, not one per bounce. Edges keep latching in the pending
+ * register while a line is masked. Call @ref exti_pending_clear to
+ * discard them before sampling the pin, then @ref exti_unmask. An edge
+ * between the two is latched and reported as soon as the line is
+ * unmasked.
+ *
+ * Give every EXTI interrupt the same priority in the board's irq table,
+ * 1 or less urgent, so edge callbacks never preempt each other. Lines
+ * are masked and unmasked outside the handlers in critical sections at
+ * that priority, so more urgent interrupts are never held off by them.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef EXTI_H_
+#define EXTI_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdint.h>
+
+/* Drivers. */
+#include "gpio/gpio.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief @p edge runs in interrupt context once per reported edge with
+ * the line number and the cycle counter value taken on handler entry.
+ * The cycle counter must already be running. Lines start out disabled.
+ */
+extern void exti_init(void (*edge)(uint8_t line, uint32_t cycles));
+
+/**
+ * @brief Makes @p pin an input with pull @p pull (GPIO_PUPDR_XXX), routes
+ * it to its line and enables both edges. The line starts masked so the
+ * caller can sample the pin first. See @ref exti_unmask. The line's
+ * interrupt priority must already be set, see irq_init().
+ */
+extern void exti_line_init(const struct gpio_pin *pin, uint32_t pull);
+
+/**
+ * @brief Discards edges latched on @p line while it was masked.
+ */
+extern void exti_pending_clear(uint8_t line);
+
+/**
+ * @brief Reports edges on @p line again, starting with one latched since
+ * the last @ref exti_pending_clear.
+ */
+extern void exti_unmask(uint8_t line);
+
+/**
+ * @brief Override the weak handlers in the startup code's vector table.
+ */
+extern void exti0_isr_handler(void);
+extern void exti1_isr_handler(void);
+extern void exti2_isr_handler(void);
+extern void exti3_isr_handler(void);
+extern void exti4_isr_handler(void);
+extern void exti_9_5_isr_handler(void);
+extern void exti15_10_isr_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EXTI_H_ */
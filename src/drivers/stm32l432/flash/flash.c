@@ -0,0 +1,175 @@
+/**
+ * @file
+ * @brief See flash.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "flash/flash.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Register map. */
+#include "registers/registers.h"
+
+/* External libraries. ECU. */
+#include "ecu/asserter.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- FILE SCOPE DEFINES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define PAGE_COUNT                              (128U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------- FILE SCOPE VARIABLES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static volatile bool erasing;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- STATIC FUNCTION DECLARATIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void unlock(void);
+static void lock(void);
+static void wait_idle(void);
+static void data_cache_reset(void);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void unlock(void)
+{
+    if (FLASH->CR & FLASH_CR_LOCK)
+    {
+        FLASH->KEYR = FLASH_KEYR_KEY1;
+        FLASH->KEYR = FLASH_KEYR_KEY2;
+    }
+    ECU_RUNTIME_ASSERT( (!(FLASH->CR & FLASH_CR_LOCK)), ECU_DEFAULT_FUNCTOR );
+}
+
+
+static void lock(void)
+{
+    FLASH->CR |= FLASH_CR_LOCK;
+}
+
+
+static void wait_idle(void)
+{
+    do
+    {
+        STM32L432_POLL();
+    } while (FLASH->SR & FLASH_SR_BSY);
+}
+
+
+static void data_cache_reset(void)
+{
+    /* Lines cached before an erase would still read as the old data. */
+    if (FLASH->ACR & FLASH_ACR_DCEN)
+    {
+        FLASH->ACR &= ~FLASH_ACR_DCEN;
+        FLASH->ACR |= FLASH_ACR_DCRST;
+        FLASH->ACR &= ~FLASH_ACR_DCRST;
+        FLASH->ACR |= FLASH_ACR_DCEN;
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC FUNCTIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void flash_init(void)
+{
+    erasing = false;
+    NVIC->ISER[NVIC_IRQ_FLASH / 32U] = (1U << (NVIC_IRQ_FLASH % 32U));
+}
+
+
+bool flash_program(uintptr_t address, const void *data, uint32_t len)
+{
+    const uint8_t *src = (const uint8_t *)data;
+    uint32_t words[2];
+    uint32_t errors = 0;
+    ECU_RUNTIME_ASSERT( (data && !erasing), ECU_DEFAULT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (((address % FLASH_DOUBLE_WORD_SIZE) == 0) && ((len % FLASH_DOUBLE_WORD_SIZE) == 0)), ECU_DEFAULT_FUNCTOR );
+
+    wait_idle();
+    unlock();
+    FLASH->SR = FLASH_SR_EOP | FLASH_SR_ERRORS;
+    FLASH->CR |= FLASH_CR_PG;
+
+    /* Two word writes back to back make one double word program. data
+    need not be aligned. */
+    for (uint32_t i = 0; (i < len) && !errors; i += FLASH_DOUBLE_WORD_SIZE)
+    {
+        memcpy(words, &src[i], sizeof(words));
+        ((volatile uint32_t *)(address + i))[0] = words[0];
+        ((volatile uint32_t *)(address + i))[1] = words[1];
+        wait_idle();
+        errors = FLASH->SR & FLASH_SR_ERRORS;
+    }
+
+    FLASH->SR = FLASH_SR_EOP | FLASH_SR_ERRORS;
+    FLASH->CR &= ~FLASH_CR_PG;
+    lock();
+    return (errors == 0);
+}
+
+
+void flash_page_erase_start(uint32_t page)
+{
+    ECU_RUNTIME_ASSERT( ((page < PAGE_COUNT) && !erasing), ECU_DEFAULT_FUNCTOR );
+
+    wait_idle();
+    unlock();
+    FLASH->SR = FLASH_SR_EOP | FLASH_SR_ERRORS;
+    erasing = true;
+    FLASH->CR = (FLASH->CR & ~FLASH_CR_PNB_MASK) | (page << FLASH_CR_PNB_OFFSET) |
+                FLASH_CR_PER | FLASH_CR_EOPIE | FLASH_CR_ERRIE;
+    FLASH->CR |= FLASH_CR_STRT;
+}
+
+
+bool flash_busy(void)
+{
+    return erasing;
+}
+
+
+void flash_isr_handler(void)
+{
+    /* Done or failed. Either way the erase is over. Callers verify the
+    page reads back erased. */
+    FLASH->SR = FLASH_SR_EOP | FLASH_SR_ERRORS;
+    FLASH->CR &= ~(FLASH_CR_PER | FLASH_CR_PNB_MASK | FLASH_CR_EOPIE | FLASH_CR_ERRIE);
+    lock();
+    data_cache_reset();
+    erasing = false;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file
+ * @brief Programs and erases the internal flash. Programming is done in
+ * 64-bit double words and waits for completion. A double word can only be
+ * programmed once between erases. Page erase is started here and finished
+ * by @ref flash_isr_handler, so the caller does not spin for the ~22 ms
+ * it takes.
+ *
+ * The L432 has a single flash bank. While an erase or a program runs the
+ * core stalls on every fetch from flash, so only code and data in SRAM
+ * make progress. Not spinning means the main loop is not held up between
+ * its flash accesses, not that it runs at full speed: it stalls on its
+ * next fetch for the rest of the erase, up to 24.5 ms. Interrupts stay
+ * enabled. The startup code moves the vector table to SRAM, so handlers
+ * in SRAM (STM32L432_RAMFUNC) run during the erase, which is how the
+ * watchdog is kept fed (see watchdog.h). Every other handler runs once
+ * the erase is over.
+ *
+ * Not interrupt safe. One operation at a time.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef FLASH_H_
+#define FLASH_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- DEFINES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define FLASH_BASE_ADDRESS                      (0x08000000U)
+#define FLASH_PAGE_SIZE                         (2048U)
+#define FLASH_DOUBLE_WORD_SIZE                  (8U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern void flash_init(void);
+
+/**
+ * @brief Programs @p len bytes from @p data at @p address. Both @p address
+ * and @p len must be multiples of FLASH_DOUBLE_WORD_SIZE and the double
+ * words must be erased. Returns false if the flash reported an error.
+ */
+extern bool flash_program(uintptr_t address, const void *data, uint32_t len);
+
+/**
+ * @brief Starts erasing page @p page (address FLASH_BASE_ADDRESS +
+ * page * FLASH_PAGE_SIZE) and returns. @ref flash_busy stays true until
+ * it is done.
+ */
+extern void flash_page_erase_start(uint32_t page);
+
+extern bool flash_busy(void);
+
+/**
+ * @brief Overrides the weak handler in the startup code's vector table.
+ */
+extern void flash_isr_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLASH_H_ */
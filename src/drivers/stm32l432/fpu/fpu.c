@@ -0,0 +1,37 @@
+/**
+ * @file
+ * @brief See fpu.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "fpu/fpu.h"
+
+/* Register map. */
+#include "registers/registers.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void fpu_enable(void)
+{
+    SCB->CPACR |= SCB_CPACR_CP10_CP11_FULL;
+    FPU->FPCCR |= (FPU_FPCCR_ASPEN | FPU_FPCCR_LSPEN);
+
+    /* CPACR write must complete before the next instruction could be an FP one. */
+    STM32L432_DSB();
+    STM32L432_ISB();
+}
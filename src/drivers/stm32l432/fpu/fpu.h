@@ -0,0 +1,38 @@
+/**
+ * @file
+ * @brief Cortex-M4 FPU enable. Must run before the first floating point
+ * instruction, which is why the startup code calls it before anything
+ * else. Lazy stacking is turned on so exceptions only save the FP
+ * context if the interrupted code and the handler both used the FPU.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef FPU_H_
+#define FPU_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Grants full access to CP10 and CP11 and enables automatic
+ * plus lazy FP context stacking.
+ */
+extern void fpu_enable(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FPU_H_ */
@@ -0,0 +1,152 @@
+/**
+ * @file
+ * @brief See gpio.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "gpio/gpio.h"
+
+/* Register map. */
+#include "registers/registers.h"
+
+/* External libraries. ECU. */
+#include "ecu/asserter.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------- STATIC FUNCTION DECLARATIONS - CHECKS ---------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static bool is_valid(const struct gpio_pin *me);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- STATIC FUNCTION DECLARATIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void port_clock_enable(const struct gpio_pin *me);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------- STATIC FUNCTION DEFINITIONS - CHECKS ---------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static bool is_valid(const struct gpio_pin *me)
+{
+    return ((me) && (me->port) && (me->pin < 16U));
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void port_clock_enable(const struct gpio_pin *me)
+{
+    ECU_RUNTIME_ASSERT( (is_valid(me)), ECU_DEFAULT_FUNCTOR );
+
+    if (me->port == GPIOA)
+    {
+        RCC->AHB2ENR |= RCC_AHB2ENR_GPIOAEN;
+    }
+    else if (me->port == GPIOB)
+    {
+        RCC->AHB2ENR |= RCC_AHB2ENR_GPIOBEN;
+    }
+    else
+    {
+        RCC->AHB2ENR |= RCC_AHB2ENR_GPIOCEN;
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void gpio_output_init(const struct gpio_pin *me, bool level)
+{
+    ECU_RUNTIME_ASSERT( (is_valid(me)), ECU_DEFAULT_FUNCTOR );
+    port_clock_enable(me);
+
+    /* Latch the level before switching to output so the pin never glitches. */
+    gpio_write(me, level);
+    me->port->OTYPER &= ~(1U << me->pin);
+    gpio_mode_set(me, GPIO_MODER_OUTPUT);
+}
+
+
+void gpio_input_init(const struct gpio_pin *me, uint32_t pull)
+{
+    uint32_t shift = 0;
+    ECU_RUNTIME_ASSERT( (is_valid(me) && (pull <= GPIO_PUPDR_PULL_DOWN)), ECU_DEFAULT_FUNCTOR );
+    port_clock_enable(me);
+
+    /* Pull first so the input never floats once it is read. */
+    shift = me->pin * 2U;
+    me->port->PUPDR = (me->port->PUPDR & ~(0x3U << shift)) | (pull << shift);
+    gpio_mode_set(me, GPIO_MODER_INPUT);
+}
+
+
+void gpio_af_init(const struct gpio_pin *me, uint8_t af)
+{
+    ECU_RUNTIME_ASSERT( (is_valid(me)), ECU_DEFAULT_FUNCTOR );
+    port_clock_enable(me);
+
+    /* Select the function before handing the pin over to it. */
+    me->port->OTYPER &= ~(1U << me->pin);
+    gpio_af_select(me, af);
+    gpio_mode_set(me, GPIO_MODER_ALTERNATE);
+}
+
+
+void gpio_write(const struct gpio_pin *me, bool level)
+{
+    ECU_RUNTIME_ASSERT( (is_valid(me)), ECU_DEFAULT_FUNCTOR );
+    me->port->BSRR = (level) ? (1U << me->pin) : (1U << (me->pin + 16U));
+}
+
+
+bool gpio_read(const struct gpio_pin *me)
+{
+    ECU_RUNTIME_ASSERT( (is_valid(me)), ECU_DEFAULT_FUNCTOR );
+    return ((me->port->IDR & (1U << me->pin)) != 0);
+}
+
+
+void gpio_af_select(const struct gpio_pin *me, uint8_t af)
+{
+    uint32_t shift = 0;
+    ECU_RUNTIME_ASSERT( (is_valid(me) && (af < 16U)), ECU_DEFAULT_FUNCTOR );
+
+    shift = (me->pin % 8U) * 4U;
+    me->port->AFR[me->pin / 8U] = (me->port->AFR[me->pin / 8U] & ~(0xFU << shift)) |
+                                  ((uint32_t)af << shift);
+}
+
+
+void gpio_mode_set(const struct gpio_pin *me, uint32_t mode)
+{
+    uint32_t shift = 0;
+    ECU_RUNTIME_ASSERT( (is_valid(me) && (mode <= GPIO_MODER_ANALOG)), ECU_DEFAULT_FUNCTOR );
+
+    shift = me->pin * 2U;
+    me->port->MODER = (me->port->MODER & ~(0x3U << shift)) | (mode << shift);
+}
@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief Minimal GPIO driver for STM32L432. Pins are identified by a
+ * port and pin number so boards can describe their wiring in one
+ * const table.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef GPIO_H_
+#define GPIO_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Register map. */
+#include "registers/registers.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------- GPIO DATA STRUCTURES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct gpio_pin
+{
+    struct stm32l432_gpio_regs *port;
+    uint8_t pin; /* 0 - 15. */
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Enables the port clock and configures the pin as a push-pull
+ * output driven to @p level.
+ */
+extern void gpio_output_init(const struct gpio_pin *me, bool level);
+
+/**
+ * @brief Enables the port clock and configures the pin as an input with
+ * pull @p pull. Use GPIO_PUPDR_XXX values.
+ */
+extern void gpio_input_init(const struct gpio_pin *me, uint32_t pull);
+
+/**
+ * @brief Enables the port clock and hands the pin over to push-pull
+ * alternate function @p af (0 - 15).
+ */
+extern void gpio_af_init(const struct gpio_pin *me, uint8_t af);
+
+/**
+ * @brief Atomically drives the output latch of the pin. Takes effect on the
+ * pin only while it is in output mode.
+ */
+extern void gpio_write(const struct gpio_pin *me, bool level);
+
+/**
+ * @brief Returns the level currently on the pin. Valid in every mode,
+ * including alternate function mode.
+ */
+extern bool gpio_read(const struct gpio_pin *me);
+
+/**
+ * @brief Selects alternate function @p af (0 - 15) for the pin. Does not
+ * change the pin mode. See @ref gpio_mode_set.
+ */
+extern void gpio_af_select(const struct gpio_pin *me, uint8_t af);
+
+/**
+ * @brief Sets the pin mode. Use GPIO_MODER_XXX values.
+ */
+extern void gpio_mode_set(const struct gpio_pin *me, uint32_t mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GPIO_H_ */
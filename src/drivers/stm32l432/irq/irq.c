@@ -0,0 +1,231 @@
+/**
+ * @file
+ * @brief See irq.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "irq/irq.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Drivers. */
+#include "cycle_counter/cycle_counter.h"
+
+/* Register map. */
+#include "registers/registers.h"
+
+/* External libraries. ECU. */
+#include "ecu/asserter.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- STATIC ASSERTS -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+ECU_STATIC_ASSERT( (IRQ_PRIORITY_LOWEST == ((1U << NVIC_PRIORITY_BITS) - 1U)) );
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------- FILE SCOPE VARIABLES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Only touched with BASEPRI raised by the outermost section. Sections
+cannot overlap, so these need no protection of their own. */
+static uint32_t lock_start;
+static uint8_t lock_ceiling;
+static struct irq_stats stats;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- STATIC FUNCTION DECLARATIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void priority_set(int16_t irq, uint8_t priority);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void priority_set(int16_t irq, uint8_t priority)
+{
+    uint32_t value = (uint32_t)priority << NVIC_PRIORITY_SHIFT;
+
+    switch (irq)
+    {
+        case IRQ_SYSTICK:
+        {
+            SCB->SHPR[2] = (SCB->SHPR[2] & ~(0xFFU << SCB_SHPR3_SYSTICK_OFFSET)) |
+                           (value << SCB_SHPR3_SYSTICK_OFFSET);
+            break;
+        }
+
+        case IRQ_PENDSV:
+        {
+            SCB->SHPR[2] = (SCB->SHPR[2] & ~(0xFFU << SCB_SHPR3_PENDSV_OFFSET)) |
+                           (value << SCB_SHPR3_PENDSV_OFFSET);
+            break;
+        }
+
+        default:
+        {
+            ECU_RUNTIME_ASSERT( ((irq >= 0) && ((uint32_t)irq < sizeof(NVIC->IP))), ECU_DEFAULT_FUNCTOR );
+            NVIC->IP[irq] = (uint8_t)value;
+            break;
+        }
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC FUNCTIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void irq_init(const struct irq_priority *table, uint8_t count)
+{
+    ECU_RUNTIME_ASSERT( (table || (count == 0)), ECU_DEFAULT_FUNCTOR );
+
+    SCB->AIRCR = SCB_AIRCR_VECTKEY | SCB_AIRCR_PRIGROUP_PREEMPT_ONLY |
+                 (SCB->AIRCR & ~(SCB_AIRCR_VECTKEY_MASK | SCB_AIRCR_PRIGROUP_MASK));
+
+    /* Bytes of interrupts this part does not have ignore writes. */
+    for (uint32_t i = 0; i < sizeof(NVIC->IP); i++)
+    {
+        NVIC->IP[i] = (uint8_t)(IRQ_PRIORITY_LOWEST << NVIC_PRIORITY_SHIFT);
+    }
+    priority_set(IRQ_SYSTICK, IRQ_PRIORITY_LOWEST);
+    priority_set(IRQ_PENDSV, IRQ_PRIORITY_LOWEST);
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        ECU_RUNTIME_ASSERT( (table[i].priority <= IRQ_PRIORITY_LOWEST), ECU_DEFAULT_FUNCTOR );
+        for (uint8_t j = 0; j < i; j++)
+        {
+            ECU_RUNTIME_ASSERT( (table[j].irq != table[i].irq), ECU_DEFAULT_FUNCTOR );
+        }
+
+        priority_set(table[i].irq, table[i].priority);
+    }
+
+    irq_stats_reset();
+}
+
+
+uint8_t irq_priority_get(int16_t irq)
+{
+    uint32_t value = 0;
+
+    switch (irq)
+    {
+        case IRQ_SYSTICK:
+        {
+            value = SCB->SHPR[2] >> SCB_SHPR3_SYSTICK_OFFSET;
+            break;
+        }
+
+        case IRQ_PENDSV:
+        {
+            value = SCB->SHPR[2] >> SCB_SHPR3_PENDSV_OFFSET;
+            break;
+        }
+
+        default:
+        {
+            ECU_RUNTIME_ASSERT( ((irq >= 0) && ((uint32_t)irq < sizeof(NVIC->IP))), ECU_DEFAULT_FUNCTOR );
+            value = NVIC->IP[irq];
+            break;
+        }
+    }
+
+    return (uint8_t)((value & 0xFFU) >> NVIC_PRIORITY_SHIFT);
+}
+
+
+uint32_t irq_lock(uint8_t ceiling)
+{
+    uint32_t key = 0;
+    ECU_RUNTIME_ASSERT( ((ceiling > 0) && (ceiling <= IRQ_PRIORITY_LOWEST)), ECU_DEFAULT_FUNCTOR );
+
+    /* A handler that runs between the read and the raise leaves BASEPRI
+    as it found it. */
+    STM32L432_BASEPRI_GET(key);
+    STM32L432_BASEPRI_MAX_SET((uint32_t)ceiling << NVIC_PRIORITY_SHIFT);
+
+    if (key == 0)
+    {
+        lock_start = cycle_counter_get();
+        lock_ceiling = ceiling;
+        stats.locks++;
+    }
+
+    return key;
+}
+
+
+void irq_unlock(uint32_t key)
+{
+    uint32_t elapsed = 0;
+
+    /* Measured before lowering BASEPRI, so nothing it held off can run
+    in between. */
+    if (key == 0)
+    {
+        elapsed = cycle_counter_get() - lock_start;
+        if (elapsed > stats.masked_max_cycles)
+        {
+            stats.masked_max_cycles = elapsed;
+            stats.masked_max_ceiling = lock_ceiling;
+        }
+    }
+
+    STM32L432_BASEPRI_SET(key);
+}
+
+
+bool irq_is_masked(int16_t irq)
+{
+    uint32_t basepri = 0;
+
+    STM32L432_BASEPRI_GET(basepri);
+    basepri = (basepri & 0xFFU) >> NVIC_PRIORITY_SHIFT;
+    return (basepri != 0) && (irq_priority_get(irq) >= basepri);
+}
+
+
+const struct irq_stats *irq_stats(void)
+{
+    return &stats;
+}
+
+
+void irq_stats_reset(void)
+{
+    uint32_t key = 0;
+
+    /* Holds off every handler that can take a section, without counting
+    as one. A section open right now is still measured when it ends. */
+    STM32L432_BASEPRI_GET(key);
+    STM32L432_BASEPRI_MAX_SET(1U << NVIC_PRIORITY_SHIFT);
+    stats.locks = 0;
+    stats.masked_max_cycles = 0;
+    stats.masked_max_ceiling = 0;
+    STM32L432_BASEPRI_SET(key);
+}
@@ -0,0 +1,129 @@
+/**
+ * @file
+ * @brief Interrupt priorities and critical sections. @ref irq_init gives
+ * every interrupt its priority from one board table, so which handler may
+ * preempt which is decided in one place.
+ *
+ * Critical sections raise BASEPRI to the priority of the data's owner,
+ * i.e. the most urgent interrupt that touches the data, instead of
+ * disabling every interrupt. Interrupts more urgent than the owner still
+ * run inside the section. Sections nest. An inner one never lowers the
+ * level an outer one set.
+ *
+ *     uint32_t key = irq_lock(owner_priority);
+ *     ...
+ *     irq_unlock(key);
+ *
+ * Sections must be released in the reverse order they were taken, also
+ * across handlers. Priority 0 cannot be masked this way, so level 0 is for
+ * handlers that share nothing with a less urgent one.
+ *
+ * The longest outermost section is recorded in cycle counter cycles, so
+ * the cycle counter must be running before the first lock. Cycles convert
+ * to time at the clock the section ran at.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef IRQ_H_
+#define IRQ_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- DEFINES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Priorities 0 (most urgent) to IRQ_PRIORITY_LOWEST. Interrupts
+ * left out of the board table get IRQ_PRIORITY_LOWEST.
+ */
+#define IRQ_PRIORITY_LOWEST                     (15U)
+
+/**
+ * @brief System handlers that take a priority. Device interrupts use
+ * their NVIC_IRQ_XXX number.
+ */
+#define IRQ_SYSTICK                             (-1)
+#define IRQ_PENDSV                              (-2)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- IRQ DATA STRUCTURES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct irq_priority
+{
+    int16_t irq;                    /* NVIC_IRQ_XXX or IRQ_SYSTICK / IRQ_PENDSV. */
+    uint8_t priority;
+};
+
+
+struct irq_stats
+{
+    uint32_t locks;                 /* Outermost sections taken. */
+    uint32_t masked_max_cycles;     /* Longest outermost section. */
+    uint8_t masked_max_ceiling;     /* Priority it was taken at. */
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Makes every priority bit preemption priority, sets every
+ * interrupt to IRQ_PRIORITY_LOWEST, then applies @p table. Call before
+ * enabling any interrupt. Each interrupt may appear once.
+ */
+extern void irq_init(const struct irq_priority *table, uint8_t count);
+
+extern uint8_t irq_priority_get(int16_t irq);
+
+/**
+ * @brief Holds off every interrupt with a priority of @p ceiling or less
+ * urgent. Returns the key @ref irq_unlock needs. @p ceiling must be 1 to
+ * IRQ_PRIORITY_LOWEST.
+ */
+extern uint32_t irq_lock(uint8_t ceiling);
+
+/**
+ * @brief Ends the section @p key was returned for.
+ */
+extern void irq_unlock(uint32_t key);
+
+/**
+ * @brief True if @p irq could not preempt right now because a section
+ * holds it off.
+ */
+extern bool irq_is_masked(int16_t irq);
+
+extern const struct irq_stats *irq_stats(void);
+
+extern void irq_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IRQ_H_ */
@@ -0,0 +1,827 @@
+/**
+ * @file
+ * @brief Memory-mapped register layouts and peripheral instances for STM32L432.
+ * Only the peripherals our drivers use are described. Register offsets follow
+ * RM0394 and are checked with static asserts below.
+ *
+ * Defining STM32L432_MOCK_REGISTERS (host builds) points every peripheral
+ * instance at a plain RAM struct defined in registers_mock.c instead of its
+ * hardware address. Drivers are compiled unchanged and their register writes
+ * can be inspected on host. Note that mocked registers do not react to writes,
+ * so status flags a driver polls on (i.e. ready bits) must be preset by whoever
+ * drives the mock, or emulated by a poll hook. Drivers call STM32L432_POLL()
+ * every time they spin on a status flag, at least once per wait so every wait
+ * is a point the host can inspect. It compiles to nothing on target and
+ * calls the hook installed with stm32l432_mock_poll_hook_set() on host, which
+ * can update status registers the way hardware would and check the register
+ * sequence the driver wrote so far.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef STM32L432_REGISTERS_H_
+#define STM32L432_REGISTERS_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stddef.h> /* offsetof */
+#include <stdint.h>
+
+/* ECU. */
+#include "ecu/asserter.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- REGISTER MAPS -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct stm32l432_gpio_regs
+{
+    volatile uint32_t MODER;        /* 0x00. */
+    volatile uint32_t OTYPER;       /* 0x04. */
+    volatile uint32_t OSPEEDR;      /* 0x08. */
+    volatile uint32_t PUPDR;        /* 0x0C. */
+    volatile uint32_t IDR;          /* 0x10. */
+    volatile uint32_t ODR;          /* 0x14. */
+    volatile uint32_t BSRR;         /* 0x18. */
+    volatile uint32_t LCKR;         /* 0x1C. */
+    volatile uint32_t AFR[2];       /* 0x20. AFRL, AFRH. */
+    volatile uint32_t BRR;          /* 0x28. */
+};
+
+
+struct stm32l432_rcc_regs
+{
+    volatile uint32_t CR;           /* 0x00. */
+    volatile uint32_t ICSCR;        /* 0x04. */
+    volatile uint32_t CFGR;         /* 0x08. */
+    volatile uint32_t PLLCFGR;      /* 0x0C. */
+    volatile uint32_t PLLSAI1CFGR;  /* 0x10. */
+    uint32_t RESERVED0;             /* 0x14. */
+    volatile uint32_t CIER;         /* 0x18. */
+    volatile uint32_t CIFR;         /* 0x1C. */
+    volatile uint32_t CICR;         /* 0x20. */
+    uint32_t RESERVED1;             /* 0x24. */
+    volatile uint32_t AHB1RSTR;     /* 0x28. */
+    volatile uint32_t AHB2RSTR;     /* 0x2C. */
+    volatile uint32_t AHB3RSTR;     /* 0x30. */
+    uint32_t RESERVED2;             /* 0x34. */
+    volatile uint32_t APB1RSTR1;    /* 0x38. */
+    volatile uint32_t APB1RSTR2;    /* 0x3C. */
+    volatile uint32_t APB2RSTR;     /* 0x40. */
+    uint32_t RESERVED3;             /* 0x44. */
+    volatile uint32_t AHB1ENR;      /* 0x48. */
+    volatile uint32_t AHB2ENR;      /* 0x4C. */
+    volatile uint32_t AHB3ENR;      /* 0x50. */
+    uint32_t RESERVED4;             /* 0x54. */
+    volatile uint32_t APB1ENR1;     /* 0x58. */
+    volatile uint32_t APB1ENR2;     /* 0x5C. */
+    volatile uint32_t APB2ENR;      /* 0x60. */
+    uint32_t RESERVED5;             /* 0x64. */
+    volatile uint32_t AHB1SMENR;    /* 0x68. */
+    volatile uint32_t AHB2SMENR;    /* 0x6C. */
+    volatile uint32_t AHB3SMENR;    /* 0x70. */
+    uint32_t RESERVED6;             /* 0x74. */
+    volatile uint32_t APB1SMENR1;   /* 0x78. */
+    volatile uint32_t APB1SMENR2;   /* 0x7C. */
+    volatile uint32_t APB2SMENR;    /* 0x80. */
+    uint32_t RESERVED7;             /* 0x84. */
+    volatile uint32_t CCIPR;        /* 0x88. */
+    uint32_t RESERVED8;             /* 0x8C. */
+    volatile uint32_t BDCR;         /* 0x90. */
+    volatile uint32_t CSR;          /* 0x94. */
+    volatile uint32_t CRRCR;        /* 0x98. */
+    volatile uint32_t CCIPR2;       /* 0x9C. */
+};
+
+
+/**
+ * @brief General purpose timer. TIM2 (32-bit counter) and TIM15/16
+ * share this layout. Registers a timer does not implement read as 0.
+ */
+struct stm32l432_tim_regs
+{
+    volatile uint32_t CR1;          /* 0x00. */
+    volatile uint32_t CR2;          /* 0x04. */
+    volatile uint32_t SMCR;         /* 0x08. */
+    volatile uint32_t DIER;         /* 0x0C. */
+    volatile uint32_t SR;           /* 0x10. */
+    volatile uint32_t EGR;          /* 0x14. */
+    volatile uint32_t CCMR[2];      /* 0x18. CCMR1, CCMR2. */
+    volatile uint32_t CCER;         /* 0x20. */
+    volatile uint32_t CNT;          /* 0x24. */
+    volatile uint32_t PSC;          /* 0x28. */
+    volatile uint32_t ARR;          /* 0x2C. */
+    volatile uint32_t RCR;          /* 0x30. */
+    volatile uint32_t CCR[4];       /* 0x34. CCR1 - CCR4. */
+    volatile uint32_t BDTR;         /* 0x44. */
+    volatile uint32_t DCR;          /* 0x48. */
+    volatile uint32_t DMAR;         /* 0x4C. */
+    volatile uint32_t OR1;          /* 0x50. */
+};
+
+
+struct stm32l432_flash_regs
+{
+    volatile uint32_t ACR;          /* 0x00. */
+    volatile uint32_t PDKEYR;       /* 0x04. */
+    volatile uint32_t KEYR;         /* 0x08. */
+    volatile uint32_t OPTKEYR;      /* 0x0C. */
+    volatile uint32_t SR;           /* 0x10. */
+    volatile uint32_t CR;           /* 0x14. */
+    volatile uint32_t ECCR;         /* 0x18. */
+    uint32_t RESERVED0;             /* 0x1C. */
+    volatile uint32_t OPTR;         /* 0x20. */
+    volatile uint32_t PCROP1SR;     /* 0x24. */
+    volatile uint32_t PCROP1ER;     /* 0x28. */
+    volatile uint32_t WRP1AR;       /* 0x2C. */
+    volatile uint32_t WRP1BR;       /* 0x30. */
+};
+
+
+struct stm32l432_pwr_regs
+{
+    volatile uint32_t CR1;          /* 0x00. */
+    volatile uint32_t CR2;          /* 0x04. */
+    volatile uint32_t CR3;          /* 0x08. */
+    volatile uint32_t CR4;          /* 0x0C. */
+    volatile uint32_t SR1;          /* 0x10. */
+    volatile uint32_t SR2;          /* 0x14. */
+    volatile uint32_t SCR;          /* 0x18. */
+};
+
+
+/**
+ * @brief Cortex-M4 system control block. CPACR is the only register
+ * past the fault status registers we use.
+ */
+struct stm32l432_scb_regs
+{
+    volatile uint32_t CPUID;        /* 0x00. */
+    volatile uint32_t ICSR;         /* 0x04. */
+    volatile uint32_t VTOR;         /* 0x08. */
+    volatile uint32_t AIRCR;        /* 0x0C. */
+    volatile uint32_t SCR;          /* 0x10. */
+    volatile uint32_t CCR;          /* 0x14. */
+    volatile uint32_t SHPR[3];      /* 0x18. SHPR1 - SHPR3. */
+    volatile uint32_t SHCSR;        /* 0x24. */
+    volatile uint32_t CFSR;         /* 0x28. */
+    volatile uint32_t HFSR;         /* 0x2C. */
+    volatile uint32_t DFSR;         /* 0x30. */
+    volatile uint32_t MMFAR;        /* 0x34. */
+    volatile uint32_t BFAR;         /* 0x38. */
+    volatile uint32_t AFSR;         /* 0x3C. */
+    uint32_t RESERVED0[18];         /* 0x40. Processor feature registers. */
+    volatile uint32_t CPACR;        /* 0x88. */
+};
+
+
+/**
+ * @brief Cortex-M4 floating point context control. Starts at FPCCR.
+ */
+struct stm32l432_fpu_regs
+{
+    volatile uint32_t FPCCR;        /* 0x00. */
+    volatile uint32_t FPCAR;        /* 0x04. */
+    volatile uint32_t FPDSCR;       /* 0x08. */
+};
+
+
+/**
+ * @brief Cortex-M4 debug exception and monitor control. Starts at DHCSR.
+ */
+struct stm32l432_coredebug_regs
+{
+    volatile uint32_t DHCSR;        /* 0x00. */
+    volatile uint32_t DCRSR;        /* 0x04. */
+    volatile uint32_t DCRDR;        /* 0x08. */
+    volatile uint32_t DEMCR;        /* 0x0C. */
+};
+
+
+/**
+ * @brief Cortex-M4 data watchpoint and trace unit. Only the cycle counter
+ * is described.
+ */
+struct stm32l432_dwt_regs
+{
+    volatile uint32_t CTRL;         /* 0x00. */
+    volatile uint32_t CYCCNT;       /* 0x04. */
+};
+
+
+struct stm32l432_systick_regs
+{
+    volatile uint32_t CTRL;         /* 0x00. */
+    volatile uint32_t LOAD;         /* 0x04. */
+    volatile uint32_t VAL;          /* 0x08. */
+    volatile uint32_t CALIB;        /* 0x0C. */
+};
+
+
+/**
+ * @brief Cortex-M4 nested vectored interrupt controller. Starts at ISER0.
+ */
+struct stm32l432_nvic_regs
+{
+    volatile uint32_t ISER[8];      /* 0x000. */
+    uint32_t RESERVED0[24];
+    volatile uint32_t ICER[8];      /* 0x080. */
+    uint32_t RESERVED1[24];
+    volatile uint32_t ISPR[8];      /* 0x100. */
+    uint32_t RESERVED2[24];
+    volatile uint32_t ICPR[8];      /* 0x180. */
+    uint32_t RESERVED3[24];
+    volatile uint32_t IABR[8];      /* 0x200. */
+    uint32_t RESERVED4[56];
+    volatile uint8_t IP[240];       /* 0x300. One byte per interrupt. */
+};
+
+
+struct stm32l432_wwdg_regs
+{
+    volatile uint32_t CR;           /* 0x00. */
+    volatile uint32_t CFR;          /* 0x04. */
+    volatile uint32_t SR;           /* 0x08. */
+};
+
+
+struct stm32l432_usart_regs
+{
+    volatile uint32_t CR1;          /* 0x00. */
+    volatile uint32_t CR2;          /* 0x04. */
+    volatile uint32_t CR3;          /* 0x08. */
+    volatile uint32_t BRR;          /* 0x0C. */
+    volatile uint32_t GTPR;         /* 0x10. */
+    volatile uint32_t RTOR;         /* 0x14. */
+    volatile uint32_t RQR;          /* 0x18. */
+    volatile uint32_t ISR;          /* 0x1C. */
+    volatile uint32_t ICR;          /* 0x20. */
+    volatile uint32_t RDR;          /* 0x24. */
+    volatile uint32_t TDR;          /* 0x28. */
+};
+
+
+struct stm32l432_dma_channel_regs
+{
+    volatile uint32_t CCR;          /* 0x00. */
+    volatile uint32_t CNDTR;        /* 0x04. */
+    volatile uint32_t CPAR;         /* 0x08. */
+    volatile uint32_t CMAR;         /* 0x0C. */
+    uint32_t RESERVED0;             /* 0x10. */
+};
+
+
+/**
+ * @brief CH[0] is channel 1.
+ */
+struct stm32l432_dma_regs
+{
+    volatile uint32_t ISR;          /* 0x00. */
+    volatile uint32_t IFCR;         /* 0x04. */
+    struct stm32l432_dma_channel_regs CH[7];    /* 0x08. */
+    uint32_t RESERVED0[5];          /* 0x94. */
+    volatile uint32_t CSELR;        /* 0xA8. */
+};
+
+
+/**
+ * @brief Lines 0 - 15 are the GPIO pins routed by SYSCFG. Only the first
+ * bank of registers is described.
+ */
+struct stm32l432_exti_regs
+{
+    volatile uint32_t IMR1;         /* 0x00. */
+    volatile uint32_t EMR1;         /* 0x04. */
+    volatile uint32_t RTSR1;        /* 0x08. */
+    volatile uint32_t FTSR1;        /* 0x0C. */
+    volatile uint32_t SWIER1;       /* 0x10. */
+    volatile uint32_t PR1;          /* 0x14. Write 1 to clear. */
+};
+
+
+struct stm32l432_syscfg_regs
+{
+    volatile uint32_t MEMRMP;       /* 0x00. */
+    volatile uint32_t CFGR1;        /* 0x04. */
+    volatile uint32_t EXTICR[4];    /* 0x08. EXTICR1 - EXTICR4. */
+    volatile uint32_t SCSR;         /* 0x18. */
+    volatile uint32_t CFGR2;        /* 0x1C. */
+    volatile uint32_t SWPR;         /* 0x20. */
+    volatile uint32_t SKR;          /* 0x24. */
+};
+
+
+struct stm32l432_can_tx_mailbox_regs
+{
+    volatile uint32_t TIR;          /* 0x00. */
+    volatile uint32_t TDTR;         /* 0x04. */
+    volatile uint32_t TDLR;         /* 0x08. */
+    volatile uint32_t TDHR;         /* 0x0C. */
+};
+
+
+struct stm32l432_can_rx_mailbox_regs
+{
+    volatile uint32_t RIR;          /* 0x00. */
+    volatile uint32_t RDTR;         /* 0x04. */
+    volatile uint32_t RDLR;         /* 0x08. */
+    volatile uint32_t RDHR;         /* 0x0C. */
+};
+
+
+struct stm32l432_can_filter_regs
+{
+    volatile uint32_t FR1;          /* 0x00. */
+    volatile uint32_t FR2;          /* 0x04. */
+};
+
+
+/**
+ * @brief bxCAN. RX[n] is the output mailbox of FIFO n. FILTER[n] is
+ * filter bank n. Filter registers only take writes while FMR.FINIT is set.
+ */
+struct stm32l432_can_regs
+{
+    volatile uint32_t MCR;          /* 0x000. */
+    volatile uint32_t MSR;          /* 0x004. */
+    volatile uint32_t TSR;          /* 0x008. */
+    volatile uint32_t RF0R;         /* 0x00C. */
+    volatile uint32_t RF1R;         /* 0x010. */
+    volatile uint32_t IER;          /* 0x014. */
+    volatile uint32_t ESR;          /* 0x018. */
+    volatile uint32_t BTR;          /* 0x01C. */
+    uint32_t RESERVED0[88];         /* 0x020. */
+    struct stm32l432_can_tx_mailbox_regs TX[3];     /* 0x180. */
+    struct stm32l432_can_rx_mailbox_regs RX[2];     /* 0x1B0. */
+    uint32_t RESERVED1[12];         /* 0x1D0. */
+    volatile uint32_t FMR;          /* 0x200. */
+    volatile uint32_t FM1R;         /* 0x204. */
+    uint32_t RESERVED2;             /* 0x208. */
+    volatile uint32_t FS1R;         /* 0x20C. */
+    uint32_t RESERVED3;             /* 0x210. */
+    volatile uint32_t FFA1R;        /* 0x214. */
+    uint32_t RESERVED4;             /* 0x218. */
+    volatile uint32_t FA1R;         /* 0x21C. */
+    uint32_t RESERVED5[8];          /* 0x220. */
+    struct stm32l432_can_filter_regs FILTER[14];    /* 0x240. */
+};
+
+
+/**
+ * @brief Debug MCU. Freezes peripherals while the core is halted.
+ */
+struct stm32l432_dbgmcu_regs
+{
+    volatile uint32_t IDCODE;       /* 0x00. */
+    volatile uint32_t CR;           /* 0x04. */
+    volatile uint32_t APB1FZR1;     /* 0x08. */
+    volatile uint32_t APB1FZR2;     /* 0x0C. */
+    volatile uint32_t APB2FZR;      /* 0x10. */
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- STATIC ASSERTS -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_gpio_regs, BRR) == 0x28) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_rcc_regs, AHB2ENR) == 0x4C) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_rcc_regs, APB1ENR1) == 0x58) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_rcc_regs, CCIPR2) == 0x9C) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_tim_regs, CCR) == 0x34) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_tim_regs, OR1) == 0x50) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_flash_regs, OPTR) == 0x20) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_flash_regs, WRP1BR) == 0x30) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_pwr_regs, SCR) == 0x18) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_scb_regs, AFSR) == 0x3C) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_scb_regs, CPACR) == 0x88) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_fpu_regs, FPDSCR) == 0x08) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_systick_regs, CALIB) == 0x0C) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_coredebug_regs, DEMCR) == 0x0C) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_dwt_regs, CYCCNT) == 0x04) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_nvic_regs, ICER) == 0x080) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_nvic_regs, IABR) == 0x200) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_nvic_regs, IP) == 0x300) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_wwdg_regs, SR) == 0x08) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_dbgmcu_regs, APB2FZR) == 0x10) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_usart_regs, TDR) == 0x28) );
+ECU_STATIC_ASSERT( (sizeof(struct stm32l432_dma_channel_regs) == 0x14) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_dma_regs, CSELR) == 0xA8) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_exti_regs, PR1) == 0x14) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_syscfg_regs, SKR) == 0x24) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_can_regs, TX) == 0x180) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_can_regs, RX) == 0x1B0) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_can_regs, FMR) == 0x200) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_can_regs, FA1R) == 0x21C) );
+ECU_STATIC_ASSERT( (offsetof(struct stm32l432_can_regs, FILTER) == 0x240) );
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- BIT DEFINITIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* GPIO. Two bit fields per pin in MODER. */
+#define GPIO_MODER_INPUT                        (0x0U)
+#define GPIO_MODER_OUTPUT                       (0x1U)
+#define GPIO_MODER_ALTERNATE                    (0x2U)
+#define GPIO_MODER_ANALOG                       (0x3U)
+
+/* GPIO. Two bit fields per pin in PUPDR. */
+#define GPIO_PUPDR_NONE                         (0x0U)
+#define GPIO_PUPDR_PULL_UP                      (0x1U)
+#define GPIO_PUPDR_PULL_DOWN                    (0x2U)
+
+/* RCC. */
+#define RCC_CR_MSION                            (1U << 0)
+#define RCC_CR_MSIRDY                           (1U << 1)
+#define RCC_CR_MSIRGSEL                         (1U << 3)
+#define RCC_CR_MSIRANGE_OFFSET                  (4U)
+#define RCC_CR_MSIRANGE_MASK                    (0xFU << RCC_CR_MSIRANGE_OFFSET)
+#define RCC_CR_HSION                            (1U << 8)
+#define RCC_CR_HSIRDY                           (1U << 10)
+#define RCC_CR_PLLON                            (1U << 24)
+#define RCC_CR_PLLRDY                           (1U << 25)
+#define RCC_CFGR_SW_MASK                        (0x3U << 0)
+#define RCC_CFGR_SW_MSI                         (0x0U << 0)
+#define RCC_CFGR_SW_PLL                         (0x3U << 0)
+#define RCC_CFGR_SWS_MASK                       (0x3U << 2)
+#define RCC_CFGR_SWS_MSI                        (0x0U << 2)
+#define RCC_CFGR_SWS_PLL                        (0x3U << 2)
+#define RCC_CFGR_HPRE_OFFSET                    (4U)
+#define RCC_CFGR_HPRE_MASK                      (0xFU << RCC_CFGR_HPRE_OFFSET)
+#define RCC_CFGR_PPRE1_OFFSET                   (8U)
+#define RCC_CFGR_PPRE1_MASK                     (0x7U << RCC_CFGR_PPRE1_OFFSET)
+#define RCC_CFGR_PPRE2_OFFSET                   (11U)
+#define RCC_CFGR_PPRE2_MASK                     (0x7U << RCC_CFGR_PPRE2_OFFSET)
+#define RCC_PLLCFGR_PLLSRC_MASK                 (0x3U << 0)
+#define RCC_PLLCFGR_PLLSRC_MSI                  (0x1U << 0)
+#define RCC_PLLCFGR_PLLM_OFFSET                 (4U)        /* Divider - 1. */
+#define RCC_PLLCFGR_PLLM_MASK                   (0x7U << RCC_PLLCFGR_PLLM_OFFSET)
+#define RCC_PLLCFGR_PLLN_OFFSET                 (8U)
+#define RCC_PLLCFGR_PLLN_MASK                   (0x7FU << RCC_PLLCFGR_PLLN_OFFSET)
+#define RCC_PLLCFGR_PLLREN                      (1U << 24)
+#define RCC_PLLCFGR_PLLR_OFFSET                 (25U)       /* (Divider / 2) - 1. */
+#define RCC_PLLCFGR_PLLR_MASK                   (0x3U << RCC_PLLCFGR_PLLR_OFFSET)
+#define RCC_AHB1ENR_DMA1EN                      (1U << 0)
+#define RCC_AHB2ENR_GPIOAEN                     (1U << 0)
+#define RCC_AHB2ENR_GPIOBEN                     (1U << 1)
+#define RCC_AHB2ENR_GPIOCEN                     (1U << 2)
+#define RCC_AHB2ENR_GPIOHEN                     (1U << 7)
+#define RCC_APB1ENR1_TIM2EN                     (1U << 0)
+#define RCC_APB1ENR1_WWDGEN                     (1U << 11)
+#define RCC_APB1ENR1_USART2EN                   (1U << 17)
+#define RCC_APB1ENR1_CAN1EN                     (1U << 25)
+#define RCC_APB1ENR1_PWREN                      (1U << 28)
+#define RCC_APB2ENR_SYSCFGEN                    (1U << 0)
+
+#define RCC_CCIPR_USART2SEL_OFFSET              (2U)
+#define RCC_CCIPR_USART2SEL_MASK                (0x3U << RCC_CCIPR_USART2SEL_OFFSET)
+#define RCC_CCIPR_USART2SEL_HSI16               (0x2U << RCC_CCIPR_USART2SEL_OFFSET)
+
+/* FLASH. */
+#define FLASH_ACR_LATENCY_MASK                  (0x7U << 0)
+#define FLASH_ACR_PRFTEN                        (1U << 8)
+#define FLASH_ACR_ICEN                          (1U << 9)
+#define FLASH_ACR_DCEN                          (1U << 10)
+#define FLASH_ACR_DCRST                         (1U << 12)
+#define FLASH_KEYR_KEY1                         (0x45670123U)
+#define FLASH_KEYR_KEY2                         (0xCDEF89ABU)
+#define FLASH_SR_EOP                            (1U << 0)
+#define FLASH_SR_ERRORS                         (0xC3FAU)
+#define FLASH_SR_BSY                            (1U << 16)
+#define FLASH_CR_PG                             (1U << 0)
+#define FLASH_CR_PER                            (1U << 1)
+#define FLASH_CR_PNB_OFFSET                     (3U)
+#define FLASH_CR_PNB_MASK                       (0xFFU << FLASH_CR_PNB_OFFSET)
+#define FLASH_CR_STRT                           (1U << 16)
+#define FLASH_CR_EOPIE                          (1U << 24)
+#define FLASH_CR_ERRIE                          (1U << 25)
+#define FLASH_CR_LOCK                           (1U << 31)
+
+/* PWR. VOS field holds the voltage range number. */
+#define PWR_CR1_VOS_OFFSET                      (9U)
+#define PWR_CR1_VOS_MASK                        (0x3U << PWR_CR1_VOS_OFFSET)
+#define PWR_SR2_VOSF                            (1U << 10)
+
+/* SCB. Full access to coprocessors 10 and 11 (the FPU). */
+#define SCB_CPACR_CP10_CP11_FULL                (0xFU << 20)
+
+/* SCB. AIRCR writes are ignored without the key. PRIGROUP 3 makes all
+four implemented priority bits preemption priority. */
+#define SCB_AIRCR_VECTKEY                       (0x05FAU << 16)
+#define SCB_AIRCR_VECTKEY_MASK                  (0xFFFFU << 16)
+#define SCB_AIRCR_PRIGROUP_OFFSET               (8U)
+#define SCB_AIRCR_PRIGROUP_MASK                 (0x7U << SCB_AIRCR_PRIGROUP_OFFSET)
+#define SCB_AIRCR_PRIGROUP_PREEMPT_ONLY         (0x3U << SCB_AIRCR_PRIGROUP_OFFSET)
+
+/* SCB. System handler priority bytes in SHPR3 (SHPR[2]). */
+#define SCB_SHPR3_PENDSV_OFFSET                 (16U)
+#define SCB_SHPR3_SYSTICK_OFFSET                (24U)
+
+/* FPU. */
+#define FPU_FPCCR_LSPEN                         (1U << 30)
+#define FPU_FPCCR_ASPEN                         (1U << 31)
+
+/* SysTick. */
+#define SYSTICK_CTRL_ENABLE                     (1U << 0)
+#define SYSTICK_CTRL_TICKINT                    (1U << 1)
+#define SYSTICK_CTRL_CLKSOURCE                  (1U << 2)   /* Processor clock (HCLK). */
+#define SYSTICK_LOAD_MAX                        (0x00FFFFFFU)
+
+/* Debug and trace. */
+#define COREDEBUG_DEMCR_TRCENA                  (1U << 24)
+#define DWT_CTRL_CYCCNTENA                      (1U << 0)
+
+/* NVIC. Only the top four bits of each priority byte are implemented.
+BASEPRI uses the same encoding. */
+#define NVIC_PRIORITY_BITS                      (4U)
+#define NVIC_PRIORITY_SHIFT                     (8U - NVIC_PRIORITY_BITS)
+
+/* NVIC. Interrupt numbers (vector table position - 16). */
+#define NVIC_IRQ_WWDG                           (0U)
+#define NVIC_IRQ_FLASH                          (4U)
+#define NVIC_IRQ_EXTI0                          (6U)        /* EXTI1 - EXTI4 follow. */
+#define NVIC_IRQ_DMA1_CH7                       (17U)
+#define NVIC_IRQ_CAN1_TX                        (19U)
+#define NVIC_IRQ_CAN1_RX0                       (20U)
+#define NVIC_IRQ_CAN1_RX1                       (21U)
+#define NVIC_IRQ_CAN1_SCE                       (22U)
+#define NVIC_IRQ_EXTI9_5                        (23U)
+#define NVIC_IRQ_USART2                         (38U)
+#define NVIC_IRQ_EXTI15_10                      (40U)
+
+/* SYSCFG. Four bits per line in EXTICR, four lines per register. */
+#define SYSCFG_EXTICR_PORTA                     (0x0U)
+#define SYSCFG_EXTICR_PORTB                     (0x1U)
+#define SYSCFG_EXTICR_PORTC                     (0x2U)
+#define SYSCFG_EXTICR_MASK                      (0xFU)
+
+/* WWDG. The counter resets the MCU when it decrements from 0x40 to 0x3F. */
+#define WWDG_CR_T_MASK                          (0x7FU << 0)
+#define WWDG_CR_T_MIN                           (0x40U)
+#define WWDG_CR_WDGA                            (1U << 7)
+#define WWDG_CFR_W_MASK                         (0x7FU << 0)
+#define WWDG_CFR_WDGTB_OFFSET                   (7U)        /* Prescaler is 2^WDGTB. */
+#define WWDG_CFR_WDGTB_MASK                     (0x3U << WWDG_CFR_WDGTB_OFFSET)
+#define WWDG_CFR_EWI                            (1U << 9)
+#define WWDG_SR_EWIF                            (1U << 0)
+
+/* USART. */
+#define USART_CR1_UE                            (1U << 0)
+#define USART_CR1_RE                            (1U << 2)
+#define USART_CR1_TE                            (1U << 3)
+#define USART_CR1_CMIE                          (1U << 14)
+#define USART_CR2_ADD_OFFSET                    (24U)
+#define USART_CR2_ADD_MASK                      (0xFFU << USART_CR2_ADD_OFFSET)
+#define USART_CR3_EIE                           (1U << 0)
+#define USART_CR3_DMAR                          (1U << 6)
+#define USART_CR3_DMAT                          (1U << 7)
+#define USART_CR3_OVRDIS                        (1U << 12)
+#define USART_ISR_ORE                           (1U << 3)
+#define USART_ISR_TC                            (1U << 6)
+#define USART_ISR_CMF                           (1U << 17)
+#define USART_ICR_ORECF                         (1U << 3)
+#define USART_ICR_CMCF                          (1U << 17)
+
+/* DMA. Four flag bits per channel in ISR and IFCR, channel 1 first. */
+#define DMA_CCR_EN                              (1U << 0)
+#define DMA_CCR_TCIE                            (1U << 1)
+#define DMA_CCR_DIR_FROM_MEMORY                 (1U << 4)
+#define DMA_CCR_CIRC                            (1U << 5)
+#define DMA_CCR_MINC                            (1U << 7)
+#define DMA_ISR_TCIF(ch)                        (1U << ((((ch) - 1U) * 4U) + 1U))
+#define DMA_IFCR_CGIF(ch)                       (1U << (((ch) - 1U) * 4U))
+#define DMA_CSELR_OFFSET(ch)                    (((ch) - 1U) * 4U)
+#define DMA_CSELR_MASK(ch)                      (0xFU << DMA_CSELR_OFFSET(ch))
+
+/* DBGMCU. */
+#define DBGMCU_APB1FZR1_DBG_WWDG_STOP           (1U << 11)
+
+/* CAN. RFR is RF0R or RF1R. TSR keeps eight bits per TX mailbox, mailbox 0
+first. */
+#define CAN_MCR_INRQ                            (1U << 0)
+#define CAN_MCR_SLEEP                           (1U << 1)
+#define CAN_MCR_TXFP                            (1U << 2)
+#define CAN_MCR_ABOM                            (1U << 6)
+#define CAN_MSR_INAK                            (1U << 0)
+#define CAN_MSR_SLAK                            (1U << 1)
+#define CAN_MSR_ERRI                            (1U << 2)
+#define CAN_TSR_RQCP(mb)                        (1U << ((mb) * 8U))
+#define CAN_TSR_TXOK(mb)                        (1U << (((mb) * 8U) + 1U))
+#define CAN_TSR_CODE_OFFSET                     (24U)
+#define CAN_TSR_CODE_MASK                       (0x3U << CAN_TSR_CODE_OFFSET)
+#define CAN_TSR_TME_MASK                        (0x7U << 26)
+#define CAN_RFR_FMP_MASK                        (0x3U << 0)
+#define CAN_RFR_FULL                            (1U << 3)
+#define CAN_RFR_FOVR                            (1U << 4)
+#define CAN_RFR_RFOM                            (1U << 5)
+#define CAN_IER_TMEIE                           (1U << 0)
+#define CAN_IER_FMPIE0                          (1U << 1)
+#define CAN_IER_FOVIE0                          (1U << 3)
+#define CAN_IER_FMPIE1                          (1U << 4)
+#define CAN_IER_FOVIE1                          (1U << 6)
+#define CAN_IER_EPVIE                           (1U << 9)
+#define CAN_IER_BOFIE                           (1U << 10)
+#define CAN_IER_ERRIE                           (1U << 15)
+#define CAN_ESR_EPVF                            (1U << 1)
+#define CAN_ESR_BOFF                            (1U << 2)
+#define CAN_BTR_BRP_MAX                         (1024U)
+#define CAN_BTR_TS1_OFFSET                      (16U)       /* Segment - 1. */
+#define CAN_BTR_TS2_OFFSET                      (20U)       /* Segment - 1. */
+#define CAN_BTR_SJW_OFFSET                      (24U)       /* Jump width - 1. */
+#define CAN_TDTR_DLC_MASK                       (0xFU << 0)
+#define CAN_RDTR_DLC_MASK                       (0xFU << 0)
+#define CAN_RDTR_FMI_OFFSET                     (8U)
+#define CAN_RDTR_FMI_MASK                       (0xFFU << CAN_RDTR_FMI_OFFSET)
+#define CAN_FMR_FINIT                           (1U << 0)
+
+/* CAN identifier registers (TIR, RIR) and 32-bit filters share one layout.
+16-bit filters keep the standard ID in bits 15-5, RTR in 4, IDE in 3 and
+extended ID bits 17-15 in 2-0. */
+#define CAN_IR_TXRQ                             (1U << 0)
+#define CAN_IR_RTR                              (1U << 1)
+#define CAN_IR_IDE                              (1U << 2)
+#define CAN_IR_EXID_OFFSET                      (3U)
+#define CAN_IR_STID_OFFSET                      (21U)
+#define CAN_FILTER16_RTR                        (1U << 4)
+#define CAN_FILTER16_IDE                        (1U << 3)
+#define CAN_FILTER16_STID_OFFSET                (5U)
+
+/* TIM. */
+#define TIM_CR1_CEN                             (1U << 0)
+#define TIM_CR1_ARPE                            (1U << 7)
+#define TIM_EGR_UG                              (1U << 0)
+
+/* Output compare mode field (OCxM) values. Field is 3 bits at offset 4
+within each 8-bit half of CCMRx. Bit 3 of OCxM lives in bit 16 and is 0
+for every mode used here. */
+#define TIM_OCM_FORCE_INACTIVE                  (0x4U)
+#define TIM_OCM_FORCE_ACTIVE                    (0x5U)
+#define TIM_OCM_TOGGLE                          (0x3U)
+#define TIM_OCM_MASK                            (0x7U)
+#define TIM_OCM_OFFSET                          (4U)
+
+/* Four bits per channel in CCER. */
+#define TIM_CCER_CCE                            (1U << 0)
+#define TIM_CCER_CCP                            (1U << 1)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------- PERIPHERAL INSTANCES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#if defined(STM32L432_MOCK_REGISTERS)
+
+extern struct stm32l432_gpio_regs stm32l432_mock_gpioa;
+extern struct stm32l432_gpio_regs stm32l432_mock_gpiob;
+extern struct stm32l432_gpio_regs stm32l432_mock_gpioc;
+extern struct stm32l432_rcc_regs stm32l432_mock_rcc;
+extern struct stm32l432_tim_regs stm32l432_mock_tim2;
+extern struct stm32l432_flash_regs stm32l432_mock_flash;
+extern struct stm32l432_pwr_regs stm32l432_mock_pwr;
+extern struct stm32l432_scb_regs stm32l432_mock_scb;
+extern struct stm32l432_fpu_regs stm32l432_mock_fpu;
+extern struct stm32l432_systick_regs stm32l432_mock_systick;
+extern struct stm32l432_coredebug_regs stm32l432_mock_coredebug;
+extern struct stm32l432_dwt_regs stm32l432_mock_dwt;
+extern struct stm32l432_nvic_regs stm32l432_mock_nvic;
+extern struct stm32l432_wwdg_regs stm32l432_mock_wwdg;
+extern struct stm32l432_dbgmcu_regs stm32l432_mock_dbgmcu;
+extern struct stm32l432_usart_regs stm32l432_mock_usart2;
+extern struct stm32l432_dma_regs stm32l432_mock_dma1;
+extern struct stm32l432_exti_regs stm32l432_mock_exti;
+extern struct stm32l432_syscfg_regs stm32l432_mock_syscfg;
+extern struct stm32l432_can_regs stm32l432_mock_can1;
+extern volatile uint32_t stm32l432_mock_basepri;
+
+#define GPIOA                                   (&stm32l432_mock_gpioa)
+#define GPIOB                                   (&stm32l432_mock_gpiob)
+#define GPIOC                                   (&stm32l432_mock_gpioc)
+#define RCC                                     (&stm32l432_mock_rcc)
+#define TIM2                                    (&stm32l432_mock_tim2)
+#define FLASH                                   (&stm32l432_mock_flash)
+#define PWR                                     (&stm32l432_mock_pwr)
+#define SCB                                     (&stm32l432_mock_scb)
+#define FPU                                     (&stm32l432_mock_fpu)
+#define SYSTICK                                 (&stm32l432_mock_systick)
+#define COREDEBUG                               (&stm32l432_mock_coredebug)
+#define DWT                                     (&stm32l432_mock_dwt)
+#define NVIC                                    (&stm32l432_mock_nvic)
+#define WWDG                                    (&stm32l432_mock_wwdg)
+#define DBGMCU                                  (&stm32l432_mock_dbgmcu)
+#define USART2                                  (&stm32l432_mock_usart2)
+#define DMA1                                    (&stm32l432_mock_dma1)
+#define EXTI                                    (&stm32l432_mock_exti)
+#define SYSCFG                                  (&stm32l432_mock_syscfg)
+#define CAN1                                    (&stm32l432_mock_can1)
+
+/* Barriers mean nothing to the host. Host tools call handlers from one
+thread. BASEPRI is a plain variable tools can read to check what a
+handler called now would be allowed to preempt. All code runs from host
+memory, so RAMFUNC places nothing. */
+#define STM32L432_POLL()                        stm32l432_mock_poll()
+#define STM32L432_DSB()                         do { } while (0)
+#define STM32L432_ISB()                         do { } while (0)
+#define STM32L432_BASEPRI_GET(value)            do { (value) = stm32l432_mock_basepri; } while (0)
+#define STM32L432_BASEPRI_SET(value)            do { stm32l432_mock_basepri = (value); } while (0)
+#define STM32L432_BASEPRI_MAX_SET(value)        stm32l432_mock_basepri_max_set(value)
+#define STM32L432_RAMFUNC
+
+#else
+
+#define GPIOA                                   ((struct stm32l432_gpio_regs *)0x48000000UL)
+#define GPIOB                                   ((struct stm32l432_gpio_regs *)0x48000400UL)
+#define GPIOC                                   ((struct stm32l432_gpio_regs *)0x48000800UL)
+#define RCC                                     ((struct stm32l432_rcc_regs *)0x40021000UL)
+#define TIM2                                    ((struct stm32l432_tim_regs *)0x40000000UL)
+#define FLASH                                   ((struct stm32l432_flash_regs *)0x40022000UL)
+#define PWR                                     ((struct stm32l432_pwr_regs *)0x40007000UL)
+#define SCB                                     ((struct stm32l432_scb_regs *)0xE000ED00UL)
+#define FPU                                     ((struct stm32l432_fpu_regs *)0xE000EF34UL)
+#define SYSTICK                                 ((struct stm32l432_systick_regs *)0xE000E010UL)
+#define COREDEBUG                               ((struct stm32l432_coredebug_regs *)0xE000EDF0UL)
+#define DWT                                     ((struct stm32l432_dwt_regs *)0xE0001000UL)
+#define NVIC                                    ((struct stm32l432_nvic_regs *)0xE000E100UL)
+#define WWDG                                    ((struct stm32l432_wwdg_regs *)0x40002C00UL)
+#define DBGMCU                                  ((struct stm32l432_dbgmcu_regs *)0xE0042000UL)
+#define USART2                                  ((struct stm32l432_usart_regs *)0x40004400UL)
+#define DMA1                                    ((struct stm32l432_dma_regs *)0x40020000UL)
+#define EXTI                                    ((struct stm32l432_exti_regs *)0x40010400UL)
+#define SYSCFG                                  ((struct stm32l432_syscfg_regs *)0x40010000UL)
+#define CAN1                                    ((struct stm32l432_can_regs *)0x40006400UL)
+
+#define STM32L432_POLL()                        do { } while (0)
+#define STM32L432_DSB()                         __asm volatile ("dsb 0xF" ::: "memory")
+#define STM32L432_ISB()                         __asm volatile ("isb 0xF" ::: "memory")
+
+/* Interrupts with a priority value at or above BASEPRI are held off.
+0 masks nothing. BASEPRI_MAX only ever raises the level. */
+#define STM32L432_BASEPRI_GET(value)            __asm volatile ("mrs %0, basepri" : "=r" (value) :: "memory")
+#define STM32L432_BASEPRI_SET(value)            __asm volatile ("msr basepri, %0" :: "r" (value) : "memory")
+#define STM32L432_BASEPRI_MAX_SET(value)        __asm volatile ("msr basepri_max, %0" :: "r" (value) : "memory")
+
+/* Function copied to SRAM1 with .data at startup (see the linker script),
+so it keeps running while a flash erase stalls fetches from flash. Long
+call, as SRAM is out of range of a BL from flash. */
+#define STM32L432_RAMFUNC                       __attribute__((section(".ramfunc"), noinline, long_call))
+
+#endif /* STM32L432_MOCK_REGISTERS */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC FUNCTIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#if defined(STM32L432_MOCK_REGISTERS)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Host builds only. Loads every mocked register with its
+ * RM0394 reset value.
+ */
+extern void stm32l432_mock_registers_reset(void);
+
+/**
+ * @brief Host builds only. Installs a function STM32L432_POLL() calls
+ * while a driver spins on a status flag. Null removes it. Not cleared
+ * by stm32l432_mock_registers_reset().
+ */
+extern void stm32l432_mock_poll_hook_set(void (*hook)(void));
+
+/**
+ * @brief Host builds only. What STM32L432_POLL() expands to.
+ */
+extern void stm32l432_mock_poll(void);
+
+/**
+ * @brief Host builds only. What STM32L432_BASEPRI_MAX_SET() expands to.
+ * Like the instruction, only writes @p value if it is non-zero and masks
+ * more than the current BASEPRI.
+ */
+extern void stm32l432_mock_basepri_max_set(uint32_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32L432_MOCK_REGISTERS */
+
+#endif /* STM32L432_REGISTERS_H_ */
@@ -0,0 +1,161 @@
+/**
+ * @file
+ * @brief Host-side backing storage for mocked STM32L432 registers. Only
+ * compiled into host builds that define STM32L432_MOCK_REGISTERS. See
+ * registers.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "registers/registers.h"
+
+/* STDLib. */
+#include <string.h> /* memset */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- STATIC ASSERTS -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#if !defined(STM32L432_MOCK_REGISTERS)
+#error "registers_mock.c must only be compiled for host builds that define STM32L432_MOCK_REGISTERS."
+#endif
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ MOCK REGISTER INSTANCES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct stm32l432_gpio_regs stm32l432_mock_gpioa;
+struct stm32l432_gpio_regs stm32l432_mock_gpiob;
+struct stm32l432_gpio_regs stm32l432_mock_gpioc;
+struct stm32l432_rcc_regs stm32l432_mock_rcc;
+struct stm32l432_tim_regs stm32l432_mock_tim2;
+struct stm32l432_flash_regs stm32l432_mock_flash;
+struct stm32l432_pwr_regs stm32l432_mock_pwr;
+struct stm32l432_scb_regs stm32l432_mock_scb;
+struct stm32l432_fpu_regs stm32l432_mock_fpu;
+struct stm32l432_systick_regs stm32l432_mock_systick;
+struct stm32l432_coredebug_regs stm32l432_mock_coredebug;
+struct stm32l432_dwt_regs stm32l432_mock_dwt;
+struct stm32l432_nvic_regs stm32l432_mock_nvic;
+struct stm32l432_wwdg_regs stm32l432_mock_wwdg;
+struct stm32l432_dbgmcu_regs stm32l432_mock_dbgmcu;
+struct stm32l432_usart_regs stm32l432_mock_usart2;
+struct stm32l432_dma_regs stm32l432_mock_dma1;
+struct stm32l432_exti_regs stm32l432_mock_exti;
+struct stm32l432_syscfg_regs stm32l432_mock_syscfg;
+struct stm32l432_can_regs stm32l432_mock_can1;
+volatile uint32_t stm32l432_mock_basepri;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void (*poll_hook)(void) = (void (*)(void))0;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void stm32l432_mock_registers_reset(void)
+{
+    memset((void *)&stm32l432_mock_gpioa, 0, sizeof(stm32l432_mock_gpioa));
+    memset((void *)&stm32l432_mock_gpiob, 0, sizeof(stm32l432_mock_gpiob));
+    memset((void *)&stm32l432_mock_gpioc, 0, sizeof(stm32l432_mock_gpioc));
+    memset((void *)&stm32l432_mock_rcc, 0, sizeof(stm32l432_mock_rcc));
+    memset((void *)&stm32l432_mock_tim2, 0, sizeof(stm32l432_mock_tim2));
+    memset((void *)&stm32l432_mock_flash, 0, sizeof(stm32l432_mock_flash));
+    memset((void *)&stm32l432_mock_pwr, 0, sizeof(stm32l432_mock_pwr));
+    memset((void *)&stm32l432_mock_scb, 0, sizeof(stm32l432_mock_scb));
+    memset((void *)&stm32l432_mock_fpu, 0, sizeof(stm32l432_mock_fpu));
+    memset((void *)&stm32l432_mock_systick, 0, sizeof(stm32l432_mock_systick));
+    memset((void *)&stm32l432_mock_coredebug, 0, sizeof(stm32l432_mock_coredebug));
+    memset((void *)&stm32l432_mock_dwt, 0, sizeof(stm32l432_mock_dwt));
+    memset((void *)&stm32l432_mock_nvic, 0, sizeof(stm32l432_mock_nvic));
+    memset((void *)&stm32l432_mock_wwdg, 0, sizeof(stm32l432_mock_wwdg));
+    memset((void *)&stm32l432_mock_dbgmcu, 0, sizeof(stm32l432_mock_dbgmcu));
+    memset((void *)&stm32l432_mock_usart2, 0, sizeof(stm32l432_mock_usart2));
+    memset((void *)&stm32l432_mock_dma1, 0, sizeof(stm32l432_mock_dma1));
+    memset((void *)&stm32l432_mock_exti, 0, sizeof(stm32l432_mock_exti));
+    memset((void *)&stm32l432_mock_syscfg, 0, sizeof(stm32l432_mock_syscfg));
+    memset((void *)&stm32l432_mock_can1, 0, sizeof(stm32l432_mock_can1));
+    stm32l432_mock_basepri = 0;
+
+    /* Non-zero reset values from RM0394. */
+    stm32l432_mock_gpioa.MODER      = 0xABFFFFFFU;
+    stm32l432_mock_gpioa.OSPEEDR    = 0x0C000000U;
+    stm32l432_mock_gpioa.PUPDR      = 0x64000000U;
+    stm32l432_mock_gpiob.MODER      = 0xFFFFFEBFU;
+    stm32l432_mock_gpiob.PUPDR      = 0x00000100U;
+    stm32l432_mock_gpioc.MODER      = 0xFFFFFFFFU;
+    stm32l432_mock_rcc.CR           = 0x00000063U;
+    stm32l432_mock_rcc.ICSCR        = 0x10000000U;
+    stm32l432_mock_rcc.PLLCFGR      = 0x00001000U;
+    stm32l432_mock_rcc.PLLSAI1CFGR  = 0x00001000U;
+    stm32l432_mock_rcc.AHB1ENR      = 0x00000100U;
+    stm32l432_mock_rcc.AHB3ENR      = 0x00000100U;
+    stm32l432_mock_tim2.ARR         = 0xFFFFFFFFU;
+    stm32l432_mock_flash.ACR        = 0x00000600U;
+    stm32l432_mock_flash.OPTR       = 0xFFEFF8AAU;
+    stm32l432_mock_flash.CR         = 0xC0000000U;
+    stm32l432_mock_pwr.CR1          = 0x00000200U;
+    stm32l432_mock_pwr.CR3          = 0x00008000U;
+    stm32l432_mock_scb.CPUID        = 0x410FC241U;
+    stm32l432_mock_scb.AIRCR        = 0xFA050000U;
+    stm32l432_mock_scb.CCR          = 0x00000200U;
+    stm32l432_mock_fpu.FPCCR        = 0xC0000000U;
+    stm32l432_mock_dwt.CTRL         = 0x40000000U;
+    stm32l432_mock_wwdg.CR          = 0x0000007FU;
+    stm32l432_mock_wwdg.CFR         = 0x0000007FU;
+    stm32l432_mock_dbgmcu.IDCODE    = 0x10016435U;
+    stm32l432_mock_usart2.ISR       = 0x020000C0U;
+    stm32l432_mock_exti.IMR1        = 0xFF820000U;
+    stm32l432_mock_can1.MCR         = 0x00010002U;
+    stm32l432_mock_can1.MSR         = 0x00000C02U;
+    stm32l432_mock_can1.TSR         = 0x1C000000U;
+    stm32l432_mock_can1.BTR         = 0x01230000U;
+    stm32l432_mock_can1.FMR         = 0x2A1C0E01U;
+}
+
+
+void stm32l432_mock_poll_hook_set(void (*hook)(void))
+{
+    poll_hook = hook;
+}
+
+
+void stm32l432_mock_poll(void)
+{
+    if (poll_hook)
+    {
+        poll_hook();
+    }
+}
+
+
+void stm32l432_mock_basepri_max_set(uint32_t value)
+{
+    /* Lower values mask more. Only the implemented bits are kept. */
+    value &= 0xFFU & ~((1U << NVIC_PRIORITY_SHIFT) - 1U);
+    if ((value != 0) && ((stm32l432_mock_basepri == 0) || (value < stm32l432_mock_basepri)))
+    {
+        stm32l432_mock_basepri = value;
+    }
+}
@@ -0,0 +1,151 @@
+/**
+ * @file
+ * @brief See systick.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "systick/systick.h"
+
+/* STDLib. */
+#include <stdint.h>
+
+/* Register map. */
+#include "registers/registers.h"
+
+/* External libraries. ECU. */
+#include "ecu/asserter.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- FILE SCOPE DEFINES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Shortest half of a carried remainder, in cycles. Covers the
+ * interrupt latency and the handler up to its LOAD write.
+ */
+#define CARRY_HALF_MIN                          (64U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static volatile uint32_t ticks;
+
+/* Reload to restore once the first half of a carried remainder ran. 0 if
+none is pending. */
+static volatile uint32_t carry_reload;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- STATIC FUNCTION DECLARATIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint32_t reload_get(uint32_t hclk_hz, uint32_t tick_hz);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint32_t reload_get(uint32_t hclk_hz, uint32_t tick_hz)
+{
+    uint32_t reload = 0;
+    ECU_RUNTIME_ASSERT( ((tick_hz > 0) && ((hclk_hz / tick_hz) > 0)), ECU_DEFAULT_FUNCTOR );
+
+    reload = (hclk_hz / tick_hz) - 1U;
+    ECU_RUNTIME_ASSERT( (reload <= SYSTICK_LOAD_MAX), ECU_DEFAULT_FUNCTOR );
+    return reload;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void systick_init(uint32_t hclk_hz, uint32_t tick_hz)
+{
+    uint32_t reload = reload_get(hclk_hz, tick_hz);
+
+    carry_reload = 0;
+    SYSTICK->CTRL = 0;
+    SYSTICK->LOAD = reload;
+    SYSTICK->VAL = 0;
+    SYSTICK->CTRL = SYSTICK_CTRL_CLKSOURCE | SYSTICK_CTRL_TICKINT | SYSTICK_CTRL_ENABLE;
+}
+
+
+void systick_clock_set(uint32_t hclk_hz, uint32_t tick_hz)
+{
+    uint32_t reload = reload_get(hclk_hz, tick_hz);
+    uint32_t old_reload = SYSTICK->LOAD;
+    uint32_t old_remaining = SYSTICK->VAL;
+    uint32_t remaining = 0;
+    SYSTICK->CTRL = 0;
+
+    /* Still in the first half of the last carry. The second half is to run
+    too and the tick is as long as the reload it restores. */
+    if (carry_reload != 0)
+    {
+        old_remaining += old_reload + 1U;
+        old_reload = carry_reload;
+    }
+
+    /* Counted down at the old clock except for the few cycles since HCLK
+    changed. */
+    remaining = (uint32_t)(((uint64_t)old_remaining * (reload + 1U)) / (old_reload + 1U));
+
+    /* Each half must outlast the interrupt latency, or the counter reloads
+    the half a third time. A tick that wrapped just before CTRL was cleared
+    also lands here with its interrupt still pending. */
+    if ((remaining / 2U) < CARRY_HALF_MIN)
+    {
+        carry_reload = 0;
+        SYSTICK->LOAD = reload;
+    }
+    else
+    {
+        carry_reload = reload;
+        SYSTICK->LOAD = (remaining / 2U) - 1U;
+    }
+
+    SYSTICK->VAL = 0;
+    SYSTICK->CTRL = SYSTICK_CTRL_CLKSOURCE | SYSTICK_CTRL_TICKINT | SYSTICK_CTRL_ENABLE;
+}
+
+
+uint32_t systick_get_ticks(void)
+{
+    return ticks;
+}
+
+
+void systick_isr_handler(void)
+{
+    /* End of the first half. The counter already took the half again. */
+    if (carry_reload != 0)
+    {
+        SYSTICK->LOAD = carry_reload;
+        carry_reload = 0;
+        return;
+    }
+
+    ticks++;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file
+ * @brief Free running tick counter driven by the SysTick interrupt. The
+ * counter is 32 bits and wraps.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef SYSTICK_H_
+#define SYSTICK_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Starts SysTick from the processor clock so it interrupts
+ * @p tick_hz times a second. @p hclk_hz / @p tick_hz must fit in
+ * 24 bits.
+ */
+extern void systick_init(uint32_t hclk_hz, uint32_t tick_hz);
+
+/**
+ * @brief Call right after HCLK changed, with the new HCLK. The tick count
+ * is kept and so is the part of the current tick still to run, scaled to
+ * the new clock. The next tick is split into two reloads of half that
+ * remainder, the first of which is not counted, because SysTick already
+ * reloaded when its interrupt runs. Less than 128 cycles of remainder is
+ * dropped.
+ */
+extern void systick_clock_set(uint32_t hclk_hz, uint32_t tick_hz);
+
+extern uint32_t systick_get_ticks(void);
+
+/**
+ * @brief Overrides the weak handler in the startup code's vector table.
+ */
+extern void systick_isr_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYSTICK_H_ */
@@ -0,0 +1,161 @@
+/**
+ * @file
+ * @brief See toggle_timer.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "toggle_timer/toggle_timer.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Drivers. */
+#include "gpio/gpio.h"
+
+/* Register map. */
+#include "registers/registers.h"
+
+/* External libraries. ECU. */
+#include "ecu/asserter.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- FILE SCOPE DEFINES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Counter frequency. 10 ticks per millisecond.
+ */
+#define COUNTER_HZ                              (10000U)
+#define COUNTS_PER_MS                           (COUNTER_HZ / 1000U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- STATIC FUNCTION DECLARATIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Writes the OCxM field of this channel. Also clears CCxS
+ * (channel is an output) and OCxPE (CCRx writes take effect immediately).
+ */
+static void output_compare_mode_set(struct toggle_timer *me, uint32_t mode);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void output_compare_mode_set(struct toggle_timer *me, uint32_t mode)
+{
+    uint32_t shift = 0;
+    ECU_RUNTIME_ASSERT( (me), ECU_DEFAULT_FUNCTOR );
+
+    /* Channels 1 and 3 use the low byte, 2 and 4 the high byte. */
+    shift = ((me->channel - 1U) % 2U) * 8U;
+    me->tim->CCMR[(me->channel - 1U) / 2U] = (me->tim->CCMR[(me->channel - 1U) / 2U] & ~(0xFFU << shift)) |
+                                             ((mode & TIM_OCM_MASK) << (TIM_OCM_OFFSET + shift));
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void toggle_timer_ctor(struct toggle_timer *me,
+                       struct stm32l432_tim_regs *tim_0,
+                       uint8_t channel_0,
+                       const struct gpio_pin *pin_0,
+                       uint8_t af_0,
+                       uint32_t clock_hz_0)
+{
+    ECU_RUNTIME_ASSERT( (me && pin_0), ECU_DEFAULT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (tim_0 == TIM2), ECU_DEFAULT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( ((channel_0 >= 1U) && (channel_0 <= 4U)), ECU_DEFAULT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( ((clock_hz_0 >= COUNTER_HZ) && ((clock_hz_0 % COUNTER_HZ) == 0)), ECU_DEFAULT_FUNCTOR );
+
+    me->tim         = tim_0;
+    me->channel     = channel_0;
+    me->pin         = *pin_0;
+    me->af          = af_0;
+    me->clock_hz    = clock_hz_0;
+
+    RCC->APB1ENR1 |= RCC_APB1ENR1_TIM2EN;
+    me->tim->CR1 &= ~TIM_CR1_CEN;
+}
+
+
+void toggle_timer_start(struct toggle_timer *me, bool level, uint32_t period_ms)
+{
+    ECU_RUNTIME_ASSERT( (me), ECU_DEFAULT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( ((period_ms > 0) && (period_ms <= (UINT32_MAX / COUNTS_PER_MS))), ECU_DEFAULT_FUNCTOR );
+
+    /* Step 1: Program the period. UG loads PSC and ARR and resets the counter. */
+    me->tim->CR1 &= ~TIM_CR1_CEN;
+    me->tim->PSC = (me->clock_hz / COUNTER_HZ) - 1U;
+    me->tim->ARR = (period_ms * COUNTS_PER_MS) - 1U;
+    me->tim->CCR[me->channel - 1U] = me->tim->ARR;
+    me->tim->EGR = TIM_EGR_UG;
+
+    /* Step 2: Force the channel output to the level the pin currently has
+    and enable it (active high) before the timer is given the pin. */
+    output_compare_mode_set(me, (level) ? TIM_OCM_FORCE_ACTIVE : TIM_OCM_FORCE_INACTIVE);
+    me->tim->CCER = (me->tim->CCER & ~((TIM_CCER_CCE | TIM_CCER_CCP) << ((me->channel - 1U) * 4U))) |
+                    (TIM_CCER_CCE << ((me->channel - 1U) * 4U));
+
+    /* Step 3: Hand the pin over. Both drivers output the same level so there is no glitch. */
+    gpio_write(&me->pin, level);
+    gpio_af_select(&me->pin, me->af);
+    gpio_mode_set(&me->pin, GPIO_MODER_ALTERNATE);
+
+    /* Step 4: Start toggling. */
+    output_compare_mode_set(me, TIM_OCM_TOGGLE);
+    me->tim->CR1 |= TIM_CR1_CEN;
+}
+
+
+bool toggle_timer_stop(struct toggle_timer *me)
+{
+    bool level = false;
+    ECU_RUNTIME_ASSERT( (me), ECU_DEFAULT_FUNCTOR );
+
+    /* Freeze the output first so the level cannot change while it is being sampled. */
+    me->tim->CR1 &= ~TIM_CR1_CEN;
+    level = gpio_read(&me->pin);
+
+    /* Latch the same level into ODR before taking the pin back from the timer. */
+    gpio_write(&me->pin, level);
+    gpio_mode_set(&me->pin, GPIO_MODER_OUTPUT);
+    me->tim->CCER &= ~(TIM_CCER_CCE << ((me->channel - 1U) * 4U));
+
+    return level;
+}
+
+
+void toggle_timer_clock_set(struct toggle_timer *me, uint32_t clock_hz)
+{
+    ECU_RUNTIME_ASSERT( (me), ECU_DEFAULT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( ((clock_hz >= COUNTER_HZ) && ((clock_hz % COUNTER_HZ) == 0)), ECU_DEFAULT_FUNCTOR );
+
+    me->clock_hz = clock_hz;
+    if (me->tim->CR1 & TIM_CR1_CEN)
+    {
+        /* PSC is always preloaded. Loaded on the next update event. */
+        me->tim->PSC = (me->clock_hz / COUNTER_HZ) - 1U;
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief Drives a pin with a timer output compare channel in toggle mode
+ * so an LED can blink without waking the CPU. The pin is handed over from
+ * GPIO output mode to the timer on @ref toggle_timer_start and back on
+ * @ref toggle_timer_stop without glitching its level.
+ *
+ * Only TIM2 is currently supported. The counter runs at a fixed 10 kHz
+ * so periods have 100us resolution. Note that the first toggle after
+ * start lands one counter tick early since the compare match happens
+ * when the counter reaches ARR, not when it wraps.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef TOGGLE_TIMER_H_
+#define TOGGLE_TIMER_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Drivers. */
+#include "gpio/gpio.h"
+
+/* Register map. */
+#include "registers/registers.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- TOGGLE TIMER DATA STRUCTURES ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct toggle_timer
+{
+    struct stm32l432_tim_regs *tim;
+    uint8_t channel;        /* 1 - 4. */
+    struct gpio_pin pin;    /* Must be routed to this channel by alternate function af. */
+    uint8_t af;
+    uint32_t clock_hz;      /* Timer kernel clock. Must be a multiple of 10 kHz. */
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern void toggle_timer_ctor(struct toggle_timer *me,
+                              struct stm32l432_tim_regs *tim_0,
+                              uint8_t channel_0,
+                              const struct gpio_pin *pin_0,
+                              uint8_t af_0,
+                              uint32_t clock_hz_0);
+
+/**
+ * @brief Hands the pin to the timer and toggles it every @p period_ms.
+ * The pin keeps @p level until the first toggle. Pin must currently be
+ * a GPIO output.
+ */
+extern void toggle_timer_start(struct toggle_timer *me, bool level, uint32_t period_ms);
+
+/**
+ * @brief Stops toggling and hands the pin back to GPIO output mode. The
+ * pin holds whatever level it had when the counter was stopped, which is
+ * returned so the caller's view of the LED stays in sync with the pin.
+ */
+extern bool toggle_timer_stop(struct toggle_timer *me);
+
+/**
+ * @brief Call whenever the timer kernel clock changes. Same requirements
+ * as clock_hz_0 in the constructor. If the timer is toggling, the new
+ * prescaler is preloaded and takes over at the next toggle, so the period
+ * in progress runs at the old rate scaled by the clock change.
+ */
+extern void toggle_timer_clock_set(struct toggle_timer *me, uint32_t clock_hz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TOGGLE_TIMER_H_ */
@@ -0,0 +1,202 @@
+/**
+ * @file
+ * @brief See uart.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "uart/uart.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Drivers. */
+#include "gpio/gpio.h"
+
+/* Register map. */
+#include "registers/registers.h"
+
+/* External libraries. ECU. */
+#include "ecu/asserter.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- FILE SCOPE DEFINES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define KERNEL_CLOCK_HZ                         (16000000U)
+
+/**
+ * @brief DMA1 channels and the request number that routes USART2 to them.
+ */
+#define RX_CHANNEL                              (6U)
+#define TX_CHANNEL                              (7U)
+#define DMA_REQUEST_USART2                      (2U)
+
+#define TX_AF                                   (7U)
+#define RX_AF                                   (3U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------- FILE SCOPE VARIABLES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static const struct gpio_pin tx_pin =
+{
+    .port   = GPIOA,
+    .pin    = 2
+};
+
+
+static const struct gpio_pin rx_pin =
+{
+    .port   = GPIOA,
+    .pin    = 15
+};
+
+
+static uint16_t rx_buf_size;
+static volatile uint32_t rx_delimiters;
+static volatile bool tx_in_flight;
+static void (*tx_done_fn)(void);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC FUNCTIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void uart_init(uint32_t baud,
+               uint8_t *rx_buf,
+               uint16_t rx_size,
+               uint8_t delimiter,
+               void (*tx_done)(void))
+{
+    struct stm32l432_dma_channel_regs *rx = &DMA1->CH[RX_CHANNEL - 1U];
+    struct stm32l432_dma_channel_regs *tx = &DMA1->CH[TX_CHANNEL - 1U];
+    ECU_RUNTIME_ASSERT( (rx_buf && (rx_size > 0) && (baud > 0)), ECU_DEFAULT_FUNCTOR );
+    ECU_RUNTIME_ASSERT( (((KERNEL_CLOCK_HZ + (baud / 2U)) / baud) >= 16U), ECU_DEFAULT_FUNCTOR );
+
+    rx_buf_size = rx_size;
+    rx_delimiters = 0;
+    tx_in_flight = false;
+    tx_done_fn = tx_done;
+
+    RCC->CR |= RCC_CR_HSION;
+    do
+    {
+        STM32L432_POLL();
+    } while (!(RCC->CR & RCC_CR_HSIRDY));
+
+    RCC->CCIPR = (RCC->CCIPR & ~RCC_CCIPR_USART2SEL_MASK) | RCC_CCIPR_USART2SEL_HSI16;
+    RCC->APB1ENR1 |= RCC_APB1ENR1_USART2EN;
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+    gpio_af_init(&tx_pin, TX_AF);
+    gpio_af_init(&rx_pin, RX_AF);
+
+    DMA1->CSELR = (DMA1->CSELR & ~(DMA_CSELR_MASK(RX_CHANNEL) | DMA_CSELR_MASK(TX_CHANNEL))) |
+                  (DMA_REQUEST_USART2 << DMA_CSELR_OFFSET(RX_CHANNEL)) |
+                  (DMA_REQUEST_USART2 << DMA_CSELR_OFFSET(TX_CHANNEL));
+
+    /* 8N1, oversampling by 16. An overrun only happens if the DMA falls
+    behind, and then the byte is lost either way. Keep receiving. */
+    USART2->CR1 = 0;
+    USART2->BRR = (KERNEL_CLOCK_HZ + (baud / 2U)) / baud;
+    USART2->CR2 = (uint32_t)delimiter << USART_CR2_ADD_OFFSET;
+    USART2->CR3 = USART_CR3_DMAR | USART_CR3_DMAT | USART_CR3_OVRDIS;
+
+    rx->CCR = 0;
+    rx->CPAR = (uint32_t)(uintptr_t)&USART2->RDR;
+    rx->CMAR = (uint32_t)(uintptr_t)rx_buf;
+    rx->CNDTR = rx_size;
+    rx->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_EN;
+
+    tx->CCR = 0;
+    tx->CPAR = (uint32_t)(uintptr_t)&USART2->TDR;
+
+    USART2->ICR = USART_ICR_CMCF | USART_ICR_ORECF;
+    USART2->CR1 = USART_CR1_CMIE | USART_CR1_TE | USART_CR1_RE | USART_CR1_UE;
+
+    NVIC->ISER[NVIC_IRQ_USART2 / 32U] = (1U << (NVIC_IRQ_USART2 % 32U));
+    NVIC->ISER[NVIC_IRQ_DMA1_CH7 / 32U] = (1U << (NVIC_IRQ_DMA1_CH7 % 32U));
+}
+
+
+uint16_t uart_rx_head(void)
+{
+    /* CNDTR counts down from the size and reloads at 0. */
+    uint16_t remaining = (uint16_t)DMA1->CH[RX_CHANNEL - 1U].CNDTR;
+    return (remaining == 0) ? 0 : (uint16_t)(rx_buf_size - remaining);
+}
+
+
+uint32_t uart_rx_delimiters(void)
+{
+    return rx_delimiters;
+}
+
+
+bool uart_tx_start(const uint8_t *data, uint16_t len)
+{
+    struct stm32l432_dma_channel_regs *tx = &DMA1->CH[TX_CHANNEL - 1U];
+    ECU_RUNTIME_ASSERT( (data && (len > 0)), ECU_DEFAULT_FUNCTOR );
+
+    if (tx_in_flight)
+    {
+        return false;
+    }
+
+    tx_in_flight = true;
+    tx->CCR = 0;
+    tx->CMAR = (uint32_t)(uintptr_t)data;
+    tx->CNDTR = len;
+    DMA1->IFCR = DMA_IFCR_CGIF(TX_CHANNEL);
+    tx->CCR = DMA_CCR_MINC | DMA_CCR_DIR_FROM_MEMORY | DMA_CCR_TCIE | DMA_CCR_EN;
+    return true;
+}
+
+
+bool uart_tx_busy(void)
+{
+    return tx_in_flight;
+}
+
+
+void uart2_isr_handler(void)
+{
+    if (USART2->ISR & USART_ISR_CMF)
+    {
+        USART2->ICR = USART_ICR_CMCF;
+        rx_delimiters++;
+    }
+}
+
+
+void dma1_channel7_isr_handler(void)
+{
+    if (DMA1->ISR & DMA_ISR_TCIF(TX_CHANNEL))
+    {
+        /* The last bytes are still shifting out of the USART. The next
+        block queues behind them. */
+        DMA1->IFCR = DMA_IFCR_CGIF(TX_CHANNEL);
+        DMA1->CH[TX_CHANNEL - 1U].CCR = 0;
+        tx_in_flight = false;
+        if (tx_done_fn)
+        {
+            (*tx_done_fn)();
+        }
+    }
+}
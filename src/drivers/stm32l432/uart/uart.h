@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @brief USART2 with DMA in both directions. On the Nucleo-L432KC USART2
+ * is wired to the ST-LINK virtual COM port (PA2 TX, PA15 RX).
+ *
+ * Receive runs forever on DMA1 channel 6 in circular mode into a buffer
+ * the caller owns. The CPU never touches received bytes in interrupt
+ * context. The character match interrupt only counts delimiters, so the
+ * application can tell that a complete frame arrived without scanning
+ * the buffer. The DMA may still be moving the delimiter when the count
+ * changes, and if the interrupt is held off across two delimiters only
+ * one is counted. Treat the count as a wake-up and the write index as
+ * the truth.
+ *
+ * Transmit runs on DMA1 channel 7 straight from the caller's memory, one
+ * contiguous block at a time. The block must stay untouched until the
+ * done callback runs.
+ *
+ * The kernel clock is HSI16 so the baud rate does not move when the
+ * system clock changes.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef UART_H_
+#define UART_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Starts receiving into @p rx_buf. Bytes equal to @p delimiter are
+ * counted. @p tx_done is optional and runs in interrupt context after
+ * each @ref uart_tx_start block has been handed to the USART.
+ */
+extern void uart_init(uint32_t baud,
+                      uint8_t *rx_buf,
+                      uint16_t rx_size,
+                      uint8_t delimiter,
+                      void (*tx_done)(void));
+
+/**
+ * @brief Index in the receive buffer the DMA writes next.
+ */
+extern uint16_t uart_rx_head(void);
+
+/**
+ * @brief Delimiters received since @ref uart_init. Wraps.
+ */
+extern uint32_t uart_rx_delimiters(void);
+
+/**
+ * @brief Sends @p len bytes from @p data without copying them. Returns
+ * false and does nothing if the previous block is still in flight.
+ */
+extern bool uart_tx_start(const uint8_t *data, uint16_t len);
+
+extern bool uart_tx_busy(void);
+
+/**
+ * @brief Override the weak handlers in the startup code's vector table.
+ */
+extern void uart2_isr_handler(void);
+extern void dma1_channel7_isr_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UART_H_ */
@@ -0,0 +1,160 @@
+/**
+ * @file
+ * @brief See watchdog.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "watchdog/watchdog.h"
+
+/* STDLib. */
+#include <stdint.h>
+
+/* Register map. */
+#include "registers/registers.h"
+
+/* External libraries. ECU. */
+#include "ecu/asserter.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- FILE SCOPE DEFINES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief WWDG counter clock is PCLK1 / 4096 / 2^WDGTB.
+ */
+#define CLOCK_DIVIDER                           (4096U)
+#define PRESCALER_SHIFT_MAX                     (3U)
+
+/**
+ * @brief Counter steps from 0x7F down to the reset at 0x3F.
+ */
+#define COUNTER_STEPS_MAX                       (WWDG_CR_T_MASK - WWDG_CR_T_MIN + 1U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------- FILE SCOPE VARIABLES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint32_t requested_us;
+static uint32_t configured_us;
+static uint32_t counter_reload;
+static void (*early_warning_fn)(void);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------- STATIC FUNCTION DECLARATIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void prescaler_set(uint32_t pclk1_hz);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------- STATIC FUNCTION DEFINITIONS ----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void prescaler_set(uint32_t pclk1_hz)
+{
+    uint32_t shift = 0;
+    uint64_t step_hz_us = 0;
+    uint64_t steps = 0;
+    ECU_RUNTIME_ASSERT( (pclk1_hz >= CLOCK_DIVIDER), ECU_DEFAULT_FUNCTOR );
+
+    /* Smallest prescaler that fits the timeout gives the finest steps. */
+    for (shift = 0; shift <= PRESCALER_SHIFT_MAX; shift++)
+    {
+        step_hz_us = (uint64_t)(CLOCK_DIVIDER << shift) * 1000000U;
+        steps = (((uint64_t)requested_us * pclk1_hz) + step_hz_us - 1U) / step_hz_us;
+        if (steps <= COUNTER_STEPS_MAX)
+        {
+            break;
+        }
+    }
+    ECU_RUNTIME_ASSERT( (steps <= COUNTER_STEPS_MAX), ECU_DEFAULT_FUNCTOR );
+
+    if (steps == 0)
+    {
+        steps = 1;
+    }
+
+    counter_reload = (WWDG_CR_T_MIN - 1U) + (uint32_t)steps;
+    configured_us = (uint32_t)((steps * step_hz_us) / pclk1_hz);
+    WWDG->CFR = WWDG_CFR_EWI | (shift << WWDG_CFR_WDGTB_OFFSET) | WWDG_CFR_W_MASK;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC FUNCTIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void watchdog_init(uint32_t pclk1_hz, uint32_t timeout_us, void (*early_warning)(void))
+{
+    ECU_RUNTIME_ASSERT( (timeout_us > 0), ECU_DEFAULT_FUNCTOR );
+
+    requested_us = timeout_us;
+    early_warning_fn = early_warning;
+
+    RCC->APB1ENR1 |= RCC_APB1ENR1_WWDGEN;
+    DBGMCU->APB1FZR1 |= DBGMCU_APB1FZR1_DBG_WWDG_STOP;
+
+    prescaler_set(pclk1_hz);
+    WWDG->SR = 0;
+    WWDG->CR = WWDG_CR_WDGA | counter_reload;
+    NVIC->ISER[NVIC_IRQ_WWDG / 32U] = (1U << (NVIC_IRQ_WWDG % 32U));
+}
+
+
+void watchdog_clock_set(uint32_t pclk1_hz)
+{
+    prescaler_set(pclk1_hz);
+}
+
+
+void watchdog_refresh(void)
+{
+    /* WDGA is set once and stays set. Writing it again is harmless. */
+    WWDG->CR = WWDG_CR_WDGA | counter_reload;
+}
+
+
+uint32_t watchdog_timeout_us(void)
+{
+    return configured_us;
+}
+
+
+STM32L432_RAMFUNC void watchdog_isr_handler(void)
+{
+    WWDG->SR = 0;
+
+    /* A page erase stalls everything in flash, the main loop and the early
+    warning function included, for longer than the timeout. It ends on its
+    own, so refresh through it from here. Nothing in flash may run until
+    BSY clears. */
+    if (FLASH->SR & FLASH_SR_BSY)
+    {
+        WWDG->CR = WWDG_CR_WDGA | counter_reload;
+        return;
+    }
+
+    if (early_warning_fn)
+    {
+        (*early_warning_fn)();
+    }
+}
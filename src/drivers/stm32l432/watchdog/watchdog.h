@@ -0,0 +1,83 @@
+/**
+ * @file
+ * @brief Window watchdog (WWDG). Resets the MCU unless @ref watchdog_refresh
+ * is called within the configured timeout. Once started it can only be
+ * stopped by a reset. The refresh window is left fully open, so a refresh
+ * is accepted at any time.
+ *
+ * WWDG counts PCLK1 / 4096 / prescaler, so the timeout depends on the bus
+ * clock. Call @ref watchdog_clock_set whenever PCLK1 changes to keep the
+ * timeout close to what was asked for. The counter has 64 steps, which
+ * limits the timeout to 64 * 4096 * 8 / PCLK1 (26 ms at 80 MHz).
+ *
+ * One counter step before the reset, the early wakeup interrupt calls the
+ * early warning function so the application can record why it stalled.
+ * It cannot prevent the reset other than by refreshing.
+ *
+ * The interrupt handler runs from SRAM. While a flash page erase is in
+ * progress, which stalls everything in flash for up to 24.5 ms, it
+ * refreshes the watchdog instead (see flash.h). The erase ends on its own,
+ * so a firmware stuck after it still resets.
+ *
+ * The watchdog is frozen while the core is halted by a debugger.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Starts the watchdog with a timeout of at least @p timeout_us.
+ * Asserts if PCLK1 is too fast for it. @p early_warning is optional and
+ * runs in interrupt context.
+ */
+extern void watchdog_init(uint32_t pclk1_hz, uint32_t timeout_us, void (*early_warning)(void));
+
+/**
+ * @brief Reprograms the prescaler for a new PCLK1 without refreshing.
+ * Call before raising PCLK1 and after lowering it so the counter never
+ * runs faster than the prescaler assumes.
+ */
+extern void watchdog_clock_set(uint32_t pclk1_hz);
+
+extern void watchdog_refresh(void);
+
+/**
+ * @brief Timeout the current prescaler gives. At least the requested one.
+ */
+extern uint32_t watchdog_timeout_us(void);
+
+/**
+ * @brief Overrides the weak handler in the startup code's vector table.
+ */
+extern void watchdog_isr_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WATCHDOG_H_ */
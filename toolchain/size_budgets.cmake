@@ -0,0 +1,53 @@
+# Flash and RAM budgets checked by the size_report target (see size_report.cmake). Sizes are
+# in bytes. FLASH is .text + .rodata + .data (initial values) and RAM is .data + .bss of every
+# object file that belongs to the module. The totals also count the linker fill between
+# sections and the stack and heap reserved by stm32l432xc.ld.
+#
+# These are regression budgets, not hardware limits. Keep them a little above what the
+# current build uses so an unexpected jump fails the build. Raise them on purpose in the
+# same commit that needs the space.
+#
+# Where the numbers below come from. No arm-none-eabi build could be run when they were set, so
+# each module's sources were compiled as 32 bit x86 objects with the firmware's -O0,
+# -ffunction-sections and -fdata-sections. Then .text + .rodata + .data and .data + .bss were
+# summed with size -A. 25 % headroom was added, and the result rounded up to 512 (FLASH) or 64
+# (RAM). Static RAM is the same layout as on the Cortex-M4 (ILP32) except for 8 byte alignment
+# inside structs. FLASH is x86 code standing in for Thumb-2, so it is an estimate. ecu, libc and
+# other keep their first estimates, as only a stand-in ECU was available. The first size_report
+# run of a target build replaces them all with the measured sizes plus some headroom.
+#
+#   module   FLASH   RAM    largest RAM users
+#   app      23414      0
+#   bsp       4343   2796   telemetry 588 (512 B TX ring), event_log 528 (512 B token ring),
+#                           telemetry_rx_ring 256, loop_monitor 252, can_filter_plan 244
+#   drivers  14803    127   + watchdog_isr_handler in .ramfunc, about 85
+#   startup  ~1000    404   sram_vector_table (512 B aligned)
+set(SIZE_BUDGETS_PROVISIONAL    FALSE)
+
+
+# Module           FLASH       RAM
+set(SIZE_BUDGET_app_FLASH       29696)
+set(SIZE_BUDGET_app_RAM         64)
+
+set(SIZE_BUDGET_bsp_FLASH       5632)
+set(SIZE_BUDGET_bsp_RAM         3520)
+
+set(SIZE_BUDGET_drivers_FLASH   18944)
+set(SIZE_BUDGET_drivers_RAM     320)
+
+set(SIZE_BUDGET_startup_FLASH   1280)
+set(SIZE_BUDGET_startup_RAM     512)
+
+set(SIZE_BUDGET_ecu_FLASH       12288)
+set(SIZE_BUDGET_ecu_RAM         256)
+
+set(SIZE_BUDGET_libc_FLASH      4096)
+set(SIZE_BUDGET_libc_RAM        512)
+
+set(SIZE_BUDGET_other_FLASH     512)
+set(SIZE_BUDGET_other_RAM       64)
+
+
+# Whole image. Stays well under the 248K FLASH and 64K SRAM1 regions of stm32l432xc.ld.
+set(SIZE_BUDGET_total_FLASH     65536)
+set(SIZE_BUDGET_total_RAM       7744)
@@ -0,0 +1,322 @@
+# Flash and RAM report of the firmware image. Run in script mode by the size_report target:
+#
+#   cmake -DMAP_FILE=<.map> -DELF_FILE=<.elf> -DNM=<nm> [-DSIZE=<size>]
+#         -DBUDGETS_FILE=<budgets.cmake> [-DREPORT_FILE=<.txt>] [-DTOP_SYMBOLS=<n>]
+#         -P size_report.cmake
+#
+# Every input section in the memory map section of the linker map is attributed to a module
+# from the path of the object file it came from and to .text, .rodata, .data or .bss from the
+# output section it was placed in. Module totals are checked against BUDGETS_FILE and the
+# largest symbols are listed from the symbol table. Fails if any module or the whole image
+# goes over its budget so it can gate CI, unless BUDGETS_FILE sets SIZE_BUDGETS_PROVISIONAL,
+# i.e. the budgets were never measured. Then overruns are only warned about.
+#
+# Only reads the GNU ld map format. Input sections whose name does not fit in the name
+# column are printed on their own line with the address and size on the next one.
+cmake_minimum_required(VERSION 3.21)
+
+
+foreach(var IN ITEMS MAP_FILE ELF_FILE NM BUDGETS_FILE)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "size_report: ${var} must be defined.")
+    endif()
+endforeach()
+
+foreach(file IN ITEMS "${MAP_FILE}" "${ELF_FILE}" "${BUDGETS_FILE}")
+    if(NOT EXISTS "${file}")
+        message(FATAL_ERROR "size_report: ${file} does not exist.")
+    endif()
+endforeach()
+
+if(NOT DEFINED TOP_SYMBOLS)
+    set(TOP_SYMBOLS 20)
+endif()
+
+include("${BUDGETS_FILE}")
+
+
+
+#--------------------------------------------------------------------------------------------------------#
+#------------------------------ MODULES AND THE OBJECT FILE PATHS THEY OWN. -----------------------------#
+#------------- CHECKED IN ORDER. OBJECT FILES THAT MATCH NONE (LINKER STUBS, FILL) ARE OTHER. -----------#
+#--------------------------------------------------------------------------------------------------------#
+set(SIZE_MODULES app bsp drivers startup ecu libc other)
+
+set(SIZE_MODULE_app_MATCH       "/src/app/")
+set(SIZE_MODULE_bsp_MATCH       "/src/bsp/")
+set(SIZE_MODULE_drivers_MATCH   "/src/drivers/")
+set(SIZE_MODULE_startup_MATCH   "/toolchain/")
+set(SIZE_MODULE_ecu_MATCH       "libecu\\.a\\(|/_deps/ecu-")
+set(SIZE_MODULE_libc_MATCH      "lib(c|c_nano|g|g_nano|m|nosys|gcc|stdc\\+\\+|stdc\\+\\+_nano)\\.a\\(|crt[^/]*\\.o$")
+
+# Output sections of stm32l432xc.ld and what they count as. .heap and .stack have no input
+# sections. They are only added to the RAM total.
+set(SIZE_TEXT_SECTIONS      .text)
+set(SIZE_RODATA_SECTIONS    .isr_vector .rodata .ARM.extab .ARM .preinit_array .init_array .fini_array)
+set(SIZE_DATA_SECTIONS      .data)
+set(SIZE_BSS_SECTIONS       .bss)
+set(SIZE_RESERVED_SECTIONS  .heap .stack)
+set(SIZE_CATEGORIES         text rodata data bss)
+
+
+
+#--------------------------------------------------------------------------------------------------------#
+#----------------------------------------------- HELPERS. -----------------------------------------------#
+#--------------------------------------------------------------------------------------------------------#
+# Pads text to width. RIGHT aligns numbers, LEFT aligns names.
+function(size_report_pad out align width text)
+    string(LENGTH "${text}" len)
+    set(pad "")
+    if(len LESS width)
+        math(EXPR n "${width} - ${len}")
+        string(REPEAT " " ${n} pad)
+    endif()
+
+    if(align STREQUAL "RIGHT")
+        set(${out} "${pad}${text}" PARENT_SCOPE)
+    else()
+        set(${out} "${text}${pad}" PARENT_SCOPE)
+    endif()
+endfunction()
+
+
+function(size_report_module out object)
+    foreach(module IN LISTS SIZE_MODULES)
+        if(DEFINED SIZE_MODULE_${module}_MATCH AND object MATCHES "${SIZE_MODULE_${module}_MATCH}")
+            set(${out} ${module} PARENT_SCOPE)
+            return()
+        endif()
+    endforeach()
+    set(${out} other PARENT_SCOPE)
+endfunction()
+
+
+function(size_report_category out section)
+    foreach(category IN LISTS SIZE_CATEGORIES)
+        string(TOUPPER ${category} upper)
+        if(section IN_LIST SIZE_${upper}_SECTIONS)
+            set(${out} ${category} PARENT_SCOPE)
+            return()
+        endif()
+    endforeach()
+    set(${out} "" PARENT_SCOPE)
+endfunction()
+
+
+
+#--------------------------------------------------------------------------------------------------------#
+#------------------------------------------ PARSE THE LINKER MAP. ---------------------------------------#
+#--------------------------------------------------------------------------------------------------------#
+foreach(module IN LISTS SIZE_MODULES)
+    foreach(category IN LISTS SIZE_CATEGORIES)
+        set(size_${module}_${category} 0)
+    endforeach()
+endforeach()
+set(size_reserved 0)
+
+file(STRINGS "${MAP_FILE}" map_lines)
+set(in_memory_map FALSE)
+set(output_section "")
+set(category "")
+set(pending_input "")
+
+foreach(line IN LISTS map_lines)
+    # Discarded input sections and the memory configuration come first. Skip them.
+    if(NOT in_memory_map)
+        if(line MATCHES "^Linker script and memory map")
+            set(in_memory_map TRUE)
+        endif()
+        continue()
+    endif()
+
+    set(input "")
+    set(object "")
+    set(bytes 0)
+
+    if(line MATCHES "^(\\.[^ ]+)( +0x[0-9a-fA-F]+ +0x([0-9a-fA-F]+))?")
+        # Output section.
+        set(output_section "${CMAKE_MATCH_1}")
+        size_report_category(category "${output_section}")
+        set(pending_input "")
+        if(output_section IN_LIST SIZE_RESERVED_SECTIONS AND CMAKE_MATCH_3)
+            math(EXPR size_reserved "${size_reserved} + 0x${CMAKE_MATCH_3}")
+        endif()
+        continue()
+    elseif(line MATCHES "^ ([^ ]+) +0x[0-9a-fA-F]+ +0x([0-9a-fA-F]+) *(.*)$")
+        # Input section or fill on one line.
+        set(input "${CMAKE_MATCH_1}")
+        set(bytes "0x${CMAKE_MATCH_2}")
+        set(object "${CMAKE_MATCH_3}")
+    elseif(line MATCHES "^ ([^ *][^ ]*)$")
+        # Input section name too long for its column. Address and size follow.
+        set(pending_input "${CMAKE_MATCH_1}")
+        continue()
+    elseif(pending_input AND line MATCHES "^ +0x[0-9a-fA-F]+ +0x([0-9a-fA-F]+) +(.+)$")
+        set(input "${pending_input}")
+        set(bytes "0x${CMAKE_MATCH_1}")
+        set(object "${CMAKE_MATCH_2}")
+    else()
+        # Symbols, assignments and input section patterns.
+        set(pending_input "")
+        continue()
+    endif()
+
+    set(pending_input "")
+    math(EXPR bytes "${bytes}")
+    if(category STREQUAL "" OR bytes EQUAL 0)
+        continue()
+    endif()
+
+    string(STRIP "${object}" object)
+    size_report_module(module "${object}")
+    math(EXPR size_${module}_${category} "${size_${module}_${category}} + ${bytes}")
+
+    # -ffunction-sections and -fdata-sections name input sections after their symbol. Remember
+    # who owns it so the symbol list can show the module.
+    if(input MATCHES "^\\.(text|rodata|data|bss)\\.(.+)$")
+        set(owner_${CMAKE_MATCH_2} ${module})
+    endif()
+endforeach()
+
+if(NOT in_memory_map)
+    message(FATAL_ERROR "size_report: ${MAP_FILE} has no memory map. Is it a GNU ld map file?")
+endif()
+
+
+
+#--------------------------------------------------------------------------------------------------------#
+#------------------------------------ MODULE TABLE AND BUDGET CHECK. ------------------------------------#
+#--------------------------------------------------------------------------------------------------------#
+set(report "")
+set(overruns "")
+
+if(DEFINED SIZE AND EXISTS "${SIZE}")
+    execute_process(COMMAND ${SIZE} --format=berkeley "${ELF_FILE}" OUTPUT_VARIABLE berkeley)
+    string(APPEND report "${berkeley}\n")
+endif()
+
+set(header "")
+foreach(column IN ITEMS module .text .rodata .data .bss FLASH budget RAM budget)
+    if(column STREQUAL "module")
+        size_report_pad(cell LEFT 10 ${column})
+    else()
+        size_report_pad(cell RIGHT 9 ${column})
+    endif()
+    string(APPEND header "${cell}")
+endforeach()
+string(APPEND report "${header}\n")
+
+foreach(category IN LISTS SIZE_CATEGORIES)
+    set(size_total_${category} 0)
+endforeach()
+
+foreach(module IN LISTS SIZE_MODULES ITEMS total)
+    if(module STREQUAL "total")
+        string(REGEX REPLACE "." "-" rule "${header}")
+        string(APPEND report "${rule}\n")
+    else()
+        foreach(category IN LISTS SIZE_CATEGORIES)
+            math(EXPR size_total_${category} "${size_total_${category}} + ${size_${module}_${category}}")
+        endforeach()
+    endif()
+
+    math(EXPR flash "${size_${module}_text} + ${size_${module}_rodata} + ${size_${module}_data}")
+    math(EXPR ram "${size_${module}_data} + ${size_${module}_bss}")
+    if(module STREQUAL "total")
+        math(EXPR ram "${ram} + ${size_reserved}")
+    endif()
+
+    size_report_pad(row LEFT 10 ${module})
+    foreach(value IN ITEMS ${size_${module}_text} ${size_${module}_rodata} ${size_${module}_data} ${size_${module}_bss})
+        size_report_pad(cell RIGHT 9 ${value})
+        string(APPEND row "${cell}")
+    endforeach()
+
+    foreach(memory IN ITEMS FLASH RAM)
+        if(memory STREQUAL "FLASH")
+            set(used ${flash})
+        else()
+            set(used ${ram})
+        endif()
+
+        if(NOT DEFINED SIZE_BUDGET_${module}_${memory})
+            message(FATAL_ERROR "size_report: SIZE_BUDGET_${module}_${memory} is missing from ${BUDGETS_FILE}.")
+        endif()
+        set(budget ${SIZE_BUDGET_${module}_${memory}})
+
+        size_report_pad(cell RIGHT 9 ${used})
+        string(APPEND row "${cell}")
+        size_report_pad(cell RIGHT 9 ${budget})
+        string(APPEND row "${cell}")
+
+        if(used GREATER budget)
+            math(EXPR over "${used} - ${budget}")
+            string(APPEND overruns "  ${module} ${memory}: ${used} bytes, budget ${budget} (+${over})\n")
+            string(APPEND row " !")
+        endif()
+    endforeach()
+    string(APPEND report "${row}\n")
+endforeach()
+string(APPEND report "Total RAM includes ${size_reserved} bytes of stack and heap.\n")
+if(SIZE_BUDGETS_PROVISIONAL)
+    string(APPEND report "Budgets are provisional estimates, not measured sizes. See ${BUDGETS_FILE}.\n")
+endif()
+
+
+
+#--------------------------------------------------------------------------------------------------------#
+#------------------------------------------- LARGEST SYMBOLS. -------------------------------------------#
+#--------------------------------------------------------------------------------------------------------#
+execute_process(
+    COMMAND ${NM} --print-size --size-sort --reverse-sort --radix=d "${ELF_FILE}"
+    OUTPUT_VARIABLE nm_output
+    RESULT_VARIABLE nm_result
+)
+if(NOT nm_result EQUAL 0)
+    message(FATAL_ERROR "size_report: ${NM} failed on ${ELF_FILE}.")
+endif()
+
+string(APPEND report "\nLargest ${TOP_SYMBOLS} symbols:\n")
+string(REPLACE "\n" ";" nm_lines "${nm_output}")
+set(listed 0)
+foreach(line IN LISTS nm_lines)
+    if(listed GREATER_EQUAL TOP_SYMBOLS)
+        break()
+    endif()
+
+    # <address> <size> <type> <name>. Symbols without a size have no size column.
+    if(NOT line MATCHES "^[0-9]+ ([0-9]+) ([A-Za-z]) (.+)$")
+        continue()
+    endif()
+    math(EXPR bytes "${CMAKE_MATCH_1}")
+    set(type "${CMAKE_MATCH_2}")
+    set(name "${CMAKE_MATCH_3}")
+
+    set(module "?")
+    if(DEFINED owner_${name})
+        set(module ${owner_${name}})
+    endif()
+
+    size_report_pad(row RIGHT 9 ${bytes})
+    size_report_pad(cell LEFT 10 ${module})
+    string(APPEND report "${row}  ${type}  ${cell}${name}\n")
+    math(EXPR listed "${listed} + 1")
+endforeach()
+
+
+
+#--------------------------------------------------------------------------------------------------------#
+#----------------------------------------------- OUTPUT. ------------------------------------------------#
+#--------------------------------------------------------------------------------------------------------#
+if(DEFINED REPORT_FILE)
+    file(WRITE "${REPORT_FILE}" "${report}")
+endif()
+message("${report}")
+
+if((NOT overruns STREQUAL "") AND SIZE_BUDGETS_PROVISIONAL)
+    message(WARNING "size_report: over the provisional budget. Set measured budgets in ${BUDGETS_FILE}.\n"
+                    "${overruns}")
+elseif(NOT overruns STREQUAL "")
+    message(FATAL_ERROR "size_report: over budget. Raise the budget in ${BUDGETS_FILE} "
+                        "if the growth is intended.\n${overruns}")
+endif()
@@ -29,6 +29,10 @@
 /* ECU. */
 #include "ecu/asserter.h"
 
+/* Drivers. */
+#include "fpu/fpu.h"
+#include "registers/registers.h"
+
 
 
 /*------------------------------------------------------------------------------------------------------*/
@@ -113,6 +117,13 @@ static void bus_fault_isr_handler(void);
 static void usage_fault_isr_handler(void);
 
 
+/**
+ * @brief Default for system_init(). Leaves the core on the 4 MHz MSI
+ * reset clock.
+ */
+static void default_system_init(void);
+
+
 
 /*------------------------------------------------------------------------------------------------------*/
 /*---------------------------------------- PUBLIC FUNCTION DECLARATIONS --------------------------------*/
@@ -146,6 +157,14 @@ extern int main(void);
 /*-------------------------------- DEFINITIONS CAN BE OVERRIDDEN BY APPLICATION ------------------------*/
 /*------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @brief Called before main() once .bss and .data are initialized. Boards
+ * override this to set up the clock tree and anything else that must run
+ * before main().
+ */
+extern void system_init(void)                               __attribute__((weak, alias ("default_system_init")));
+
+
 extern void nmi_isr_handler(void)                           __attribute__((weak, alias ("unregistered_isr_handler")));
 extern void svcall_isr_handler(void)                        __attribute__((weak, alias ("unregistered_isr_handler")));
 extern void debug_monitor_isr_handler(void)                 __attribute__((weak, alias ("unregistered_isr_handler")));
@@ -352,6 +371,16 @@ static const uint32_t vector_table[] __attribute__((section(".isr_vector"))) =
 };
 ECU_STATIC_ASSERT( ((sizeof(vector_table) / sizeof(vector_table[0])) == 101U) );
 
+/**
+ * @brief Copy of vector_table that VTOR points to once .data is in SRAM.
+ * Vectors fetched from flash would stall for the length of a flash erase,
+ * so only a table in SRAM lets handlers placed in SRAM (STM32L432_RAMFUNC)
+ * run during one. VTOR needs the table aligned to its size rounded up to
+ * a power of two.
+ */
+static uint32_t sram_vector_table[sizeof(vector_table) / sizeof(vector_table[0])] __attribute__((aligned(512)));
+ECU_STATIC_ASSERT( (sizeof(sram_vector_table) <= 512U) );
+
 
 
 /*------------------------------------------------------------------------------------------------------*/
@@ -391,6 +420,11 @@ static void unregistered_isr_handler(void)
 }
 
 
+static void default_system_init(void)
+{
+}
+
+
 
 /*------------------------------------------------------------------------------------------------------*/
 /*----------------------------------------- PUBLIC FUNCTION DEFINITIONS --------------------------------*/
@@ -403,6 +437,11 @@ void reset_isr_handler(void)
     ECU_RUNTIME_ASSERT( (&bss_end_ >= &bss_start_), ECU_DEFAULT_FUNCTOR );
     ECU_RUNTIME_ASSERT( (&data_end_ram_ >= &data_start_ram_), ECU_DEFAULT_FUNCTOR );
 
+    /* Step 0: Enable the FPU before anything that could be compiled to a
+    floating point instruction runs. Code is built with -mfloat-abi=hard so
+    that includes stdlib. */
+    fpu_enable();
+
     /* Step 1: Zero out .bss section. */
     for (uint32_t *bss = &bss_start_; bss < &bss_end_; ++bss)
     {
@@ -415,13 +454,21 @@ void reset_isr_handler(void)
     and .init_array sections. */
     __libc_init_array();
 
-    /* Step 3: Copy .data from FLASH into RAM. */
-    memcpy((void *)&data_start_ram_, (const void *)&data_start_flash_, (&data_end_ram_ - &data_start_ram_));
+    /* Step 3: Copy .data from FLASH into RAM. Functions placed in SRAM are
+    part of it. The length is in bytes, not words. */
+    memcpy((void *)&data_start_ram_, (const void *)&data_start_flash_,
+           (size_t)((uintptr_t)&data_end_ram_ - (uintptr_t)&data_start_ram_));
+
+    /* Step 4: Take exceptions through a copy of the vector table in SRAM. */
+    memcpy((void *)sram_vector_table, (const void *)vector_table, sizeof(sram_vector_table));
+    SCB->VTOR = (uint32_t)sram_vector_table;
+    STM32L432_DSB();
 
-    /* Step 4: Initialize system clocks and any hardware you need. */
-    #warning "todo: have to do this and also enable fpu."
+    /* Step 5: Initialize system clocks and any hardware the board needs
+    before main(). */
+    system_init();
 
-    /* Step 5: Branch to main. Assert if main ever exits. */
+    /* Step 6: Branch to main. Assert if main ever exits. */
     #warning "todo: will I have stack saved that will be unusd since we branch to forever main??"
     main();
     ECU_RUNTIME_ASSERT( (false), ECU_DEFAULT_FUNCTOR);
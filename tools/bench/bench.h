@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief Host microbenchmark framework. Cases are grouped into suites,
+ * one suite per file, and listed in main.c. Each case performs roughly
+ * the requested number of operations and reports how many it actually
+ * performed and how long only the measured part took, so cases can do
+ * untimed setup between timed phases.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stddef.h>
+#include <stdint.h>
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------- BENCHMARK DATA STRUCTURES -----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct bench_case
+{
+    /* Unique. Used as the key when comparing against a baseline. */
+    const char *name;
+
+    /* Perform about iterations operations. Store the time spent in
+    the measured operations in elapsed_ns. Return the exact number of
+    operations performed. */
+    uint64_t (*run)(uint64_t iterations, uint64_t *elapsed_ns);
+};
+
+
+struct bench_suite
+{
+    const struct bench_case *cases;
+    size_t count;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- BENCHMARK SUITES ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+extern const struct bench_suite bench_can_suite;
+extern const struct bench_suite bench_ecu_suite;
+extern const struct bench_suite bench_led_fsm_suite;
+extern const struct bench_suite bench_led_fsm_cpp_suite;
+extern const struct bench_suite bench_led_behavior_suite;
+extern const struct bench_suite bench_led_pattern_suite;
+extern const struct bench_suite bench_switch_coalescer_suite;
+extern const struct bench_suite bench_token_log_suite;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Monotonic time in nanoseconds.
+ */
+extern uint64_t bench_now_ns(void);
+
+/**
+ * @brief Attaches a named counter to the case that is currently running,
+ * i.e. memory used or operations avoided. Counters are written to the JSON
+ * results but are not compared against the baseline. The last value set
+ * during the final repetition is kept.
+ */
+extern void bench_counter(const char *name, double value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_H_ */
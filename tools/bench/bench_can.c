@@ -0,0 +1,317 @@
+/**
+ * @file
+ * @brief Replays a seeded bus trace through the CAN driver on mocked
+ * registers and the receive model in can_model.h. The board only
+ * listens to its LED command IDs, a small share of the traffic. Once the
+ * filter banks pass only those IDs, once they pass everything and the
+ * receive callback compares each frame's ID with the command IDs. Frames
+ * arrive in groups of up to three back to back, and the receive
+ * interrupt runs after each group. Only the interrupt handlers are timed.
+ * The banks are hardware on target, so the model's time is left out.
+ * ns/op is per bus frame. Counters report frames the handlers had to
+ * read per bus frame and frames drained per interrupt.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "bench.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Application. */
+#include "app/can_command.h"
+
+/* Host model. */
+#include "can_model.h"
+
+/* Drivers. */
+#include "can/can.h"
+#include "registers/registers.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define TRACE_SEED                              (0xCA4U)
+#define TRACE_GROUPS                            (2048U)
+#define GROUP_FRAMES_MAX                        (3U)
+#define PCLK1_HZ                                (80000000U)
+#define BITRATE                                 (500000U)
+
+/**
+ * @brief Same as the board. Other ECUs' cyclic messages are the rest of
+ * the traffic.
+ */
+#define LEDS                                    (2U)
+#define COMMAND_ID(n)                           (0x300U + (uint32_t)(n))
+#define OTHER_IDS                               (40U)
+
+/* Chance per frame, in percent. */
+#define COMMAND_PERCENT                         (5U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct group
+{
+    struct can_model_frame frames[GROUP_FRAMES_MAX];
+    uint8_t count;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void);
+static void trace_build(void);
+
+static void hw_rx(const struct can_frame *frame, uint32_t cycles);
+static void sw_rx(const struct can_frame *frame, uint32_t cycles);
+static uint64_t replay(uint64_t iterations,
+                       uint64_t *elapsed_ns,
+                       const struct can_filter *filter_list,
+                       uint8_t count,
+                       void (*rx)(const struct can_frame *frame, uint32_t cycles));
+
+static uint64_t hw_filter_drain(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t software_filter_drain(uint64_t iterations, uint64_t *elapsed_ns);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Filter n takes LED n's commands, as on the board.
+ */
+static const struct can_filter command_filters[] =
+{
+    { .id = COMMAND_ID(0), .mask = CAN_STD_ID_MASK, .extended = false, .fifo = 0 },
+    { .id = COMMAND_ID(1), .mask = CAN_STD_ID_MASK, .extended = false, .fifo = 1 }
+};
+
+
+/**
+ * @brief Masks of zero. Every data frame, either ID format.
+ */
+static const struct can_filter accept_all_filters[] =
+{
+    { .id = 0, .mask = 0, .extended = false, .fifo = 0 },
+    { .id = 0, .mask = 0, .extended = true, .fifo = 0 }
+};
+
+
+static const uint32_t command_ids[LEDS] = { COMMAND_ID(0), COMMAND_ID(1) };
+
+
+static uint64_t rand_state;
+static struct group trace[TRACE_GROUPS];
+static uint64_t trace_frames;
+
+static struct can_filter_plan plan;
+static struct can_command commands;
+static uint64_t isr_frames;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- TRACE ---------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void)
+{
+    /* xorshift64*. Same trace on every host. */
+    rand_state ^= rand_state >> 12;
+    rand_state ^= rand_state << 25;
+    rand_state ^= rand_state >> 27;
+    return rand_state * 0x2545F4914F6CDD1DULL;
+}
+
+
+static void trace_build(void)
+{
+    struct can_model_frame *frame = (struct can_model_frame *)0;
+
+    if (trace_frames > 0)
+    {
+        return;
+    }
+
+    rand_state = TRACE_SEED;
+    for (uint32_t g = 0; g < TRACE_GROUPS; g++)
+    {
+        trace[g].count = (uint8_t)(1U + (rand_next() % GROUP_FRAMES_MAX));
+        for (uint8_t i = 0; i < trace[g].count; i++)
+        {
+            frame = &trace[g].frames[i];
+            frame->extended = false;
+            frame->remote = false;
+            frame->len = 8U;
+            for (uint8_t b = 0; b < 8U; b++)
+            {
+                frame->data[b] = (uint8_t)rand_next();
+            }
+
+            /* Commands switch their LED at random. Other IDs sit below
+            the command IDs, as higher priority powertrain traffic would. */
+            if ((rand_next() % 100U) < COMMAND_PERCENT)
+            {
+                frame->id = command_ids[rand_next() % LEDS];
+                frame->data[0] = (uint8_t)(rand_next() % 2U);
+            }
+            else
+            {
+                frame->id = 0x100U + (uint32_t)(rand_next() % OTHER_IDS);
+            }
+        }
+        trace_frames += trace[g].count;
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- RECEIVE CALLBACKS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void hw_rx(const struct can_frame *frame, uint32_t cycles)
+{
+    isr_frames++;
+    can_command_post(&commands, frame->filter, frame->data, frame->len, cycles);
+}
+
+
+static void sw_rx(const struct can_frame *frame, uint32_t cycles)
+{
+    isr_frames++;
+    if (frame->extended)
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < LEDS; i++)
+    {
+        if (frame->id == command_ids[i])
+        {
+            can_command_post(&commands, i, frame->data, frame->len, cycles);
+            return;
+        }
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t replay(uint64_t iterations,
+                       uint64_t *elapsed_ns,
+                       const struct can_filter *filter_list,
+                       uint8_t count,
+                       void (*rx)(const struct can_frame *frame, uint32_t cycles))
+{
+    const struct can_model_stats *model = can_model_stats();
+    struct can_command_event evt;
+    uint64_t start = 0;
+    uint64_t rounds = 0;
+    uint64_t interrupts = 0;
+    uint8_t fifo = 0;
+
+    trace_build();
+    rounds = (iterations + trace_frames - 1U) / trace_frames;
+    (void)can_filter_compile(filter_list, count, &plan);
+    stm32l432_mock_registers_reset();
+    can_model_reset();
+    can_init(PCLK1_HZ, BITRATE, &plan, rx);
+    can_command_ctor(&commands, LEDS);
+    isr_frames = 0;
+    *elapsed_ns = 0;
+
+    for (uint64_t r = 0; r < rounds; r++)
+    {
+        for (uint32_t g = 0; g < TRACE_GROUPS; g++)
+        {
+            for (uint8_t i = 0; i < trace[g].count; i++)
+            {
+                (void)can_model_receive(&trace[g].frames[i], &fifo);
+            }
+
+            /* Nothing raised an interrupt, nothing ran. */
+            if ((can_model_pending(0) + can_model_pending(1)) > 0)
+            {
+                start = bench_now_ns();
+                can_model_service();
+                *elapsed_ns += bench_now_ns() - start;
+            }
+
+            /* The main loop's share. */
+            while (can_command_take(&commands, &evt))
+            {
+            }
+        }
+    }
+
+    interrupts = (uint64_t)model->interrupts[0] + model->interrupts[1];
+    bench_counter("isr_frames_per_bus_frame", (double)isr_frames / (double)(rounds * trace_frames));
+    bench_counter("frames_per_interrupt", (interrupts > 0) ? ((double)isr_frames / (double)interrupts) : 0.0);
+    return rounds * trace_frames;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- CAN CASES -------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t hw_filter_drain(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    return replay(iterations, elapsed_ns, command_filters,
+                  (uint8_t)(sizeof(command_filters) / sizeof(command_filters[0])), &hw_rx);
+}
+
+
+static uint64_t software_filter_drain(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    return replay(iterations, elapsed_ns, accept_all_filters,
+                  (uint8_t)(sizeof(accept_all_filters) / sizeof(accept_all_filters[0])), &sw_rx);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- SUITE ---------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static const struct bench_case cases[] =
+{
+    { "can/hw_filter_drain",                            &hw_filter_drain },
+    { "can/software_filter_drain",                      &software_filter_drain }
+};
+
+
+const struct bench_suite bench_can_suite =
+{
+    .cases = cases,
+    .count = sizeof(cases) / sizeof(cases[0])
+};
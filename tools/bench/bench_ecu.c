@@ -0,0 +1,361 @@
+/**
+ * @file
+ * @brief Benchmarks for the ECU primitives on our hot paths: FSM
+ * dispatch and timer arm, disarm and collection tick.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "bench.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* External libraries. ECU. */
+#include "ecu/fsm.h"
+#include "ecu/interface/itimer.h"
+#include "ecu/timer.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Timers that stay armed in the collection during every timer case
+ * so lists are not trivially short. Roughly a board with this many LEDs.
+ */
+#define BACKGROUND_TIMERS                       (16U)
+
+/**
+ * @brief Timers armed or disarmed back to back per timed phase. The
+ * collection holds between BACKGROUND_TIMERS and BACKGROUND_TIMERS +
+ * PHASE_TIMERS timers while they are measured.
+ */
+#define PHASE_TIMERS                            (256U)
+
+/**
+ * @brief Far enough in the future that background timers never expire.
+ */
+#define NEVER_TICKS                             (1000000U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static enum ecu_fsm_status handled_state_handler(struct ecu_fsm *me, const struct ecu_event *evt);
+static enum ecu_fsm_status a_state_handler(struct ecu_fsm *me, const struct ecu_event *evt);
+static enum ecu_fsm_status b_state_handler(struct ecu_fsm *me, const struct ecu_event *evt);
+
+static ecu_max_tick_size_t get_ticks(struct i_ecu_timer *me);
+static bool idle_callback(void *obj);
+static bool rearm_callback(void *obj);
+static void timers_setup(void);
+static void timers_teardown(void);
+
+static uint64_t fsm_dispatch_handled(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t fsm_dispatch_transition(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t timer_arm(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t timer_disarm(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t timer_tick_idle(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t timer_tick_one_expiring(uint64_t iterations, uint64_t *elapsed_ns);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static const struct ecu_fsm_state handled_state =
+{
+    .handler    = &handled_state_handler,
+    .on_entry   = (ecu_fsm_on_entry_handler)0,
+    .on_exit    = (ecu_fsm_on_exit_handler)0
+};
+
+
+static const struct ecu_fsm_state a_state =
+{
+    .handler    = &a_state_handler,
+    .on_entry   = (ecu_fsm_on_entry_handler)0,
+    .on_exit    = (ecu_fsm_on_exit_handler)0
+};
+
+
+static const struct ecu_fsm_state b_state =
+{
+    .handler    = &b_state_handler,
+    .on_entry   = (ecu_fsm_on_entry_handler)0,
+    .on_exit    = (ecu_fsm_on_exit_handler)0
+};
+
+
+static const struct ecu_event bench_event =
+{
+    .id = ECU_USER_EVENT_ID_BEGIN
+};
+
+
+static ecu_max_tick_size_t ticks;
+static struct i_ecu_timer timer_api;
+static struct ecu_timer_collection collection;
+static struct ecu_timer background[BACKGROUND_TIMERS];
+static struct ecu_timer phase[PHASE_TIMERS];
+static struct ecu_timer rearming;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static enum ecu_fsm_status handled_state_handler(struct ecu_fsm *me, const struct ecu_event *evt)
+{
+    (void)me;
+    (void)evt;
+    return ECU_FSM_EVENT_HANDLED;
+}
+
+
+static enum ecu_fsm_status a_state_handler(struct ecu_fsm *me, const struct ecu_event *evt)
+{
+    (void)evt;
+    return ecu_fsm_transition_to_state(me, &b_state);
+}
+
+
+static enum ecu_fsm_status b_state_handler(struct ecu_fsm *me, const struct ecu_event *evt)
+{
+    (void)evt;
+    return ecu_fsm_transition_to_state(me, &a_state);
+}
+
+
+static ecu_max_tick_size_t get_ticks(struct i_ecu_timer *me)
+{
+    (void)me;
+    return ticks;
+}
+
+
+static bool idle_callback(void *obj)
+{
+    (void)obj;
+    return true;
+}
+
+
+static bool rearm_callback(void *obj)
+{
+    /* Same pattern as the held down state. Timer callback re-arms the timer. */
+    ecu_timer_arm(&collection, (struct ecu_timer *)obj, false, 0);
+    return true;
+}
+
+
+static void timers_setup(void)
+{
+    ticks = 0;
+    i_ecu_timer_ctor(&timer_api, sizeof(ecu_max_tick_size_t), &get_ticks);
+    ecu_timer_collection_ctor(&collection, &timer_api);
+
+    for (uint32_t i = 0; i < BACKGROUND_TIMERS; i++)
+    {
+        ecu_timer_ctor(&background[i], (void *)0, &idle_callback);
+        ecu_timer_arm(&collection, &background[i], false, NEVER_TICKS);
+    }
+
+    for (uint32_t i = 0; i < PHASE_TIMERS; i++)
+    {
+        ecu_timer_ctor(&phase[i], (void *)0, &idle_callback);
+    }
+
+    ecu_timer_ctor(&rearming, (void *)&rearming, &rearm_callback);
+}
+
+
+static void timers_teardown(void)
+{
+    for (uint32_t i = 0; i < BACKGROUND_TIMERS; i++)
+    {
+        ecu_timer_disarm(&background[i]);
+    }
+
+    for (uint32_t i = 0; i < PHASE_TIMERS; i++)
+    {
+        ecu_timer_disarm(&phase[i]);
+    }
+
+    ecu_timer_disarm(&rearming);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- ECU FSM CASES -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t fsm_dispatch_handled(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    struct ecu_fsm fsm;
+    uint64_t start = 0;
+
+    ecu_fsm_ctor(&fsm, &handled_state);
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        ecu_fsm_dispatch(&fsm, &bench_event);
+    }
+    *elapsed_ns = bench_now_ns() - start;
+
+    return iterations;
+}
+
+
+static uint64_t fsm_dispatch_transition(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    struct ecu_fsm fsm;
+    uint64_t start = 0;
+
+    ecu_fsm_ctor(&fsm, &a_state);
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        ecu_fsm_dispatch(&fsm, &bench_event);
+    }
+    *elapsed_ns = bench_now_ns() - start;
+
+    return iterations;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- ECU TIMER CASES ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t timer_arm(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    uint64_t rounds = (iterations + PHASE_TIMERS - 1U) / PHASE_TIMERS;
+    uint64_t start = 0;
+
+    timers_setup();
+    *elapsed_ns = 0;
+    for (uint64_t r = 0; r < rounds; r++)
+    {
+        start = bench_now_ns();
+        for (uint32_t i = 0; i < PHASE_TIMERS; i++)
+        {
+            ecu_timer_arm(&collection, &phase[i], false, NEVER_TICKS);
+        }
+        *elapsed_ns += bench_now_ns() - start;
+
+        for (uint32_t i = 0; i < PHASE_TIMERS; i++)
+        {
+            ecu_timer_disarm(&phase[i]);
+        }
+    }
+    timers_teardown();
+
+    return rounds * PHASE_TIMERS;
+}
+
+
+static uint64_t timer_disarm(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    uint64_t rounds = (iterations + PHASE_TIMERS - 1U) / PHASE_TIMERS;
+    uint64_t start = 0;
+
+    timers_setup();
+    *elapsed_ns = 0;
+    for (uint64_t r = 0; r < rounds; r++)
+    {
+        for (uint32_t i = 0; i < PHASE_TIMERS; i++)
+        {
+            ecu_timer_arm(&collection, &phase[i], false, NEVER_TICKS);
+        }
+
+        start = bench_now_ns();
+        for (uint32_t i = 0; i < PHASE_TIMERS; i++)
+        {
+            ecu_timer_disarm(&phase[i]);
+        }
+        *elapsed_ns += bench_now_ns() - start;
+    }
+    timers_teardown();
+
+    return rounds * PHASE_TIMERS;
+}
+
+
+static uint64_t timer_tick_idle(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    uint64_t start = 0;
+
+    timers_setup();
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        ecu_timer_collection_tick(&collection);
+    }
+    *elapsed_ns = bench_now_ns() - start;
+    timers_teardown();
+
+    return iterations;
+}
+
+
+static uint64_t timer_tick_one_expiring(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    uint64_t start = 0;
+
+    /* Includes the callback re-arming its own timer. */
+    timers_setup();
+    ecu_timer_arm(&collection, &rearming, false, 0);
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        ecu_timer_collection_tick(&collection);
+    }
+    *elapsed_ns = bench_now_ns() - start;
+    timers_teardown();
+
+    return iterations;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- SUITE ---------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static const struct bench_case cases[] =
+{
+    { "ecu_fsm_dispatch/handled",                       &fsm_dispatch_handled },
+    { "ecu_fsm_dispatch/transition",                    &fsm_dispatch_transition },
+    { "ecu_timer_arm/batch_256",                        &timer_arm },
+    { "ecu_timer_disarm/batch_256",                     &timer_disarm },
+    { "ecu_timer_collection_tick/16_armed_idle",        &timer_tick_idle },
+    { "ecu_timer_collection_tick/16_armed_1_expiring",  &timer_tick_one_expiring }
+};
+
+
+const struct bench_suite bench_ecu_suite =
+{
+    .cases = cases,
+    .count = sizeof(cases) / sizeof(cases[0])
+};
@@ -0,0 +1,287 @@
+/**
+ * @file
+ * @brief Same transitions as bench_led_fsm.c, run against the coroutine
+ * version of the behavior in led_behavior.hpp. Resume latency is the
+ * ns/op of each case. RAM per behavior is reported as counters next to
+ * the size of one struct led_fsm.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "bench.h"
+
+/* STDLib. */
+#include <cstddef>
+#include <cstdint>
+
+/* LED behaviors. */
+#include "app/led_behavior.hpp"
+#include "app/led_fsm.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Every behavior in the batch needs its own frame. */
+#define BATCH                                   (app::frame_pool::block_count)
+#define MAX_SETUP_EVENTS                        (3U)
+
+
+
+namespace
+{
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Written by the fake outputs so calls cannot be optimized away.
+ */
+volatile std::uint32_t sink;
+
+
+struct config
+{
+    static constexpr std::uint32_t hold_time_ms = 3000U;
+    static constexpr std::uint32_t toggle_time_ms = 1000U;
+};
+
+
+struct outputs
+{
+    static void led_set(enum led_fsm_led_state state)
+    {
+        sink = static_cast<std::uint32_t>(state);
+    }
+};
+
+
+struct hw_toggle_outputs : outputs
+{
+    static void toggle_start(enum led_fsm_led_state state, std::uint32_t period_ms)
+    {
+        sink = static_cast<std::uint32_t>(state) + period_ms;
+    }
+
+    static enum led_fsm_led_state toggle_stop()
+    {
+        return LED_FSM_LED_STATE_ON;
+    }
+};
+
+
+struct timer
+{
+    static void arm(std::uint32_t ms)
+    {
+        sink = ms;
+    }
+
+    static void disarm()
+    {
+        sink = 0;
+    }
+};
+
+
+/**
+ * @brief Same as the transition struct in bench_led_fsm.c.
+ */
+struct transition
+{
+    std::size_t setup_count;
+    enum led_fsm_event_signals setup[MAX_SETUP_EVENTS];
+    enum led_fsm_event_signals measured;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+app::led_behavior behaviors[BATCH];
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void report_ram()
+{
+    bench_counter("frame_bytes", static_cast<double>(app::frame_pool::largest_request()));
+    bench_counter("ram_per_behavior_bytes", static_cast<double>(app::frame_pool::block_bytes + sizeof(app::led_behavior)));
+    bench_counter("c_object_bytes", static_cast<double>(sizeof(struct led_fsm)));
+}
+
+
+template<typename Outputs>
+std::uint64_t run_transition(const transition &t, std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    std::uint64_t rounds = (iterations + BATCH - 1U) / BATCH;
+    std::uint64_t start = 0;
+
+    for (auto &behavior : behaviors)
+    {
+        behavior = app::led_behavior{};
+    }
+
+    for (auto &behavior : behaviors)
+    {
+        behavior = app::press_and_hold<config, Outputs, timer>();
+        ECU_RUNTIME_ASSERT( (behavior.valid()), BSP_ASSERT_FUNCTOR );
+    }
+
+    *elapsed_ns = 0;
+    for (std::uint64_t r = 0; r < rounds; r++)
+    {
+        for (auto &behavior : behaviors)
+        {
+            for (std::size_t s = 0; s < t.setup_count; s++)
+            {
+                behavior.dispatch(t.setup[s]);
+            }
+        }
+
+        start = bench_now_ns();
+        for (auto &behavior : behaviors)
+        {
+            behavior.dispatch(t.measured);
+        }
+        *elapsed_ns += bench_now_ns() - start;
+
+        /* Back to waiting for a press. Release is ignored if already there. */
+        for (auto &behavior : behaviors)
+        {
+            behavior.dispatch(LED_FSM_SWITCH_RELEASED_EVT);
+        }
+    }
+
+    report_ram();
+    return rounds * BATCH;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------- LED BEHAVIOR CASES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+std::uint64_t create_destroy(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    std::uint64_t start = 0;
+
+    for (auto &behavior : behaviors)
+    {
+        behavior = app::led_behavior{};
+    }
+
+    start = bench_now_ns();
+    for (std::uint64_t i = 0; i < iterations; i++)
+    {
+        app::led_behavior behavior = app::press_and_hold<config, outputs, timer>();
+        sink = static_cast<std::uint32_t>(behavior.valid());
+    }
+    *elapsed_ns = bench_now_ns() - start;
+
+    report_ram();
+    return iterations;
+}
+
+
+std::uint64_t off_to_on(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 0, {}, LED_FSM_SWITCH_PRESSED_EVT };
+    return run_transition<outputs>(t, iterations, elapsed_ns);
+}
+
+
+std::uint64_t on_to_off(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 1, { LED_FSM_SWITCH_PRESSED_EVT }, LED_FSM_SWITCH_RELEASED_EVT };
+    return run_transition<outputs>(t, iterations, elapsed_ns);
+}
+
+
+std::uint64_t on_to_held_down(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 1, { LED_FSM_SWITCH_PRESSED_EVT }, LED_FSM_TIMEOUT_EVT };
+    return run_transition<outputs>(t, iterations, elapsed_ns);
+}
+
+
+std::uint64_t held_down_toggle(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 2, { LED_FSM_SWITCH_PRESSED_EVT, LED_FSM_TIMEOUT_EVT }, LED_FSM_TIMEOUT_EVT };
+    return run_transition<outputs>(t, iterations, elapsed_ns);
+}
+
+
+std::uint64_t held_down_to_off(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 2, { LED_FSM_SWITCH_PRESSED_EVT, LED_FSM_TIMEOUT_EVT }, LED_FSM_SWITCH_RELEASED_EVT };
+    return run_transition<outputs>(t, iterations, elapsed_ns);
+}
+
+
+std::uint64_t on_to_held_down_hw(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 1, { LED_FSM_SWITCH_PRESSED_EVT }, LED_FSM_TIMEOUT_EVT };
+    return run_transition<hw_toggle_outputs>(t, iterations, elapsed_ns);
+}
+
+
+std::uint64_t held_down_to_off_hw(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 2, { LED_FSM_SWITCH_PRESSED_EVT, LED_FSM_TIMEOUT_EVT }, LED_FSM_SWITCH_RELEASED_EVT };
+    return run_transition<hw_toggle_outputs>(t, iterations, elapsed_ns);
+}
+
+
+std::uint64_t off_ignored_release(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 0, {}, LED_FSM_SWITCH_RELEASED_EVT };
+    return run_transition<outputs>(t, iterations, elapsed_ns);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- SUITE ---------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+const struct bench_case cases[] =
+{
+    { "led_behavior/create_destroy",                    &create_destroy },
+    { "led_behavior/off_to_on",                         &off_to_on },
+    { "led_behavior/on_to_off",                         &on_to_off },
+    { "led_behavior/on_to_held_down",                   &on_to_held_down },
+    { "led_behavior/held_down_toggle",                  &held_down_toggle },
+    { "led_behavior/held_down_to_off",                  &held_down_to_off },
+    { "led_behavior/on_to_held_down_hw_toggle",         &on_to_held_down_hw },
+    { "led_behavior/held_down_to_off_hw_toggle",        &held_down_to_off_hw },
+    { "led_behavior/off_ignored_release",               &off_ignored_release }
+};
+
+} /* namespace */
+
+
+extern "C" const struct bench_suite bench_led_behavior_suite =
+{
+    cases,
+    sizeof(cases) / sizeof(cases[0])
+};
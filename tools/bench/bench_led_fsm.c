@@ -0,0 +1,343 @@
+/**
+ * @file
+ * @brief Benchmarks every led_fsm transition. Each case drives a batch of
+ * FSMs into the source state untimed, times one dispatch per FSM, then
+ * returns them to the off state untimed.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "bench.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* LED FSM. */
+#include "app/led_fsm.h"
+
+/* External libraries. ECU. */
+#include "ecu/fsm.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define BATCH                                   (256U)
+#define HOLD_TIME_MS                            (3000U)
+#define TOGGLE_TIME_MS                          (1000U)
+#define MAX_SETUP_EVENTS                        (3U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Describes one transition. Setup events take a FSM from the off
+ * state to the source state. The measured event takes the transition.
+ */
+struct transition
+{
+    bool hw_toggle;
+    size_t setup_count;
+    enum led_fsm_event_signals setup[MAX_SETUP_EVENTS];
+    enum led_fsm_event_signals measured;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void led_set(void *obj, enum led_fsm_led_state state);
+static void timer_arm(void *obj, uint32_t ms);
+static void timer_disarm(void *obj);
+static void toggle_start(void *obj, enum led_fsm_led_state state, uint32_t period_ms);
+static enum led_fsm_led_state toggle_stop(void *obj);
+
+static void dispatch(struct led_fsm *me, enum led_fsm_event_signals signal);
+static uint64_t run_transition(const struct transition *t, uint64_t iterations, uint64_t *elapsed_ns);
+
+static uint64_t off_to_on(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t on_to_off(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t on_to_held_down(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t held_down_toggle(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t held_down_to_off(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t on_to_held_down_hw(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t held_down_to_off_hw(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t off_ignored_release(uint64_t iterations, uint64_t *elapsed_ns);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static const struct led_fsm_event events[] =
+{
+    { .base_event.id = LED_FSM_SWITCH_PRESSED_EVT },
+    { .base_event.id = LED_FSM_SWITCH_RELEASED_EVT },
+    { .base_event.id = LED_FSM_TIMEOUT_EVT }
+};
+
+
+static struct led_fsm fsms[BATCH];
+
+
+/**
+ * @brief Written by the fake interface so calls cannot be optimized away.
+ */
+static volatile uint32_t sink;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- FAKE INTERFACE -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void led_set(void *obj, enum led_fsm_led_state state)
+{
+    (void)obj;
+    sink = (uint32_t)state;
+}
+
+
+static void timer_arm(void *obj, uint32_t ms)
+{
+    (void)obj;
+    sink = ms;
+}
+
+
+static void timer_disarm(void *obj)
+{
+    (void)obj;
+    sink = 0;
+}
+
+
+static void toggle_start(void *obj, enum led_fsm_led_state state, uint32_t period_ms)
+{
+    (void)obj;
+    sink = (uint32_t)state + period_ms;
+}
+
+
+static enum led_fsm_led_state toggle_stop(void *obj)
+{
+    (void)obj;
+    return LED_FSM_LED_STATE_ON;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void dispatch(struct led_fsm *me, enum led_fsm_event_signals signal)
+{
+    ecu_fsm_dispatch((struct ecu_fsm *)me,
+                     (const struct ecu_event *)&events[signal - LED_FSM_SWITCH_PRESSED_EVT]);
+}
+
+
+static uint64_t run_transition(const struct transition *t, uint64_t iterations, uint64_t *elapsed_ns)
+{
+    uint64_t rounds = (iterations + BATCH - 1U) / BATCH;
+    uint64_t start = 0;
+
+    for (size_t i = 0; i < BATCH; i++)
+    {
+        led_fsm_ctor(&fsms[i], HOLD_TIME_MS, TOGGLE_TIME_MS, (void *)0,
+                     &led_set, &timer_arm, &timer_disarm);
+
+        if (t->hw_toggle)
+        {
+            led_fsm_hw_toggle_set(&fsms[i], &toggle_start, &toggle_stop);
+        }
+    }
+
+    *elapsed_ns = 0;
+    for (uint64_t r = 0; r < rounds; r++)
+    {
+        for (size_t i = 0; i < BATCH; i++)
+        {
+            for (size_t s = 0; s < t->setup_count; s++)
+            {
+                dispatch(&fsms[i], t->setup[s]);
+            }
+        }
+
+        start = bench_now_ns();
+        for (size_t i = 0; i < BATCH; i++)
+        {
+            dispatch(&fsms[i], t->measured);
+        }
+        *elapsed_ns += bench_now_ns() - start;
+
+        /* Back to the off state. Release is ignored if already off. */
+        for (size_t i = 0; i < BATCH; i++)
+        {
+            dispatch(&fsms[i], LED_FSM_SWITCH_RELEASED_EVT);
+        }
+    }
+
+    return rounds * BATCH;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- LED FSM CASES -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t off_to_on(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    static const struct transition t =
+    {
+        .hw_toggle = false,
+        .setup_count = 0,
+        .measured = LED_FSM_SWITCH_PRESSED_EVT
+    };
+
+    return run_transition(&t, iterations, elapsed_ns);
+}
+
+
+static uint64_t on_to_off(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    static const struct transition t =
+    {
+        .hw_toggle = false,
+        .setup_count = 1,
+        .setup = { LED_FSM_SWITCH_PRESSED_EVT },
+        .measured = LED_FSM_SWITCH_RELEASED_EVT
+    };
+
+    return run_transition(&t, iterations, elapsed_ns);
+}
+
+
+static uint64_t on_to_held_down(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    static const struct transition t =
+    {
+        .hw_toggle = false,
+        .setup_count = 1,
+        .setup = { LED_FSM_SWITCH_PRESSED_EVT },
+        .measured = LED_FSM_TIMEOUT_EVT
+    };
+
+    return run_transition(&t, iterations, elapsed_ns);
+}
+
+
+static uint64_t held_down_toggle(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    static const struct transition t =
+    {
+        .hw_toggle = false,
+        .setup_count = 2,
+        .setup = { LED_FSM_SWITCH_PRESSED_EVT, LED_FSM_TIMEOUT_EVT },
+        .measured = LED_FSM_TIMEOUT_EVT
+    };
+
+    return run_transition(&t, iterations, elapsed_ns);
+}
+
+
+static uint64_t held_down_to_off(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    static const struct transition t =
+    {
+        .hw_toggle = false,
+        .setup_count = 2,
+        .setup = { LED_FSM_SWITCH_PRESSED_EVT, LED_FSM_TIMEOUT_EVT },
+        .measured = LED_FSM_SWITCH_RELEASED_EVT
+    };
+
+    return run_transition(&t, iterations, elapsed_ns);
+}
+
+
+static uint64_t on_to_held_down_hw(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    static const struct transition t =
+    {
+        .hw_toggle = true,
+        .setup_count = 1,
+        .setup = { LED_FSM_SWITCH_PRESSED_EVT },
+        .measured = LED_FSM_TIMEOUT_EVT
+    };
+
+    return run_transition(&t, iterations, elapsed_ns);
+}
+
+
+static uint64_t held_down_to_off_hw(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    static const struct transition t =
+    {
+        .hw_toggle = true,
+        .setup_count = 2,
+        .setup = { LED_FSM_SWITCH_PRESSED_EVT, LED_FSM_TIMEOUT_EVT },
+        .measured = LED_FSM_SWITCH_RELEASED_EVT
+    };
+
+    return run_transition(&t, iterations, elapsed_ns);
+}
+
+
+static uint64_t off_ignored_release(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    static const struct transition t =
+    {
+        .hw_toggle = false,
+        .setup_count = 0,
+        .measured = LED_FSM_SWITCH_RELEASED_EVT
+    };
+
+    return run_transition(&t, iterations, elapsed_ns);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- SUITE ---------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static const struct bench_case cases[] =
+{
+    { "led_fsm/off_to_on",                              &off_to_on },
+    { "led_fsm/on_to_off",                              &on_to_off },
+    { "led_fsm/on_to_held_down",                        &on_to_held_down },
+    { "led_fsm/held_down_toggle",                       &held_down_toggle },
+    { "led_fsm/held_down_to_off",                       &held_down_to_off },
+    { "led_fsm/on_to_held_down_hw_toggle",              &on_to_held_down_hw },
+    { "led_fsm/held_down_to_off_hw_toggle",             &held_down_to_off_hw },
+    { "led_fsm/off_ignored_release",                    &off_ignored_release }
+};
+
+
+const struct bench_suite bench_led_fsm_suite =
+{
+    .cases = cases,
+    .count = sizeof(cases) / sizeof(cases[0])
+};
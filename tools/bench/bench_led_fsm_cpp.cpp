@@ -0,0 +1,254 @@
+/**
+ * @file
+ * @brief Same transitions as bench_led_fsm.c, run against the header-only
+ * app::led_fsm template so the two can be compared case for case. Every
+ * case also reports the size of one FSM object for both versions.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "bench.h"
+
+/* STDLib. */
+#include <cstddef>
+#include <cstdint>
+
+/* LED FSM. */
+#include "app/led_fsm.h"
+#include "app/led_fsm.hpp"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define BATCH                                   (256U)
+#define MAX_SETUP_EVENTS                        (3U)
+
+
+
+namespace
+{
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Written by the fake outputs so calls cannot be optimized away.
+ */
+volatile std::uint32_t sink;
+
+
+struct config
+{
+    static constexpr std::uint32_t hold_time_ms = 3000U;
+    static constexpr std::uint32_t toggle_time_ms = 1000U;
+};
+
+
+struct outputs
+{
+    static void led_set(enum led_fsm_led_state state)
+    {
+        sink = static_cast<std::uint32_t>(state);
+    }
+};
+
+
+struct hw_toggle_outputs : outputs
+{
+    static void toggle_start(enum led_fsm_led_state state, std::uint32_t period_ms)
+    {
+        sink = static_cast<std::uint32_t>(state) + period_ms;
+    }
+
+    static enum led_fsm_led_state toggle_stop()
+    {
+        return LED_FSM_LED_STATE_ON;
+    }
+};
+
+
+struct timer
+{
+    static void arm(std::uint32_t ms)
+    {
+        sink = ms;
+    }
+
+    static void disarm()
+    {
+        sink = 0;
+    }
+};
+
+
+using sw_fsm = app::led_fsm<config, outputs, timer>;
+using hw_fsm = app::led_fsm<config, hw_toggle_outputs, timer>;
+
+
+/**
+ * @brief Same as the transition struct in bench_led_fsm.c.
+ */
+struct transition
+{
+    std::size_t setup_count;
+    enum led_fsm_event_signals setup[MAX_SETUP_EVENTS];
+    enum led_fsm_event_signals measured;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+sw_fsm sw_fsms[BATCH];
+hw_fsm hw_fsms[BATCH];
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+template<typename Fsm>
+std::uint64_t run_transition(Fsm (&fsms)[BATCH], const transition &t, std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    std::uint64_t rounds = (iterations + BATCH - 1U) / BATCH;
+    std::uint64_t start = 0;
+
+    for (auto &fsm : fsms)
+    {
+        fsm = Fsm{};
+    }
+
+    *elapsed_ns = 0;
+    for (std::uint64_t r = 0; r < rounds; r++)
+    {
+        for (auto &fsm : fsms)
+        {
+            for (std::size_t s = 0; s < t.setup_count; s++)
+            {
+                fsm.dispatch(t.setup[s]);
+            }
+        }
+
+        start = bench_now_ns();
+        for (auto &fsm : fsms)
+        {
+            fsm.dispatch(t.measured);
+        }
+        *elapsed_ns += bench_now_ns() - start;
+
+        /* Back to the off state. Release is ignored if already off. */
+        for (auto &fsm : fsms)
+        {
+            fsm.dispatch(LED_FSM_SWITCH_RELEASED_EVT);
+        }
+    }
+
+    bench_counter("object_bytes", static_cast<double>(sizeof(Fsm)));
+    bench_counter("c_object_bytes", static_cast<double>(sizeof(struct led_fsm)));
+    return rounds * BATCH;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- LED FSM C++ CASES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+std::uint64_t off_to_on(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 0, {}, LED_FSM_SWITCH_PRESSED_EVT };
+    return run_transition(sw_fsms, t, iterations, elapsed_ns);
+}
+
+
+std::uint64_t on_to_off(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 1, { LED_FSM_SWITCH_PRESSED_EVT }, LED_FSM_SWITCH_RELEASED_EVT };
+    return run_transition(sw_fsms, t, iterations, elapsed_ns);
+}
+
+
+std::uint64_t on_to_held_down(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 1, { LED_FSM_SWITCH_PRESSED_EVT }, LED_FSM_TIMEOUT_EVT };
+    return run_transition(sw_fsms, t, iterations, elapsed_ns);
+}
+
+
+std::uint64_t held_down_toggle(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 2, { LED_FSM_SWITCH_PRESSED_EVT, LED_FSM_TIMEOUT_EVT }, LED_FSM_TIMEOUT_EVT };
+    return run_transition(sw_fsms, t, iterations, elapsed_ns);
+}
+
+
+std::uint64_t held_down_to_off(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 2, { LED_FSM_SWITCH_PRESSED_EVT, LED_FSM_TIMEOUT_EVT }, LED_FSM_SWITCH_RELEASED_EVT };
+    return run_transition(sw_fsms, t, iterations, elapsed_ns);
+}
+
+
+std::uint64_t on_to_held_down_hw(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 1, { LED_FSM_SWITCH_PRESSED_EVT }, LED_FSM_TIMEOUT_EVT };
+    return run_transition(hw_fsms, t, iterations, elapsed_ns);
+}
+
+
+std::uint64_t held_down_to_off_hw(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 2, { LED_FSM_SWITCH_PRESSED_EVT, LED_FSM_TIMEOUT_EVT }, LED_FSM_SWITCH_RELEASED_EVT };
+    return run_transition(hw_fsms, t, iterations, elapsed_ns);
+}
+
+
+std::uint64_t off_ignored_release(std::uint64_t iterations, std::uint64_t *elapsed_ns)
+{
+    static const transition t = { 0, {}, LED_FSM_SWITCH_RELEASED_EVT };
+    return run_transition(sw_fsms, t, iterations, elapsed_ns);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- SUITE ---------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+const struct bench_case cases[] =
+{
+    { "led_fsm_cpp/off_to_on",                          &off_to_on },
+    { "led_fsm_cpp/on_to_off",                          &on_to_off },
+    { "led_fsm_cpp/on_to_held_down",                    &on_to_held_down },
+    { "led_fsm_cpp/held_down_toggle",                   &held_down_toggle },
+    { "led_fsm_cpp/held_down_to_off",                   &held_down_to_off },
+    { "led_fsm_cpp/on_to_held_down_hw_toggle",          &on_to_held_down_hw },
+    { "led_fsm_cpp/held_down_to_off_hw_toggle",         &held_down_to_off_hw },
+    { "led_fsm_cpp/off_ignored_release",                &off_ignored_release }
+};
+
+} /* namespace */
+
+
+extern "C" const struct bench_suite bench_led_fsm_cpp_suite =
+{
+    cases,
+    sizeof(cases) / sizeof(cases[0])
+};
@@ -0,0 +1,358 @@
+/**
+ * @file
+ * @brief Compares the pattern sequencer against led_fsm running the same
+ * press and hold behavior on 1000 LEDs. Both are driven through the same
+ * switch schedule on a simulated 1 ms tick. Each LED is pressed once per
+ * cycle, held past its hold time and released, with presses spread
+ * evenly over the cycle. One operation is one LED for one 1 ms pass,
+ * including the switch events posted and the timers or steps that expire
+ * in it.
+ *
+ * The led_fsm side needs a deadline_timer per LED for its timeouts, so
+ * both count toward its RAM per LED. led_changes_per_led_cycle must match
+ * between the two cases, otherwise they did not run the same behavior.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "bench.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Application. */
+#include "app/deadline_timer.h"
+#include "app/led_fsm.h"
+#include "app/led_pattern.h"
+
+/* External libraries. ECU. */
+#include "ecu/fsm.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define CHANNELS                                (1000U)
+#define HOLD_TIME_MS                            (3000U)
+#define TOGGLE_TIME_MS                          (1000U)
+
+/* One press per LED per cycle. LED i is pressed PRESS_SPACING_MS * i into
+the cycle and released RELEASE_AFTER_MS later. */
+#define PRESS_SPACING_MS                        (8U)
+#define CYCLE_MS                                (CHANNELS * PRESS_SPACING_MS)
+#define RELEASE_AFTER_MS                        (6500U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct fsm_channel
+{
+    struct led_fsm fsm;
+    struct deadline_timer timer;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint32_t get_ticks(void *obj);
+static void pattern_led_set(void *obj, uint16_t channel, bool on);
+static void fsm_led_set(void *obj, enum led_fsm_led_state state);
+static void fsm_timer_arm(void *obj, uint32_t ms);
+static void fsm_timer_disarm(void *obj);
+static void fsm_timeout(void *obj);
+
+static bool pressed_now(uint32_t tick, uint16_t *channel);
+static bool released_now(uint32_t tick, uint16_t *channel);
+static uint64_t cycle_passes(uint64_t iterations);
+static void pattern_drive(uint64_t passes);
+static void fsm_drive(uint64_t passes);
+static void report(uint64_t passes, size_t ram_per_led);
+
+static uint64_t pattern_press_and_hold(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t fsm_press_and_hold(uint64_t iterations, uint64_t *elapsed_ns);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static const led_pattern_step press_and_hold_steps[] =
+{
+    LED_PATTERN_OFF(0),
+    LED_PATTERN_WAIT(LED_FSM_SWITCH_PRESSED_EVT),
+    LED_PATTERN_ON(HOLD_TIME_MS),
+    LED_PATTERN_ON(TOGGLE_TIME_MS),
+    LED_PATTERN_OFF(TOGGLE_TIME_MS),
+    LED_PATTERN_LOOP(2U, LED_PATTERN_FOREVER)
+};
+
+
+static const struct led_pattern press_and_hold =
+{
+    .steps = press_and_hold_steps,
+    .count = (uint8_t)(sizeof(press_and_hold_steps) / sizeof(press_and_hold_steps[0])),
+    .restart_event = (uint8_t)LED_FSM_SWITCH_RELEASED_EVT
+};
+
+
+static const struct led_fsm_event events[] =
+{
+    { .base_event.id = LED_FSM_SWITCH_PRESSED_EVT },
+    { .base_event.id = LED_FSM_SWITCH_RELEASED_EVT },
+    { .base_event.id = LED_FSM_TIMEOUT_EVT }
+};
+
+
+static struct led_pattern_engine engine;
+static struct led_pattern_channel pattern_channels[CHANNELS];
+
+static struct deadline_timer_collection timers;
+static struct fsm_channel fsm_channels[CHANNELS];
+
+/* led_fsm sets the LED on every state entry. Levels are tracked here so
+only real changes are counted, as the engine reports them. */
+static bool fsm_levels[CHANNELS];
+
+static uint32_t ticks;
+static uint64_t led_changes;
+
+
+/**
+ * @brief Written by the LED callbacks so calls cannot be optimized away.
+ */
+static volatile uint32_t sink;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- FAKE INTERFACE -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint32_t get_ticks(void *obj)
+{
+    (void)obj;
+    return ticks;
+}
+
+
+static void pattern_led_set(void *obj, uint16_t channel, bool on)
+{
+    (void)obj;
+    sink = (uint32_t)channel + (on ? 1U : 0U);
+    led_changes++;
+}
+
+
+static void fsm_led_set(void *obj, enum led_fsm_led_state state)
+{
+    size_t channel = (size_t)((struct fsm_channel *)obj - &fsm_channels[0]);
+    bool on = (state == LED_FSM_LED_STATE_ON);
+
+    sink = (uint32_t)state;
+    if (fsm_levels[channel] != on)
+    {
+        fsm_levels[channel] = on;
+        led_changes++;
+    }
+}
+
+
+static void fsm_timer_arm(void *obj, uint32_t ms)
+{
+    struct fsm_channel *me = (struct fsm_channel *)obj;
+    deadline_timer_arm(&timers, &me->timer, ms);
+}
+
+
+static void fsm_timer_disarm(void *obj)
+{
+    struct fsm_channel *me = (struct fsm_channel *)obj;
+    deadline_timer_disarm(&me->timer);
+}
+
+
+static void fsm_timeout(void *obj)
+{
+    struct fsm_channel *me = (struct fsm_channel *)obj;
+    ecu_fsm_dispatch((struct ecu_fsm *)&me->fsm,
+                     (const struct ecu_event *)&events[LED_FSM_TIMEOUT_EVT - LED_FSM_SWITCH_PRESSED_EVT]);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static bool pressed_now(uint32_t tick, uint16_t *channel)
+{
+    uint32_t t = tick % CYCLE_MS;
+    *channel = (uint16_t)(t / PRESS_SPACING_MS);
+    return ((t % PRESS_SPACING_MS) == 0);
+}
+
+
+static bool released_now(uint32_t tick, uint16_t *channel)
+{
+    uint32_t t = (tick + CYCLE_MS - (RELEASE_AFTER_MS % CYCLE_MS)) % CYCLE_MS;
+    *channel = (uint16_t)(t / PRESS_SPACING_MS);
+    return ((t % PRESS_SPACING_MS) == 0) && (tick >= RELEASE_AFTER_MS);
+}
+
+
+static uint64_t cycle_passes(uint64_t iterations)
+{
+    /* Whole cycles, so every LED goes through the same presses and
+    releases however many passes are asked for. */
+    uint64_t cycles = (iterations + ((uint64_t)CHANNELS * CYCLE_MS) - 1U) / ((uint64_t)CHANNELS * CYCLE_MS);
+    return cycles * CYCLE_MS;
+}
+
+
+static void pattern_drive(uint64_t passes)
+{
+    uint16_t channel = 0;
+
+    for (uint64_t p = 0; p < passes; p++)
+    {
+        ticks++;
+        if (released_now(ticks, &channel))
+        {
+            (void)led_pattern_post(&engine, channel, (uint8_t)LED_FSM_SWITCH_RELEASED_EVT);
+        }
+        if (pressed_now(ticks, &channel))
+        {
+            (void)led_pattern_post(&engine, channel, (uint8_t)LED_FSM_SWITCH_PRESSED_EVT);
+        }
+        (void)led_pattern_engine_run(&engine);
+    }
+}
+
+
+static void fsm_drive(uint64_t passes)
+{
+    uint16_t channel = 0;
+
+    for (uint64_t p = 0; p < passes; p++)
+    {
+        ticks++;
+        if (released_now(ticks, &channel))
+        {
+            ecu_fsm_dispatch((struct ecu_fsm *)&fsm_channels[channel].fsm,
+                             (const struct ecu_event *)&events[LED_FSM_SWITCH_RELEASED_EVT - LED_FSM_SWITCH_PRESSED_EVT]);
+        }
+        if (pressed_now(ticks, &channel))
+        {
+            ecu_fsm_dispatch((struct ecu_fsm *)&fsm_channels[channel].fsm,
+                             (const struct ecu_event *)&events[LED_FSM_SWITCH_PRESSED_EVT - LED_FSM_SWITCH_PRESSED_EVT]);
+        }
+        (void)deadline_timer_collection_tick(&timers);
+    }
+}
+
+
+static void report(uint64_t passes, size_t ram_per_led)
+{
+    bench_counter("ram_bytes_per_led", (double)ram_per_led);
+    bench_counter("led_changes_per_led_cycle",
+                  (double)led_changes / (((double)passes / (double)CYCLE_MS) * (double)CHANNELS));
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- LED PATTERN CASES ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t pattern_press_and_hold(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    uint64_t passes = cycle_passes(iterations);
+    uint64_t start = 0;
+
+    ticks = 0;
+    led_pattern_engine_ctor(&engine, pattern_channels, CHANNELS, (void *)0, &pattern_led_set, &get_ticks);
+    for (uint16_t i = 0; i < CHANNELS; i++)
+    {
+        led_pattern_start(&engine, i, &press_and_hold);
+    }
+
+    /* Untimed first cycle. The first releases come before some LEDs were
+    ever pressed. */
+    pattern_drive(CYCLE_MS);
+    led_changes = 0;
+
+    start = bench_now_ns();
+    pattern_drive(passes);
+    *elapsed_ns = bench_now_ns() - start;
+
+    report(passes, sizeof(struct led_pattern_channel));
+    bench_counter("flash_bytes_per_behavior", (double)(sizeof(press_and_hold_steps) + sizeof(press_and_hold)));
+    return passes * CHANNELS;
+}
+
+
+static uint64_t fsm_press_and_hold(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    uint64_t passes = cycle_passes(iterations);
+    uint64_t start = 0;
+
+    ticks = 0;
+    deadline_timer_collection_ctor(&timers, (void *)0, &get_ticks);
+    for (uint16_t i = 0; i < CHANNELS; i++)
+    {
+        deadline_timer_ctor(&fsm_channels[i].timer, &fsm_channels[i], &fsm_timeout);
+        led_fsm_ctor(&fsm_channels[i].fsm, HOLD_TIME_MS, TOGGLE_TIME_MS, &fsm_channels[i],
+                     &fsm_led_set, &fsm_timer_arm, &fsm_timer_disarm);
+        fsm_levels[i] = false;
+    }
+
+    fsm_drive(CYCLE_MS);
+    led_changes = 0;
+
+    start = bench_now_ns();
+    fsm_drive(passes);
+    *elapsed_ns = bench_now_ns() - start;
+
+    report(passes, sizeof(struct fsm_channel));
+    return passes * CHANNELS;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- SUITE ---------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static const struct bench_case cases[] =
+{
+    { "led_pattern/press_and_hold_1000_leds",           &pattern_press_and_hold },
+    { "led_pattern/led_fsm_press_and_hold_1000_leds",   &fsm_press_and_hold }
+};
+
+
+const struct bench_suite bench_led_pattern_suite =
+{
+    .cases = cases,
+    .count = sizeof(cases) / sizeof(cases[0])
+};
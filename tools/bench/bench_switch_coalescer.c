@@ -0,0 +1,341 @@
+/**
+ * @file
+ * @brief Replays a seeded noisy switch trace into a led_fsm, once
+ * dispatching every raw event and once through a switch_coalescer. The
+ * trace has contact bounce on every real edge and short glitches while
+ * the switch is idle. ns/op is per raw input event. Counters report
+ * dispatches and timer arm/disarm calls per 1000 input events.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "bench.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Application. */
+#include "app/led_fsm.h"
+#include "app/switch_coalescer.h"
+
+/* External libraries. ECU. */
+#include "ecu/fsm.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define TRACE_SEED                              (0xC0FFEEU)
+#define PASSES                                  (4096U)
+#define MAX_EVENTS_PER_PASS                     (8U)
+#define HOLD_TIME_MS                            (3000U)
+#define TOGGLE_TIME_MS                          (1000U)
+
+/* Chance per pass, in percent. */
+#define EDGE_PERCENT                            (2U)
+#define GLITCH_PERCENT                          (3U)
+#define BOUNCE_SPILL_PERCENT                    (30U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Events sampled during one led_fsms_run() pass, in order.
+ */
+struct pass
+{
+    uint32_t count;
+    enum led_fsm_event_signals events[MAX_EVENTS_PER_PASS];
+};
+
+
+struct totals
+{
+    uint64_t events;
+    uint64_t dispatches;
+    uint64_t timer_ops;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void);
+static enum led_fsm_event_signals level_event(bool pressed);
+static void pass_add(struct pass *p, enum led_fsm_event_signals signal);
+static void trace_build(void);
+
+static void led_set(void *obj, enum led_fsm_led_state state);
+static void timer_arm(void *obj, uint32_t ms);
+static void timer_disarm(void *obj);
+static void dispatch(enum led_fsm_event_signals signal);
+static void report(void);
+
+static uint64_t raw(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t coalesced(uint64_t iterations, uint64_t *elapsed_ns);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static const struct led_fsm_event events[] =
+{
+    { .base_event.id = LED_FSM_SWITCH_PRESSED_EVT },
+    { .base_event.id = LED_FSM_SWITCH_RELEASED_EVT },
+    { .base_event.id = LED_FSM_TIMEOUT_EVT }
+};
+
+
+static uint64_t rand_state;
+static struct pass trace[PASSES];
+static uint64_t trace_events;
+
+static struct led_fsm fsm;
+static struct totals totals;
+
+
+/**
+ * @brief Written by the fake interface so calls cannot be optimized away.
+ */
+static volatile uint32_t sink;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- TRACE -----------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void)
+{
+    /* xorshift64*. Same trace on every host. */
+    rand_state ^= rand_state >> 12;
+    rand_state ^= rand_state << 25;
+    rand_state ^= rand_state >> 27;
+    return rand_state * 0x2545F4914F6CDD1DULL;
+}
+
+
+static enum led_fsm_event_signals level_event(bool pressed)
+{
+    return (pressed) ? LED_FSM_SWITCH_PRESSED_EVT : LED_FSM_SWITCH_RELEASED_EVT;
+}
+
+
+static void pass_add(struct pass *p, enum led_fsm_event_signals signal)
+{
+    if (p->count < MAX_EVENTS_PER_PASS)
+    {
+        p->events[p->count++] = signal;
+    }
+}
+
+
+static void trace_build(void)
+{
+    bool pressed = false;
+
+    if (trace_events > 0)
+    {
+        return;
+    }
+
+    rand_state = TRACE_SEED;
+    for (uint32_t i = 0; i < PASSES; i++)
+    {
+        struct pass *p = &trace[i];
+        uint64_t r = rand_next() % 100U;
+
+        if ((r < EDGE_PERCENT) || ((i == (PASSES - 1U)) && (pressed)))
+        {
+            /* Real edge with an odd number of bounces so it ends on the new level. */
+            uint32_t bounces = (uint32_t)(rand_next() % (MAX_EVENTS_PER_PASS / 2U));
+            pressed = !pressed;
+            pass_add(p, level_event(pressed));
+            for (uint32_t b = 0; b < bounces; b++)
+            {
+                pass_add(p, level_event(!pressed));
+                pass_add(p, level_event(pressed));
+            }
+
+            /* Some bounce spills into the next pass. Never into the last
+            pass, which returns the switch to released for the next replay. */
+            if (((i + 1U) < (PASSES - 1U)) && ((rand_next() % 100U) < BOUNCE_SPILL_PERCENT))
+            {
+                pass_add(&trace[i + 1U], level_event(!pressed));
+                pass_add(&trace[i + 1U], level_event(pressed));
+                i++;
+            }
+        }
+        else if (r < (EDGE_PERCENT + GLITCH_PERCENT))
+        {
+            /* Glitch while idle. */
+            pass_add(p, level_event(!pressed));
+            pass_add(p, level_event(pressed));
+        }
+    }
+
+    for (uint32_t i = 0; i < PASSES; i++)
+    {
+        trace_events += trace[i].count;
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- FAKE INTERFACE -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void led_set(void *obj, enum led_fsm_led_state state)
+{
+    (void)obj;
+    sink = (uint32_t)state;
+}
+
+
+static void timer_arm(void *obj, uint32_t ms)
+{
+    (void)obj;
+    sink = ms;
+    totals.timer_ops++;
+}
+
+
+static void timer_disarm(void *obj)
+{
+    (void)obj;
+    sink = 0;
+    totals.timer_ops++;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void dispatch(enum led_fsm_event_signals signal)
+{
+    totals.dispatches++;
+    ecu_fsm_dispatch((struct ecu_fsm *)&fsm,
+                     (const struct ecu_event *)&events[signal - LED_FSM_SWITCH_PRESSED_EVT]);
+}
+
+
+static void report(void)
+{
+    double per_1000 = (totals.events > 0) ? (1000.0 / (double)totals.events) : 0.0;
+    bench_counter("dispatches_per_1000_events", (double)totals.dispatches * per_1000);
+    bench_counter("timer_ops_per_1000_events", (double)totals.timer_ops * per_1000);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ SWITCH COALESCER CASES -------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t raw(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    uint64_t start = 0;
+    uint64_t rounds = 0;
+
+    trace_build();
+    rounds = (iterations + trace_events - 1U) / trace_events;
+    led_fsm_ctor(&fsm, HOLD_TIME_MS, TOGGLE_TIME_MS, (void *)0, &led_set, &timer_arm, &timer_disarm);
+    totals = (struct totals){0};
+
+    start = bench_now_ns();
+    for (uint64_t r = 0; r < rounds; r++)
+    {
+        for (uint32_t i = 0; i < PASSES; i++)
+        {
+            for (uint32_t e = 0; e < trace[i].count; e++)
+            {
+                dispatch(trace[i].events[e]);
+            }
+        }
+    }
+    *elapsed_ns = bench_now_ns() - start;
+
+    totals.events = rounds * trace_events;
+    report();
+    return totals.events;
+}
+
+
+static uint64_t coalesced(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    struct switch_coalescer input;
+    enum led_fsm_event_signals signal = LED_FSM_SWITCH_PRESSED_EVT;
+    uint64_t start = 0;
+    uint64_t rounds = 0;
+
+    trace_build();
+    rounds = (iterations + trace_events - 1U) / trace_events;
+    led_fsm_ctor(&fsm, HOLD_TIME_MS, TOGGLE_TIME_MS, (void *)0, &led_set, &timer_arm, &timer_disarm);
+    switch_coalescer_ctor(&input, false);
+    totals = (struct totals){0};
+
+    start = bench_now_ns();
+    for (uint64_t r = 0; r < rounds; r++)
+    {
+        for (uint32_t i = 0; i < PASSES; i++)
+        {
+            for (uint32_t e = 0; e < trace[i].count; e++)
+            {
+                switch_coalescer_post(&input, trace[i].events[e]);
+            }
+
+            if (switch_coalescer_take(&input, &signal))
+            {
+                dispatch(signal);
+            }
+        }
+    }
+    *elapsed_ns = bench_now_ns() - start;
+
+    totals.events = rounds * trace_events;
+    report();
+    bench_counter("dropped_percent", (100.0 * (double)input.dropped) / (double)input.posted);
+    return totals.events;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- SUITE ---------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static const struct bench_case cases[] =
+{
+    { "switch_coalescer/raw_noisy_trace",               &raw },
+    { "switch_coalescer/coalesced_noisy_trace",         &coalesced }
+};
+
+
+const struct bench_suite bench_switch_coalescer_suite =
+{
+    .cases = cases,
+    .count = sizeof(cases) / sizeof(cases[0])
+};
@@ -0,0 +1,158 @@
+/**
+ * @file
+ * @brief What a log call costs the code that makes it. The same LED
+ * message is logged with TOKEN_LOG() and, for comparison, formatted
+ * with snprintf() into a text buffer the way a printf-style logger
+ * would before queueing it. Reading the records out is the consumer's
+ * job, off the hot path, so it is done between timed batches.
+ *
+ * Counters report the bytes each message takes in the ring or the text
+ * buffer, and the size of the log_fmt section of this program, i.e. the
+ * format string bytes that would be in flash without tokens. The code
+ * behind snprintf() would be too, which cannot be measured on host.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "bench.h"
+
+/* STDLib. */
+#include <stdint.h>
+#include <stdio.h>
+
+/* Application. */
+#include "app/token_log.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Records of two arguments that fit the ring.
+ */
+#define BATCH                                   (TOKEN_LOG_RING_WORDS / 3U)
+
+/**
+ * @brief One formatted message. Longer ones are cut.
+ */
+#define LINE_MAX                                (32U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t tokenized(uint64_t iterations, uint64_t *elapsed_ns);
+static uint64_t formatted(uint64_t iterations, uint64_t *elapsed_ns);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static struct token_log log_ring;
+static uint8_t records[TOKEN_LOG_RING_WORDS * 4U];
+static char lines[BATCH][LINE_MAX];
+
+
+/**
+ * @brief Defined by the linker around the section.
+ */
+extern const char __start_log_fmt[];
+extern const char __stop_log_fmt[];
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------ LOG CASES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t tokenized(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    uint64_t batches = (iterations + BATCH - 1U) / BATCH;
+    uint64_t start = 0;
+    uint16_t len = 0;
+    uint32_t ms = 0;
+
+    token_log_ctor(&log_ring);
+    *elapsed_ns = 0;
+
+    for (uint64_t b = 0; b < batches; b++)
+    {
+        start = bench_now_ns();
+        for (uint32_t i = 0; i < BATCH; i++)
+        {
+            TOKEN_LOG(&log_ring, "%8u ms  LED%c ON", ms, (uint32_t)('0' + (i & 1U)));
+            ms++;
+        }
+        *elapsed_ns += bench_now_ns() - start;
+
+        len = token_log_read(&log_ring, records, (uint16_t)sizeof(records));
+    }
+
+    bench_counter("bytes_per_message", (double)len / (double)BATCH);
+    bench_counter("dropped", (double)token_log_dropped(&log_ring));
+    bench_counter("format_bytes_not_in_flash", (double)((uintptr_t)__stop_log_fmt - (uintptr_t)__start_log_fmt));
+    return batches * BATCH;
+}
+
+
+static uint64_t formatted(uint64_t iterations, uint64_t *elapsed_ns)
+{
+    uint64_t batches = (iterations + BATCH - 1U) / BATCH;
+    uint64_t start = 0;
+    uint64_t bytes = 0;
+    uint32_t ms = 0;
+    int len = 0;
+
+    *elapsed_ns = 0;
+
+    for (uint64_t b = 0; b < batches; b++)
+    {
+        start = bench_now_ns();
+        for (uint32_t i = 0; i < BATCH; i++)
+        {
+            len = snprintf(lines[i], LINE_MAX, "%8u ms  LED%c ON", (unsigned)ms, (char)('0' + (i & 1U)));
+            ms++;
+        }
+        *elapsed_ns += bench_now_ns() - start;
+
+        bytes = (uint64_t)len + 1U;
+    }
+
+    bench_counter("bytes_per_message", (double)bytes);
+    return batches * BATCH;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- SUITE ---------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static const struct bench_case cases[] =
+{
+    { "token_log/tokenized_2_args",                     &tokenized },
+    { "token_log/snprintf_2_args",                      &formatted }
+};
+
+
+const struct bench_suite bench_token_log_suite =
+{
+    .cases = cases,
+    .count = sizeof(cases) / sizeof(cases[0])
+};
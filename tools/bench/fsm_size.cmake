@@ -0,0 +1,86 @@
+# Code size of the two LED FSMs. Run in script mode by the bench_fsm_size target:
+#
+#   cmake -DNM=<nm> -DC_OBJECTS=<led_fsm.o;ECU objects> -DCPP_OBJECTS=<led_fsm_size.o>
+#         [-DECU_SOURCE_OVERRIDE=<FETCHCONTENT_SOURCE_DIR_ECU>] -P fsm_size.cmake
+#
+# Lists the code symbols (nm types t, T, W) of the C FSM and of the C++ one, smallest first, and
+# totals them. Both sides count the same parts: the constructor, dispatch with the transition it
+# does, and the off, on and held down state handlers. For C that is led_fsm_ctor(), the state
+# handlers and their entry and exit functions in led_fsm.o, and ecu_fsm_ctor(), ecu_fsm_dispatch()
+# and ecu_fsm_transition_to_state() from the ECU objects. For C++ it is led_fsm(), dispatch(),
+# transition() and led_set() of the explicit instantiations of app::led_fsm in led_fsm_size.cpp.
+# Timing, hardware toggle and periodic timer setters, the is_constructed() assert helper and the
+# state accessors have no counterpart on the other side and are left out. The ECU sizes are only
+# those of the pinned ECU commit if FETCHCONTENT_SOURCE_DIR_ECU is not set, which the report says. These are host objects built with the
+# host tool flags, so they compare the two designs, not the firmware's flash use. For that,
+# see the size_report target of a target build.
+cmake_minimum_required(VERSION 3.21)
+
+
+foreach(var IN ITEMS NM C_OBJECTS CPP_OBJECTS)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "fsm_size: ${var} must be defined.")
+    endif()
+endforeach()
+
+
+
+#--------------------------------------------------------------------------------------------------------#
+#------------------------------ SUMS THE CODE SYMBOLS OF OBJECTS. PRINTS EACH. --------------------------#
+#--------------------------------------------------------------------------------------------------------#
+function(fsm_size_report title objects filter out_total)
+    set(total 0)
+    message("${title}")
+
+    foreach(object IN LISTS objects)
+        if(NOT EXISTS "${object}")
+            message(FATAL_ERROR "fsm_size: ${object} does not exist.")
+        endif()
+
+        execute_process(
+            COMMAND ${NM} --size-sort -C -t d "${object}"
+            OUTPUT_VARIABLE symbols
+            RESULT_VARIABLE result
+        )
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "fsm_size: ${NM} failed on ${object}.")
+        endif()
+
+        string(REPLACE "\n" ";" symbols "${symbols}")
+        foreach(line IN LISTS symbols)
+            if(line MATCHES "^0*([0-9]+) [tTW] (.*)$")
+                set(size ${CMAKE_MATCH_1})
+                set(name "${CMAKE_MATCH_2}")
+                if(name MATCHES "${filter}")
+                    math(EXPR total "${total} + ${size}")
+                    string(LENGTH "${size}" width)
+                    math(EXPR pad "8 - ${width}")
+                    string(REPEAT " " ${pad} spaces)
+                    message("  ${spaces}${size}  ${name}")
+                endif()
+            endif()
+        endforeach()
+    endforeach()
+
+    message("  total ${total} bytes\n")
+    set(${out_total} ${total} PARENT_SCOPE)
+endfunction()
+
+
+
+#--------------------------------------------------------------------------------------------------------#
+#------------------------------------------------ REPORT. -----------------------------------------------#
+#--------------------------------------------------------------------------------------------------------#
+if(ECU_SOURCE_OVERRIDE)
+    message("ECU objects built from ${ECU_SOURCE_OVERRIDE} (FETCHCONTENT_SOURCE_DIR_ECU), not the pinned "
+            "commit. The ecu_fsm_*() sizes below are that source's.\n")
+else()
+    message("ECU objects built from the pinned commit.\n")
+endif()
+
+fsm_size_report("C: led_fsm.o ctor and state handlers, ecu_fsm ctor and dispatch (.text)" "${C_OBJECTS}"
+    "^(led_fsm_ctor|(off|on|held_down)_state_(handler|on_entry|on_exit)|ecu_fsm_(ctor|dispatch|transition_to_state))$" c_total)
+fsm_size_report("C++: app::led_fsm<> ctor, dispatch, transition, led_set (.text)" "${CPP_OBJECTS}"
+    "^app::led_fsm<.*>::(led_fsm|dispatch|transition|led_set)\\(" cpp_total)
+
+message("C ${c_total} bytes, C++ ${cpp_total} bytes for two instantiations (software and hardware toggle).")
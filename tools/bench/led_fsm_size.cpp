@@ -0,0 +1,69 @@
+/**
+ * @file
+ * @brief Not linked into anything. Instantiates app::led_fsm the way a
+ * board would, with and without hardware toggling, so the bench_fsm_size
+ * target can read the code size of every member function out of this
+ * object file and compare it with led_fsm.o. The outputs and the timer
+ * are only declared, like BSP functions in another translation unit, so
+ * calls to them stay calls and are not folded into the FSM.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <cstdint>
+
+/* LED FSM. */
+#include "app/led_fsm.h"
+#include "app/led_fsm.hpp"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct size_config
+{
+    static constexpr std::uint32_t hold_time_ms = 3000U;
+    static constexpr std::uint32_t toggle_time_ms = 1000U;
+};
+
+
+struct size_outputs
+{
+    static void led_set(enum led_fsm_led_state state);
+};
+
+
+struct size_hw_toggle_outputs
+{
+    static void led_set(enum led_fsm_led_state state);
+    static void toggle_start(enum led_fsm_led_state state, std::uint32_t period_ms);
+    static enum led_fsm_led_state toggle_stop();
+};
+
+
+struct size_timer
+{
+    static void arm(std::uint32_t ms);
+    static void disarm();
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- INSTANTIATIONS ----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+template class app::led_fsm<size_config, size_outputs, size_timer>;
+template class app::led_fsm<size_config, size_hw_toggle_outputs, size_timer>;
@@ -0,0 +1,604 @@
+/**
+ * @file
+ * @brief Host microbenchmark runner for ECU and application hot paths.
+ * Every case is calibrated to run for at least --min-time-ms, repeated
+ * and the fastest repetition is reported. Usage:
+ *
+ *     bench [--filter=SUBSTRING] [--min-time-ms=N] [--runs=N] [--json=FILE]
+ *           [--compare=BASELINE.json] [--threshold=PERCENT]
+ *
+ * --runs runs the whole selection N times (default 1, at most 15), one
+ * pass over every case after the other, so slow phases of the host hit
+ * all cases alike. Each case reports the median of its N results and how
+ * much slower than that its slowest run was.
+ *
+ * --json writes results as JSON along with the host they were measured
+ * on, the number of runs and whether the ECU was the pinned commit or a
+ * local FETCHCONTENT_SOURCE_DIR_ECU override. Writing over an existing
+ * file keeps the tolerance_percent of every case that has one, so a
+ * baseline can be recorded again without losing them.
+ *
+ * --compare flags every case whose ns/op is more than its tolerance in
+ * the baseline slower than the baseline. Cases without a tolerance use
+ * --threshold percent (default 10). It exits non-zero if any case
+ * regressed or is missing from the baseline, so a change that adds a case
+ * records it in the baseline too. Timings only mean something on the
+ * host and ECU the baseline names. Otherwise the comparison still runs,
+ * with a warning.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "bench.h"
+
+/* STDLib. */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* POSIX. */
+#include <sys/utsname.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define DEFAULT_MIN_TIME_MS                     (100U)
+#define DEFAULT_THRESHOLD_PERCENT               (10.0)
+#define REPETITIONS                             (5U)
+#define DEFAULT_RUNS                            (1U)
+#define MAX_RUNS                                (15U)
+#define CALIBRATION_TIME_NS                     (5000000U)
+#define MAX_RESULTS                             (256U)
+#define MAX_COUNTERS                            (8U)
+#define HOST_MAX                                (160U)
+
+/**
+ * @brief Defined by the build: "pinned" or "override".
+ */
+#ifndef BENCH_ECU_SOURCE
+#define BENCH_ECU_SOURCE                        "unknown"
+#endif
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct result
+{
+    const char *name;
+    double ns_per_op;
+    uint64_t operations;
+    double slowest_run_percent;     /* Slowest run over the median. 0 for one run. */
+
+    size_t counter_count;
+    struct
+    {
+        const char *name;
+        double value;
+    } counters[MAX_COUNTERS];
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void measure(const struct bench_case *bench, uint64_t min_time_ns, struct result *out);
+static int sample_order(const void *a, const void *b);
+static void median_take(struct result *out, double *run_ns, uint32_t runs);
+static void host_describe(char *out, size_t size);
+static bool write_json(const char *path, const struct result *results, size_t count, uint32_t runs);
+static char *read_file(const char *path);
+static bool baseline_lookup(const char *baseline, const char *name, const char *field, double *value);
+static void baseline_string(const char *baseline, const char *field, char *out, size_t size);
+static bool compare(const char *path, const struct result *results, size_t count, double threshold);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static const struct bench_suite *const suites[] =
+{
+    &bench_can_suite,
+    &bench_ecu_suite,
+    &bench_led_fsm_suite,
+    &bench_led_fsm_cpp_suite,
+    &bench_led_behavior_suite,
+    &bench_led_pattern_suite,
+    &bench_switch_coalescer_suite,
+    &bench_token_log_suite
+};
+
+
+static struct result results[MAX_RESULTS];
+
+
+/**
+ * @brief ns/op of every run of every case, fastest repetition each.
+ */
+static double samples[MAX_RESULTS][MAX_RUNS];
+
+
+/**
+ * @brief Result of the case that is currently running. Target of
+ * bench_counter().
+ */
+static struct result *current;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void measure(const struct bench_case *bench, uint64_t min_time_ns, struct result *out)
+{
+    uint64_t iterations = 64;
+    uint64_t elapsed_ns = 0;
+    uint64_t operations = 0;
+
+    /* Step 1: Calibrate. Grow the iteration count until one run is long
+    enough to time reliably, then scale it up to the requested run time. */
+    for (;;)
+    {
+        operations = (*bench->run)(iterations, &elapsed_ns);
+        if ((elapsed_ns >= CALIBRATION_TIME_NS) || (iterations >= (UINT64_MAX / 4U)))
+        {
+            break;
+        }
+        iterations *= 4U;
+    }
+
+    if ((elapsed_ns > 0) && (elapsed_ns < min_time_ns))
+    {
+        iterations = (uint64_t)((double)iterations * ((double)min_time_ns / (double)elapsed_ns));
+    }
+
+    /* Step 2: Keep the fastest repetition. Slower ones are noise from the host. */
+    out->name = bench->name;
+    out->ns_per_op = 0.0;
+    for (uint32_t rep = 0; rep < REPETITIONS; rep++)
+    {
+        double ns_per_op = 0.0;
+        operations = (*bench->run)(iterations, &elapsed_ns);
+        ns_per_op = (operations > 0) ? ((double)elapsed_ns / (double)operations) : 0.0;
+
+        if ((rep == 0) || (ns_per_op < out->ns_per_op))
+        {
+            out->ns_per_op = ns_per_op;
+            out->operations = operations;
+        }
+    }
+}
+
+
+static int sample_order(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+
+static void median_take(struct result *out, double *run_ns, uint32_t runs)
+{
+    double median = 0.0;
+
+    qsort(run_ns, runs, sizeof(run_ns[0]), &sample_order);
+    median = ((runs % 2U) == 1U) ? run_ns[runs / 2U] : ((run_ns[(runs / 2U) - 1U] + run_ns[runs / 2U]) / 2.0);
+
+    out->ns_per_op = median;
+    out->slowest_run_percent = (median > 0.0) ? (((run_ns[runs - 1U] - median) / median) * 100.0) : 0.0;
+}
+
+
+static void host_describe(char *out, size_t size)
+{
+    struct utsname uts;
+    char line[256];
+    char cpu[128] = "unknown CPU";
+    FILE *f = fopen("/proc/cpuinfo", "r");
+
+    if (f)
+    {
+        while (fgets(line, sizeof(line), f))
+        {
+            const char *colon = strchr(line, ':');
+            if ((strncmp(line, "model name", 10) == 0) && colon)
+            {
+                snprintf(cpu, sizeof(cpu), "%s", colon + 2);
+                cpu[strcspn(cpu, "\n")] = '\0';
+                break;
+            }
+        }
+        fclose(f);
+    }
+
+    if (uname(&uts) == 0)
+    {
+        snprintf(out, size, "%.100s, %.20s %.20s", cpu, uts.sysname, uts.machine);
+    }
+    else
+    {
+        snprintf(out, size, "%s", cpu);
+    }
+
+    /* Written into a JSON string as is. */
+    for (char *c = out; *c; c++)
+    {
+        if ((*c == '"') || (*c == '\\'))
+        {
+            *c = ' ';
+        }
+    }
+}
+
+
+static bool write_json(const char *path, const struct result *res, size_t count, uint32_t runs)
+{
+    char host[HOST_MAX];
+    char *previous = read_file(path);
+    FILE *f = fopen(path, "w");
+    if (!f)
+    {
+        fprintf(stderr, "bench: cannot write %s\n", path);
+        free(previous);
+        return false;
+    }
+
+    host_describe(host, sizeof(host));
+    fprintf(f, "{\n    \"host\": \"%s\",\n    \"ecu\": \"%s\",\n    \"runs\": %" PRIu32 ",\n    \"benchmarks\": [\n",
+            host, BENCH_ECU_SOURCE, runs);
+    for (size_t i = 0; i < count; i++)
+    {
+        double tolerance = 0.0;
+
+        fprintf(f, "        { \"name\": \"%s\", \"ns_per_op\": %.3f, \"operations\": %" PRIu64,
+                res[i].name, res[i].ns_per_op, res[i].operations);
+
+        if (runs > 1U)
+        {
+            fprintf(f, ", \"slowest_run_percent\": %.1f", res[i].slowest_run_percent);
+        }
+
+        if (previous && baseline_lookup(previous, res[i].name, "tolerance_percent", &tolerance))
+        {
+            fprintf(f, ", \"tolerance_percent\": %.1f", tolerance);
+        }
+
+        if (res[i].counter_count > 0)
+        {
+            fprintf(f, ", \"counters\": {");
+            for (size_t c = 0; c < res[i].counter_count; c++)
+            {
+                fprintf(f, "%s \"%s\": %.3f", (c == 0) ? "" : ",",
+                        res[i].counters[c].name, res[i].counters[c].value);
+            }
+            fprintf(f, " }");
+        }
+
+        fprintf(f, " }%s\n", (i + 1U < count) ? "," : "");
+    }
+    fprintf(f, "    ]\n}\n");
+
+    fclose(f);
+    free(previous);
+    return true;
+}
+
+
+static char *read_file(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    char *buf = (char *)0;
+    long size = 0;
+
+    if (!f)
+    {
+        return (char *)0;
+    }
+
+    if ((fseek(f, 0, SEEK_END) == 0) && ((size = ftell(f)) >= 0) && (fseek(f, 0, SEEK_SET) == 0))
+    {
+        buf = (char *)malloc((size_t)size + 1U);
+        if (buf)
+        {
+            size_t n = fread(buf, 1, (size_t)size, f);
+            buf[n] = '\0';
+        }
+    }
+
+    fclose(f);
+    return buf;
+}
+
+
+static bool baseline_lookup(const char *baseline, const char *name, const char *field, double *value)
+{
+    /* Results are written by write_json() so a full JSON parser is not
+    needed. Find the exact name, then the field on the same line. */
+    char key[256];
+    const char *entry = (const char *)0;
+    const char *end = (const char *)0;
+    const char *found = (const char *)0;
+
+    snprintf(key, sizeof(key), "\"name\": \"%s\"", name);
+    entry = strstr(baseline, key);
+    if (!entry)
+    {
+        return false;
+    }
+
+    snprintf(key, sizeof(key), "\"%s\":", field);
+    found = strstr(entry, key);
+    end = strchr(entry, '\n');
+    if (!found || (end && (found > end)))
+    {
+        return false;
+    }
+
+    return (sscanf(found + strlen(key), " %lf", value) == 1);
+}
+
+
+static void baseline_string(const char *baseline, const char *field, char *out, size_t size)
+{
+    char key[32];
+    const char *value = (const char *)0;
+    size_t len = 0;
+
+    snprintf(key, sizeof(key), "\"%s\": \"", field);
+    value = strstr(baseline, key);
+    snprintf(out, size, "unknown");
+    if (value)
+    {
+        value += strlen(key);
+        len = strcspn(value, "\"");
+        snprintf(out, size, "%.*s", (int)len, value);
+    }
+}
+
+
+static bool compare(const char *path, const struct result *res, size_t count, double threshold)
+{
+    char *baseline = read_file(path);
+    char reference[HOST_MAX];
+    char host[HOST_MAX];
+    char ecu[HOST_MAX];
+    size_t regressions = 0;
+    size_t missing = 0;
+
+    if (!baseline)
+    {
+        fprintf(stderr, "bench: cannot read baseline %s\n", path);
+        return false;
+    }
+
+    baseline_string(baseline, "host", reference, sizeof(reference));
+    baseline_string(baseline, "ecu", ecu, sizeof(ecu));
+    host_describe(host, sizeof(host));
+    printf("\nComparing against %s (default threshold %.1f%%)\n", path, threshold);
+    printf("  reference host: %s, ECU: %s\n", reference, ecu);
+    if (strcmp(reference, host) != 0)
+    {
+        printf("  WARNING: running on %s. Timings are not comparable.\n", host);
+    }
+    if (strcmp(ecu, BENCH_ECU_SOURCE) != 0)
+    {
+        printf("  WARNING: built with ECU %s. The ECU cases are not comparable.\n", BENCH_ECU_SOURCE);
+    }
+    if (strcmp(ecu, "pinned") != 0)
+    {
+        printf("  WARNING: the baseline was not recorded against the pinned ECU commit.\n");
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        double base = 0.0;
+        double tolerance = threshold;
+
+        if (!baseline_lookup(baseline, res[i].name, "ns_per_op", &base) || (base <= 0.0))
+        {
+            missing++;
+            printf("  MISSING     %-48s %10.2f ns/op  not in the baseline\n", res[i].name, res[i].ns_per_op);
+        }
+        else
+        {
+            double change = ((res[i].ns_per_op - base) / base) * 100.0;
+            bool regressed = false;
+
+            (void)baseline_lookup(baseline, res[i].name, "tolerance_percent", &tolerance);
+            regressed = (change > tolerance);
+            regressions += (regressed) ? 1U : 0U;
+            printf("  %-11s %-48s %10.2f ns/op  baseline %10.2f  %+7.1f%% of %4.1f%%\n",
+                   (regressed) ? "REGRESSION" : "ok", res[i].name, res[i].ns_per_op, base, change, tolerance);
+        }
+    }
+
+    free(baseline);
+    printf("%zu regression(s), %zu missing from the baseline\n", regressions, missing);
+    return ((regressions == 0) && (missing == 0));
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+
+void bench_counter(const char *name, double value)
+{
+    if (!current)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < current->counter_count; i++)
+    {
+        if (strcmp(current->counters[i].name, name) == 0)
+        {
+            current->counters[i].value = value;
+            return;
+        }
+    }
+
+    if (current->counter_count < MAX_COUNTERS)
+    {
+        current->counters[current->counter_count].name = name;
+        current->counters[current->counter_count].value = value;
+        current->counter_count++;
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- MAIN ----------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    const char *filter = (const char *)0;
+    const char *json_path = (const char *)0;
+    const char *baseline_path = (const char *)0;
+    double threshold = DEFAULT_THRESHOLD_PERCENT;
+    uint64_t min_time_ns = (uint64_t)DEFAULT_MIN_TIME_MS * 1000000U;
+    uint32_t runs = DEFAULT_RUNS;
+    size_t count = 0;
+    bool ok = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--filter=", 9) == 0)
+        {
+            filter = &argv[i][9];
+        }
+        else if (strncmp(argv[i], "--min-time-ms=", 14) == 0)
+        {
+            min_time_ns = strtoull(&argv[i][14], (char **)0, 0) * 1000000U;
+        }
+        else if (strncmp(argv[i], "--runs=", 7) == 0)
+        {
+            runs = (uint32_t)strtoul(&argv[i][7], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--json=", 7) == 0)
+        {
+            json_path = &argv[i][7];
+        }
+        else if (strncmp(argv[i], "--compare=", 10) == 0)
+        {
+            baseline_path = &argv[i][10];
+        }
+        else if (strncmp(argv[i], "--threshold=", 12) == 0)
+        {
+            threshold = strtod(&argv[i][12], (char **)0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--filter=SUBSTRING] [--min-time-ms=N] [--runs=N] [--json=FILE] "
+                            "[--compare=BASELINE.json] [--threshold=PERCENT]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((runs < 1U) || (runs > MAX_RUNS))
+    {
+        fprintf(stderr, "bench: --runs must be 1 to %u\n", MAX_RUNS);
+        return EXIT_FAILURE;
+    }
+
+    for (uint32_t run = 0; run < runs; run++)
+    {
+        if (runs > 1U)
+        {
+            fprintf(stderr, "bench: run %" PRIu32 " of %" PRIu32 "\n", run + 1U, runs);
+        }
+
+        count = 0;
+        for (size_t s = 0; s < (sizeof(suites) / sizeof(suites[0])); s++)
+        {
+            for (size_t c = 0; c < suites[s]->count; c++)
+            {
+                const struct bench_case *bench = &suites[s]->cases[c];
+
+                if ((filter) && (!strstr(bench->name, filter)))
+                {
+                    continue;
+                }
+
+                if (count >= MAX_RESULTS)
+                {
+                    fprintf(stderr, "bench: more than %u cases, increase MAX_RESULTS\n", MAX_RESULTS);
+                    return EXIT_FAILURE;
+                }
+
+                current = &results[count];
+                measure(bench, min_time_ns, current);
+                current = (struct result *)0;
+                samples[count][run] = results[count].ns_per_op;
+                count++;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        median_take(&results[i], samples[i], runs);
+        if (runs > 1U)
+        {
+            printf("%-56s %10.2f ns/op  median of %" PRIu32 ", slowest %+.1f%%\n",
+                   results[i].name, results[i].ns_per_op, runs, results[i].slowest_run_percent);
+        }
+        else
+        {
+            printf("%-56s %10.2f ns/op\n", results[i].name, results[i].ns_per_op);
+        }
+
+        for (size_t c = 0; c < results[i].counter_count; c++)
+        {
+            printf("    %-52s %10.2f\n", results[i].counters[c].name, results[i].counters[c].value);
+        }
+    }
+
+    if (json_path)
+    {
+        ok = write_json(json_path, results, count, runs) && ok;
+    }
+
+    if (baseline_path)
+    {
+        ok = compare(baseline_path, results, count, threshold) && ok;
+    }
+
+    return (ok) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,807 @@
+/**
+ * @file
+ * @brief Drives the CAN driver through the mocked CAN1 registers and the
+ * receive model in can_model.h.
+ *
+ * Filters. Random filter lists of every kind are compiled and loaded.
+ * Checks:
+ *
+ *     1. Compiling succeeds exactly when the kinds fit the 14 banks, and
+ *        uses as few banks as they allow.
+ *     2. After can_init() the controller is on the bus with bit timing
+ *        for the clock, the loaded banks are active and all four
+ *        interrupts are enabled in CAN1 and the NVIC.
+ *     3. Random frames, and frames built to match a filter, are accepted
+ *        by the loaded banks exactly when a filter accepts them, and go
+ *        to the FIFO of a filter that does, with a match index the
+ *        driver turns back into that filter. Remote frames never pass.
+ *
+ * Traffic. Frames arrive at 500 kbit/s with random gaps and bursts. The
+ * receive interrupt is entered after a random latency, sometimes long
+ * enough for a FIFO to overrun, and frames keep arriving while it
+ * drains. Checks:
+ *
+ *     4. Rejected frames are never delivered. Delivered frames come out
+ *        of each FIFO in order with their ID, data and the index of a
+ *        filter of that FIFO that accepts them.
+ *     5. Every frame of one interrupt carries the cycle counter value
+ *        the handler was entered at.
+ *     6. The driver's frame, interrupt and overrun counts agree with the
+ *        model's.
+ *     7. Clock level changes mid run keep the bitrate and the frames.
+ *
+ * Also checks that transmit requests fill the mailbox the controller
+ * names, and that transmit and error interrupts are counted. Reports how
+ * much traffic the banks kept from costing an interrupt and how many
+ * frames each interrupt drained.
+ *
+ * Usage:
+ *
+ *     can_check [--seed=N] [--frames=N]
+ *
+ * Exits with a non-zero status on any violation.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Host model. */
+#include "can_model.h"
+
+/* Drivers. */
+#include "can/can.h"
+#include "cycle_counter/cycle_counter.h"
+#include "registers/registers.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define DEFAULT_SEED                            (1U)
+#define DEFAULT_FRAMES                          (200000U)
+
+/**
+ * @brief Random filter lists compiled, and frames tried on each.
+ */
+#define FILTER_SETS                             (400U)
+#define FRAMES_PER_SET                          (128U)
+#define FILTERS_PER_SET_MAX                     (40U)
+
+/**
+ * @brief Same as the board. The traffic runs at the top clock level.
+ */
+#define CPU_HZ                                  (80000000U)
+#define BITRATE                                 (500000U)
+
+/**
+ * @brief Cortex-M4 exception entry, and what the handler and the receive
+ * callback take per frame.
+ */
+#define ENTRY_CYCLES                            (12U)
+#define DRAIN_FRAME_CYCLES                      (400U)
+
+/**
+ * @brief Frames between clock level changes.
+ */
+#define CLOCK_CHANGE_FRAMES                     (10000U)
+
+#define FIFO_DEPTH                              (3U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief What each FIFO should hold, kept from the model's results.
+ */
+struct mirror
+{
+    struct can_model_frame frames[FIFO_DEPTH];
+    uint8_t count;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void);
+static uint64_t rand_range(uint64_t lo, uint64_t hi);
+static void expect(const char *what, uint32_t actual, uint32_t expected);
+static bool bit_timing_exists(uint32_t pclk1_hz, uint32_t bitrate);
+static void bit_timing_check(uint32_t pclk1_hz, uint32_t bitrate);
+static void filter_random(struct can_filter *filter);
+static uint8_t banks_needed(const struct can_filter *filters, uint8_t count);
+static bool filter_accepts(const struct can_filter *filter, const struct can_model_frame *frame);
+static bool any_accepts(const struct can_model_frame *frame);
+static void frame_random(struct can_model_frame *frame);
+static void controller_init(uint32_t pclk1_hz);
+static void filters_check(void);
+static uint64_t frame_cycles(const struct can_model_frame *frame);
+static uint64_t isr_latency(void);
+static void bus_until(uint64_t now);
+static void offer(void);
+static void rx(const struct can_frame *frame, uint32_t cycles);
+static void traffic_check(uint32_t frames);
+static void tx_check(void);
+static void error_check(void);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief PCLK1 of every board clock level.
+ */
+static const uint32_t pclk1_levels[] = { 4000000U, 16000000U, 48000000U, 80000000U };
+
+static const uint32_t bitrates[] = { 125000U, 250000U, 500000U, 1000000U };
+
+static uint64_t rand_state;
+static uint32_t failures;
+
+static struct can_filter filters[CAN_FILTERS_MAX];
+static uint8_t filter_count;
+static struct can_filter_plan plan;
+
+/* Traffic. */
+static uint64_t sim_now;
+static struct can_model_frame next_frame;
+static uint64_t next_frame_end;
+static uint32_t burst_left;
+static bool isr_pending;
+static uint64_t isr_at;
+static bool in_isr;
+static struct mirror mirrors[CAN_FIFOS];
+static uint32_t delivered[CAN_FIFOS];
+static uint32_t accepted;
+static uint32_t seen_interrupts[CAN_FIFOS];
+static uint8_t current_fifo;
+static uint32_t handler_stamp;
+static uint32_t dwt_last;
+static uint32_t clock_changes;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void)
+{
+    /* xorshift64*. Deterministic for a given seed on every host. */
+    rand_state ^= rand_state >> 12;
+    rand_state ^= rand_state << 25;
+    rand_state ^= rand_state >> 27;
+    return rand_state * 0x2545F4914F6CDD1DULL;
+}
+
+
+static uint64_t rand_range(uint64_t lo, uint64_t hi)
+{
+    return lo + (rand_next() % ((hi - lo) + 1U));
+}
+
+
+static void expect(const char *what, uint32_t actual, uint32_t expected)
+{
+    if (actual != expected)
+    {
+        failures++;
+        fprintf(stderr, "can_check: %s is 0x%08" PRIX32 ", expected 0x%08" PRIX32 "\n", what, actual, expected);
+    }
+}
+
+
+static bool bit_timing_exists(uint32_t pclk1_hz, uint32_t bitrate)
+{
+    for (uint32_t quanta = 8U; quanta <= 16U; quanta++)
+    {
+        if (((pclk1_hz % (bitrate * quanta)) == 0) && ((pclk1_hz / (bitrate * quanta)) <= 1024U))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+static void bit_timing_check(uint32_t pclk1_hz, uint32_t bitrate)
+{
+    uint32_t btr = CAN1->BTR;
+    uint32_t brp = (btr & 0x3FFU) + 1U;
+    uint32_t ts1 = ((btr >> 16) & 0xFU) + 1U;
+    uint32_t ts2 = ((btr >> 20) & 0x7U) + 1U;
+    uint32_t sjw = ((btr >> 24) & 0x3U) + 1U;
+    uint32_t quanta = 1U + ts1 + ts2;
+    uint32_t sample_permille = ((1U + ts1) * 1000U) / quanta;
+
+    /* Exact bitrate, sample point within a quantum of 87.5%, no test
+    modes. */
+    if (((uint64_t)brp * quanta * bitrate != pclk1_hz) || (sjw > ts2) ||
+        (((sample_permille > 875U) ? (sample_permille - 875U) : (875U - sample_permille)) > (1000U / quanta)) ||
+        (btr & 0xC0000000U))
+    {
+        failures++;
+        fprintf(stderr, "can_check: BTR 0x%08" PRIX32 " at %" PRIu32 " Hz for %" PRIu32 " bit/s: %" PRIu32
+                " quanta of %" PRIu32 " clocks, sample point %" PRIu32 " permille\n",
+                btr, pclk1_hz, bitrate, quanta, brp, sample_permille);
+    }
+}
+
+
+static void filter_random(struct can_filter *filter)
+{
+    uint32_t all = 0;
+
+    /* Half the filters take one ID. Masks are mostly narrow so random
+    traffic is mostly rejected, as on a real bus. */
+    filter->extended = ((rand_next() % 2U) == 0);
+    filter->fifo = (uint8_t)(rand_next() % CAN_FIFOS);
+    all = (filter->extended) ? CAN_EXT_ID_MASK : CAN_STD_ID_MASK;
+    if ((rand_next() % 2U) == 0)
+    {
+        filter->mask = all;
+    }
+    else
+    {
+        filter->mask = all & ~((uint32_t)rand_next() & (uint32_t)rand_next() & (uint32_t)rand_next());
+    }
+    filter->id = (uint32_t)rand_next() & all;
+}
+
+
+static uint8_t banks_needed(const struct can_filter *filter_list, uint8_t count)
+{
+    uint8_t n[CAN_FIFOS][4] = {{0}};
+    uint32_t banks = 0;
+    uint8_t kind = 0;
+    static const uint8_t slots[4] = { 1U, 2U, 2U, 4U };
+
+    /* Extended mask, extended list, standard mask, standard list. */
+    for (uint8_t i = 0; i < count; i++)
+    {
+        kind = (filter_list[i].extended) ?
+               ((filter_list[i].mask == CAN_EXT_ID_MASK) ? 1U : 0U) :
+               ((filter_list[i].mask == CAN_STD_ID_MASK) ? 3U : 2U);
+        n[filter_list[i].fifo][kind]++;
+    }
+
+    for (uint8_t f = 0; f < CAN_FIFOS; f++)
+    {
+        for (uint8_t k = 0; k < 4U; k++)
+        {
+            banks += (uint32_t)((n[f][k] + slots[k] - 1U) / slots[k]);
+        }
+    }
+
+    return (banks > UINT8_MAX) ? UINT8_MAX : (uint8_t)banks;
+}
+
+
+static bool filter_accepts(const struct can_filter *filter, const struct can_model_frame *frame)
+{
+    return !frame->remote && (frame->extended == filter->extended) && (((frame->id ^ filter->id) & filter->mask) == 0);
+}
+
+
+static bool any_accepts(const struct can_model_frame *frame)
+{
+    for (uint8_t i = 0; i < filter_count; i++)
+    {
+        if (filter_accepts(&filters[i], frame))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+static void frame_random(struct can_model_frame *frame)
+{
+    const struct can_filter *f = (struct can_filter *)0;
+    uint64_t roll = rand_next() % 100U;
+
+    /* Some built to pass a filter, some of those sent as remote frames,
+    the rest anything. */
+    if ((filter_count > 0) && (roll < 50U))
+    {
+        f = &filters[rand_next() % filter_count];
+        frame->extended = f->extended;
+        frame->id = (f->id & f->mask) |
+                    ((uint32_t)rand_next() & ~f->mask & ((f->extended) ? CAN_EXT_ID_MASK : CAN_STD_ID_MASK));
+        frame->remote = (roll < 5U);
+    }
+    else
+    {
+        frame->extended = ((rand_next() % 2U) == 0);
+        frame->id = (uint32_t)rand_next() & ((frame->extended) ? CAN_EXT_ID_MASK : CAN_STD_ID_MASK);
+        frame->remote = ((rand_next() % 20U) == 0);
+    }
+
+    frame->len = (uint8_t)rand_range(0U, 8U);
+    for (uint8_t i = 0; i < 8U; i++)
+    {
+        frame->data[i] = (i < frame->len) ? (uint8_t)rand_next() : 0U;
+    }
+}
+
+
+static void controller_init(uint32_t pclk1_hz)
+{
+    stm32l432_mock_registers_reset();
+    can_model_reset();
+    cycle_counter_init();
+    can_init(pclk1_hz, BITRATE, &plan, &rx);
+    can_model_service();
+}
+
+
+static void filters_check(void)
+{
+    struct can_model_frame frame;
+    uint32_t banks_mask = 0;
+    uint8_t needed = 0;
+    uint8_t fifo = 0;
+    uint8_t fmi = 0;
+    uint8_t index = 0;
+    bool compiled = false;
+    bool matched = false;
+    uint32_t sets_fit = 0;
+    uint32_t tried = 0;
+    uint32_t passed = 0;
+
+    for (uint32_t set = 0; set < FILTER_SETS; set++)
+    {
+        filter_count = (uint8_t)rand_range(0U, FILTERS_PER_SET_MAX);
+        for (uint8_t i = 0; i < filter_count; i++)
+        {
+            filter_random(&filters[i]);
+        }
+
+        needed = banks_needed(filters, filter_count);
+        compiled = can_filter_compile(filters, filter_count, &plan);
+        if (compiled != (needed <= CAN_FILTER_BANKS))
+        {
+            failures++;
+            fprintf(stderr, "can_check: %u filters needing %u banks %s\n", filter_count, needed,
+                    (compiled) ? "compiled" : "did not compile");
+        }
+        if (!compiled)
+        {
+            continue;
+        }
+        sets_fit++;
+        expect("banks used", plan.banks, needed);
+
+        controller_init(CPU_HZ);
+        banks_mask = (uint32_t)((1UL << plan.banks) - 1UL);
+        expect("RCC APB1ENR1 CAN1EN", RCC->APB1ENR1 & RCC_APB1ENR1_CAN1EN, RCC_APB1ENR1_CAN1EN);
+        expect("GPIOA MODER PA11 PA12", (GPIOA->MODER >> 22) & 0xFU, (GPIO_MODER_ALTERNATE << 2) | GPIO_MODER_ALTERNATE);
+        expect("GPIOA AFRH PA11 PA12", (GPIOA->AFR[1] >> 12) & 0xFFU, 0x99U);
+        expect("CAN MCR", CAN1->MCR & (CAN_MCR_INRQ | CAN_MCR_SLEEP | CAN_MCR_TXFP | CAN_MCR_ABOM),
+               CAN_MCR_TXFP | CAN_MCR_ABOM);
+        expect("CAN FMR FINIT", CAN1->FMR & CAN_FMR_FINIT, 0);
+        expect("CAN FA1R", CAN1->FA1R, banks_mask);
+        expect("CAN IER", CAN1->IER,
+               CAN_IER_FMPIE0 | CAN_IER_FOVIE0 | CAN_IER_FMPIE1 | CAN_IER_FOVIE1 |
+               CAN_IER_TMEIE | CAN_IER_EPVIE | CAN_IER_BOFIE | CAN_IER_ERRIE);
+        expect("NVIC ISER0 CAN1", NVIC->ISER[0] & (0xFU << NVIC_IRQ_CAN1_TX), 0xFU << NVIC_IRQ_CAN1_TX);
+        bit_timing_check(CPU_HZ, BITRATE);
+
+        for (uint32_t i = 0; i < FRAMES_PER_SET; i++)
+        {
+            frame_random(&frame);
+            tried++;
+            matched = can_model_match(&frame, &fifo, &fmi);
+            if (matched != any_accepts(&frame))
+            {
+                failures++;
+                fprintf(stderr, "can_check: %s frame 0x%08" PRIX32 "%s %s by the banks but %s by the filters\n",
+                        (frame.extended) ? "extended" : "standard", frame.id, (frame.remote) ? " remote" : "",
+                        (matched) ? "accepted" : "rejected", (matched) ? "rejected" : "accepted");
+                continue;
+            }
+            if (!matched)
+            {
+                continue;
+            }
+
+            passed++;
+            if (fmi >= plan.fmi_count[fifo])
+            {
+                failures++;
+                fprintf(stderr, "can_check: match index %u of FIFO %u past the %u the driver numbered\n",
+                        fmi, fifo, plan.fmi_count[fifo]);
+                continue;
+            }
+
+            index = plan.fmi_filter[fifo][fmi];
+            if ((index >= filter_count) || (filters[index].fifo != fifo) || !filter_accepts(&filters[index], &frame))
+            {
+                failures++;
+                fprintf(stderr, "can_check: frame 0x%08" PRIX32 " in FIFO %u reported as filter %u, which does not take it\n",
+                        frame.id, fifo, index);
+            }
+        }
+    }
+
+    printf("filters: %u random lists, %" PRIu32 " fit the banks, %" PRIu32 " frames tried, %" PRIu32 " accepted\n",
+           FILTER_SETS, sets_fit, tried, passed);
+}
+
+
+static uint64_t frame_cycles(const struct can_model_frame *frame)
+{
+    uint64_t bits = ((frame->extended) ? 67U : 47U) + ((frame->remote) ? 0U : (8U * (uint64_t)frame->len));
+
+    /* Frame, interframe space and some stuff bits. */
+    bits += rand_range(0U, bits / 5U);
+    return (bits * CPU_HZ) / BITRATE;
+}
+
+
+static uint64_t isr_latency(void)
+{
+    uint64_t roll = rand_next() % 1000U;
+
+    /* Mostly prompt. Sometimes behind a long critical section or a
+    higher priority handler, long enough for a burst to overrun. */
+    if (roll < 850U)
+    {
+        return ENTRY_CYCLES + rand_range(0U, 400U);
+    }
+    if (roll < 980U)
+    {
+        return ENTRY_CYCLES + rand_range(400U, 200U * 80U);
+    }
+    return ENTRY_CYCLES + rand_range(200U * 80U, 1200U * 80U);
+}
+
+
+static void bus_until(uint64_t now)
+{
+    while (next_frame_end <= now)
+    {
+        offer();
+    }
+}
+
+
+static void offer(void)
+{
+    struct mirror *m = (struct mirror *)0;
+    enum can_model_result result = CAN_MODEL_REJECTED;
+    uint8_t fifo = 0;
+    bool expected = any_accepts(&next_frame);
+
+    result = can_model_receive(&next_frame, &fifo);
+    if ((result != CAN_MODEL_REJECTED) != expected)
+    {
+        failures++;
+        fprintf(stderr, "can_check: frame 0x%08" PRIX32 " %s but the filters %s it\n", next_frame.id,
+                (result == CAN_MODEL_REJECTED) ? "rejected" : "received", (expected) ? "accept" : "reject");
+    }
+
+    if (result != CAN_MODEL_REJECTED)
+    {
+        accepted++;
+        m = &mirrors[fifo];
+        if (result == CAN_MODEL_QUEUED)
+        {
+            m->frames[m->count++] = next_frame;
+        }
+        else
+        {
+            m->frames[FIFO_DEPTH - 1U] = next_frame;
+        }
+
+        /* Found by the handler that is draining, or raises one. */
+        if (!in_isr && !isr_pending)
+        {
+            isr_pending = true;
+            isr_at = next_frame_end + isr_latency();
+        }
+    }
+
+    /* Back to back in a burst, otherwise idle for a while. */
+    if ((burst_left == 0) && ((rand_next() % 5U) == 0))
+    {
+        burst_left = (uint32_t)rand_range(3U, 12U);
+    }
+    frame_random(&next_frame);
+    next_frame_end += frame_cycles(&next_frame) + ((burst_left > 0) ? 0U : rand_range(0U, 2000U * 80U));
+    burst_left -= (burst_left > 0) ? 1U : 0U;
+}
+
+
+static void rx(const struct can_frame *frame, uint32_t cycles)
+{
+    const struct can_model_stats *model = can_model_stats();
+    struct mirror *m = (struct mirror *)0;
+    const struct can_model_frame *head = (const struct can_model_frame *)0;
+
+    /* A new handler. Its stamp is the cycle counter when it was entered. */
+    for (uint8_t i = 0; i < CAN_FIFOS; i++)
+    {
+        if (model->interrupts[i] != seen_interrupts[i])
+        {
+            seen_interrupts[i] = model->interrupts[i];
+            current_fifo = i;
+            handler_stamp = dwt_last;
+        }
+    }
+
+    if (cycles != handler_stamp)
+    {
+        failures++;
+        fprintf(stderr, "can_check: frame stamped %" PRIu32 ", handler entered at %" PRIu32 "\n", cycles, handler_stamp);
+    }
+
+    m = &mirrors[current_fifo];
+    if (m->count == 0)
+    {
+        failures++;
+        fprintf(stderr, "can_check: FIFO %u delivered a frame it was never given\n", current_fifo);
+    }
+    else
+    {
+        head = &m->frames[0];
+        if ((frame->id != head->id) || (frame->extended != head->extended) || (frame->len != head->len) ||
+            (memcmp(frame->data, head->data, frame->len) != 0))
+        {
+            failures++;
+            fprintf(stderr, "can_check: FIFO %u delivered 0x%08" PRIX32 " len %u, expected 0x%08" PRIX32 " len %u\n",
+                    current_fifo, frame->id, frame->len, head->id, head->len);
+        }
+        else if ((frame->filter >= filter_count) || (filters[frame->filter].fifo != current_fifo) ||
+                 !filter_accepts(&filters[frame->filter], head))
+        {
+            failures++;
+            fprintf(stderr, "can_check: frame 0x%08" PRIX32 " from FIFO %u reported as filter %u, which does not take it\n",
+                    frame->id, current_fifo, frame->filter);
+        }
+
+        memmove(&m->frames[0], &m->frames[1], sizeof(m->frames[0]) * (size_t)(m->count - 1U));
+        m->count--;
+    }
+    delivered[current_fifo]++;
+
+    /* The bus keeps going while the handler works. */
+    sim_now += DRAIN_FRAME_CYCLES;
+    dwt_last = (uint32_t)sim_now;
+    DWT->CYCCNT = dwt_last;
+    bus_until(sim_now);
+}
+
+
+static void traffic_check(uint32_t frames)
+{
+    const struct can_model_stats *model = can_model_stats();
+    const struct can_stats *driver = can_stats();
+    uint32_t pclk1_hz = CPU_HZ;
+    uint32_t interrupts = 0;
+
+    /* A list that uses both FIFOs and fits. */
+    do
+    {
+        filter_count = (uint8_t)rand_range(4U, 16U);
+        for (uint8_t i = 0; i < filter_count; i++)
+        {
+            filter_random(&filters[i]);
+        }
+    } while (!can_filter_compile(filters, filter_count, &plan));
+    controller_init(CPU_HZ);
+
+    frame_random(&next_frame);
+    next_frame_end = frame_cycles(&next_frame);
+    while (model->frames < frames)
+    {
+        if (isr_pending && (isr_at <= next_frame_end))
+        {
+            sim_now = isr_at;
+            dwt_last = (uint32_t)sim_now;
+            DWT->CYCCNT = dwt_last;
+            isr_pending = false;
+            in_isr = true;
+            can_model_service();
+            in_isr = false;
+            continue;
+        }
+
+        sim_now = next_frame_end;
+        offer();
+
+        /* Between frames, so none arrive while the controller is off the
+        bus. Frames waiting in the FIFOs stay there. */
+        if ((model->frames % CLOCK_CHANGE_FRAMES) == 0)
+        {
+            pclk1_hz = pclk1_levels[rand_next() % (sizeof(pclk1_levels) / sizeof(pclk1_levels[0]))];
+            can_suspend();
+            expect("CAN MSR INAK after suspend", CAN1->MSR & CAN_MSR_INAK, CAN_MSR_INAK);
+            can_resume(pclk1_hz);
+            expect("CAN MCR INRQ after resume", CAN1->MCR & CAN_MCR_INRQ, 0);
+            bit_timing_check(pclk1_hz, BITRATE);
+            clock_changes++;
+        }
+    }
+
+    /* Whatever is still waiting. */
+    sim_now = next_frame_end;
+    dwt_last = (uint32_t)sim_now;
+    DWT->CYCCNT = dwt_last;
+    next_frame_end = UINT64_MAX;
+    in_isr = true;
+    can_model_service();
+    in_isr = false;
+
+    for (uint8_t i = 0; i < CAN_FIFOS; i++)
+    {
+        expect("frames left in the FIFO", mirrors[i].count, 0);
+        expect("driver frames received", driver->rx_frames[i], delivered[i]);
+        expect("driver interrupts", driver->rx_interrupts[i], model->interrupts[i]);
+        expect("driver overruns", driver->rx_overruns[i], model->overruns[i]);
+        expect("frames received", delivered[i], model->queued[i]);
+        interrupts += model->interrupts[i];
+    }
+
+    printf("traffic: %" PRIu32 " frames at %u bit/s over %.1f s, %u filters, %" PRIu32 " clock changes\n",
+           model->frames, BITRATE, (double)sim_now / CPU_HZ, filter_count, clock_changes);
+    printf("  rejected by the banks %" PRIu32 " (%.1f%%), never cost an interrupt\n",
+           model->rejected, (100.0 * model->rejected) / (double)model->frames);
+    for (uint8_t i = 0; i < CAN_FIFOS; i++)
+    {
+        printf("  FIFO %u: %" PRIu32 " received, %" PRIu32 " lost in %" PRIu32 " overruns, %" PRIu32 " interrupts, %.2f frames per interrupt\n",
+               i, delivered[i], model->lost[i], model->overruns[i], model->interrupts[i],
+               (model->interrupts[i] > 0) ? ((double)delivered[i] / (double)model->interrupts[i]) : 0.0);
+    }
+    printf("  %.3f interrupts per bus frame, %.3f per accepted frame\n",
+           (double)interrupts / (double)model->frames, (accepted > 0) ? ((double)interrupts / (double)accepted) : 0.0);
+}
+
+
+static void tx_check(void)
+{
+    struct can_frame frame = { .id = 0x123U, .data = { 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U }, .len = 8U, .extended = false };
+    const struct can_stats *driver = can_stats();
+    uint32_t sent = driver->tx_frames;
+    uint32_t failed = driver->tx_failed;
+
+    /* All empty, the controller names mailbox 0. */
+    CAN1->TSR = CAN_TSR_TME_MASK;
+    expect("can_tx into an empty mailbox", can_tx(&frame), true);
+    expect("CAN TIR0", CAN1->TX[0].TIR, (0x123U << CAN_IR_STID_OFFSET) | CAN_IR_TXRQ);
+    expect("CAN TDTR0", CAN1->TX[0].TDTR & CAN_TDTR_DLC_MASK, 8U);
+    expect("CAN TDLR0", CAN1->TX[0].TDLR, 0x04030201U);
+    expect("CAN TDHR0", CAN1->TX[0].TDHR, 0x08070605U);
+
+    /* Mailbox 0 busy, the controller names mailbox 2. */
+    frame.id = 0x1ABCDEF0U;
+    frame.extended = true;
+    frame.len = 1U;
+    CAN1->TSR = (CAN_TSR_TME_MASK & ~(1U << 26)) | (2U << CAN_TSR_CODE_OFFSET);
+    expect("can_tx into a named mailbox", can_tx(&frame), true);
+    expect("CAN TIR2", CAN1->TX[2].TIR, (0x1ABCDEF0U << CAN_IR_EXID_OFFSET) | CAN_IR_IDE | CAN_IR_TXRQ);
+    expect("CAN TDTR2", CAN1->TX[2].TDTR & CAN_TDTR_DLC_MASK, 1U);
+
+    CAN1->TSR = 0;
+    expect("can_tx with every mailbox busy", can_tx(&frame), false);
+
+    /* Mailbox 0 sent, mailbox 2 failed. Completion flags are write 1 to
+    clear. */
+    CAN1->TSR = CAN_TSR_RQCP(0) | CAN_TSR_TXOK(0) | CAN_TSR_RQCP(2);
+    can1_tx_isr_handler();
+    expect("CAN TSR written by the transmit handler", CAN1->TSR, CAN_TSR_RQCP(0) | CAN_TSR_RQCP(2));
+    expect("driver frames sent", driver->tx_frames - sent, 1U);
+    expect("driver frames failed", driver->tx_failed - failed, 1U);
+}
+
+
+static void error_check(void)
+{
+    const struct can_stats *driver = can_stats();
+    uint32_t passive = driver->error_passive;
+    uint32_t off = driver->bus_off;
+
+    CAN1->ESR = CAN_ESR_EPVF;
+    CAN1->MSR |= CAN_MSR_ERRI;
+    can1_sce_isr_handler();
+    expect("CAN MSR written by the error handler", CAN1->MSR, CAN_MSR_ERRI);
+    expect("driver error passive", driver->error_passive - passive, 1U);
+
+    CAN1->ESR = CAN_ESR_EPVF | CAN_ESR_BOFF;
+    CAN1->MSR |= CAN_MSR_ERRI;
+    can1_sce_isr_handler();
+    expect("driver bus off", driver->bus_off - off, 1U);
+    expect("driver error passive on bus off", driver->error_passive - passive, 1U);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    uint64_t seed = DEFAULT_SEED;
+    uint32_t frames = DEFAULT_FRAMES;
+    uint32_t timings = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+        {
+            seed = strtoull(&argv[i][7], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--frames=", 9) == 0)
+        {
+            frames = (uint32_t)strtoul(&argv[i][9], (char **)0, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--seed=N] [--frames=N]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    rand_state = (seed == 0) ? 1U : seed;
+
+    /* Bit timing on every clock level for every bitrate that divides. */
+    filter_count = 0;
+    (void)can_filter_compile(filters, 0, &plan);
+    for (size_t c = 0; c < (sizeof(pclk1_levels) / sizeof(pclk1_levels[0])); c++)
+    {
+        for (size_t b = 0; b < (sizeof(bitrates) / sizeof(bitrates[0])); b++)
+        {
+            if (!bit_timing_exists(pclk1_levels[c], bitrates[b]))
+            {
+                continue;
+            }
+            stm32l432_mock_registers_reset();
+            can_model_reset();
+            can_init(pclk1_levels[c], bitrates[b], &plan, &rx);
+            bit_timing_check(pclk1_levels[c], bitrates[b]);
+            timings++;
+        }
+    }
+    printf("bit timing: %" PRIu32 " clock and bitrate pairs\n", timings);
+
+    filters_check();
+    traffic_check(frames);
+    tx_check();
+    error_check();
+
+    if (failures > 0)
+    {
+        fprintf(stderr, "can_check: FAIL %" PRIu32 " violations\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
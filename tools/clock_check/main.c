@@ -0,0 +1,411 @@
+/**
+ * @file
+ * @brief Runs clock_init() against mocked RCC, FLASH and PWR registers and
+ * checks the register sequence it writes. A small hardware model runs every
+ * time the driver waits on a status flag (STM32L432_POLL()). It makes ready
+ * and switch status bits follow their enable bits the way hardware does and
+ * then checks the clock tree the driver left at that point:
+ *
+ *     1. HCLK is within the limit of the current voltage range.
+ *     2. Flash wait states are enough for HCLK in the current range.
+ *     3. PLL configuration and its MSI input never change while the PLL is on.
+ *     4. PWR is only written with its bus clock enabled.
+ *
+ * A list of clock configurations is applied back to back, starting from the
+ * reset state, so both speeding up and slowing down are covered. Final
+ * register values of every step and fpu_enable() / systick_init() /
+ * systick_clock_set() / watchdog_init() are checked as well. Exits with a non-zero status on any violation.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Drivers. */
+#include "clock/clock.h"
+#include "fpu/fpu.h"
+#include "registers/registers.h"
+#include "systick/systick.h"
+#include "watchdog/watchdog.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief A wait that polls this often in one clock_init() never ends.
+ */
+#define MAX_POLLS_PER_STEP                      (1000U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct step
+{
+    const char *name;
+    struct clock_config config;
+
+    /* Expected once clock_init() returns. */
+    uint32_t hclk_hz;
+    uint32_t apb1_timer_hz;
+    uint32_t latency;
+};
+
+
+struct model
+{
+    uint32_t polls;
+    uint32_t violations;
+
+    /* PLL state seen at the previous poll. */
+    bool pll_on;
+    uint32_t pllcfgr;
+    uint32_t msirange;
+
+    uint32_t pwr_cr1;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void violation(const char *what, uint32_t a, uint32_t b);
+static uint32_t model_sysclk_hz(void);
+static uint32_t model_hclk_hz(void);
+static void model_poll(void);
+static void expect(const char *what, uint32_t actual, uint32_t expected);
+static void watchdog_early_warning(void);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static const uint32_t msi_table[] =
+{
+    100000U, 200000U, 400000U, 800000U, 1000000U, 2000000U,
+    4000000U, 8000000U, 16000000U, 24000000U, 32000000U, 48000000U
+};
+
+
+/**
+ * @brief Applied in order. Each step starts from the state the previous one left.
+ */
+static const struct step steps[] =
+{
+    {
+        .name = "reset -> 80 MHz PLL (board)",
+        .config = { CLOCK_VOLTAGE_RANGE_1, CLOCK_MSI_4MHZ, CLOCK_SYSCLK_PLL, 1, 40, 2, 1, 1, 1, true, true, true },
+        .hclk_hz = 80000000U, .apb1_timer_hz = 80000000U, .latency = 4
+    },
+    {
+        .name = "80 MHz PLL -> 16 MHz MSI range 2",
+        .config = { CLOCK_VOLTAGE_RANGE_2, CLOCK_MSI_16MHZ, CLOCK_SYSCLK_MSI, 0, 0, 0, 1, 1, 1, true, true, true },
+        .hclk_hz = 16000000U, .apb1_timer_hz = 16000000U, .latency = 2
+    },
+    {
+        .name = "16 MHz MSI range 2 -> 80 MHz PLL from 48 MHz MSI",
+        .config = { CLOCK_VOLTAGE_RANGE_1, CLOCK_MSI_48MHZ, CLOCK_SYSCLK_PLL, 6, 20, 2, 1, 1, 1, true, true, true },
+        .hclk_hz = 80000000U, .apb1_timer_hz = 80000000U, .latency = 4
+    },
+    {
+        .name = "80 MHz PLL -> 24 MHz PLL range 2, APB1 / 4",
+        .config = { CLOCK_VOLTAGE_RANGE_2, CLOCK_MSI_4MHZ, CLOCK_SYSCLK_PLL, 1, 24, 4, 1, 4, 1, false, true, false },
+        .hclk_hz = 24000000U, .apb1_timer_hz = 12000000U, .latency = 3
+    },
+    {
+        .name = "24 MHz PLL range 2 -> 40 MHz HCLK from 80 MHz PLL",
+        .config = { CLOCK_VOLTAGE_RANGE_1, CLOCK_MSI_4MHZ, CLOCK_SYSCLK_PLL, 1, 40, 2, 2, 1, 1, true, true, true },
+        .hclk_hz = 40000000U, .apb1_timer_hz = 40000000U, .latency = 2
+    },
+    {
+        .name = "40 MHz HCLK -> 100 kHz MSI range 2",
+        .config = { CLOCK_VOLTAGE_RANGE_2, CLOCK_MSI_100KHZ, CLOCK_SYSCLK_MSI, 0, 0, 0, 1, 1, 1, false, false, false },
+        .hclk_hz = 100000U, .apb1_timer_hz = 100000U, .latency = 0
+    }
+};
+
+
+static struct model model;
+static uint32_t failures;
+static uint32_t early_warnings;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------ HARDWARE MODEL ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void violation(const char *what, uint32_t a, uint32_t b)
+{
+    model.violations++;
+    printf("    poll %" PRIu32 ": %s (%" PRIu32 ", %" PRIu32 ")\n", model.polls, what, a, b);
+}
+
+
+static uint32_t model_sysclk_hz(void)
+{
+    uint32_t msi = msi_table[(RCC->CR & RCC_CR_MSIRANGE_MASK) >> RCC_CR_MSIRANGE_OFFSET];
+    uint32_t hz = msi;
+
+    if ((RCC->CFGR & RCC_CFGR_SWS_MASK) == RCC_CFGR_SWS_PLL)
+    {
+        uint32_t m = ((RCC->PLLCFGR & RCC_PLLCFGR_PLLM_MASK) >> RCC_PLLCFGR_PLLM_OFFSET) + 1U;
+        uint32_t n = (RCC->PLLCFGR & RCC_PLLCFGR_PLLN_MASK) >> RCC_PLLCFGR_PLLN_OFFSET;
+        uint32_t r = (((RCC->PLLCFGR & RCC_PLLCFGR_PLLR_MASK) >> RCC_PLLCFGR_PLLR_OFFSET) + 1U) * 2U;
+        hz = ((msi / m) * n) / r;
+    }
+
+    return hz;
+}
+
+
+static uint32_t model_hclk_hz(void)
+{
+    static const uint32_t shifts[] = { 1U, 2U, 3U, 4U, 6U, 7U, 8U, 9U };
+    uint32_t hpre = (RCC->CFGR & RCC_CFGR_HPRE_MASK) >> RCC_CFGR_HPRE_OFFSET;
+    return (hpre & 0x8U) ? (model_sysclk_hz() >> shifts[hpre & 0x7U]) : model_sysclk_hz();
+}
+
+
+static void model_poll(void)
+{
+    enum clock_voltage_range range = CLOCK_VOLTAGE_RANGE_1;
+    uint32_t max_hz = 0;
+    uint32_t hclk = 0;
+    model.polls++;
+
+    /* Hardware. Ready and switch status follow their enables. */
+    RCC->CR = (RCC->CR & RCC_CR_PLLON) ? (RCC->CR | RCC_CR_PLLRDY) : (RCC->CR & ~RCC_CR_PLLRDY);
+    RCC->CR |= RCC_CR_MSIRDY;
+    RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SWS_MASK) | ((RCC->CFGR & RCC_CFGR_SW_MASK) << 2);
+    PWR->SR2 &= ~PWR_SR2_VOSF;
+
+    /* Checks. */
+    range = ((PWR->CR1 & PWR_CR1_VOS_MASK) >> PWR_CR1_VOS_OFFSET == 2U) ? CLOCK_VOLTAGE_RANGE_2 : CLOCK_VOLTAGE_RANGE_1;
+    max_hz = (range == CLOCK_VOLTAGE_RANGE_2) ? 26000000U : 80000000U;
+    hclk = model_hclk_hz();
+
+    if (hclk > max_hz)
+    {
+        violation("HCLK above voltage range limit", hclk, max_hz);
+    }
+    else if ((FLASH->ACR & FLASH_ACR_LATENCY_MASK) < clock_flash_latency(range, hclk))
+    {
+        violation("too few flash wait states for HCLK", FLASH->ACR & FLASH_ACR_LATENCY_MASK, hclk);
+    }
+
+    if ((model.pll_on) && (RCC->CR & RCC_CR_PLLON))
+    {
+        if (RCC->PLLCFGR != model.pllcfgr)
+        {
+            violation("PLLCFGR changed while PLL on", RCC->PLLCFGR, model.pllcfgr);
+        }
+
+        if ((RCC->CR & RCC_CR_MSIRANGE_MASK) != model.msirange)
+        {
+            violation("MSI range changed while PLL on", RCC->CR & RCC_CR_MSIRANGE_MASK, model.msirange);
+        }
+    }
+
+    if ((PWR->CR1 != model.pwr_cr1) && !(RCC->APB1ENR1 & RCC_APB1ENR1_PWREN))
+    {
+        violation("PWR written with its clock off", PWR->CR1, model.pwr_cr1);
+    }
+
+    model.pll_on = ((RCC->CR & RCC_CR_PLLON) != 0);
+    model.pllcfgr = RCC->PLLCFGR;
+    model.msirange = RCC->CR & RCC_CR_MSIRANGE_MASK;
+    model.pwr_cr1 = PWR->CR1;
+
+    if (model.polls > MAX_POLLS_PER_STEP)
+    {
+        printf("    driver never stopped waiting\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void expect(const char *what, uint32_t actual, uint32_t expected)
+{
+    if (actual != expected)
+    {
+        failures++;
+        printf("    %s is 0x%08" PRIX32 ", expected 0x%08" PRIX32 "\n", what, actual, expected);
+    }
+}
+
+
+static void watchdog_early_warning(void)
+{
+    early_warnings++;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- MAIN ----------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+int main(void)
+{
+    /* Step 1: Reset state. MSI is ready out of reset. */
+    stm32l432_mock_registers_reset();
+    stm32l432_mock_poll_hook_set(&model_poll);
+    model.msirange = RCC->CR & RCC_CR_MSIRANGE_MASK;
+    model.pwr_cr1 = PWR->CR1;
+
+    /* Step 2: FPU. */
+    printf("clock_check: fpu_enable\n");
+    fpu_enable();
+    expect("SCB CPACR", SCB->CPACR, SCB_CPACR_CP10_CP11_FULL);
+    expect("FPU FPCCR", FPU->FPCCR & (FPU_FPCCR_ASPEN | FPU_FPCCR_LSPEN), FPU_FPCCR_ASPEN | FPU_FPCCR_LSPEN);
+
+    /* Step 3: Clock tree changes back to back. */
+    for (size_t i = 0; i < (sizeof(steps) / sizeof(steps[0])); i++)
+    {
+        const struct step *s = &steps[i];
+        const struct clock_config *c = &s->config;
+        uint32_t before = failures + model.violations;
+
+        printf("clock_check: %s\n", s->name);
+        model.polls = 0;
+        clock_init(c);
+        model_poll();
+
+        expect("HCLK", clock_hclk_hz(), s->hclk_hz);
+        expect("model HCLK", model_hclk_hz(), s->hclk_hz);
+        expect("APB1 timer clock", clock_apb1_timer_hz(), s->apb1_timer_hz);
+        expect("FLASH ACR LATENCY", FLASH->ACR & FLASH_ACR_LATENCY_MASK, s->latency);
+        expect("FLASH ACR PRFTEN", FLASH->ACR & FLASH_ACR_PRFTEN, (c->prefetch) ? FLASH_ACR_PRFTEN : 0U);
+        expect("FLASH ACR ICEN", FLASH->ACR & FLASH_ACR_ICEN, (c->icache) ? FLASH_ACR_ICEN : 0U);
+        expect("FLASH ACR DCEN", FLASH->ACR & FLASH_ACR_DCEN, (c->dcache) ? FLASH_ACR_DCEN : 0U);
+        expect("PWR CR1 VOS", (PWR->CR1 & PWR_CR1_VOS_MASK) >> PWR_CR1_VOS_OFFSET, (uint32_t)c->voltage_range);
+        expect("RCC CR MSIRANGE", (RCC->CR & RCC_CR_MSIRANGE_MASK) >> RCC_CR_MSIRANGE_OFFSET, (uint32_t)c->msi_range);
+        expect("RCC CR MSIRGSEL", RCC->CR & RCC_CR_MSIRGSEL, RCC_CR_MSIRGSEL);
+
+        if (c->sysclk_source == CLOCK_SYSCLK_PLL)
+        {
+            expect("RCC CFGR SWS", RCC->CFGR & RCC_CFGR_SWS_MASK, RCC_CFGR_SWS_PLL);
+            expect("RCC PLLCFGR", RCC->PLLCFGR,
+                   RCC_PLLCFGR_PLLSRC_MSI | RCC_PLLCFGR_PLLREN |
+                   ((uint32_t)(c->pll_m - 1U) << RCC_PLLCFGR_PLLM_OFFSET) |
+                   ((uint32_t)c->pll_n << RCC_PLLCFGR_PLLN_OFFSET) |
+                   ((uint32_t)((c->pll_r / 2U) - 1U) << RCC_PLLCFGR_PLLR_OFFSET));
+        }
+        else
+        {
+            expect("RCC CFGR SWS", RCC->CFGR & RCC_CFGR_SWS_MASK, RCC_CFGR_SWS_MSI);
+            expect("RCC CR PLLON", RCC->CR & RCC_CR_PLLON, 0);
+        }
+
+        printf("    %s, %" PRIu32 " polls, HCLK %" PRIu32 " Hz, %" PRIu32 " wait states\n",
+               (failures + model.violations == before) ? "ok" : "FAIL",
+               model.polls, clock_hclk_hz(), FLASH->ACR & FLASH_ACR_LATENCY_MASK);
+    }
+
+    /* Step 4: 1 ms SysTick at 80 MHz HCLK. */
+    printf("clock_check: systick_init\n");
+    systick_init(80000000U, 1000U);
+    expect("SysTick LOAD", SYSTICK->LOAD, 79999U);
+    expect("SysTick CTRL", SYSTICK->CTRL, SYSTICK_CTRL_CLKSOURCE | SYSTICK_CTRL_TICKINT | SYSTICK_CTRL_ENABLE);
+    systick_isr_handler();
+    expect("SysTick ticks", systick_get_ticks(), 1U);
+
+    /* 80 to 10 MHz with 30000 of 80000 cycles left. The 3750 cycles left
+    at 10 MHz run as two reloads of 1875. The first interrupt restores the
+    full reload without counting. */
+    printf("clock_check: systick_clock_set\n");
+    SYSTICK->VAL = 30000U;
+    systick_clock_set(10000000U, 1000U);
+    expect("SysTick carry LOAD", SYSTICK->LOAD, 1874U);
+    expect("SysTick carry CTRL", SYSTICK->CTRL, SYSTICK_CTRL_CLKSOURCE | SYSTICK_CTRL_TICKINT | SYSTICK_CTRL_ENABLE);
+
+    /* Back to 80 MHz within the first half. 1000 + 1875 of 10000 cycles
+    left, 23000 at 80 MHz. */
+    SYSTICK->VAL = 1000U;
+    systick_clock_set(80000000U, 1000U);
+    expect("SysTick carry in first half LOAD", SYSTICK->LOAD, 11499U);
+    systick_isr_handler();
+    expect("SysTick carry first half ticks", systick_get_ticks(), 1U);
+    expect("SysTick carry restored LOAD", SYSTICK->LOAD, 79999U);
+    systick_isr_handler();
+    expect("SysTick carry second half ticks", systick_get_ticks(), 2U);
+
+    /* 80 cycles left at 80 MHz are 10 at 10 MHz, too few to split. */
+    SYSTICK->VAL = 80U;
+    systick_clock_set(10000000U, 1000U);
+    expect("SysTick no carry LOAD", SYSTICK->LOAD, 9999U);
+    systick_isr_handler();
+    expect("SysTick no carry ticks", systick_get_ticks(), 3U);
+
+    /* Step 5: 20 ms WWDG at 80 MHz PCLK1 needs the /8 prescaler, 49 steps
+    of 409.6 us. At 4 MHz it needs no prescaler, 20 steps of 1024 us. */
+    printf("clock_check: watchdog_init\n");
+    watchdog_init(80000000U, 20000U, &watchdog_early_warning);
+    expect("RCC APB1ENR1 WWDGEN", RCC->APB1ENR1 & RCC_APB1ENR1_WWDGEN, RCC_APB1ENR1_WWDGEN);
+    expect("DBGMCU APB1FZR1", DBGMCU->APB1FZR1 & DBGMCU_APB1FZR1_DBG_WWDG_STOP, DBGMCU_APB1FZR1_DBG_WWDG_STOP);
+    expect("WWDG CFR", WWDG->CFR, WWDG_CFR_EWI | (3U << WWDG_CFR_WDGTB_OFFSET) | WWDG_CFR_W_MASK);
+    expect("WWDG CR", WWDG->CR, WWDG_CR_WDGA | (0x3FU + 49U));
+    expect("WWDG timeout us", watchdog_timeout_us(), 20070U);
+    expect("NVIC ISER0 WWDG", NVIC->ISER[0] & (1U << NVIC_IRQ_WWDG), 1U << NVIC_IRQ_WWDG);
+
+    watchdog_clock_set(4000000U);
+    expect("WWDG CFR at 4 MHz", WWDG->CFR, WWDG_CFR_EWI | WWDG_CFR_W_MASK);
+    expect("WWDG CR before refresh", WWDG->CR, WWDG_CR_WDGA | (0x3FU + 49U));
+    watchdog_refresh();
+    expect("WWDG CR at 4 MHz", WWDG->CR, WWDG_CR_WDGA | (0x3FU + 20U));
+    expect("WWDG timeout us at 4 MHz", watchdog_timeout_us(), 20480U);
+
+    WWDG->SR = WWDG_SR_EWIF;
+    watchdog_isr_handler();
+    expect("WWDG SR", WWDG->SR, 0);
+    expect("early warnings", early_warnings, 1U);
+
+    /* During a flash page erase the handler refreshes instead, and must not
+    call the early warning function, which would be in flash. */
+    WWDG->CR = WWDG_CR_WDGA | 0x40U;
+    WWDG->SR = WWDG_SR_EWIF;
+    FLASH->SR = FLASH_SR_BSY;
+    watchdog_isr_handler();
+    FLASH->SR = 0;
+    expect("WWDG CR refreshed during erase", WWDG->CR, WWDG_CR_WDGA | (0x3FU + 20U));
+    expect("early warnings during erase", early_warnings, 1U);
+
+    if ((failures + model.violations) > 0)
+    {
+        fprintf(stderr, "clock_check: FAIL %" PRIu32 " wrong register values, %" PRIu32 " sequence violations\n",
+                failures, model.violations);
+        return EXIT_FAILURE;
+    }
+
+    printf("clock_check: ok\n");
+    return EXIT_SUCCESS;
+}
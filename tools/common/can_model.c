@@ -0,0 +1,332 @@
+/**
+ * @file
+ * @brief See can_model.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "can_model.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Drivers. */
+#include "can/can.h"
+#include "registers/registers.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define FIFO_DEPTH                              (3U)
+
+/**
+ * @brief Filter priority when several match. Higher wins.
+ */
+#define RANK_16_MASK                            (0U)
+#define RANK_16_LIST                            (1U)
+#define RANK_32_MASK                            (2U)
+#define RANK_32_LIST                            (3U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct fifo
+{
+    struct can_model_frame frames[FIFO_DEPTH];
+    uint8_t fmi[FIFO_DEPTH];
+    uint8_t count;
+    bool full;
+    bool overrun;
+    uint32_t released;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static volatile uint32_t *rfr(uint8_t fifo);
+static void fifo_load(uint8_t fifo);
+static void poll(void);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static struct fifo fifos[CAN_FIFOS];
+static struct can_model_stats stats;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static volatile uint32_t *rfr(uint8_t fifo)
+{
+    return (fifo == 0U) ? &CAN1->RF0R : &CAN1->RF1R;
+}
+
+
+static void fifo_load(uint8_t fifo)
+{
+    struct fifo *f = &fifos[fifo];
+    const struct can_model_frame *frame = &f->frames[0];
+    struct stm32l432_can_rx_mailbox_regs *mailbox = &CAN1->RX[fifo];
+
+    *rfr(fifo) = f->count | ((f->full) ? CAN_RFR_FULL : 0U) | ((f->overrun) ? CAN_RFR_FOVR : 0U);
+    if (f->count == 0)
+    {
+        return;
+    }
+
+    mailbox->RIR = ((frame->extended) ? ((frame->id << CAN_IR_EXID_OFFSET) | CAN_IR_IDE) : (frame->id << CAN_IR_STID_OFFSET)) |
+                   ((frame->remote) ? CAN_IR_RTR : 0U);
+    mailbox->RDTR = frame->len | ((uint32_t)f->fmi[0] << CAN_RDTR_FMI_OFFSET);
+    mailbox->RDLR = 0;
+    mailbox->RDHR = 0;
+    for (uint8_t i = 0; i < 4U; i++)
+    {
+        mailbox->RDLR |= (uint32_t)frame->data[i] << (8U * i);
+        mailbox->RDHR |= (uint32_t)frame->data[4U + i] << (8U * i);
+    }
+}
+
+
+static void poll(void)
+{
+    uint32_t written = 0;
+    struct fifo *f = (struct fifo *)0;
+
+    /* Mode changes are acknowledged right away. */
+    CAN1->MSR = (CAN1->MSR & ~(CAN_MSR_INAK | CAN_MSR_SLAK)) |
+                ((CAN1->MCR & CAN_MCR_INRQ) ? CAN_MSR_INAK : 0U) |
+                ((CAN1->MCR & CAN_MCR_SLEEP) ? CAN_MSR_SLAK : 0U);
+
+    /* The model never loads RFOM, so a set RFOM is a write from the
+    driver. Its FULL and FOVR bits are write 1 to clear. */
+    for (uint8_t i = 0; i < CAN_FIFOS; i++)
+    {
+        written = *rfr(i);
+        if (!(written & CAN_RFR_RFOM))
+        {
+            continue;
+        }
+
+        f = &fifos[i];
+        if (f->count > 0)
+        {
+            for (uint8_t j = 1; j < f->count; j++)
+            {
+                f->frames[j - 1U] = f->frames[j];
+                f->fmi[j - 1U] = f->fmi[j];
+            }
+            f->count--;
+            f->released++;
+        }
+        f->full = f->full && !(written & CAN_RFR_FULL);
+        f->overrun = f->overrun && !(written & CAN_RFR_FOVR);
+        fifo_load(i);
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+void can_model_reset(void)
+{
+    for (uint8_t i = 0; i < CAN_FIFOS; i++)
+    {
+        fifos[i] = (struct fifo){0};
+        fifo_load(i);
+    }
+    stats = (struct can_model_stats){0};
+    stm32l432_mock_poll_hook_set(&poll);
+    poll();
+}
+
+
+bool can_model_match(const struct can_model_frame *frame, uint8_t *fifo, uint8_t *fmi)
+{
+    uint32_t word32 = 0;
+    uint32_t word16 = 0;
+    uint32_t fr[2] = {0};
+    uint32_t bit = 0;
+    uint8_t base[CAN_FIFOS] = {0};
+    uint8_t bank_fifo = 0;
+    uint8_t slots = 0;
+    uint8_t rank = 0;
+    bool found = false;
+    uint8_t best_rank = 0;
+    bool hit = false;
+
+    /* Nothing is received off the bus or while the filters are set up. */
+    if ((CAN1->MCR & (CAN_MCR_INRQ | CAN_MCR_SLEEP)) || (CAN1->FMR & CAN_FMR_FINIT))
+    {
+        return false;
+    }
+
+    /* The frame as 32-bit and 16-bit scale filters see it. */
+    word32 = ((frame->extended) ? ((frame->id << CAN_IR_EXID_OFFSET) | CAN_IR_IDE) : (frame->id << CAN_IR_STID_OFFSET)) |
+             ((frame->remote) ? CAN_IR_RTR : 0U);
+    word16 = (frame->extended) ?
+             (((frame->id >> 18) << CAN_FILTER16_STID_OFFSET) | CAN_FILTER16_IDE | ((frame->id >> 15) & 0x7U)) :
+             (frame->id << CAN_FILTER16_STID_OFFSET);
+    word16 |= (frame->remote) ? CAN_FILTER16_RTR : 0U;
+
+    for (uint8_t bank = 0; bank < CAN_FILTER_BANKS; bank++)
+    {
+        bit = 1U << bank;
+        bank_fifo = (CAN1->FFA1R & bit) ? 1U : 0U;
+        fr[0] = CAN1->FILTER[bank].FR1;
+        fr[1] = CAN1->FILTER[bank].FR2;
+
+        if (CAN1->FS1R & bit)
+        {
+            slots = (CAN1->FM1R & bit) ? 2U : 1U;
+            rank = (CAN1->FM1R & bit) ? RANK_32_LIST : RANK_32_MASK;
+        }
+        else
+        {
+            slots = (CAN1->FM1R & bit) ? 4U : 2U;
+            rank = (CAN1->FM1R & bit) ? RANK_16_LIST : RANK_16_MASK;
+        }
+
+        /* Inactive banks keep their numbers. */
+        for (uint8_t slot = 0; (CAN1->FA1R & bit) && (slot < slots); slot++)
+        {
+            switch (rank)
+            {
+                case RANK_32_MASK: hit = (((word32 ^ fr[0]) & fr[1]) == 0); break;
+                case RANK_32_LIST: hit = (word32 == fr[slot]); break;
+                case RANK_16_MASK: hit = (((word16 ^ fr[slot]) & (fr[slot] >> 16)) & 0xFFFFU) == 0; break;
+                case RANK_16_LIST: hit = (word16 == ((fr[slot / 2U] >> (16U * (slot % 2U))) & 0xFFFFU)); break;
+                default: hit = false; break;
+            }
+
+            /* Lower bank and earlier slot win ties, so only a better rank
+            replaces a match. */
+            if (hit && (!found || (rank > best_rank)))
+            {
+                found = true;
+                best_rank = rank;
+                *fifo = bank_fifo;
+                *fmi = (uint8_t)(base[bank_fifo] + slot);
+            }
+        }
+
+        base[bank_fifo] = (uint8_t)(base[bank_fifo] + slots);
+    }
+
+    return found;
+}
+
+
+enum can_model_result can_model_receive(const struct can_model_frame *frame, uint8_t *fifo)
+{
+    struct fifo *f = (struct fifo *)0;
+    uint8_t fmi = 0;
+
+    stats.frames++;
+    if (!can_model_match(frame, fifo, &fmi))
+    {
+        stats.rejected++;
+        return CAN_MODEL_REJECTED;
+    }
+
+    f = &fifos[*fifo];
+    if (f->count == FIFO_DEPTH)
+    {
+        f->frames[FIFO_DEPTH - 1U] = *frame;
+        f->fmi[FIFO_DEPTH - 1U] = fmi;
+        stats.lost[*fifo]++;
+        stats.overruns[*fifo] += (f->overrun) ? 0U : 1U;
+        f->overrun = true;
+        fifo_load(*fifo);
+        return CAN_MODEL_OVERRUN;
+    }
+
+    f->frames[f->count] = *frame;
+    f->fmi[f->count] = fmi;
+    f->count++;
+    f->full = f->full || (f->count == FIFO_DEPTH);
+    stats.queued[*fifo]++;
+    fifo_load(*fifo);
+    return CAN_MODEL_QUEUED;
+}
+
+
+uint8_t can_model_pending(uint8_t fifo)
+{
+    return fifos[fifo].count;
+}
+
+
+void can_model_service(void)
+{
+    static const uint32_t fmpie[CAN_FIFOS] = { CAN_IER_FMPIE0, CAN_IER_FMPIE1 };
+    static const uint8_t irq[CAN_FIFOS] = { NVIC_IRQ_CAN1_RX0, NVIC_IRQ_CAN1_RX1 };
+    uint32_t released = 0;
+    bool ran = true;
+
+    while (ran)
+    {
+        ran = false;
+        for (uint8_t i = 0; (i < CAN_FIFOS) && !ran; i++)
+        {
+            if ((fifos[i].count == 0) || !(CAN1->IER & fmpie[i]) ||
+                !(NVIC->ISER[irq[i] / 32U] & (1U << (irq[i] % 32U))))
+            {
+                continue;
+            }
+
+            released = fifos[i].released;
+            stats.interrupts[i]++;
+            if (i == 0U)
+            {
+                can1_rx0_isr_handler();
+            }
+            else
+            {
+                can1_rx1_isr_handler();
+            }
+            if (fifos[i].released == released)
+            {
+                fprintf(stderr, "can_model: FIFO %u handler returned without releasing a frame\n", i);
+                exit(EXIT_FAILURE);
+            }
+            ran = true;
+        }
+    }
+}
+
+
+const struct can_model_stats *can_model_stats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file
+ * @brief Host model of the bxCAN receive path behind the mocked CAN1
+ * registers, for tools that drive the CAN driver.
+ *
+ * Frames offered to the model are run through the filter banks exactly
+ * as the driver programmed them: active banks only, with the hardware's
+ * priority when several filters match (32-bit over 16-bit scale, list
+ * over mask mode, then the lower bank and the earlier slot). The filter
+ * match index is numbered per FIFO in bank order with inactive banks
+ * counted, as the hardware does. Nothing matches while the controller
+ * is off the bus or the filters are in init mode. Each FIFO holds three
+ * frames. A frame arriving at a full FIFO replaces the newest one and
+ * sets FOVR.
+ *
+ * Mocked registers do not react to writes, so the model installs the
+ * poll hook and, on every STM32L432_POLL():
+ *
+ *     - Sets INAK and SLAK in MSR to follow INRQ and SLEEP in MCR.
+ *     - Releases the output mailbox of a FIFO whose RFxR has RFOM set,
+ *       clears the FULL and FOVR bits written with it, and loads the
+ *       next frame.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef CAN_MODEL_H_
+#define CAN_MODEL_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- ENUMS ---------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+enum can_model_result
+{
+    CAN_MODEL_REJECTED,             /* No filter matched. */
+    CAN_MODEL_QUEUED,
+    CAN_MODEL_OVERRUN               /* Replaced the newest frame of a full FIFO. */
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------- CAN MODEL DATA STRUCTURES -----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct can_model_frame
+{
+    uint32_t id;
+    uint8_t data[8];
+    uint8_t len;
+    bool extended;
+    bool remote;
+};
+
+
+struct can_model_stats
+{
+    uint32_t frames;                /* Offered. */
+    uint32_t rejected;
+    uint32_t queued[2];
+    uint32_t lost[2];               /* Frames replaced by a later one. */
+    uint32_t overruns[2];           /* Times FOVR went from clear to set. */
+    uint32_t interrupts[2];         /* Receive handlers run. */
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Empties both FIFOs, clears the stats and installs the poll hook.
+ * Call after stm32l432_mock_registers_reset().
+ */
+extern void can_model_reset(void);
+
+/**
+ * @brief Runs @p frame through the filter banks without receiving it.
+ * Returns false if no filter matched. Otherwise stores the FIFO and the
+ * filter match index it would be received with.
+ */
+extern bool can_model_match(const struct can_model_frame *frame, uint8_t *fifo, uint8_t *fmi);
+
+/**
+ * @brief A frame finished on the bus. Stores the FIFO it went to unless
+ * it was rejected. Does not run interrupt handlers, so it can be called
+ * from inside one to model frames arriving while a FIFO is drained.
+ */
+extern enum can_model_result can_model_receive(const struct can_model_frame *frame, uint8_t *fifo);
+
+/**
+ * @brief Frames waiting in @p fifo.
+ */
+extern uint8_t can_model_pending(uint8_t fifo);
+
+/**
+ * @brief Runs the receive handlers the NVIC would until both FIFOs are
+ * empty or their interrupts are disabled in IER or the NVIC. Both have
+ * the same priority, so FIFO 0 goes first. Set DWT->CYCCNT to the entry
+ * time before calling.
+ */
+extern void can_model_service(void);
+
+extern const struct can_model_stats *can_model_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAN_MODEL_H_ */
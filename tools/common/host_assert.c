@@ -0,0 +1,31 @@
+/**
+ * @file
+ * @brief Assert handler used by application code in host tools. Stands
+ * in for the one each board's bsp.c provides.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Board support package. Asserts. */
+#include "bsp/bsp.h"
+
+/* External libraries. ECU. */
+#include "ecu/asserter.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- GLOBAL VARIABLES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Use ECU's default handler. */
+struct ecu_assert_functor *const BSP_ASSERT_FUNCTOR = (struct ecu_assert_functor *)0;
@@ -0,0 +1,577 @@
+/**
+ * @file
+ * @brief Runs config_store against a RAM model of the L432 flash and
+ * measures what the log costs. The model enforces the rules of the real
+ * part: double words are programmed once between erases and an erase
+ * leaves the page all 0xFF. Erases stay busy for a few passes like the
+ * interrupt driven erase on target.
+ *
+ *     workload    Random sets of 8 byte values (an LED's hold and toggle
+ *                 times) across a few keys, some repeating the stored
+ *                 value. One config_store_run() per pass. Reports write
+ *                 amplification, erases per page and how long sets were
+ *                 held off by compaction.
+ *     boot        Times mounting a full log and looking a key up, against
+ *                 the naive alternative of scanning the log for every
+ *                 lookup.
+ *     power cuts  Cuts power at a random double word program or erase,
+ *                 remounts and checks that every key reads back the last
+ *                 value a set acknowledged, or the one in flight.
+ *
+ * Usage:
+ *
+ *     config_store_model [--seed=N] [--sets=N] [--keys=N] [--pages=N]
+ *                        [--same-percent=N] [--cuts=N]
+ *
+ * Exits with a non-zero status if a value was lost or the store broke a
+ * flash programming rule.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Config store. */
+#include "app/config_store.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define DEFAULT_SEED                            (1U)
+#define DEFAULT_SETS                            (100000U)
+#define DEFAULT_KEYS                            (4U)
+#define DEFAULT_PAGES                           (4U)
+#define DEFAULT_SAME_PERCENT                    (20U)
+#define DEFAULT_CUTS                            (500U)
+
+/**
+ * @brief Same page size as the L432. Passes an erase stays busy for.
+ */
+#define PAGE_SIZE                               (2048U)
+#define ERASE_PASSES                            (3U)
+#define VALUE_SIZE                              (8U)
+
+/**
+ * @brief A set held off for longer than this means compaction is stuck.
+ */
+#define DEFER_PASSES_MAX                        (1000U)
+
+/**
+ * @brief Program/erase cycles the L432 flash is rated for.
+ */
+#define ENDURANCE_CYCLES                        (10000U)
+
+#define BOOT_REPEATS                            (2000U)
+#define LOOKUP_REPEATS                          (1000000U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct flash_model
+{
+    uint8_t bytes[CONFIG_STORE_PAGES_MAX * PAGE_SIZE];
+    uint8_t pages;
+    uint32_t erases[CONFIG_STORE_PAGES_MAX];
+    uint32_t busy_passes;
+    bool powered;
+    int64_t cut_countdown;          /* Operations until the power fails. Negative for never. */
+    uint32_t violations;
+};
+
+
+struct value
+{
+    bool set;
+    uint8_t bytes[VALUE_SIZE];
+};
+
+
+struct workload_result
+{
+    uint32_t deferred_sets;
+    uint32_t deferred_passes_max;
+    bool cut;                       /* Power failed. The set in flight was not acknowledged. */
+    uint16_t in_flight_key;
+    struct value in_flight;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void);
+static uint64_t monotonic_ns(void);
+static bool power_tick(void);
+static bool model_program(void *obj, uint32_t offset, const void *data, uint32_t len);
+static void model_erase_start(void *obj, uint8_t page);
+static bool model_busy(void *obj);
+static void model_reset(uint8_t pages);
+static void store_mount(struct config_store *store);
+static struct workload_result workload(struct config_store *store, uint32_t sets, struct value *acked);
+static const uint8_t *scan_lookup(uint16_t key);
+static bool verify(const struct config_store *store, const struct value *acked, const struct workload_result *r);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_state;
+static uint32_t keys = DEFAULT_KEYS;
+static uint32_t same_percent = DEFAULT_SAME_PERCENT;
+static struct flash_model flash;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void)
+{
+    /* xorshift64*. Deterministic for a given seed on every host. */
+    rand_state ^= rand_state >> 12;
+    rand_state ^= rand_state << 25;
+    rand_state ^= rand_state >> 27;
+    return rand_state * 0x2545F4914F6CDD1DULL;
+}
+
+
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+
+static bool power_tick(void)
+{
+    /* Counts one flash operation. False once the power has failed. */
+    if (flash.powered && (flash.cut_countdown >= 0))
+    {
+        if (flash.cut_countdown == 0)
+        {
+            flash.powered = false;
+        }
+        flash.cut_countdown--;
+    }
+    return flash.powered;
+}
+
+
+static bool model_program(void *obj, uint32_t offset, const void *data, uint32_t len)
+{
+    const uint8_t *src = (const uint8_t *)data;
+    (void)obj;
+
+    if (((offset % 8U) != 0) || ((len % 8U) != 0) || ((offset + len) > ((uint32_t)flash.pages * PAGE_SIZE)))
+    {
+        flash.violations++;
+        return false;
+    }
+
+    for (uint32_t i = 0; i < len; i += 8U)
+    {
+        if (!power_tick())
+        {
+            return false;
+        }
+
+        for (uint32_t j = 0; j < 8U; j++)
+        {
+            if (flash.bytes[offset + i + j] != 0xFFU)
+            {
+                /* PROGERR on target. */
+                flash.violations++;
+                return false;
+            }
+        }
+        memcpy(&flash.bytes[offset + i], &src[i], 8U);
+    }
+
+    return true;
+}
+
+
+static void model_erase_start(void *obj, uint8_t page)
+{
+    (void)obj;
+
+    if (page >= flash.pages)
+    {
+        flash.violations++;
+        return;
+    }
+
+    if (!power_tick())
+    {
+        /* Cut partway. The first half is erased, the rest is not. */
+        memset(&flash.bytes[(uint32_t)page * PAGE_SIZE], 0xFF, PAGE_SIZE / 2U);
+        return;
+    }
+
+    memset(&flash.bytes[(uint32_t)page * PAGE_SIZE], 0xFF, PAGE_SIZE);
+    flash.erases[page]++;
+    flash.busy_passes = ERASE_PASSES;
+}
+
+
+static bool model_busy(void *obj)
+{
+    (void)obj;
+
+    if (flash.busy_passes > 0)
+    {
+        flash.busy_passes--;
+        return true;
+    }
+    return false;
+}
+
+
+static void model_reset(uint8_t pages)
+{
+    memset(&flash, 0, sizeof(flash));
+    memset(flash.bytes, 0xFF, sizeof(flash.bytes));
+    flash.pages = pages;
+    flash.powered = true;
+    flash.cut_countdown = -1;
+}
+
+
+static void store_mount(struct config_store *store)
+{
+    /* A reboot. Whatever the power cut left behind is now the flash. */
+    flash.powered = true;
+    flash.cut_countdown = -1;
+    flash.busy_passes = 0;
+    config_store_ctor(store, flash.bytes, PAGE_SIZE, flash.pages, (void *)0,
+                      &model_program, &model_erase_start, &model_busy);
+}
+
+
+static struct workload_result workload(struct config_store *store, uint32_t sets, struct value *acked)
+{
+    struct workload_result r;
+    struct value next;
+    uint16_t key = 0;
+    uint32_t passes = 0;
+
+    memset(&r, 0, sizeof(r));
+    for (uint32_t i = 0; i < sets; i++)
+    {
+        key = (uint16_t)(rand_next() % keys);
+        next.set = true;
+        if (acked[key].set && ((rand_next() % 100U) < same_percent))
+        {
+            memcpy(next.bytes, acked[key].bytes, VALUE_SIZE);
+        }
+        else
+        {
+            for (uint32_t j = 0; j < VALUE_SIZE; j++)
+            {
+                next.bytes[j] = (uint8_t)rand_next();
+            }
+        }
+
+        /* One main loop pass per attempt. */
+        passes = 0;
+        while (!config_store_set(store, key, next.bytes, VALUE_SIZE))
+        {
+            if (!flash.powered)
+            {
+                break;
+            }
+
+            config_store_run(store);
+            passes++;
+            if (passes > DEFER_PASSES_MAX)
+            {
+                fprintf(stderr, "config_store_model: FAIL set of key %u held off for %u passes\n",
+                        (unsigned)key, (unsigned)passes);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        if (!flash.powered)
+        {
+            r.cut = true;
+            r.in_flight_key = key;
+            r.in_flight = next;
+            return r;
+        }
+
+        acked[key] = next;
+        r.deferred_sets += (passes > 0) ? 1U : 0U;
+        r.deferred_passes_max = (passes > r.deferred_passes_max) ? passes : r.deferred_passes_max;
+
+        config_store_run(store);
+        if (!flash.powered)
+        {
+            r.cut = true;
+            r.in_flight_key = key;
+            r.in_flight = next;
+            return r;
+        }
+    }
+
+    return r;
+}
+
+
+static const uint8_t *scan_lookup(uint16_t key)
+{
+    const uint8_t *found = (const uint8_t *)0;
+    uint32_t found_seq = 0;
+    uint32_t seq = 0;
+    uint32_t offset = 0;
+    uint16_t len = 0;
+
+    /* What a lookup costs without the index. Walks every record of every
+    page and keeps the newest match. Checks headers only. */
+    for (uint32_t page = 0; page < flash.pages; page++)
+    {
+        memcpy(&seq, &flash.bytes[(page * PAGE_SIZE) + 4U], sizeof(seq));
+        if ((seq == 0xFFFFFFFFU) || (seq < found_seq))
+        {
+            continue;
+        }
+
+        for (offset = 8U; (offset + 8U) <= PAGE_SIZE; offset += 8U + ((len + 7U) & ~7U))
+        {
+            const uint8_t *record = &flash.bytes[(page * PAGE_SIZE) + offset];
+            uint16_t record_key = (uint16_t)(record[0] | (record[1] << 8));
+            len = (uint16_t)(record[2] | (record[3] << 8));
+            if ((record_key == 0xFFFFU) || (len > CONFIG_STORE_VALUE_MAX))
+            {
+                break;
+            }
+            if (record_key == key)
+            {
+                found = &record[8];
+                found_seq = seq;
+            }
+        }
+    }
+
+    return found;
+}
+
+
+static bool verify(const struct config_store *store, const struct value *acked, const struct workload_result *r)
+{
+    const uint8_t *got = (const uint8_t *)0;
+    uint16_t len = 0;
+    bool matches_acked = false;
+    bool matches_in_flight = false;
+
+    for (uint16_t key = 0; key < keys; key++)
+    {
+        got = config_store_get(store, key, &len);
+        matches_acked = (got && acked[key].set && (len == VALUE_SIZE) &&
+                         (memcmp(got, acked[key].bytes, VALUE_SIZE) == 0)) || (!got && !acked[key].set);
+        matches_in_flight = r->cut && (key == r->in_flight_key) && got && (len == VALUE_SIZE) &&
+                            (memcmp(got, r->in_flight.bytes, VALUE_SIZE) == 0);
+        if (!matches_acked && !matches_in_flight)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    static struct config_store store;
+    static struct value acked[CONFIG_STORE_KEYS];
+
+    uint64_t seed = DEFAULT_SEED;
+    uint32_t sets = DEFAULT_SETS;
+    uint32_t pages = DEFAULT_PAGES;
+    uint32_t cuts = DEFAULT_CUTS;
+    struct workload_result r;
+    const struct config_store_stats *stats = (const struct config_store_stats *)0;
+    uint32_t erases_min = UINT32_MAX;
+    uint32_t erases_max = 0;
+    uint32_t erases_total = 0;
+    uint32_t lost = 0;
+    uint32_t cut_sets = 0;
+    uint64_t start_ns = 0;
+    uint64_t mount_ns = 0;
+    uint64_t get_ns = 0;
+    uint64_t scan_ns = 0;
+    uintptr_t sink = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+        {
+            seed = strtoull(&argv[i][7], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--sets=", 7) == 0)
+        {
+            sets = (uint32_t)strtoul(&argv[i][7], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--keys=", 7) == 0)
+        {
+            keys = (uint32_t)strtoul(&argv[i][7], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--pages=", 8) == 0)
+        {
+            pages = (uint32_t)strtoul(&argv[i][8], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--same-percent=", 15) == 0)
+        {
+            same_percent = (uint32_t)strtoul(&argv[i][15], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--cuts=", 7) == 0)
+        {
+            cuts = (uint32_t)strtoul(&argv[i][7], (char **)0, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--seed=N] [--sets=N] [--keys=N] [--pages=N] "
+                            "[--same-percent=N] [--cuts=N]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((keys == 0) || (keys > CONFIG_STORE_KEYS) || (pages < 2U) || (pages > CONFIG_STORE_PAGES_MAX))
+    {
+        fprintf(stderr, "config_store_model: --keys must be 1 to %u and --pages 2 to %u\n",
+                CONFIG_STORE_KEYS, CONFIG_STORE_PAGES_MAX);
+        return EXIT_FAILURE;
+    }
+    rand_state = (seed == 0) ? 1U : seed;
+
+    /* Workload. */
+    model_reset((uint8_t)pages);
+    store_mount(&store);
+    r = workload(&store, sets, acked);
+    stats = config_store_stats(&store);
+    for (uint32_t page = 0; page < pages; page++)
+    {
+        erases_min = (flash.erases[page] < erases_min) ? flash.erases[page] : erases_min;
+        erases_max = (flash.erases[page] > erases_max) ? flash.erases[page] : erases_max;
+        erases_total += flash.erases[page];
+    }
+
+    printf("workload: %" PRIu32 " sets of %u bytes over %" PRIu32 " keys, %" PRIu32 "%% unchanged, %" PRIu32 " pages\n",
+           sets, VALUE_SIZE, keys, same_percent, pages);
+    printf("  written %" PRIu32 " (%" PRIu32 " unchanged skipped), value bytes %" PRIu32 ", flash bytes %" PRIu32 "\n",
+           stats->sets - stats->sets_unchanged, stats->sets_unchanged, stats->value_bytes, stats->flash_bytes);
+    printf("  write amplification %.2f (flash bytes per value byte written), %" PRIu32 " records moved\n",
+           (stats->value_bytes > 0) ? ((double)stats->flash_bytes / (double)stats->value_bytes) : 0.0,
+           stats->records_moved);
+    printf("  erases %" PRIu32 ", per page min %" PRIu32 " max %" PRIu32 ", sets per erase %.1f\n",
+           erases_total, erases_min, erases_max, (erases_total > 0) ? ((double)sets / (double)erases_total) : 0.0);
+    printf("  sets to wear out at %u cycles per page: %.3g\n", ENDURANCE_CYCLES,
+           (erases_total > 0) ? (((double)ENDURANCE_CYCLES * (double)pages * (double)sets) / (double)erases_total) : 0.0);
+    printf("  sets held off by compaction %" PRIu32 ", longest %" PRIu32 " passes\n",
+           r.deferred_sets, r.deferred_passes_max);
+
+    if (!verify(&store, acked, &r) || (flash.violations > 0))
+    {
+        fprintf(stderr, "config_store_model: FAIL workload lost a value or broke a flash rule\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Boot. Mount the log the workload left and look keys up. */
+    start_ns = monotonic_ns();
+    for (uint32_t i = 0; i < BOOT_REPEATS; i++)
+    {
+        store_mount(&store);
+    }
+    mount_ns = (monotonic_ns() - start_ns) / BOOT_REPEATS;
+
+    start_ns = monotonic_ns();
+    for (uint32_t i = 0; i < LOOKUP_REPEATS; i++)
+    {
+        sink += (uintptr_t)config_store_get(&store, (uint16_t)(i % keys), (uint16_t *)0);
+    }
+    get_ns = monotonic_ns() - start_ns;
+
+    start_ns = monotonic_ns();
+    for (uint32_t i = 0; i < (LOOKUP_REPEATS / 100U); i++)
+    {
+        sink += (uintptr_t)scan_lookup((uint16_t)(i % keys));
+    }
+    scan_ns = (monotonic_ns() - start_ns) * 100U;
+
+    printf("boot: mount %.2f us for %" PRIu32 " KiB of log, lookup %.1f ns indexed vs %.1f ns scanning%s\n",
+           (double)mount_ns / 1e3, (pages * PAGE_SIZE) / 1024U, (double)get_ns / LOOKUP_REPEATS,
+           (double)scan_ns / LOOKUP_REPEATS, (sink == 1U) ? " " : "");
+
+    /* Power cuts. Each trial runs a random amount of workload on a fresh
+    flash, then cuts power at a random operation within the next sets. */
+    for (uint32_t i = 0; i < cuts; i++)
+    {
+        memset(acked, 0, sizeof(acked));
+        model_reset((uint8_t)pages);
+        store_mount(&store);
+        (void)workload(&store, (uint32_t)(rand_next() % (sets / 10U + 1U)), acked);
+
+        flash.cut_countdown = (int64_t)(rand_next() % 2000U);
+        r = workload(&store, sets, acked);
+        cut_sets += (r.cut) ? 1U : 0U;
+
+        store_mount(&store);
+        if (!verify(&store, acked, &r))
+        {
+            lost++;
+            continue;
+        }
+
+        /* Still usable after recovery. */
+        memset(&r, 0, sizeof(r));
+        r = workload(&store, 1000U, acked);
+        if (!verify(&store, acked, &r))
+        {
+            lost++;
+        }
+    }
+
+    printf("power cuts: %" PRIu32 " trials, %" PRIu32 " cut mid workload, %" PRIu32 " lost a value, %" PRIu32 " flash rule violations\n",
+           cuts, cut_sets, lost, flash.violations);
+
+    if ((lost > 0) || (flash.violations > 0))
+    {
+        fprintf(stderr, "config_store_model: FAIL\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,627 @@
+/**
+ * @file
+ * @brief Fleet simulator. Runs thousands of independent boards on every
+ * core of the host. Each board has its own tick counter, deadline timer
+ * collection and 1 to 8 LEDs. Each LED has an led_fsm, a switch coalescer
+ * and a seeded random switch trace with contact bounce. Boards are passed
+ * every simulated millisecond like led_fsms_run() and the per-board
+ * results are summed into fleet totals. Usage:
+ *
+ *     fleet_sim [--seed=N] [--boards=N] [--seconds=N] [--threads=N]
+ *               [--hold-ms=N] [--toggle-ms=N] [--scaling]
+ *
+ * Boards are handed out in tasks of BOARDS_PER_TASK to a work stealing
+ * pool (see work_pool.h). The LED count varies per board, so tasks cost
+ * different amounts and stealing balances the threads. --threads defaults
+ * to the number of online cores. --scaling runs the same fleet on 1, 2,
+ * 4, ... up to --threads threads and prints the speedup and efficiency
+ * of each against 1 thread.
+ *
+ * A board's results only depend on the seed and its index, never on the
+ * thread that ran it. Exits with a non-zero status if the totals differ
+ * between thread counts.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* POSIX. */
+#include <unistd.h>
+
+/* Application. */
+#include "app/deadline_timer.h"
+#include "app/led_fsm.h"
+#include "app/switch_coalescer.h"
+
+/* Fleet simulator. */
+#include "work_pool.h"
+
+/* External libraries. ECU. */
+#include "ecu/fsm.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define DEFAULT_SEED                            (1U)
+#define DEFAULT_BOARDS                          (4096U)
+#define DEFAULT_SECONDS                         (10U)
+#define DEFAULT_HOLD_MS                         (3000U)
+#define DEFAULT_TOGGLE_MS                       (1000U)
+
+#define BOARD_LEDS_MAX                          (8U)
+#define BOARDS_PER_TASK                         (16U)
+
+/**
+ * @brief Same catch up limit as the board's periodic toggle timers.
+ */
+#define LED_TOGGLE_MAX_CATCH_UP                 (4U)
+
+/**
+ * @brief Switch trace. A change bounces for up to BOUNCE_PAIRS_MAX extra
+ * edge pairs, each 0 or 1 ms apart. Releases last up to RELEASE_MAX_MS.
+ * Presses last up to twice the LED's hold time plus a few toggles, so
+ * about half of them reach the held down state.
+ */
+#define BOUNCE_PAIRS_MAX                        (3U)
+#define PRESS_MIN_MS                            (50U)
+#define RELEASE_MIN_MS                          (100U)
+#define RELEASE_MAX_MS                          (5000U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct board;
+
+
+struct board_led
+{
+    struct board *board;
+    struct deadline_timer timer;
+    struct switch_coalescer input;
+    struct led_fsm fsm;
+    struct led_fsm_event evt;
+
+    /* Switch trace. */
+    bool pressed;
+    uint32_t next_edge;
+    uint32_t bounce_edges;
+    uint32_t press_max_ms;
+
+    enum led_fsm_led_state led;
+    uint32_t lit_since;
+};
+
+
+struct board_stats
+{
+    uint64_t leds;
+    uint64_t passes;
+    uint64_t edges;
+    uint64_t dispatched;
+    uint64_t dropped;
+    uint64_t timeouts;
+    uint64_t missed;
+    uint64_t toggles;
+    uint64_t lit_ms;
+    uint64_t checksum;
+};
+
+
+/**
+ * @brief Aligned so boards run by different threads never share a cache
+ * line.
+ */
+struct board
+{
+    _Alignas(64) uint32_t ticks;
+    uint64_t rand_state;
+    struct deadline_timer_collection timers;
+    uint8_t led_count;
+    struct board_led leds[BOARD_LEDS_MAX];
+    struct board_stats stats;
+};
+
+
+struct fleet
+{
+    struct board *boards;
+    uint32_t board_count;
+    uint32_t passes;
+    uint64_t seed;
+    uint32_t hold_ms;
+    uint32_t toggle_ms;
+};
+
+
+struct run_result
+{
+    uint32_t threads;
+    double elapsed;
+    uint64_t stolen;
+    uint32_t tasks_min;
+    uint32_t tasks_max;
+    struct board_stats totals;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(uint64_t *state);
+static uint32_t rand_range(uint64_t *state, uint32_t min, uint32_t max);
+static double now_s(void);
+
+static uint32_t board_get_ticks(void *obj);
+static void led_set(void *obj, enum led_fsm_led_state state);
+static void led_timer_arm(void *obj, uint32_t ms);
+static void led_timer_arm_periodic(void *obj, uint32_t period_ms);
+static void led_timer_disarm(void *obj);
+static void led_timeout_callback(void *obj);
+
+static void led_input(struct board_led *me);
+static void board_ctor(struct board *me, uint32_t index, const struct fleet *fleet);
+static void board_pass(struct board *me);
+static void board_finish(struct board *me);
+static void fleet_task(void *obj, uint32_t task, uint32_t worker);
+static bool fleet_run(struct fleet *me, uint32_t threads, struct run_result *result);
+static bool stats_equal(const struct board_stats *a, const struct board_stats *b);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(uint64_t *state)
+{
+    /* xorshift64*. Deterministic for a given seed on every host. */
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+
+static uint32_t rand_range(uint64_t *state, uint32_t min, uint32_t max)
+{
+    return min + (uint32_t)(rand_next(state) % ((uint64_t)max - min + 1U));
+}
+
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+
+static uint32_t board_get_ticks(void *obj)
+{
+    return ((struct board *)obj)->ticks;
+}
+
+
+static void led_set(void *obj, enum led_fsm_led_state state)
+{
+    struct board_led *me = (struct board_led *)obj;
+    struct board *b = me->board;
+
+    if (state == me->led)
+    {
+        return;
+    }
+
+    if (state == LED_FSM_LED_STATE_ON)
+    {
+        me->lit_since = b->ticks;
+    }
+    else
+    {
+        b->stats.lit_ms += b->ticks - me->lit_since;
+    }
+
+    /* Order sensitive, so any difference in when or which LED changed shows. */
+    me->led = state;
+    b->stats.toggles++;
+    b->stats.checksum = (b->stats.checksum * 0x100000001B3ULL) ^
+                        ((uint64_t)b->ticks << 8) ^ ((uint64_t)(me - b->leds) << 1) ^
+                        ((state == LED_FSM_LED_STATE_ON) ? 1U : 0U);
+}
+
+
+static void led_timer_arm(void *obj, uint32_t ms)
+{
+    struct board_led *me = (struct board_led *)obj;
+    deadline_timer_arm(&me->board->timers, &me->timer, ms);
+}
+
+
+static void led_timer_arm_periodic(void *obj, uint32_t period_ms)
+{
+    struct board_led *me = (struct board_led *)obj;
+    deadline_timer_arm_periodic(&me->board->timers, &me->timer, period_ms,
+                                DEADLINE_TIMER_CATCH_UP, LED_TOGGLE_MAX_CATCH_UP);
+}
+
+
+static void led_timer_disarm(void *obj)
+{
+    struct board_led *me = (struct board_led *)obj;
+    deadline_timer_disarm(&me->timer);
+}
+
+
+static void led_timeout_callback(void *obj)
+{
+    static const struct led_fsm_event timeout_evt =
+    {
+        .base_event.id = LED_FSM_TIMEOUT_EVT
+    };
+
+    struct board_led *me = (struct board_led *)obj;
+    ecu_fsm_dispatch((struct ecu_fsm *)&me->fsm, (const struct ecu_event *)&timeout_evt);
+}
+
+
+static void led_input(struct board_led *me)
+{
+    struct board *b = me->board;
+
+    /* Several edges can land in one pass. The coalescer keeps the last. */
+    while (me->next_edge == b->ticks)
+    {
+        me->pressed = !me->pressed;
+        switch_coalescer_post(&me->input, (me->pressed) ? LED_FSM_SWITCH_PRESSED_EVT :
+                                                          LED_FSM_SWITCH_RELEASED_EVT);
+        b->stats.edges++;
+
+        if (me->bounce_edges > 0)
+        {
+            me->bounce_edges--;
+            me->next_edge = b->ticks + rand_range(&b->rand_state, 0U, 1U);
+        }
+        else
+        {
+            /* Settled. Schedule the next real change, which starts by
+            bouncing. An odd number of edges takes it to the other level. */
+            me->next_edge = b->ticks + ((me->pressed) ?
+                            rand_range(&b->rand_state, PRESS_MIN_MS, me->press_max_ms) :
+                            rand_range(&b->rand_state, RELEASE_MIN_MS, RELEASE_MAX_MS));
+            me->bounce_edges = 2U * rand_range(&b->rand_state, 0U, BOUNCE_PAIRS_MAX);
+        }
+    }
+}
+
+
+static void board_ctor(struct board *me, uint32_t index, const struct fleet *fleet)
+{
+    struct board_led *led = (struct board_led *)0;
+    uint32_t hold_ms = 0;
+    uint32_t toggle_ms = 0;
+
+    memset(me, 0, sizeof(*me));
+
+    /* Each board gets its own stream, derived from the fleet seed and its
+    index only. xorshift state must never be 0. */
+    me->rand_state = (fleet->seed ^ 0x9E3779B97F4A7C15ULL) + (0xBF58476D1CE4E5B9ULL * (index + 1ULL));
+    for (uint32_t i = 0; i < 4U; i++)
+    {
+        (void)rand_next(&me->rand_state);
+    }
+    me->rand_state = (me->rand_state == 0) ? 1U : me->rand_state;
+
+    deadline_timer_collection_ctor(&me->timers, (void *)me, &board_get_ticks);
+    me->led_count = (uint8_t)rand_range(&me->rand_state, 1U, BOARD_LEDS_MAX);
+    me->stats.leds = me->led_count;
+
+    /* Timings spread over half to one and a half times the fleet's. Every
+    other LED uses a periodic toggle timer like LED1 on the board. */
+    for (uint8_t i = 0; i < me->led_count; i++)
+    {
+        led = &me->leds[i];
+        hold_ms = rand_range(&me->rand_state, (fleet->hold_ms + 1U) / 2U, fleet->hold_ms + (fleet->hold_ms / 2U));
+        toggle_ms = rand_range(&me->rand_state, (fleet->toggle_ms + 1U) / 2U, fleet->toggle_ms + (fleet->toggle_ms / 2U));
+
+        led->board = me;
+        led->pressed = false;
+        led->bounce_edges = 2U * rand_range(&me->rand_state, 0U, BOUNCE_PAIRS_MAX);
+        led->press_max_ms = (2U * hold_ms) + (4U * toggle_ms);
+        led->next_edge = rand_range(&me->rand_state, 1U, RELEASE_MAX_MS);
+        led->led = LED_FSM_LED_STATE_OFF;
+        led->lit_since = 0;
+
+        deadline_timer_ctor(&led->timer, (void *)led, &led_timeout_callback);
+        switch_coalescer_ctor(&led->input, false);
+        led_fsm_ctor(&led->fsm, hold_ms, toggle_ms, (void *)led,
+                     &led_set, &led_timer_arm, &led_timer_disarm);
+        if ((i % 2U) == 1U)
+        {
+            led_fsm_periodic_timer_set(&led->fsm, &led_timer_arm_periodic);
+        }
+    }
+}
+
+
+static void board_pass(struct board *me)
+{
+    enum led_fsm_event_signals signal = LED_FSM_SWITCH_PRESSED_EVT;
+    struct board_led *led = (struct board_led *)0;
+
+    /* Same order as led_fsms_run(). Timeouts first, then one net switch
+    event per LED. */
+    me->ticks++;
+    me->stats.passes++;
+    me->stats.timeouts += deadline_timer_collection_tick(&me->timers);
+
+    for (uint8_t i = 0; i < me->led_count; i++)
+    {
+        led = &me->leds[i];
+        led_input(led);
+        if (switch_coalescer_take(&led->input, &signal))
+        {
+            led->evt.base_event.id = signal;
+            ecu_fsm_dispatch((struct ecu_fsm *)&led->fsm, (const struct ecu_event *)&led->evt);
+            me->stats.dispatched++;
+        }
+    }
+}
+
+
+static void board_finish(struct board *me)
+{
+    for (uint8_t i = 0; i < me->led_count; i++)
+    {
+        if (me->leds[i].led == LED_FSM_LED_STATE_ON)
+        {
+            me->stats.lit_ms += me->ticks - me->leds[i].lit_since;
+        }
+
+        me->stats.dropped += me->leds[i].input.dropped;
+        me->stats.missed += me->leds[i].timer.missed;
+    }
+}
+
+
+static void fleet_task(void *obj, uint32_t task, uint32_t worker)
+{
+    struct fleet *me = (struct fleet *)obj;
+    uint32_t first = task * BOARDS_PER_TASK;
+    uint32_t last = first + BOARDS_PER_TASK;
+    (void)worker;
+
+    /* Boards are independent, so each runs its whole trace in one go and
+    stays in this core's cache. Constructed here so its memory is first
+    touched by the thread that uses it. */
+    last = (last > me->board_count) ? me->board_count : last;
+    for (uint32_t b = first; b < last; b++)
+    {
+        board_ctor(&me->boards[b], b, me);
+        for (uint32_t p = 0; p < me->passes; p++)
+        {
+            board_pass(&me->boards[b]);
+        }
+        board_finish(&me->boards[b]);
+    }
+}
+
+
+static bool fleet_run(struct fleet *me, uint32_t threads, struct run_result *result)
+{
+    struct work_pool pool;
+    uint32_t tasks = (me->board_count + BOARDS_PER_TASK - 1U) / BOARDS_PER_TASK;
+    struct board_stats *t = &result->totals;
+    const struct board_stats *s = (const struct board_stats *)0;
+    double start = 0.0;
+    bool ok = false;
+
+    memset(result, 0, sizeof(*result));
+    result->threads = threads;
+    result->tasks_min = UINT32_MAX;
+
+    /* Threads are started before timing begins. */
+    if (!work_pool_ctor(&pool, threads))
+    {
+        return false;
+    }
+
+    start = now_s();
+    ok = work_pool_run(&pool, tasks, &fleet_task, (void *)me);
+    result->elapsed = now_s() - start;
+
+    for (uint32_t i = 0; i < threads; i++)
+    {
+        result->stolen += pool.workers[i].stolen;
+        result->tasks_min = (pool.workers[i].executed < result->tasks_min) ? pool.workers[i].executed : result->tasks_min;
+        result->tasks_max = (pool.workers[i].executed > result->tasks_max) ? pool.workers[i].executed : result->tasks_max;
+    }
+    work_pool_dtor(&pool);
+
+    /* Board order, not completion order, so totals never depend on scheduling. */
+    for (uint32_t b = 0; (b < me->board_count) && ok; b++)
+    {
+        s = &me->boards[b].stats;
+        t->leds += s->leds;
+        t->passes += s->passes;
+        t->edges += s->edges;
+        t->dispatched += s->dispatched;
+        t->dropped += s->dropped;
+        t->timeouts += s->timeouts;
+        t->missed += s->missed;
+        t->toggles += s->toggles;
+        t->lit_ms += s->lit_ms;
+        t->checksum = (t->checksum * 0x100000001B3ULL) ^ s->checksum;
+    }
+
+    return ok;
+}
+
+
+static bool stats_equal(const struct board_stats *a, const struct board_stats *b)
+{
+    return (a->leds == b->leds) && (a->passes == b->passes) && (a->edges == b->edges) &&
+           (a->dispatched == b->dispatched) && (a->dropped == b->dropped) &&
+           (a->timeouts == b->timeouts) && (a->missed == b->missed) &&
+           (a->toggles == b->toggles) && (a->lit_ms == b->lit_ms) && (a->checksum == b->checksum);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- MAIN ----------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    struct fleet fleet = {0};
+    struct run_result baseline = {0};
+    struct run_result result = {0};
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t max_threads = (cores > 0) ? (uint32_t)cores : 1U;
+    uint32_t seconds = DEFAULT_SECONDS;
+    uint32_t threads = 0;
+    uint32_t tasks = 0;
+    double board_seconds = 0.0;
+    bool scaling = false;
+    bool first = true;
+
+    fleet.seed = DEFAULT_SEED;
+    fleet.board_count = DEFAULT_BOARDS;
+    fleet.hold_ms = DEFAULT_HOLD_MS;
+    fleet.toggle_ms = DEFAULT_TOGGLE_MS;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+        {
+            fleet.seed = strtoull(&argv[i][7], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--boards=", 9) == 0)
+        {
+            fleet.board_count = (uint32_t)strtoul(&argv[i][9], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--seconds=", 10) == 0)
+        {
+            seconds = (uint32_t)strtoul(&argv[i][10], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--threads=", 10) == 0)
+        {
+            max_threads = (uint32_t)strtoul(&argv[i][10], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--hold-ms=", 10) == 0)
+        {
+            fleet.hold_ms = (uint32_t)strtoul(&argv[i][10], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--toggle-ms=", 12) == 0)
+        {
+            fleet.toggle_ms = (uint32_t)strtoul(&argv[i][12], (char **)0, 0);
+        }
+        else if (strcmp(argv[i], "--scaling") == 0)
+        {
+            scaling = true;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--seed=N] [--boards=N] [--seconds=N] [--threads=N] "
+                            "[--hold-ms=N] [--toggle-ms=N] [--scaling]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((fleet.board_count == 0) || (seconds == 0) || (seconds > 1000000U) || (max_threads == 0) ||
+        (fleet.hold_ms == 0) || (fleet.toggle_ms == 0) || (fleet.hold_ms > 1000000U) || (fleet.toggle_ms > 1000000U))
+    {
+        fprintf(stderr, "fleet_sim: --boards, --seconds, --threads, --hold-ms and --toggle-ms must be "
+                        "greater than 0 and times at most 1000000\n");
+        return EXIT_FAILURE;
+    }
+
+    fleet.passes = seconds * 1000U;
+    fleet.boards = (struct board *)aligned_alloc(64, sizeof(struct board) * fleet.board_count);
+    if (!fleet.boards)
+    {
+        fprintf(stderr, "fleet_sim: out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    tasks = (fleet.board_count + BOARDS_PER_TASK - 1U) / BOARDS_PER_TASK;
+    board_seconds = (double)fleet.board_count * (double)seconds;
+    printf("fleet_sim: seed=%" PRIu64 " boards=%" PRIu32 " seconds=%" PRIu32 " tasks=%" PRIu32 " cores=%ld\n",
+           fleet.seed, fleet.board_count, seconds, tasks, cores);
+    printf("%8s %9s %13s %8s %11s %8s %12s\n",
+           "threads", "wall s", "board s/s", "speedup", "efficiency", "stolen", "tasks/thread");
+
+    /* Powers of two up to the maximum, then the maximum itself. */
+    threads = (scaling) ? 1U : max_threads;
+    while (threads <= max_threads)
+    {
+        if (!fleet_run(&fleet, threads, &result))
+        {
+            fprintf(stderr, "fleet_sim: could not start %" PRIu32 " threads\n", threads);
+            free(fleet.boards);
+            return EXIT_FAILURE;
+        }
+
+        if (first)
+        {
+            baseline = result;
+            first = false;
+        }
+        else if (!stats_equal(&result.totals, &baseline.totals))
+        {
+            fprintf(stderr, "fleet_sim: FAIL seed=%" PRIu64 " totals on %" PRIu32 " threads differ from %" PRIu32 " threads\n",
+                    fleet.seed, threads, baseline.threads);
+            free(fleet.boards);
+            return EXIT_FAILURE;
+        }
+
+        printf("%8" PRIu32 " %9.3f %13.0f %7.2fx %10.1f%% %7.1f%% %5" PRIu32 "-%-6" PRIu32 "\n",
+               threads, result.elapsed,
+               (result.elapsed > 0.0) ? (board_seconds / result.elapsed) : 0.0,
+               (result.elapsed > 0.0) ? (baseline.elapsed / result.elapsed) : 0.0,
+               (result.elapsed > 0.0) ? (100.0 * baseline.elapsed * (double)baseline.threads / (result.elapsed * (double)threads)) : 0.0,
+               100.0 * (double)result.stolen / (double)tasks, result.tasks_min, result.tasks_max);
+
+        if (!scaling || (threads == max_threads))
+        {
+            break;
+        }
+        threads = ((2U * threads) < max_threads) ? (2U * threads) : max_threads;
+    }
+
+    printf("fleet_sim: leds=%" PRIu64 " edges=%" PRIu64 " dispatched=%" PRIu64 " dropped=%" PRIu64
+           " timeouts=%" PRIu64 " missed=%" PRIu64 " toggles=%" PRIu64 " lit=%.1f%% checksum=%016" PRIx64 "\n",
+           baseline.totals.leds, baseline.totals.edges, baseline.totals.dispatched, baseline.totals.dropped,
+           baseline.totals.timeouts, baseline.totals.missed, baseline.totals.toggles,
+           100.0 * (double)baseline.totals.lit_ms / ((double)baseline.totals.leds * (double)fleet.passes),
+           baseline.totals.checksum);
+    printf("fleet_sim: PASS%s\n", (scaling) ? " identical totals on every thread count" : "");
+
+    free(fleet.boards);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,275 @@
+/**
+ * @file
+ * @brief See work_pool.h.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Translation unit. */
+#include "work_pool.h"
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* POSIX. */
+#include <pthread.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(struct work_pool_worker *me);
+static bool take(struct work_pool_worker *me, uint32_t *task);
+static bool steal(struct work_pool_worker *me, uint32_t *task);
+static void *worker_main(void *arg);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(struct work_pool_worker *me)
+{
+    /* xorshift64*. Only picks victims, so quality hardly matters. */
+    me->rand_state ^= me->rand_state >> 12;
+    me->rand_state ^= me->rand_state << 25;
+    me->rand_state ^= me->rand_state >> 27;
+    return me->rand_state * 0x2545F4914F6CDD1DULL;
+}
+
+
+static bool take(struct work_pool_worker *me, uint32_t *task)
+{
+    bool taken = false;
+
+    pthread_mutex_lock(&me->lock);
+    if (me->bottom > me->top)
+    {
+        me->bottom--;
+        *task = me->bottom;
+        taken = true;
+    }
+    pthread_mutex_unlock(&me->lock);
+
+    return taken;
+}
+
+
+static bool steal(struct work_pool_worker *me, uint32_t *task)
+{
+    struct work_pool *pool = me->pool;
+    struct work_pool_worker *victim = (struct work_pool_worker *)0;
+    uint32_t first = 0;
+    uint32_t top = 0;
+    uint32_t count = 0;
+
+    /* Random first victim so thieves spread out, then every other worker
+    once. Work only moves from one deque to another during a batch, so an
+    empty sweep means whatever is left already has a thread running it. */
+    first = (uint32_t)(rand_next(me) % pool->threads);
+    for (uint32_t i = 0; (i < pool->threads) && (count == 0); i++)
+    {
+        victim = &pool->workers[(first + i) % pool->threads];
+        if (victim == me)
+        {
+            continue;
+        }
+
+        /* Take the top half, rounded up, so a thief comes back about
+        log2(tasks) times per batch instead of once per task. */
+        pthread_mutex_lock(&victim->lock);
+        count = (victim->bottom - victim->top + 1U) / 2U;
+        top = victim->top;
+        victim->top += count;
+        pthread_mutex_unlock(&victim->lock);
+    }
+
+    if (count == 0)
+    {
+        return false;
+    }
+
+    /* Own deque is empty, which is why this thread is stealing. Run the
+    first task now and keep the rest where other thieves can reach it. */
+    *task = top;
+    pthread_mutex_lock(&me->lock);
+    me->top = top + 1U;
+    me->bottom = top + count;
+    pthread_mutex_unlock(&me->lock);
+
+    me->stolen += count;
+    return true;
+}
+
+
+static void *worker_main(void *arg)
+{
+    struct work_pool_worker *me = (struct work_pool_worker *)arg;
+    struct work_pool *pool = me->pool;
+    uint64_t seen = 0;
+    uint32_t task = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->stop && (pool->generation == seen))
+        {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+
+        if (pool->stop)
+        {
+            pthread_mutex_unlock(&pool->lock);
+            return (void *)0;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        while (take(me, &task) || steal(me, &task))
+        {
+            (*pool->fn)(pool->obj, task, me->id);
+            me->executed++;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        pool->finished++;
+        if (pool->finished == pool->threads)
+        {
+            pthread_cond_signal(&pool->done);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+bool work_pool_ctor(struct work_pool *me, uint32_t threads_0)
+{
+    uint32_t started = 0;
+
+    if (!me || (threads_0 == 0))
+    {
+        return false;
+    }
+
+    me->threads = threads_0;
+    me->generation = 0;
+    me->finished = 0;
+    me->stop = false;
+    me->fn = (void (*)(void *, uint32_t, uint32_t))0;
+    me->obj = (void *)0;
+    me->workers = (struct work_pool_worker *)aligned_alloc(64, sizeof(struct work_pool_worker) * threads_0);
+    if (!me->workers)
+    {
+        return false;
+    }
+
+    pthread_mutex_init(&me->lock, (const pthread_mutexattr_t *)0);
+    pthread_cond_init(&me->start, (const pthread_condattr_t *)0);
+    pthread_cond_init(&me->done, (const pthread_condattr_t *)0);
+
+    for (started = 0; started < threads_0; started++)
+    {
+        struct work_pool_worker *w = &me->workers[started];
+        pthread_mutex_init(&w->lock, (const pthread_mutexattr_t *)0);
+        w->top = 0;
+        w->bottom = 0;
+        w->pool = me;
+        w->id = started;
+        w->rand_state = 0x9E3779B97F4A7C15ULL * (started + 1U);
+        w->executed = 0;
+        w->stolen = 0;
+        if (pthread_create(&w->thread, (const pthread_attr_t *)0, &worker_main, w) != 0)
+        {
+            pthread_mutex_destroy(&w->lock);
+            break;
+        }
+    }
+
+    if (started < threads_0)
+    {
+        me->threads = started;
+        work_pool_dtor(me);
+        return false;
+    }
+
+    return true;
+}
+
+
+void work_pool_dtor(struct work_pool *me)
+{
+    pthread_mutex_lock(&me->lock);
+    me->stop = true;
+    pthread_cond_broadcast(&me->start);
+    pthread_mutex_unlock(&me->lock);
+
+    for (uint32_t i = 0; i < me->threads; i++)
+    {
+        pthread_join(me->workers[i].thread, (void **)0);
+        pthread_mutex_destroy(&me->workers[i].lock);
+    }
+
+    pthread_cond_destroy(&me->done);
+    pthread_cond_destroy(&me->start);
+    pthread_mutex_destroy(&me->lock);
+    free(me->workers);
+    me->workers = (struct work_pool_worker *)0;
+    me->threads = 0;
+}
+
+
+bool work_pool_run(struct work_pool *me,
+                   uint32_t task_count,
+                   void (*fn)(void *obj, uint32_t task, uint32_t worker),
+                   void *obj)
+{
+    if (!fn)
+    {
+        return false;
+    }
+
+    /* Contiguous shares. Neighbouring tasks tend to cost the same, so it
+    is stealing, not the initial split, that evens out the load. Tasks are
+    numbered, so a deque is just a range and needs no storage. */
+    for (uint32_t i = 0; i < me->threads; i++)
+    {
+        struct work_pool_worker *w = &me->workers[i];
+        w->top = (uint32_t)(((uint64_t)task_count * i) / me->threads);
+        w->bottom = (uint32_t)(((uint64_t)task_count * (i + 1U)) / me->threads);
+        w->executed = 0;
+        w->stolen = 0;
+    }
+
+    pthread_mutex_lock(&me->lock);
+    me->fn = fn;
+    me->obj = obj;
+    me->finished = 0;
+    me->generation++;
+    pthread_cond_broadcast(&me->start);
+    while (me->finished < me->threads)
+    {
+        pthread_cond_wait(&me->done, &me->lock);
+    }
+    pthread_mutex_unlock(&me->lock);
+
+    return true;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file
+ * @brief Fixed size pool of threads that runs a batch of independent tasks
+ * with work stealing. Each worker starts with a contiguous share of the
+ * tasks in its own deque and takes from the bottom of it. A worker that
+ * runs dry steals the top half of another worker's deque, so uneven tasks
+ * balance out without a shared queue every task has to pass through.
+ *
+ * Tasks of a batch are all known when it starts and never spawn more.
+ * A worker is done once every deque is empty.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+#ifndef WORK_POOL_H_
+#define WORK_POOL_H_
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* POSIX. */
+#include <pthread.h>
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------- WORK POOL DATA STRUCTURES -----------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct work_pool;
+
+
+/**
+ * @brief One per thread. Aligned so workers never share a cache line.
+ */
+struct work_pool_worker
+{
+    _Alignas(64) pthread_mutex_t lock;
+    uint32_t top;                   /* Deque of tasks top to bottom - 1. Owner pops */
+    uint32_t bottom;                /* bottom, thieves take the top half. */
+
+    pthread_t thread;
+    struct work_pool *pool;
+    uint32_t id;
+    uint64_t rand_state;
+
+    /* Last batch. Stolen counts tasks, not steals. */
+    uint32_t executed;
+    uint32_t stolen;
+};
+
+
+struct work_pool
+{
+    /* Private. */
+    uint32_t threads;
+    struct work_pool_worker *workers;
+
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    uint64_t generation;
+    uint32_t finished;
+    bool stop;
+
+    void (*fn)(void *obj, uint32_t task, uint32_t worker);
+    void *obj;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Starts @p threads_0 workers that wait for batches. Returns false
+ * if a thread or allocation failed, in which case nothing is left running.
+ */
+extern bool work_pool_ctor(struct work_pool *me, uint32_t threads_0);
+
+/**
+ * @brief Stops and joins every worker.
+ */
+extern void work_pool_dtor(struct work_pool *me);
+
+/**
+ * @brief Runs @p fn for tasks 0 to @p task_count - 1 and returns once all
+ * have finished. @p worker is the id (0 to threads - 1) of the thread
+ * running the task, for per-thread scratch data. Returns false if @p fn
+ * is null.
+ */
+extern bool work_pool_run(struct work_pool *me,
+                          uint32_t task_count,
+                          void (*fn)(void *obj, uint32_t task, uint32_t worker),
+                          void *obj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WORK_POOL_H_ */
@@ -0,0 +1,493 @@
+/**
+ * @file
+ * @brief Replays event load traces through the governor and reports the
+ * energy and latency each policy ends up with. The core is modeled in
+ * 10 us steps. Every step is one main loop pass: it spends its cycles on
+ * the oldest waiting events and reports its cycles and backlog to the
+ * governor. Windows are evaluated every 100 ms, like the reva BSP does.
+ * A level change stalls the core for the clock switch time.
+ *
+ * Levels and governor thresholds are the ones the reva BSP uses. The
+ * window-only variants run without backlog boost, so they only react at
+ * the end of a window. Current per level is a linear model of the run
+ * mode figures in DS11451 (core running from flash with the ART on, all
+ * peripherals off):
+ *
+ *     I = base + per_MHz(range) * f + (PLL on ? pll : 0)
+ *
+ * The main loop never sleeps, so a pass with nothing to do costs as much
+ * as a busy one. Usage:
+ *
+ *     governor_sim [--seed=N] [--seconds=N] [--event-cycles=N] [--switch-us=N]
+ *
+ * Exits with a non-zero status if an event queue overflowed.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Application. */
+#include "app/governor.h"
+
+/* Drivers. Level frequencies. */
+#include "clock/clock.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define DEFAULT_SEED                            (1U)
+#define DEFAULT_SECONDS                         (60U)
+#define DEFAULT_EVENT_CYCLES                    (5000U)
+#define DEFAULT_SWITCH_US                       (100U)
+
+#define STEP_US                                 (10U)
+#define WINDOW_US                               (100000U)
+
+#define QUEUE_SIZE                              (1U << 16)
+#define MAX_EVENTS                              (1U << 20)
+
+/* Current model. mA and uA/MHz. */
+#define SUPPLY_V                                (3.3)
+#define BASE_MA                                 (0.05)
+#define RANGE_1_UA_PER_MHZ                      (84.0)
+#define RANGE_2_UA_PER_MHZ                      (70.0)
+#define PLL_MA                                  (0.25)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct trace
+{
+    const char *name;
+    uint64_t *arrivals;             /* Sorted. us. */
+    uint32_t count;
+};
+
+
+struct policy
+{
+    const char *name;
+    enum governor_policy policy;
+    uint32_t backlog_boost;
+    bool start_top;
+};
+
+
+struct sim
+{
+    uint64_t now;
+    uint64_t stall_until;
+    uint8_t level;
+
+    /* Waiting events by arrival time. */
+    uint64_t queue[QUEUE_SIZE];
+    uint32_t head;
+    uint32_t tail;
+    uint64_t head_cycles_left;
+    bool overflow;
+
+    double energy_uj;
+    uint64_t level_us[8];
+    uint32_t *latencies;
+    uint32_t done;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void);
+static uint32_t rand_range(uint32_t lo, uint32_t hi);
+static void trace_add(struct trace *t, uint64_t us);
+static int compare_u64(const void *a, const void *b);
+static int compare_u32(const void *a, const void *b);
+static void traces_build(uint64_t duration);
+
+static double level_ma(uint8_t level);
+static void level_set(void *obj, uint8_t level);
+static uint32_t queue_count(const struct sim *s);
+static void run(const struct trace *t, const struct policy *p, uint64_t duration);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Same as clock_levels in the reva BSP.
+ */
+static const struct clock_config levels[] =
+{
+    { .voltage_range = CLOCK_VOLTAGE_RANGE_2, .msi_range = CLOCK_MSI_4MHZ, .sysclk_source = CLOCK_SYSCLK_PLL,
+      .pll_m = 1, .pll_n = 20, .pll_r = 8, .ahb_div = 1, .apb1_div = 2, .apb2_div = 1 },
+    { .voltage_range = CLOCK_VOLTAGE_RANGE_2, .msi_range = CLOCK_MSI_4MHZ, .sysclk_source = CLOCK_SYSCLK_PLL,
+      .pll_m = 1, .pll_n = 20, .pll_r = 4, .ahb_div = 1, .apb1_div = 4, .apb2_div = 1 },
+    { .voltage_range = CLOCK_VOLTAGE_RANGE_1, .msi_range = CLOCK_MSI_4MHZ, .sysclk_source = CLOCK_SYSCLK_PLL,
+      .pll_m = 1, .pll_n = 40, .pll_r = 4, .ahb_div = 1, .apb1_div = 8, .apb2_div = 1 },
+    { .voltage_range = CLOCK_VOLTAGE_RANGE_1, .msi_range = CLOCK_MSI_4MHZ, .sysclk_source = CLOCK_SYSCLK_PLL,
+      .pll_m = 1, .pll_n = 40, .pll_r = 2, .ahb_div = 1, .apb1_div = 16, .apb2_div = 1 }
+};
+
+
+#define LEVEL_COUNT                             ((uint8_t)(sizeof(levels) / sizeof(levels[0])))
+
+
+static const struct policy policies[] =
+{
+    { "fixed-max",      GOVERNOR_FIXED,         0,  true },
+    { "fixed-min",      GOVERNOR_FIXED,         0,  false },
+    { "ondemand",       GOVERNOR_ONDEMAND,      2,  true },     /* reva BSP. */
+    { "ondemand-win",   GOVERNOR_ONDEMAND,      0,  true },
+    { "conservative",   GOVERNOR_CONSERVATIVE,  0,  true }
+};
+
+
+static uint64_t rand_state;
+static uint32_t event_cycles = DEFAULT_EVENT_CYCLES;
+static uint32_t switch_us = DEFAULT_SWITCH_US;
+
+static struct trace traces[3] =
+{
+    { "idle",   (uint64_t *)0, 0 },
+    { "storms", (uint64_t *)0, 0 },
+    { "random", (uint64_t *)0, 0 }
+};
+
+static struct sim sim;
+static bool overflowed;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------------- TRACES -------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void)
+{
+    /* xorshift64*. Deterministic for a given seed on every host. */
+    rand_state ^= rand_state >> 12;
+    rand_state ^= rand_state << 25;
+    rand_state ^= rand_state >> 27;
+    return rand_state * 0x2545F4914F6CDD1DULL;
+}
+
+
+static uint32_t rand_range(uint32_t lo, uint32_t hi)
+{
+    return lo + (uint32_t)(rand_next() % ((uint64_t)hi - lo + 1U));
+}
+
+
+static void trace_add(struct trace *t, uint64_t us)
+{
+    if (t->count < MAX_EVENTS)
+    {
+        t->arrivals[t->count++] = us;
+    }
+}
+
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+
+static void traces_build(uint64_t duration)
+{
+    for (size_t i = 0; i < (sizeof(traces) / sizeof(traces[0])); i++)
+    {
+        traces[i].arrivals = (uint64_t *)malloc(MAX_EVENTS * sizeof(uint64_t));
+        if (!traces[i].arrivals)
+        {
+            fprintf(stderr, "governor_sim: out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /* idle: LEDs holding steady. A switch edge every 500 ms. */
+    for (uint64_t us = 0; us < duration; us += 500000U)
+    {
+        trace_add(&traces[0], us + rand_range(0, 1000));
+    }
+
+    /* storms: idle plus a 300 ms switch storm at 2000 events/s every 10 s. */
+    for (uint32_t i = 0; i < traces[0].count; i++)
+    {
+        trace_add(&traces[1], traces[0].arrivals[i]);
+    }
+    for (uint64_t start = 5000000U; start < duration; start += 10000000U)
+    {
+        for (uint64_t us = start; us < (start + 300000U); us += 500U)
+        {
+            trace_add(&traces[1], us + rand_range(0, 400));
+        }
+    }
+
+    /* random: idle plus storms of random length and rate at random times. */
+    for (uint32_t i = 0; i < traces[0].count; i++)
+    {
+        trace_add(&traces[2], traces[0].arrivals[i]);
+    }
+    for (uint64_t start = rand_range(0, 4000000U); start < duration; start += rand_range(1000000U, 8000000U))
+    {
+        uint32_t length = rand_range(20000U, 600000U);
+        uint32_t gap = 1000000U / rand_range(100U, 4000U);
+        for (uint64_t us = start; us < (start + length); us += gap)
+        {
+            trace_add(&traces[2], us + rand_range(0, gap / 2U));
+        }
+    }
+
+    for (size_t i = 0; i < (sizeof(traces) / sizeof(traces[0])); i++)
+    {
+        qsort(traces[i].arrivals, traces[i].count, sizeof(uint64_t), &compare_u64);
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*-------------------------------------- CORE MODEL -----------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static double level_ma(uint8_t level)
+{
+    const struct clock_config *c = &levels[level];
+    double mhz = (double)clock_config_sysclk_hz(c) / 1e6;
+    double per_mhz = (c->voltage_range == CLOCK_VOLTAGE_RANGE_1) ? RANGE_1_UA_PER_MHZ : RANGE_2_UA_PER_MHZ;
+    return BASE_MA + ((per_mhz * mhz) / 1000.0) + ((c->sysclk_source == CLOCK_SYSCLK_PLL) ? PLL_MA : 0.0);
+}
+
+
+static void level_set(void *obj, uint8_t level)
+{
+    struct sim *s = (struct sim *)obj;
+    s->level = level;
+    s->stall_until = s->now + switch_us;
+}
+
+
+static uint32_t queue_count(const struct sim *s)
+{
+    return s->tail - s->head;
+}
+
+
+static void run(const struct trace *t, const struct policy *p, uint64_t duration)
+{
+    struct governor_config config =
+    {
+        .policy         = p->policy,
+        .levels         = LEVEL_COUNT,
+        .up_permille    = 600,
+        .down_permille  = 200,
+        .down_windows   = 5,
+        .backlog_boost  = p->backlog_boost
+    };
+    struct governor gov;
+    uint32_t next = 0;
+    uint32_t switches = 0;
+    double seconds = (double)duration / 1e6;
+
+    memset((void *)&sim, 0, sizeof(sim));
+    sim.latencies = (uint32_t *)malloc(MAX_EVENTS * sizeof(uint32_t));
+    if (!sim.latencies)
+    {
+        fprintf(stderr, "governor_sim: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    sim.level = (p->start_top) ? (uint8_t)(LEVEL_COUNT - 1U) : 0;
+    governor_ctor(&gov, &config, sim.level, (void *)&sim, &level_set);
+
+    for (sim.now = 0; sim.now < duration; sim.now += STEP_US)
+    {
+        uint32_t backlog = 0;
+        uint64_t cycles = ((uint64_t)clock_config_sysclk_hz(&levels[sim.level]) * STEP_US) / 1000000U;
+        uint64_t budget = (sim.now >= sim.stall_until) ? cycles : 0;
+
+        /* Step 1: Arrivals. */
+        while ((next < t->count) && (t->arrivals[next] <= sim.now))
+        {
+            if (queue_count(&sim) < QUEUE_SIZE)
+            {
+                if (queue_count(&sim) == 0)
+                {
+                    sim.head_cycles_left = event_cycles;
+                }
+                sim.queue[sim.tail++ % QUEUE_SIZE] = t->arrivals[next];
+            }
+            else
+            {
+                sim.overflow = true;
+            }
+            next++;
+        }
+        backlog = queue_count(&sim);
+
+        /* Step 2: Spend the pass on the oldest events. */
+        while ((budget > 0) && (queue_count(&sim) > 0))
+        {
+            uint64_t spent = (budget < sim.head_cycles_left) ? budget : sim.head_cycles_left;
+            budget -= spent;
+            sim.head_cycles_left -= spent;
+            if (sim.head_cycles_left == 0)
+            {
+                uint64_t arrival = sim.queue[sim.head++ % QUEUE_SIZE];
+                sim.latencies[sim.done++] = (uint32_t)((sim.now + STEP_US) - arrival);
+                sim.head_cycles_left = event_cycles;
+            }
+        }
+
+        /* Step 3: Energy at the level the pass ran at, then let the governor act. */
+        sim.energy_uj += level_ma(sim.level) * SUPPLY_V * STEP_US / 1000.0;
+        sim.level_us[sim.level] += STEP_US;
+        governor_pass(&gov, (uint32_t)cycles, backlog);
+        if (((sim.now + STEP_US) % WINDOW_US) == 0)
+        {
+            governor_evaluate(&gov);
+        }
+    }
+    switches = gov.switches;
+
+    /* Step 4: Report. Events still queued at the end are not in the latencies. */
+    qsort(sim.latencies, sim.done, sizeof(uint32_t), &compare_u32);
+    printf("  %-13s %10.2f %8.3f %9" PRIu32 " %9" PRIu32 " %9" PRIu32 " %9" PRIu32 "  ",
+           p->name, sim.energy_uj / 1000.0, (sim.energy_uj / SUPPLY_V) / (seconds * 1e6) * 1000.0,
+           (sim.done > 0) ? sim.latencies[sim.done / 2U] : 0,
+           (sim.done > 0) ? sim.latencies[(sim.done * 99U) / 100U] : 0,
+           (sim.done > 0) ? sim.latencies[sim.done - 1U] : 0,
+           switches);
+    for (uint8_t l = 0; l < LEVEL_COUNT; l++)
+    {
+        printf(" %5.1f", (100.0 * (double)sim.level_us[l]) / (double)duration);
+    }
+    printf("%s\n", (sim.overflow) ? "  OVERFLOW" : "");
+
+    overflowed = overflowed || sim.overflow;
+    free(sim.latencies);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- MAIN ----------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    uint64_t seed = DEFAULT_SEED;
+    uint64_t seconds = DEFAULT_SECONDS;
+    uint64_t duration = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+        {
+            seed = strtoull(&argv[i][7], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--seconds=", 10) == 0)
+        {
+            seconds = strtoull(&argv[i][10], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--event-cycles=", 15) == 0)
+        {
+            event_cycles = (uint32_t)strtoul(&argv[i][15], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--switch-us=", 12) == 0)
+        {
+            switch_us = (uint32_t)strtoul(&argv[i][12], (char **)0, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--seed=N] [--seconds=N] [--event-cycles=N] [--switch-us=N]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((seconds == 0) || (event_cycles == 0))
+    {
+        fprintf(stderr, "governor_sim: --seconds and --event-cycles must be greater than 0\n");
+        return EXIT_FAILURE;
+    }
+
+    /* xorshift state must never be 0. */
+    rand_state = seed ^ 0x9E3779B97F4A7C15ULL;
+    if (rand_state == 0)
+    {
+        rand_state = 1;
+    }
+
+    duration = seconds * 1000000U;
+    traces_build(duration);
+
+    printf("governor_sim: seed=%" PRIu64 " seconds=%" PRIu64 " event_cycles=%" PRIu32 " switch_us=%" PRIu32 "\n",
+           seed, seconds, event_cycles, switch_us);
+    printf("  levels:");
+    for (uint8_t l = 0; l < LEVEL_COUNT; l++)
+    {
+        printf(" %" PRIu32 " MHz (range %d, %.2f mA)", clock_config_sysclk_hz(&levels[l]) / 1000000U,
+               (int)levels[l].voltage_range, level_ma(l));
+    }
+    printf("\n");
+
+    for (size_t i = 0; i < (sizeof(traces) / sizeof(traces[0])); i++)
+    {
+        printf("trace %s: %" PRIu32 " events\n", traces[i].name, traces[i].count);
+        printf("  %-13s %10s %8s %9s %9s %9s %9s   %% time per level\n",
+               "policy", "energy mJ", "avg mA", "p50 us", "p99 us", "max us", "switches");
+        for (size_t p = 0; p < (sizeof(policies) / sizeof(policies[0])); p++)
+        {
+            run(&traces[i], &policies[p], duration);
+        }
+    }
+
+    for (size_t i = 0; i < (sizeof(traces) / sizeof(traces[0])); i++)
+    {
+        free(traces[i].arrivals);
+    }
+
+    if (overflowed)
+    {
+        fprintf(stderr, "governor_sim: FAIL an event queue overflowed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
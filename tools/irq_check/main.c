@@ -0,0 +1,657 @@
+/**
+ * @file
+ * @brief Runs the irq driver against a model of NVIC preemption on mocked
+ * registers. A simulated Cortex-M4 at 80 MHz runs a main loop and the
+ * board's handlers. Interrupts arrive at random and preempt whatever runs
+ * when their priority is more urgent than the current execution priority,
+ * i.e. the most urgent of the active handler and BASEPRI. The main loop
+ * and some handlers take critical sections, nested at random, at the
+ * priority of the data they share.
+ *
+ * The same arrivals and sections run twice. Once with irq_lock() and once
+ * with every section disabling all interrupts, the way PRIMASK does.
+ * Checks, for the irq_lock() run:
+ *
+ *     1. irq_init() made all priority bits preemption priority, set every
+ *        interrupt outside the table to the lowest priority and the ones
+ *        in it to their level.
+ *     2. After every lock and unlock, BASEPRI holds the most urgent
+ *        ceiling of the sections open, and irq_is_masked() agrees with the
+ *        model for every interrupt.
+ *     3. The longest masked window and the number of sections irq_stats()
+ *        reports match the model.
+ *     4. A priority 0 interrupt never waits for a critical section.
+ *
+ * Reports worst case and mean latency from arrival to handler entry for
+ * every interrupt in both runs. Usage:
+ *
+ *     irq_check [--seed=N] [--seconds=N]
+ *
+ * Exits with a non-zero status on any violation.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Drivers. */
+#include "cycle_counter/cycle_counter.h"
+#include "irq/irq.h"
+#include "registers/registers.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define DEFAULT_SEED                            (1U)
+#define DEFAULT_SECONDS                         (10U)
+#define CYCLES_PER_US                           (80U)
+
+/**
+ * @brief Execution priority of the main loop. Less urgent than any handler.
+ */
+#define THREAD_PRIORITY                         (IRQ_PRIORITY_LOWEST + 1U)
+
+#define SECTIONS_MAX                            (4U)
+#define CONTEXTS_MAX                            (8U)
+#define STEPS_MAX                               (8U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+enum op
+{
+    OP_WORK,
+    OP_LOCK,
+    OP_UNLOCK
+};
+
+
+struct step
+{
+    enum op op;
+    uint32_t arg;                   /* Cycles for OP_WORK, ceiling for OP_LOCK. */
+};
+
+
+struct source
+{
+    const char *name;
+    int16_t irq;
+    uint8_t priority;
+    uint32_t mean_interval;         /* 0 for periodic every period cycles. */
+    uint32_t period;
+    struct step body[STEPS_MAX];
+    uint8_t steps;
+
+    /* Per run. */
+    uint64_t rand_state;
+    uint64_t next_arrival;
+    bool pending;
+    uint64_t arrived;
+    uint32_t count;
+    uint32_t merged;
+    uint64_t latency_total;
+    uint64_t latency_max;
+};
+
+
+struct context
+{
+    struct source *src;             /* Null for the main loop. */
+    uint8_t priority;
+    const struct step *steps;
+    uint8_t step_count;
+    uint8_t pc;
+    uint32_t work_left;
+    uint32_t keys[SECTIONS_MAX];
+    uint8_t ceilings[SECTIONS_MAX];
+    uint8_t depth;
+};
+
+
+struct run
+{
+    bool primask;
+    uint64_t now;
+    uint64_t main_rand_state;
+    struct step main_steps[STEPS_MAX];
+
+    struct context stack[CONTEXTS_MAX];
+    uint8_t depth;
+
+    /* Model of the sections open across every context. */
+    uint8_t open;
+    uint64_t open_since;
+    uint64_t masked_max;
+    uint32_t outermost;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(uint64_t *state);
+static uint64_t rand_range(uint64_t *state, uint64_t lo, uint64_t hi);
+static void fail(const struct run *me, const char *what);
+static void arrival_schedule(struct source *src, uint64_t now);
+static void arrivals(struct run *me);
+static uint8_t model_ceiling(const struct run *me);
+static bool model_masked(const struct run *me, uint8_t priority);
+static void model_check(const struct run *me);
+static void context_push(struct run *me, struct source *src, const struct step *steps, uint8_t count, uint8_t priority);
+static void main_script(struct run *me);
+static void dispatch(struct run *me);
+static void step(struct run *me);
+static void run(struct run *me, bool primask, uint64_t seed_0, uint64_t end);
+static void init_check(void);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Same levels as the board. SysTick and FLASH touch data owned by
+ * more urgent handlers, so they take sections of their own.
+ */
+static struct source sources[] =
+{
+    { .name = "WWDG",     .irq = NVIC_IRQ_WWDG,     .priority = 0, .mean_interval = 8000000U,
+      .body = { { OP_WORK, 60U } }, .steps = 1 },
+    { .name = "EXTI0",    .irq = NVIC_IRQ_EXTI0,    .priority = 1, .mean_interval = 400000U,
+      .body = { { OP_WORK, 120U } }, .steps = 1 },
+    { .name = "SysTick",  .irq = IRQ_SYSTICK,       .priority = 2, .period = 80000U,
+      .body = { { OP_WORK, 40U }, { OP_LOCK, 1U }, { OP_WORK, 30U }, { OP_UNLOCK, 0 } }, .steps = 4 },
+    { .name = "USART2",   .irq = NVIC_IRQ_USART2,   .priority = 3, .mean_interval = 40000U,
+      .body = { { OP_WORK, 200U } }, .steps = 1 },
+    { .name = "FLASH",    .irq = NVIC_IRQ_FLASH,    .priority = 4, .mean_interval = 2000000U,
+      .body = { { OP_WORK, 300U }, { OP_LOCK, 2U }, { OP_WORK, 50U }, { OP_UNLOCK, 0 } }, .steps = 4 }
+};
+
+#define SOURCES                                 ((uint8_t)(sizeof(sources) / sizeof(sources[0])))
+
+static struct irq_priority table[SOURCES];
+static uint64_t seed;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(uint64_t *state)
+{
+    /* xorshift64*. Deterministic for a given seed on every host. */
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+
+static uint64_t rand_range(uint64_t *state, uint64_t lo, uint64_t hi)
+{
+    return lo + (rand_next(state) % (hi - lo + 1U));
+}
+
+
+static void fail(const struct run *me, const char *what)
+{
+    fprintf(stderr, "irq_check: FAIL seed=%" PRIu64 " cycle=%" PRIu64 " (%s): %s\n",
+            seed, (me) ? me->now : 0U, (me && me->primask) ? "primask" : "irq_lock", what);
+    exit(EXIT_FAILURE);
+}
+
+
+static void arrival_schedule(struct source *src, uint64_t now)
+{
+    if (src->period)
+    {
+        src->next_arrival = now + src->period;
+    }
+    else
+    {
+        src->next_arrival = now + rand_range(&src->rand_state, src->mean_interval / 2U,
+                                             src->mean_interval + (src->mean_interval / 2U));
+    }
+}
+
+
+static void arrivals(struct run *me)
+{
+    /* A second arrival before the handler ran sets a bit already set. */
+    for (uint8_t i = 0; i < SOURCES; i++)
+    {
+        while (sources[i].next_arrival <= me->now)
+        {
+            if (sources[i].pending)
+            {
+                sources[i].merged++;
+            }
+            else
+            {
+                sources[i].pending = true;
+                sources[i].arrived = sources[i].next_arrival;
+            }
+            arrival_schedule(&sources[i], sources[i].next_arrival);
+        }
+    }
+}
+
+
+static uint8_t model_ceiling(const struct run *me)
+{
+    uint8_t ceiling = 0;
+
+    for (uint8_t c = 0; c < me->depth; c++)
+    {
+        for (uint8_t s = 0; s < me->stack[c].depth; s++)
+        {
+            ceiling = ((ceiling == 0) || (me->stack[c].ceilings[s] < ceiling)) ? me->stack[c].ceilings[s] : ceiling;
+        }
+    }
+
+    return ceiling;
+}
+
+
+static bool model_masked(const struct run *me, uint8_t priority)
+{
+    uint8_t ceiling = model_ceiling(me);
+
+    if (me->primask)
+    {
+        return (me->open > 0);
+    }
+
+    return (ceiling != 0) && (priority >= ceiling);
+}
+
+
+static void model_check(const struct run *me)
+{
+    uint8_t ceiling = model_ceiling(me);
+
+    if (me->primask)
+    {
+        return;
+    }
+
+    if (stm32l432_mock_basepri != ((uint32_t)ceiling << NVIC_PRIORITY_SHIFT))
+    {
+        fail(me, "BASEPRI is not the most urgent ceiling of the open sections");
+    }
+
+    for (uint8_t i = 0; i < SOURCES; i++)
+    {
+        if (irq_is_masked(sources[i].irq) != model_masked(me, sources[i].priority))
+        {
+            fail(me, "irq_is_masked() disagrees with the priority model");
+        }
+    }
+}
+
+
+static void context_push(struct run *me, struct source *src, const struct step *steps, uint8_t count, uint8_t priority)
+{
+    struct context *c = (struct context *)0;
+
+    if (me->depth >= CONTEXTS_MAX)
+    {
+        fail(me, "handlers nested deeper than there are priority levels");
+    }
+
+    c = &me->stack[me->depth++];
+    memset(c, 0, sizeof(*c));
+    c->src = src;
+    c->priority = priority;
+    c->steps = steps;
+    c->step_count = count;
+    c->work_left = (steps[0].op == OP_WORK) ? steps[0].arg : 0;
+}
+
+
+static void main_script(struct run *me)
+{
+    uint64_t *r = &me->main_rand_state;
+    uint8_t n = 0;
+
+    /* Plain work, then a section at the priority of whichever handler
+    owns the data. Sometimes a second, nested section for data of a less
+    urgent owner, which must not lower the first. */
+    me->main_steps[n++] = (struct step){ OP_WORK, (uint32_t)rand_range(r, 50U, 2000U) };
+    me->main_steps[n++] = (struct step){ OP_LOCK, (uint32_t)rand_range(r, 1U, 3U) };
+    me->main_steps[n++] = (struct step){ OP_WORK, (uint32_t)rand_range(r, 20U, 400U) };
+    if ((rand_next(r) % 4U) == 0)
+    {
+        me->main_steps[n++] = (struct step){ OP_LOCK, (uint32_t)rand_range(r, 1U, 4U) };
+        me->main_steps[n++] = (struct step){ OP_WORK, (uint32_t)rand_range(r, 20U, 200U) };
+        me->main_steps[n++] = (struct step){ OP_UNLOCK, 0 };
+    }
+    me->main_steps[n++] = (struct step){ OP_UNLOCK, 0 };
+
+    me->depth = 0;
+    context_push(me, (struct source *)0, me->main_steps, n, THREAD_PRIORITY);
+}
+
+
+static void dispatch(struct run *me)
+{
+    struct source *next = (struct source *)0;
+
+    /* Most urgent pending interrupt first, lowest number on a tie. Table
+    order is both. */
+    for (;;)
+    {
+        next = (struct source *)0;
+        for (uint8_t i = 0; (i < SOURCES) && !next; i++)
+        {
+            if (sources[i].pending && (sources[i].priority < me->stack[me->depth - 1U].priority) &&
+                !model_masked(me, sources[i].priority))
+            {
+                next = &sources[i];
+            }
+        }
+
+        if (!next)
+        {
+            return;
+        }
+
+        next->pending = false;
+        next->count++;
+        next->latency_total += me->now - next->arrived;
+        next->latency_max = ((me->now - next->arrived) > next->latency_max) ? (me->now - next->arrived) : next->latency_max;
+        context_push(me, next, next->body, next->steps, next->priority);
+    }
+}
+
+
+static void step(struct run *me)
+{
+    struct context *c = &me->stack[me->depth - 1U];
+    const struct step *s = (const struct step *)0;
+    uint64_t until = UINT64_MAX;
+    uint64_t run_for = 0;
+
+    if (c->pc == c->step_count)
+    {
+        if (c->depth != 0)
+        {
+            fail(me, "context returned with a section open");
+        }
+
+        if (me->depth > 1U)
+        {
+            me->depth--;
+        }
+        else
+        {
+            main_script(me);
+        }
+        return;
+    }
+
+    s = &c->steps[c->pc];
+    switch (s->op)
+    {
+        case OP_WORK:
+        {
+            /* Up to the next arrival, which may preempt. */
+            for (uint8_t i = 0; i < SOURCES; i++)
+            {
+                until = (sources[i].next_arrival < until) ? sources[i].next_arrival : until;
+            }
+            run_for = ((until - me->now) < c->work_left) ? (until - me->now) : c->work_left;
+            me->now += run_for;
+            c->work_left -= (uint32_t)run_for;
+            DWT->CYCCNT = (uint32_t)me->now;
+            arrivals(me);
+            break;
+        }
+
+        case OP_LOCK:
+        {
+            if (c->depth >= SECTIONS_MAX)
+            {
+                fail(me, "sections nested too deep");
+            }
+
+            if (me->open++ == 0)
+            {
+                me->open_since = me->now;
+                me->outermost++;
+            }
+
+            c->ceilings[c->depth] = (uint8_t)s->arg;
+            c->keys[c->depth] = (me->primask) ? 0U : irq_lock((uint8_t)s->arg);
+            c->depth++;
+            model_check(me);
+            break;
+        }
+
+        case OP_UNLOCK:
+        {
+            if (c->depth == 0)
+            {
+                fail(me, "unlock without a lock");
+            }
+
+            c->depth--;
+            if (--me->open == 0)
+            {
+                me->masked_max = ((me->now - me->open_since) > me->masked_max) ? (me->now - me->open_since) : me->masked_max;
+            }
+
+            if (!me->primask)
+            {
+                irq_unlock(c->keys[c->depth]);
+            }
+            model_check(me);
+            break;
+        }
+
+        default:
+        {
+            fail(me, "corrupt step");
+            break;
+        }
+    }
+
+    if ((s->op != OP_WORK) || (c->work_left == 0))
+    {
+        c->pc++;
+        c->work_left = ((c->pc < c->step_count) && (c->steps[c->pc].op == OP_WORK)) ? c->steps[c->pc].arg : 0;
+    }
+}
+
+
+static void run(struct run *me, bool primask, uint64_t seed_0, uint64_t end)
+{
+    memset(me, 0, sizeof(*me));
+    me->primask = primask;
+    me->main_rand_state = seed_0 ^ 0x9E3779B97F4A7C15ULL;
+    me->main_rand_state = (me->main_rand_state == 0) ? 1U : me->main_rand_state;
+
+    /* Arrivals come from a stream per source, so both runs see the same
+    interrupts at the same times. */
+    for (uint8_t i = 0; i < SOURCES; i++)
+    {
+        sources[i].rand_state = (seed_0 + 1U) * (0xBF58476D1CE4E5B9ULL + i);
+        sources[i].rand_state = (sources[i].rand_state == 0) ? 1U : sources[i].rand_state;
+        sources[i].pending = false;
+        sources[i].count = 0;
+        sources[i].merged = 0;
+        sources[i].latency_total = 0;
+        sources[i].latency_max = 0;
+        arrival_schedule(&sources[i], 0);
+    }
+
+    stm32l432_mock_registers_reset();
+    irq_init(table, SOURCES);
+    cycle_counter_init();
+    main_script(me);
+
+    while (me->now < end)
+    {
+        dispatch(me);
+        step(me);
+    }
+}
+
+
+static void init_check(void)
+{
+    uint8_t expected = 0;
+
+    if ((SCB->AIRCR & (SCB_AIRCR_VECTKEY_MASK | SCB_AIRCR_PRIGROUP_MASK)) !=
+        (SCB_AIRCR_VECTKEY | SCB_AIRCR_PRIGROUP_PREEMPT_ONLY))
+    {
+        fail((const struct run *)0, "AIRCR not written with the key and PRIGROUP 3");
+    }
+
+    for (uint32_t i = 0; i < sizeof(NVIC->IP); i++)
+    {
+        expected = IRQ_PRIORITY_LOWEST;
+        for (uint8_t j = 0; j < SOURCES; j++)
+        {
+            expected = (table[j].irq == (int16_t)i) ? table[j].priority : expected;
+        }
+
+        if (NVIC->IP[i] != (uint8_t)(expected << NVIC_PRIORITY_SHIFT))
+        {
+            fail((const struct run *)0, "NVIC priority byte not set from the table");
+        }
+    }
+
+    if ((irq_priority_get(IRQ_SYSTICK) != 2U) || (irq_priority_get(IRQ_PENDSV) != IRQ_PRIORITY_LOWEST) ||
+        ((SCB->SHPR[2] & 0xFFFFU) != 0))
+    {
+        fail((const struct run *)0, "SHPR3 not set from the table");
+    }
+
+    if ((irq_stats()->locks != 0) || (irq_stats()->masked_max_cycles != 0) || (stm32l432_mock_basepri != 0))
+    {
+        fail((const struct run *)0, "irq_init() did not start with no sections");
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- MAIN ----------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    static struct run runs[2];
+    uint32_t seconds = DEFAULT_SECONDS;
+    uint64_t end = 0;
+    uint64_t worst[2][SOURCES];
+    uint64_t mean[2][SOURCES];
+    uint8_t masked_max_ceiling = 0;
+    seed = DEFAULT_SEED;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+        {
+            seed = strtoull(&argv[i][7], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--seconds=", 10) == 0)
+        {
+            seconds = (uint32_t)strtoul(&argv[i][10], (char **)0, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--seed=N] [--seconds=N]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (seconds == 0)
+    {
+        fprintf(stderr, "irq_check: --seconds must be greater than 0\n");
+        return EXIT_FAILURE;
+    }
+
+    for (uint8_t i = 0; i < SOURCES; i++)
+    {
+        table[i].irq = sources[i].irq;
+        table[i].priority = sources[i].priority;
+    }
+
+    stm32l432_mock_registers_reset();
+    irq_init(table, SOURCES);
+    init_check();
+
+    printf("irq_check: seed=%" PRIu64 " seconds=%" PRIu32 "\n", seed, seconds);
+    end = (uint64_t)seconds * 1000000U * CYCLES_PER_US;
+    for (uint8_t r = 0; r < 2U; r++)
+    {
+        run(&runs[r], (r == 1U), seed, end);
+        for (uint8_t i = 0; i < SOURCES; i++)
+        {
+            worst[r][i] = sources[i].latency_max;
+            mean[r][i] = (sources[i].count) ? (sources[i].latency_total / sources[i].count) : 0;
+        }
+
+        if (r == 0)
+        {
+            if (irq_stats()->masked_max_cycles != runs[0].masked_max)
+            {
+                fail(&runs[0], "irq_stats() longest masked window differs from the model");
+            }
+
+            if (irq_stats()->locks != runs[0].outermost)
+            {
+                fail(&runs[0], "irq_stats() section count differs from the model");
+            }
+
+            if (worst[0][0] != 0)
+            {
+                fail(&runs[0], "priority 0 interrupt waited for a critical section");
+            }
+            masked_max_ceiling = irq_stats()->masked_max_ceiling;
+        }
+    }
+
+    printf("%-8s %4s %8s %14s %14s %14s %14s\n", "irq", "prio", "count",
+           "worst us lock", "worst us off", "mean us lock", "mean us off");
+    for (uint8_t i = 0; i < SOURCES; i++)
+    {
+        printf("%-8s %4u %8" PRIu32 " %14.2f %14.2f %14.3f %14.3f\n",
+               sources[i].name, sources[i].priority, sources[i].count,
+               (double)worst[0][i] / CYCLES_PER_US, (double)worst[1][i] / CYCLES_PER_US,
+               (double)mean[0][i] / CYCLES_PER_US, (double)mean[1][i] / CYCLES_PER_US);
+    }
+
+    printf("irq_check: sections=%" PRIu32 " longest masked window %.2f us at ceiling %u\n",
+           runs[0].outermost, (double)runs[0].masked_max / CYCLES_PER_US, masked_max_ceiling);
+    printf("irq_check: PASS\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,488 @@
+/**
+ * @file
+ * @brief Randomized stress and throughput harness for led_fsm. Runs many
+ * FSM instances against fake LED, timer and hardware toggle interfaces,
+ * split between software toggling, hardware toggling and periodic timers,
+ * pushes seeded random press/release/timeout sequences through them and
+ * checks every instance against a reference model after each dispatch.
+ * Reports events per second so dispatch throughput regressions show up
+ * in the same run. Usage:
+ *
+ *     led_fsm_stress [--seed=N] [--instances=N] [--events=N] [--no-check]
+ *
+ * Exits with a non-zero status on the first invariant violation. Rerun with
+ * the printed seed to reproduce it. --no-check skips the model so only
+ * dispatch cost is timed.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* LED FSM. */
+#include "app/led_fsm.h"
+
+/* External libraries. ECU. */
+#include "ecu/fsm.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define DEFAULT_SEED                            (1U)
+#define DEFAULT_INSTANCES                       (1024U)
+#define DEFAULT_EVENTS                          (10000000U)
+#define MAX_TIME_MS                             (10000U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+enum model_state
+{
+    MODEL_STATE_OFF,
+    MODEL_STATE_ON,
+    MODEL_STATE_HELD_DOWN
+};
+
+
+struct instance
+{
+    struct led_fsm fsm;
+    size_t index;
+    bool hw_toggle;
+    bool periodic_timer;
+
+    /* Reference model. */
+    enum model_state state;
+    enum led_fsm_led_state expected_led;
+
+    /* What the FSM did through its interface. */
+    enum led_fsm_led_state led;
+    bool timer_armed;
+    bool timer_periodic;
+    uint32_t timer_ms;
+    bool hw_toggling;
+    uint32_t hw_period_ms;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void);
+static double now_s(void);
+static void fail(const struct instance *me, const char *what);
+
+static void led_set(void *obj, enum led_fsm_led_state state);
+static void timer_arm(void *obj, uint32_t ms);
+static void timer_arm_periodic(void *obj, uint32_t period_ms);
+static void timer_disarm(void *obj);
+static void toggle_start(void *obj, enum led_fsm_led_state state, uint32_t period_ms);
+static enum led_fsm_led_state toggle_stop(void *obj);
+
+static void model_update(struct instance *me, enum led_fsm_event_signals signal);
+static void model_check(const struct instance *me);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_state;
+static uint64_t event_count;
+static uint64_t seed;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void)
+{
+    /* xorshift64*. Deterministic for a given seed on every host. */
+    rand_state ^= rand_state >> 12;
+    rand_state ^= rand_state << 25;
+    rand_state ^= rand_state >> 27;
+    return rand_state * 0x2545F4914F6CDD1DULL;
+}
+
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+
+static void fail(const struct instance *me, const char *what)
+{
+    const char *mode = (me->hw_toggle) ? "hw toggle" : ((me->periodic_timer) ? "periodic timer" : "sw toggle");
+    fprintf(stderr, "led_fsm_stress: FAIL seed=%" PRIu64 " event=%" PRIu64 " instance=%zu (%s): %s\n",
+            seed, event_count, me->index, mode, what);
+    exit(EXIT_FAILURE);
+}
+
+
+static void led_set(void *obj, enum led_fsm_led_state state)
+{
+    struct instance *me = (struct instance *)obj;
+
+    if (me->hw_toggling)
+    {
+        fail(me, "i_led_set called while hardware owns the LED");
+    }
+
+    me->led = state;
+}
+
+
+static void timer_arm(void *obj, uint32_t ms)
+{
+    struct instance *me = (struct instance *)obj;
+    me->timer_armed = true;
+    me->timer_periodic = false;
+    me->timer_ms = ms;
+}
+
+
+static void timer_arm_periodic(void *obj, uint32_t period_ms)
+{
+    struct instance *me = (struct instance *)obj;
+    me->timer_armed = true;
+    me->timer_periodic = true;
+    me->timer_ms = period_ms;
+}
+
+
+static void timer_disarm(void *obj)
+{
+    struct instance *me = (struct instance *)obj;
+    me->timer_armed = false;
+}
+
+
+static void toggle_start(void *obj, enum led_fsm_led_state state, uint32_t period_ms)
+{
+    struct instance *me = (struct instance *)obj;
+
+    if (me->hw_toggling)
+    {
+        fail(me, "hardware toggling started twice");
+    }
+
+    if (state != me->led)
+    {
+        fail(me, "hardware toggling started with a level different from the LED");
+    }
+
+    me->hw_toggling = true;
+    me->hw_period_ms = period_ms;
+}
+
+
+static enum led_fsm_led_state toggle_stop(void *obj)
+{
+    struct instance *me = (struct instance *)obj;
+
+    if (!me->hw_toggling)
+    {
+        fail(me, "hardware toggling stopped while not running");
+    }
+
+    /* Hardware toggled some unknown number of times. Hand back either level. */
+    me->hw_toggling = false;
+    me->led = (rand_next() & 1U) ? LED_FSM_LED_STATE_ON : LED_FSM_LED_STATE_OFF;
+    me->expected_led = me->led;
+    return me->led;
+}
+
+
+static void model_update(struct instance *me, enum led_fsm_event_signals signal)
+{
+    switch (signal)
+    {
+        case LED_FSM_SWITCH_PRESSED_EVT:
+        {
+            if (me->state == MODEL_STATE_OFF)
+            {
+                me->state = MODEL_STATE_ON;
+                me->expected_led = LED_FSM_LED_STATE_ON;
+            }
+            break;
+        }
+
+        case LED_FSM_SWITCH_RELEASED_EVT:
+        {
+            me->state = MODEL_STATE_OFF;
+            me->expected_led = LED_FSM_LED_STATE_OFF;
+            break;
+        }
+
+        case LED_FSM_TIMEOUT_EVT:
+        {
+            if (me->state == MODEL_STATE_ON)
+            {
+                me->state = MODEL_STATE_HELD_DOWN;
+            }
+            else if ((me->state == MODEL_STATE_HELD_DOWN) && (!me->hw_toggle))
+            {
+                me->expected_led = (me->expected_led == LED_FSM_LED_STATE_ON) ?
+                                   LED_FSM_LED_STATE_OFF : LED_FSM_LED_STATE_ON;
+            }
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+}
+
+
+static void model_check(const struct instance *me)
+{
+    switch (me->state)
+    {
+        case MODEL_STATE_OFF:
+        {
+            if ((me->led != LED_FSM_LED_STATE_OFF) || (me->fsm.led_state != LED_FSM_LED_STATE_OFF))
+            {
+                fail(me, "LED is not off in the off state");
+            }
+
+            if (me->timer_armed)
+            {
+                fail(me, "timer left armed after release");
+            }
+
+            if (me->hw_toggling)
+            {
+                fail(me, "hardware toggling left running after release");
+            }
+            break;
+        }
+
+        case MODEL_STATE_ON:
+        {
+            if ((me->led != LED_FSM_LED_STATE_ON) || (me->fsm.led_state != LED_FSM_LED_STATE_ON))
+            {
+                fail(me, "LED is not on in the on state");
+            }
+
+            if ((!me->timer_armed) || (me->timer_periodic) || (me->timer_ms != me->fsm.hold_time_ms))
+            {
+                fail(me, "one-shot hold timer not armed with hold_time_ms in the on state");
+            }
+            break;
+        }
+
+        case MODEL_STATE_HELD_DOWN:
+        {
+            if (me->hw_toggle)
+            {
+                if ((!me->hw_toggling) || (me->hw_period_ms != me->fsm.toggle_time_ms))
+                {
+                    fail(me, "hardware toggling not running with toggle_time_ms in the held down state");
+                }
+
+                if (me->timer_armed)
+                {
+                    fail(me, "timer armed while hardware toggles the LED");
+                }
+            }
+            else
+            {
+                if ((me->led != me->expected_led) || (me->fsm.led_state != me->expected_led))
+                {
+                    fail(me, "LED did not toggle on timeout in the held down state");
+                }
+
+                if ((!me->timer_armed) || (me->timer_ms != me->fsm.toggle_time_ms))
+                {
+                    fail(me, "toggle timer not armed with toggle_time_ms in the held down state");
+                }
+
+                if (me->timer_periodic != me->periodic_timer)
+                {
+                    fail(me, (me->periodic_timer) ? "periodic toggle timer rearmed as one-shot" :
+                                                    "periodic toggle timer armed without being set");
+                }
+            }
+            break;
+        }
+
+        default:
+        {
+            fail(me, "corrupt model state");
+            break;
+        }
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- MAIN ----------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    static const struct led_fsm_event events[] =
+    {
+        { .base_event.id = LED_FSM_SWITCH_PRESSED_EVT },
+        { .base_event.id = LED_FSM_SWITCH_RELEASED_EVT },
+        { .base_event.id = LED_FSM_TIMEOUT_EVT }
+    };
+
+    size_t instance_count = DEFAULT_INSTANCES;
+    uint64_t total_events = DEFAULT_EVENTS;
+    bool check = true;
+    struct instance *instances = (struct instance *)0;
+    double start = 0.0;
+    double elapsed = 0.0;
+    seed = DEFAULT_SEED;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+        {
+            seed = strtoull(&argv[i][7], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--instances=", 12) == 0)
+        {
+            instance_count = (size_t)strtoull(&argv[i][12], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--events=", 9) == 0)
+        {
+            total_events = strtoull(&argv[i][9], (char **)0, 0);
+        }
+        else if (strcmp(argv[i], "--no-check") == 0)
+        {
+            check = false;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--seed=N] [--instances=N] [--events=N] [--no-check]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (instance_count == 0)
+    {
+        fprintf(stderr, "led_fsm_stress: --instances must be greater than 0\n");
+        return EXIT_FAILURE;
+    }
+
+    /* xorshift state must never be 0. */
+    rand_state = seed ^ 0x9E3779B97F4A7C15ULL;
+    if (rand_state == 0)
+    {
+        rand_state = 1;
+    }
+
+    instances = (struct instance *)calloc(instance_count, sizeof(struct instance));
+    if (!instances)
+    {
+        fprintf(stderr, "led_fsm_stress: out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Every third instance offloads held down toggling to (fake) hardware
+    and every third uses a periodic toggle timer. */
+    for (size_t i = 0; i < instance_count; i++)
+    {
+        struct instance *me = &instances[i];
+        me->index = i;
+        me->hw_toggle = ((i % 3U) == 1U);
+        me->periodic_timer = ((i % 3U) == 2U);
+        me->state = MODEL_STATE_OFF;
+        me->expected_led = LED_FSM_LED_STATE_OFF;
+        me->led = LED_FSM_LED_STATE_OFF;
+
+        led_fsm_ctor(&me->fsm, (uint32_t)((rand_next() % MAX_TIME_MS) + 1U),
+                     (uint32_t)((rand_next() % MAX_TIME_MS) + 1U), (void *)me,
+                     &led_set, &timer_arm, &timer_disarm);
+
+        if (me->hw_toggle)
+        {
+            led_fsm_hw_toggle_set(&me->fsm, &toggle_start, &toggle_stop);
+        }
+
+        if (me->periodic_timer)
+        {
+            led_fsm_periodic_timer_set(&me->fsm, &timer_arm_periodic);
+        }
+    }
+
+    printf("led_fsm_stress: seed=%" PRIu64 " instances=%zu events=%" PRIu64 "%s\n",
+           seed, instance_count, total_events, (check) ? "" : " (no checks)");
+
+    start = now_s();
+    for (event_count = 0; event_count < total_events; event_count++)
+    {
+        struct instance *me = &instances[rand_next() % instance_count];
+        uint64_t r = rand_next() % 100U;
+        enum led_fsm_event_signals signal = LED_FSM_SWITCH_PRESSED_EVT;
+
+        /* Timeouts only arrive while a timer is armed, like a real one-shot
+        timer that disarms itself before running its callback. Periodic
+        timers stay armed. Presses and releases arrive at any time,
+        including redundant ones. */
+        if ((me->timer_armed) && (r < 30U))
+        {
+            me->timer_armed = me->timer_periodic;
+            signal = LED_FSM_TIMEOUT_EVT;
+        }
+        else if (r < 65U)
+        {
+            signal = LED_FSM_SWITCH_PRESSED_EVT;
+        }
+        else
+        {
+            signal = LED_FSM_SWITCH_RELEASED_EVT;
+        }
+
+        ecu_fsm_dispatch((struct ecu_fsm *)&me->fsm,
+                         (const struct ecu_event *)&events[signal - LED_FSM_SWITCH_PRESSED_EVT]);
+
+        if (check)
+        {
+            model_update(me, signal);
+            model_check(me);
+        }
+    }
+    elapsed = now_s() - start;
+
+    printf("led_fsm_stress: PASS %" PRIu64 " events in %.3f s (%.0f events/s)\n",
+           total_events, elapsed, (elapsed > 0.0) ? ((double)total_events / elapsed) : 0.0);
+
+    free(instances);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,428 @@
+/**
+ * @file
+ * @brief Turns token_log records (see src/app/token_log.h) back into
+ * text. The format strings are read out of the log_fmt section of the
+ * ELF file the records came from, the firmware or a host program. Usage:
+ *
+ *     log_decode <elf> <records>|-
+ *     log_decode <elf> --formats
+ *
+ * Records are read from the file, or from stdin for -, one at a time, so
+ * a growing file can be followed through tail -f. Each one is printed on
+ * its own line. A token that is not in the section or an argument count
+ * that does not match its format string is flagged on the line.
+ *
+ * --formats lists every format string with its token, and how many bytes
+ * they would have taken in flash had they been linked in. Formatting
+ * code is not counted.
+ *
+ * Exits with a non-zero status if the ELF file has no log_fmt section or
+ * the records end part way through one.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <elf.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Application. */
+#include "app/token_log.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define SECTION_NAME                            "log_fmt"
+
+/**
+ * @brief Longest single conversion, e.g. "%-010u".
+ */
+#define SPEC_MAX                                (16U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint8_t *file_read(const char *path, size_t *size);
+static bool section_find(const uint8_t *elf, size_t size);
+static bool section_find32(const uint8_t *elf, size_t size);
+static bool section_find64(const uint8_t *elf, size_t size);
+static uint8_t conversions(const char *fmt);
+static void record_print(uint32_t token, const uint32_t *args, uint8_t nargs);
+static int formats_list(void);
+static int records_decode(FILE *in);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Contents of the log_fmt section. Tokens are offsets into it.
+ */
+static const char *formats;
+static uint64_t formats_size;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint8_t *file_read(const char *path, size_t *size)
+{
+    uint8_t *data = (uint8_t *)0;
+    long end = 0;
+    FILE *f = fopen(path, "rb");
+
+    if (!f)
+    {
+        perror(path);
+        return (uint8_t *)0;
+    }
+
+    if ((fseek(f, 0, SEEK_END) == 0) && ((end = ftell(f)) > 0) && (fseek(f, 0, SEEK_SET) == 0))
+    {
+        data = (uint8_t *)malloc((size_t)end);
+        if (data && (fread(data, 1, (size_t)end, f) != (size_t)end))
+        {
+            free(data);
+            data = (uint8_t *)0;
+        }
+    }
+
+    fclose(f);
+    *size = (size_t)end;
+    return data;
+}
+
+
+static bool section_find(const uint8_t *elf, size_t size)
+{
+    if ((size < EI_NIDENT) || (memcmp(elf, ELFMAG, SELFMAG) != 0) || (elf[EI_DATA] != ELFDATA2LSB))
+    {
+        fprintf(stderr, "log_decode: not a little-endian ELF file\n");
+        return false;
+    }
+
+    /* Firmware is ELF32, host programs ELF64. */
+    return (elf[EI_CLASS] == ELFCLASS32) ? section_find32(elf, size) : section_find64(elf, size);
+}
+
+
+static bool section_find32(const uint8_t *elf, size_t size)
+{
+    Elf32_Ehdr eh;
+    Elf32_Shdr sh;
+    Elf32_Shdr names;
+
+    if (size < sizeof(eh))
+    {
+        return false;
+    }
+    memcpy(&eh, elf, sizeof(eh));
+    if ((eh.e_shstrndx >= eh.e_shnum) || ((eh.e_shoff + ((uint64_t)eh.e_shnum * sizeof(sh))) > size))
+    {
+        return false;
+    }
+
+    memcpy(&names, &elf[eh.e_shoff + ((size_t)eh.e_shstrndx * sizeof(sh))], sizeof(names));
+    for (uint32_t i = 0; i < eh.e_shnum; i++)
+    {
+        memcpy(&sh, &elf[eh.e_shoff + ((size_t)i * sizeof(sh))], sizeof(sh));
+        if (((uint64_t)names.sh_offset + sh.sh_name + sizeof(SECTION_NAME) <= size) &&
+            (strcmp((const char *)&elf[names.sh_offset + sh.sh_name], SECTION_NAME) == 0) &&
+            (sh.sh_type != SHT_NOBITS) && (((uint64_t)sh.sh_offset + sh.sh_size) <= size))
+        {
+            formats = (const char *)&elf[sh.sh_offset];
+            formats_size = sh.sh_size;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+static bool section_find64(const uint8_t *elf, size_t size)
+{
+    Elf64_Ehdr eh;
+    Elf64_Shdr sh;
+    Elf64_Shdr names;
+
+    if (size < sizeof(eh))
+    {
+        return false;
+    }
+    memcpy(&eh, elf, sizeof(eh));
+    if ((eh.e_shstrndx >= eh.e_shnum) || ((eh.e_shoff + ((uint64_t)eh.e_shnum * sizeof(sh))) > size))
+    {
+        return false;
+    }
+
+    memcpy(&names, &elf[eh.e_shoff + ((size_t)eh.e_shstrndx * sizeof(sh))], sizeof(names));
+    for (uint32_t i = 0; i < eh.e_shnum; i++)
+    {
+        memcpy(&sh, &elf[eh.e_shoff + ((size_t)i * sizeof(sh))], sizeof(sh));
+        if ((names.sh_offset + sh.sh_name + sizeof(SECTION_NAME) <= size) &&
+            (strcmp((const char *)&elf[names.sh_offset + sh.sh_name], SECTION_NAME) == 0) &&
+            (sh.sh_type != SHT_NOBITS) && ((sh.sh_offset + sh.sh_size) <= size))
+        {
+            formats = (const char *)&elf[sh.sh_offset];
+            formats_size = sh.sh_size;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+static uint8_t conversions(const char *fmt)
+{
+    uint8_t count = 0;
+
+    for (const char *c = fmt; *c != '\0'; c++)
+    {
+        if (*c != '%')
+        {
+            continue;
+        }
+        c++;
+        if (*c == '\0')
+        {
+            break;
+        }
+        if (*c != '%')
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+
+static void record_print(uint32_t token, const uint32_t *args, uint8_t nargs)
+{
+    char spec[SPEC_MAX];
+    size_t spec_len = 0;
+    const char *fmt = (const char *)0;
+    uint8_t arg = 0;
+
+    if ((token >= formats_size) || ((token > 0) && (formats[token - 1U] != '\0')))
+    {
+        printf("<unknown token 0x%06" PRIX32 ">\n", token);
+        return;
+    }
+
+    fmt = &formats[token];
+    for (const char *c = fmt; *c != '\0'; c++)
+    {
+        if (*c != '%')
+        {
+            putchar(*c);
+            continue;
+        }
+
+        /* Flags and width are passed through, the conversion picks the type. */
+        spec_len = 0;
+        spec[spec_len++] = *c++;
+        while (((*c == '-') || (*c == '0') || ((*c >= '1') && (*c <= '9'))) && (spec_len < (SPEC_MAX - 2U)))
+        {
+            spec[spec_len++] = *c++;
+        }
+        spec[spec_len++] = *c;
+        spec[spec_len] = '\0';
+
+        if (*c == '%')
+        {
+            putchar('%');
+            continue;
+        }
+        if (*c == '\0')
+        {
+            break;
+        }
+        if (arg >= nargs)
+        {
+            printf("<missing>");
+            continue;
+        }
+
+        switch (*c)
+        {
+            case 'd':
+            case 'i':
+            {
+                spec[spec_len - 1U] = 'd';
+                printf(spec, (int)(int32_t)args[arg++]);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+            {
+                printf(spec, (unsigned)args[arg++]);
+                break;
+            }
+            case 'c':
+            {
+                printf(spec, (int)(args[arg++] & 0xFFU));
+                break;
+            }
+            default:
+            {
+                printf("<%%%c? 0x%08" PRIX32 ">", *c, args[arg++]);
+                break;
+            }
+        }
+    }
+
+    if (conversions(fmt) != nargs)
+    {
+        printf("  <%u arguments logged, format takes %u>", nargs, conversions(fmt));
+    }
+    putchar('\n');
+}
+
+
+static int formats_list(void)
+{
+    uint32_t count = 0;
+    uint64_t bytes = 0;
+    uint64_t token = 0;
+
+    while (token < formats_size)
+    {
+        /* Padding between strings is zeros. */
+        if (formats[token] == '\0')
+        {
+            token++;
+            continue;
+        }
+        printf("0x%06" PRIX64 "  %s\n", token, &formats[token]);
+        count++;
+        bytes += strlen(&formats[token]) + 1U;
+        token += strlen(&formats[token]) + 1U;
+    }
+
+    printf("%" PRIu32 " format strings, %" PRIu64 " bytes kept out of flash (section %" PRIu64 " bytes)\n",
+           count, bytes, formats_size);
+    return EXIT_SUCCESS;
+}
+
+
+static int records_decode(FILE *in)
+{
+    uint8_t bytes[4U * (TOKEN_LOG_ARGS_MAX + 1U)];
+    uint32_t words[TOKEN_LOG_ARGS_MAX + 1U];
+    uint8_t nargs = 0;
+
+    while (fread(bytes, 1, 4, in) == 4U)
+    {
+        words[0] = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+        nargs = (uint8_t)((words[0] & TOKEN_LOG_HEADER_ARGS_MASK) >> TOKEN_LOG_HEADER_ARGS_OFFSET);
+        if (!(words[0] & TOKEN_LOG_HEADER_VALID) || (nargs > TOKEN_LOG_ARGS_MAX))
+        {
+            fprintf(stderr, "log_decode: bad record header 0x%08" PRIX32 "\n", words[0]);
+            return EXIT_FAILURE;
+        }
+
+        if (fread(&bytes[4], 4, nargs, in) != nargs)
+        {
+            fprintf(stderr, "log_decode: records end part way through one\n");
+            return EXIT_FAILURE;
+        }
+        for (uint8_t i = 1; i <= nargs; i++)
+        {
+            words[i] = (uint32_t)bytes[4U * i] | ((uint32_t)bytes[(4U * i) + 1U] << 8) |
+                       ((uint32_t)bytes[(4U * i) + 2U] << 16) | ((uint32_t)bytes[(4U * i) + 3U] << 24);
+        }
+
+        record_print(words[0] & TOKEN_LOG_HEADER_TOKEN_MASK, &words[1], nargs);
+        fflush(stdout);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    uint8_t *elf = (uint8_t *)0;
+    size_t size = 0;
+    FILE *in = stdin;
+    int status = EXIT_FAILURE;
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: %s <elf> <records>|-|--formats\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    elf = file_read(argv[1], &size);
+    if (!elf)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (!section_find(elf, size))
+    {
+        fprintf(stderr, "log_decode: %s has no %s section\n", argv[1], SECTION_NAME);
+    }
+    else if (strcmp(argv[2], "--formats") == 0)
+    {
+        status = formats_list();
+    }
+    else
+    {
+        if (strcmp(argv[2], "-") != 0)
+        {
+            in = fopen(argv[2], "rb");
+        }
+
+        if (!in)
+        {
+            perror(argv[2]);
+        }
+        else
+        {
+            status = records_decode(in);
+            if (in != stdin)
+            {
+                fclose(in);
+            }
+        }
+    }
+
+    free(elf);
+    return status;
+}
@@ -0,0 +1,563 @@
+/**
+ * @file
+ * @brief Drives the EXTI driver and switch_input with simulated bouncing
+ * switches through mocked GPIO and EXTI registers. Each pin change sets
+ * the input data register, latches the pending bit the way the EXTI
+ * edge detectors do and runs the interrupt handlers the NVIC would. The
+ * main loop takes events once per pass, with jitter, the way
+ * led_fsms_run() does. The cycle counter advances with simulated time at
+ * 80 MHz and wraps during a default run.
+ *
+ * Switches alternate between long holds and short taps. Every change
+ * bounces a random number of times, some for longer than the debounce
+ * window, and the occasional glitch is a spike that settles back. Checks:
+ *
+ *     1. A change after two quiet windows is taken with the cycle counter
+ *        value of its first edge plus the interrupt entry latency, and
+ *        with the new level.
+ *     2. Once a switch has been quiet for the debounce window plus two
+ *        passes, the main loop has been told its level.
+ *     3. The queue never overflows.
+ *
+ * Reports edge to dispatch latency against a polled debouncer run on the
+ * same signals (sample once per pass, report a level that held for the
+ * debounce window), and how many interrupts the edges cost.
+ *
+ * Usage:
+ *
+ *     switch_input_check [--seed=N] [--seconds=N] [--switches=N]
+ *
+ * Exits with a non-zero status on any violation.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Switch input. */
+#include "app/switch_input.h"
+
+/* Drivers. */
+#include "cycle_counter/cycle_counter.h"
+#include "exti/exti.h"
+#include "gpio/gpio.h"
+#include "irq/irq.h"
+#include "registers/registers.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define DEFAULT_SEED                            (1U)
+#define DEFAULT_SECONDS                         (120U)
+#define DEFAULT_SWITCHES                        (2U)
+
+/**
+ * @brief Same as the board. Switch n is on PA n, so at most 8 fit lines
+ * the EXTI0 - EXTI4 and EXTI9_5 handlers cover.
+ */
+#define CYCLES_PER_US                           (80U)
+#define DEBOUNCE_US                             (20000U)
+#define LOOP_PERIOD_US                          (1000U)
+
+/**
+ * @brief Cortex-M4 exception entry with zero wait state memory.
+ */
+#define ENTRY_CYCLES                            (12U)
+
+/**
+ * @brief Marks PR1 as not written since the model last loaded it. Bit 31
+ * is not a line, so the driver never sees it. PR1 is write 1 to clear,
+ * which a plain RAM register cannot do by itself.
+ */
+#define PR1_UNWRITTEN                           (1U << 31)
+
+#define US(us)                                  ((uint64_t)(us) * CYCLES_PER_US)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief One switch contact. Pressed pulls the pin low.
+ */
+struct contact
+{
+    bool pressed;                   /* What the pin shows now. */
+    uint64_t next_edge;
+    uint32_t edges_left;            /* Transitions left in the current burst. */
+    uint64_t last_edge;
+    bool glitch;                    /* Current burst settles back where it started. */
+
+    /* Set by the first edge of a change after a quiet period. */
+    bool expect;
+    bool expect_pressed;
+    uint64_t expect_edge;
+
+    /* What the main loop was told. */
+    bool taken_pressed;
+
+    /* Polled debouncer on the same signal. */
+    bool polled_pressed;
+    bool polled_candidate;
+    uint64_t polled_since;
+    bool polled_expect;
+    uint64_t polled_edge;
+};
+
+
+struct latency
+{
+    uint32_t count;
+    uint64_t total;
+    uint64_t max;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void);
+static uint64_t rand_range(uint64_t lo, uint64_t hi);
+static void pr1_load(void);
+static void pr1_sync(void);
+static void nvic_service(uint64_t now);
+static void pin_set(uint8_t line, bool pressed, uint64_t now);
+static void contact_schedule(struct contact *c, uint64_t now);
+static void contact_edge(uint8_t sw, uint64_t now);
+static void pass(uint64_t now);
+static void latency_add(struct latency *me, uint64_t cycles);
+static void latency_print(const char *name, const struct latency *me);
+static void edge(uint8_t line, uint32_t cycles);
+static uint32_t input_get_time(void *obj);
+static bool input_level(void *obj, uint8_t sw);
+static void input_unmask(void *obj, uint8_t sw);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* Every handler a switch can use, at one level like the board. */
+static const struct irq_priority irq_priorities[] =
+{
+    { .irq = NVIC_IRQ_EXTI0,            .priority = 1 },
+    { .irq = NVIC_IRQ_EXTI0 + 1U,       .priority = 1 },
+    { .irq = NVIC_IRQ_EXTI0 + 2U,       .priority = 1 },
+    { .irq = NVIC_IRQ_EXTI0 + 3U,       .priority = 1 },
+    { .irq = NVIC_IRQ_EXTI0 + 4U,       .priority = 1 },
+    { .irq = NVIC_IRQ_EXTI9_5,          .priority = 1 }
+};
+
+static uint64_t rand_state;
+static uint8_t switch_count = DEFAULT_SWITCHES;
+static struct contact contacts[SWITCH_INPUT_SWITCHES_MAX];
+static struct switch_input input;
+
+/* Pending bits as the EXTI holds them. Interrupts enabled in the NVIC,
+collected from the write 1 to set ISER writes. */
+static uint32_t pending;
+static uint32_t nvic_enabled;
+static uint64_t sim_now;
+
+static uint32_t pin_edges;
+static uint32_t interrupts;
+static uint32_t glitches;
+static uint32_t stamp_violations;
+static uint32_t level_violations;
+static struct latency interrupt_latency;
+static struct latency polled_latency;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void)
+{
+    /* xorshift64*. Deterministic for a given seed on every host. */
+    rand_state ^= rand_state >> 12;
+    rand_state ^= rand_state << 25;
+    rand_state ^= rand_state >> 27;
+    return rand_state * 0x2545F4914F6CDD1DULL;
+}
+
+
+static uint64_t rand_range(uint64_t lo, uint64_t hi)
+{
+    return lo + (rand_next() % ((hi - lo) + 1U));
+}
+
+
+static void pr1_load(void)
+{
+    EXTI->PR1 = pending | PR1_UNWRITTEN;
+}
+
+
+static void pr1_sync(void)
+{
+    /* Whatever the driver wrote last are the bits it cleared. Every call
+    that can write PR1 is followed by this, and none writes it twice. */
+    if (!(EXTI->PR1 & PR1_UNWRITTEN))
+    {
+        pending &= ~EXTI->PR1;
+    }
+    pr1_load();
+}
+
+
+static void nvic_service(uint64_t now)
+{
+    uint32_t fire = 0;
+    uint8_t line = 0;
+    uint8_t irq = 0;
+
+    /* Same priority for every EXTI interrupt, so one handler at a time,
+    lowest line first. */
+    for (;;)
+    {
+        fire = pending & EXTI->IMR1 & 0xFFFFU;
+        if (fire == 0)
+        {
+            return;
+        }
+
+        for (line = 0; !(fire & (1U << line)); line++)
+        {
+        }
+
+        irq = (line <= 4U) ? (uint8_t)(NVIC_IRQ_EXTI0 + line) : NVIC_IRQ_EXTI9_5;
+        if (!(nvic_enabled & (1U << irq)))
+        {
+            fprintf(stderr, "switch_input_check: line %u pending with its interrupt disabled\n", line);
+            exit(EXIT_FAILURE);
+        }
+
+        DWT->CYCCNT = (uint32_t)(now + ENTRY_CYCLES);
+        switch (line)
+        {
+            case 0: exti0_isr_handler(); break;
+            case 1: exti1_isr_handler(); break;
+            case 2: exti2_isr_handler(); break;
+            case 3: exti3_isr_handler(); break;
+            case 4: exti4_isr_handler(); break;
+            default: exti_9_5_isr_handler(); break;
+        }
+        pr1_sync();
+        DWT->CYCCNT = (uint32_t)now;
+    }
+}
+
+
+static void pin_set(uint8_t line, bool pressed, uint64_t now)
+{
+    uint32_t bit = 1U << line;
+
+    if (pressed)
+    {
+        GPIOA->IDR &= ~bit;
+        pending |= (EXTI->FTSR1 & bit);
+    }
+    else
+    {
+        GPIOA->IDR |= bit;
+        pending |= (EXTI->RTSR1 & bit);
+    }
+
+    pin_edges++;
+    pr1_load();
+    nvic_service(now);
+}
+
+
+static void contact_schedule(struct contact *c, uint64_t now)
+{
+    uint64_t roll = rand_next() % 100U;
+
+    if (c->edges_left > 0)
+    {
+        /* Bounce. Glitches are a single short spike. */
+        c->next_edge = now + ((c->glitch) ? US(rand_range(1U, 10U)) : US(rand_range(20U, 2500U)));
+        return;
+    }
+
+    /* Quiet until the next change. Some are taps shorter than the window. */
+    c->next_edge = now + ((roll < 15U) ? US(rand_range(2000U, 15000U)) : US(rand_range(30000U, 600000U)));
+    roll = rand_next() % 100U;
+    c->glitch = (roll < 4U);
+    c->edges_left = (c->glitch) ? 2U : (uint32_t)(1U + (2U * rand_range(0U, 6U)));
+    glitches += (c->glitch) ? 1U : 0U;
+}
+
+
+static void contact_edge(uint8_t sw, uint64_t now)
+{
+    struct contact *c = &contacts[sw];
+
+    /* A change after a quiet period finds the line unmasked. Its first
+    edge is the one the event must carry. A short press found at the end
+    of a window restarts it, so quiet means two windows and their passes. */
+    if ((now - c->last_edge) >= US((2U * DEBOUNCE_US) + (4U * LOOP_PERIOD_US)))
+    {
+        c->expect = true;
+        c->expect_pressed = !c->taken_pressed;
+        c->expect_edge = now;
+        c->polled_expect = !c->glitch;
+        c->polled_edge = now;
+    }
+
+    c->pressed = !c->pressed;
+    c->last_edge = now;
+    c->edges_left--;
+    pin_set(sw, c->pressed, now);
+    contact_schedule(c, now);
+}
+
+
+static void pass(uint64_t now)
+{
+    struct switch_input_event evt;
+    struct contact *c = (struct contact *)0;
+
+    DWT->CYCCNT = (uint32_t)now;
+    while (switch_input_take(&input, &evt))
+    {
+        c = &contacts[evt.sw];
+        if (c->expect)
+        {
+            if ((evt.time != (uint32_t)(c->expect_edge + ENTRY_CYCLES)) || (evt.pressed != c->expect_pressed))
+            {
+                fprintf(stderr, "switch_input_check: switch %u event at %" PRIu32 " %s, expected %" PRIu32 " %s\n",
+                        evt.sw, evt.time, (evt.pressed) ? "pressed" : "released",
+                        (uint32_t)(c->expect_edge + ENTRY_CYCLES), (c->expect_pressed) ? "pressed" : "released");
+                stamp_violations++;
+            }
+            else
+            {
+                latency_add(&interrupt_latency, now - c->expect_edge);
+            }
+            c->expect = false;
+        }
+        c->taken_pressed = evt.pressed;
+    }
+
+    for (uint8_t i = 0; i < switch_count; i++)
+    {
+        c = &contacts[i];
+
+        /* Polled. A level must hold for the debounce window, sampled. */
+        if (c->pressed == c->polled_pressed)
+        {
+            c->polled_candidate = false;
+        }
+        else if (!c->polled_candidate)
+        {
+            c->polled_candidate = true;
+            c->polled_since = now;
+        }
+        else if ((now - c->polled_since) >= US(DEBOUNCE_US))
+        {
+            c->polled_pressed = c->pressed;
+            c->polled_candidate = false;
+            if (c->polled_expect)
+            {
+                latency_add(&polled_latency, now - c->polled_edge);
+                c->polled_expect = false;
+            }
+        }
+
+        if (((now - c->last_edge) >= (US(DEBOUNCE_US) + US(2U * LOOP_PERIOD_US))) &&
+            (c->taken_pressed != c->pressed))
+        {
+            fprintf(stderr, "switch_input_check: switch %u quiet and %s, main loop still thinks %s\n",
+                    i, (c->pressed) ? "pressed" : "released", (c->taken_pressed) ? "pressed" : "released");
+            level_violations++;
+            c->taken_pressed = c->pressed;
+        }
+    }
+}
+
+
+static void latency_add(struct latency *me, uint64_t cycles)
+{
+    me->count++;
+    me->total += cycles;
+    me->max = (cycles > me->max) ? cycles : me->max;
+}
+
+
+static void latency_print(const char *name, const struct latency *me)
+{
+    printf("  %-10s %6" PRIu32 " changes, mean %8.1f us, max %8.1f us\n", name, me->count,
+           (me->count > 0) ? ((double)me->total / (double)me->count / CYCLES_PER_US) : 0.0,
+           (double)me->max / CYCLES_PER_US);
+}
+
+
+static void edge(uint8_t line, uint32_t cycles)
+{
+    interrupts++;
+    switch_input_edge(&input, line, cycles);
+}
+
+
+static uint32_t input_get_time(void *obj)
+{
+    (void)obj;
+    return cycle_counter_get();
+}
+
+
+static bool input_level(void *obj, uint8_t sw)
+{
+    (void)obj;
+    exti_pending_clear(sw);
+    pr1_sync();
+    return !(GPIOA->IDR & (1U << sw));
+}
+
+
+static void input_unmask(void *obj, uint8_t sw)
+{
+    (void)obj;
+    exti_unmask(sw);
+
+    /* An edge latched since the sample interrupts right away. */
+    nvic_service(sim_now);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    uint64_t seed = DEFAULT_SEED;
+    uint32_t seconds = DEFAULT_SECONDS;
+    uint32_t switches = DEFAULT_SWITCHES;
+    uint64_t end = 0;
+    uint64_t next_pass = 0;
+    uint64_t next = 0;
+    uint8_t next_sw = 0;
+    uint32_t passes = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+        {
+            seed = strtoull(&argv[i][7], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--seconds=", 10) == 0)
+        {
+            seconds = (uint32_t)strtoul(&argv[i][10], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--switches=", 11) == 0)
+        {
+            switches = (uint32_t)strtoul(&argv[i][11], (char **)0, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--seed=N] [--seconds=N] [--switches=N]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((switches == 0) || (switches > SWITCH_INPUT_SWITCHES_MAX))
+    {
+        fprintf(stderr, "switch_input_check: --switches must be 1 to %u\n", SWITCH_INPUT_SWITCHES_MAX);
+        return EXIT_FAILURE;
+    }
+    switch_count = (uint8_t)switches;
+    rand_state = (seed == 0) ? 1U : seed;
+    end = US((uint64_t)seconds * 1000000U);
+
+    /* Same bring up as the board. Released switches read high. */
+    stm32l432_mock_registers_reset();
+    irq_init(irq_priorities, (uint8_t)(sizeof(irq_priorities) / sizeof(irq_priorities[0])));
+    cycle_counter_init();
+    exti_init(&edge);
+    for (uint8_t i = 0; i < switch_count; i++)
+    {
+        const struct gpio_pin pin = { .port = GPIOA, .pin = i };
+        exti_line_init(&pin, GPIO_PUPDR_PULL_UP);
+        nvic_enabled |= NVIC->ISER[0];
+        GPIOA->IDR |= (1U << i);
+        contact_schedule(&contacts[i], 0);
+    }
+    pending = 0;
+    pr1_load();
+    switch_input_ctor(&input, switch_count, US(DEBOUNCE_US), (void *)0,
+                      &input_get_time, &input_level, &input_unmask);
+
+    while (sim_now < end)
+    {
+        next = next_pass;
+        next_sw = UINT8_MAX;
+        for (uint8_t i = 0; i < switch_count; i++)
+        {
+            if (contacts[i].next_edge < next)
+            {
+                next = contacts[i].next_edge;
+                next_sw = i;
+            }
+        }
+
+        sim_now = next;
+        if (next_sw != UINT8_MAX)
+        {
+            contact_edge(next_sw, sim_now);
+        }
+        else
+        {
+            pass(sim_now);
+            passes++;
+            next_pass = sim_now + US(rand_range(LOOP_PERIOD_US / 2U, (3U * LOOP_PERIOD_US) / 2U));
+        }
+    }
+
+    printf("switch_input_check: %" PRIu32 " s, %u switches, debounce %u us, loop %u us +-50%%, %" PRIu32 " passes\n",
+           seconds, switch_count, DEBOUNCE_US, LOOP_PERIOD_US, passes);
+    printf("  pin edges %" PRIu32 ", interrupts %" PRIu32 " (%.2f per edge), glitches injected %" PRIu32 "\n",
+           pin_edges, interrupts, (pin_edges > 0) ? ((double)interrupts / (double)pin_edges) : 0.0, glitches);
+    printf("  edges reported %" PRIu32 ", short presses found at window end %" PRIu32 ", queue overflows %" PRIu32 "\n",
+           input.edges, input.short_presses, input.overflows);
+    printf("  every stamped change carried its first edge + %u cycles of entry latency\n", ENTRY_CYCLES);
+    printf("edge to dispatch:\n");
+    latency_print("interrupt", &interrupt_latency);
+    latency_print("polled", &polled_latency);
+
+    if ((stamp_violations > 0) || (level_violations > 0) || (input.overflows > 0) || (interrupt_latency.count == 0))
+    {
+        fprintf(stderr, "switch_input_check: FAIL %" PRIu32 " stamp and %" PRIu32 " level violations\n",
+                stamp_violations, level_violations);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
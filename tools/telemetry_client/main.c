@@ -0,0 +1,625 @@
+/**
+ * @file
+ * @brief Talks to the telemetry channel (see src/app/telemetry.h) over a
+ * serial port. Works against the board's virtual COM port and against
+ * the pty integration_test prints at startup. Usage:
+ *
+ *     telemetry_client <port> stats
+ *     telemetry_client <port> hist iteration|wait
+ *     telemetry_client <port> led <n> [<hold ms> <toggle ms>]
+ *     telemetry_client <port> bench [--frames=N] [--size=N] [--window=N]
+ *     telemetry_client <port> log [--seconds=N] | log_decode <elf> -
+ *
+ * bench sends ECHO requests with --size payload bytes and keeps at most
+ * --window encoded bytes in flight so the receive ring on the other end
+ * is never overrun. It checks every echo and reports round trip times
+ * and throughput.
+ *
+ * log reads the board's token_log records with LOG_READ and writes them
+ * to stdout as they are, for tools/log_decode. It reads until the log is
+ * empty, or with --seconds keeps polling it every LOG_POLL_MS for that
+ * long.
+ *
+ * Exits with a non-zero status on a timeout, a NACK or a bad echo.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <fcntl.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Telemetry. */
+#include "app/loop_monitor.h"
+#include "app/telemetry_frame.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define TIMEOUT_MS                              (1000)
+#define DEFAULT_FRAMES                          (1000U)
+#define DEFAULT_SIZE                            (64U)
+#define LOG_POLL_MS                             (10)
+
+/**
+ * @brief Encoded bytes in flight. Below the 256 byte receive ring on
+ * target and in integration_test.
+ */
+#define DEFAULT_WINDOW                          (192U)
+
+/**
+ * @brief Requests in flight are matched to responses by seq, so there can
+ * be no more of them than seq values.
+ */
+#define IN_FLIGHT_MAX                           (256U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct in_flight
+{
+    uint8_t seq;
+    uint16_t encoded_size;
+    uint64_t sent_ns;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t monotonic_ns(void);
+static int port_open(const char *path);
+static void put_u32(uint8_t *out, uint32_t value);
+static uint32_t get_u32(const uint8_t *in);
+static bool frame_send(int fd, uint8_t type, uint8_t seq, const uint8_t *payload, uint16_t len);
+static bool frame_receive(int fd, struct telemetry_frame *frame);
+static bool request(int fd, uint8_t type, const uint8_t *payload, uint16_t len, struct telemetry_frame *response);
+static int stats_command(int fd);
+static int histogram_command(int fd, const char *which);
+static int led_command(int fd, int argc, char *argv[]);
+static int bench_command(int fd, int argc, char *argv[]);
+static int log_command(int fd, int argc, char *argv[]);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint8_t next_seq;
+
+
+/**
+ * @brief Bytes received after the last delimiter. Never more than one
+ * encoded frame, anything longer is garbage.
+ */
+static uint8_t rx_buf[TELEMETRY_FRAME_ENCODED_MAX];
+static uint16_t rx_len;
+static bool rx_overflow;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+
+static int port_open(const char *path)
+{
+    struct termios tio;
+    int fd = open(path, O_RDWR | O_NOCTTY);
+
+    if (fd < 0)
+    {
+        perror(path);
+        return -1;
+    }
+
+    /* 115200 8N1 raw. The speed is ignored by a pty. */
+    if (tcgetattr(fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        (void)cfsetispeed(&tio, B115200);
+        (void)cfsetospeed(&tio, B115200);
+        tio.c_cc[VMIN] = 0;
+        tio.c_cc[VTIME] = 0;
+        (void)tcsetattr(fd, TCSANOW, &tio);
+        (void)tcflush(fd, TCIOFLUSH);
+    }
+
+    return fd;
+}
+
+
+static void put_u32(uint8_t *out, uint32_t value)
+{
+    out[0] = (uint8_t)(value & 0xFFU);
+    out[1] = (uint8_t)((value >> 8) & 0xFFU);
+    out[2] = (uint8_t)((value >> 16) & 0xFFU);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+
+static uint32_t get_u32(const uint8_t *in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+
+static bool frame_send(int fd, uint8_t type, uint8_t seq, const uint8_t *payload, uint16_t len)
+{
+    uint8_t encoded[TELEMETRY_FRAME_ENCODED_MAX];
+    uint16_t size = telemetry_frame_encode(encoded, type, seq, payload, len);
+    uint16_t sent = 0;
+    ssize_t n = 0;
+
+    while (sent < size)
+    {
+        n = write(fd, &encoded[sent], (size_t)(size - sent));
+        if (n <= 0)
+        {
+            perror("write");
+            return false;
+        }
+        sent = (uint16_t)(sent + (uint16_t)n);
+    }
+
+    return true;
+}
+
+
+static bool frame_receive(int fd, struct telemetry_frame *frame)
+{
+    struct pollfd pfd = { .fd = fd, .events = POLLIN, .revents = 0 };
+    uint8_t byte = 0;
+
+    while (true)
+    {
+        if (poll(&pfd, 1, TIMEOUT_MS) <= 0)
+        {
+            fprintf(stderr, "telemetry_client: timed out waiting for a response\n");
+            return false;
+        }
+
+        while (read(fd, &byte, 1) == 1)
+        {
+            if (byte != TELEMETRY_FRAME_DELIMITER)
+            {
+                if (rx_len < sizeof(rx_buf))
+                {
+                    rx_buf[rx_len++] = byte;
+                }
+                else
+                {
+                    rx_overflow = true;
+                }
+                continue;
+            }
+
+            if ((rx_len > 0) && !rx_overflow &&
+                telemetry_frame_decode(frame, rx_buf, (uint16_t)sizeof(rx_buf), 0, rx_len))
+            {
+                rx_len = 0;
+                return true;
+            }
+
+            if (rx_len > 0)
+            {
+                fprintf(stderr, "telemetry_client: dropped a bad frame\n");
+            }
+            rx_len = 0;
+            rx_overflow = false;
+        }
+    }
+}
+
+
+static bool request(int fd, uint8_t type, const uint8_t *payload, uint16_t len, struct telemetry_frame *response)
+{
+    uint8_t seq = next_seq++;
+
+    if (!frame_send(fd, type, seq, payload, len))
+    {
+        return false;
+    }
+
+    /* Skips stale responses to anything sent before. */
+    do
+    {
+        if (!frame_receive(fd, response))
+        {
+            return false;
+        }
+    } while (response->seq != seq);
+
+    if (response->type == TELEMETRY_FRAME_NACK)
+    {
+        fprintf(stderr, "telemetry_client: NACK, error %u\n", (response->len == 2U) ? response->payload[1] : 0U);
+        return false;
+    }
+
+    if (response->type != (uint8_t)(type | TELEMETRY_FRAME_RESPONSE))
+    {
+        fprintf(stderr, "telemetry_client: unexpected response type 0x%02X\n", response->type);
+        return false;
+    }
+
+    return true;
+}
+
+
+static int stats_command(int fd)
+{
+    static const char *const names[] =
+    {
+        "iterations", "deadline misses", "events",
+        "worst iteration us", "worst iteration tick", "worst wait us", "worst wait tick",
+        "frames ok", "frames bad", "responses dropped"
+    };
+
+    struct telemetry_frame response;
+    const size_t count = sizeof(names) / sizeof(names[0]);
+
+    if (!request(fd, TELEMETRY_FRAME_STATS_GET, (const uint8_t *)0, 0, &response))
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (response.len != ((count * 4U) + 1U))
+    {
+        fprintf(stderr, "telemetry_client: stats response is %u bytes\n", response.len);
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        printf("%-22s %" PRIu32 "\n", names[i], get_u32(&response.payload[i * 4U]));
+    }
+
+    if (response.payload[count * 4U] == 0xFFU)
+    {
+        printf("%-22s %s\n", "governor level", "none");
+    }
+    else
+    {
+        printf("%-22s %u\n", "governor level", response.payload[count * 4U]);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+static int histogram_command(int fd, const char *which)
+{
+    struct telemetry_frame response;
+    uint8_t payload[1];
+    uint8_t bins = 0;
+
+    if (strcmp(which, "iteration") == 0)
+    {
+        payload[0] = 0;
+    }
+    else if (strcmp(which, "wait") == 0)
+    {
+        payload[0] = 1;
+    }
+    else
+    {
+        fprintf(stderr, "telemetry_client: histogram is iteration or wait\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!request(fd, TELEMETRY_FRAME_HISTOGRAM_GET, payload, sizeof(payload), &response))
+    {
+        return EXIT_FAILURE;
+    }
+
+    bins = (response.len >= 2U) ? response.payload[1] : 0U;
+    if ((response.len < 2U) || (response.len != ((bins * 4U) + 2U)))
+    {
+        fprintf(stderr, "telemetry_client: histogram response is %u bytes\n", response.len);
+        return EXIT_FAILURE;
+    }
+
+    printf("%12s %12s\n", "from us", "count");
+    for (uint8_t i = 0; i < bins; i++)
+    {
+        uint32_t count = get_u32(&response.payload[2U + (i * 4U)]);
+        if (count > 0)
+        {
+            printf("%12" PRIu32 " %12" PRIu32 "\n", loop_monitor_bin_floor(i), count);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+static int led_command(int fd, int argc, char *argv[])
+{
+    struct telemetry_frame response;
+    uint8_t payload[9];
+    uint16_t len = 1;
+
+    if ((argc != 1) && (argc != 3))
+    {
+        fprintf(stderr, "telemetry_client: led <n> [<hold ms> <toggle ms>]\n");
+        return EXIT_FAILURE;
+    }
+
+    payload[0] = (uint8_t)strtoul(argv[0], (char **)0, 0);
+    if (argc == 3)
+    {
+        put_u32(&payload[1], (uint32_t)strtoul(argv[1], (char **)0, 0));
+        put_u32(&payload[5], (uint32_t)strtoul(argv[2], (char **)0, 0));
+        len = sizeof(payload);
+    }
+
+    if (!request(fd, (len == 1U) ? TELEMETRY_FRAME_LED_GET : TELEMETRY_FRAME_LED_SET, payload, len, &response))
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (response.len != 10U)
+    {
+        fprintf(stderr, "telemetry_client: led response is %u bytes\n", response.len);
+        return EXIT_FAILURE;
+    }
+
+    printf("LED%u %s, hold %" PRIu32 " ms, toggle %" PRIu32 " ms\n", response.payload[0],
+           (response.payload[1]) ? "ON" : "OFF", get_u32(&response.payload[2]), get_u32(&response.payload[6]));
+    return EXIT_SUCCESS;
+}
+
+
+static int bench_command(int fd, int argc, char *argv[])
+{
+    static struct in_flight queue[IN_FLIGHT_MAX];
+
+    struct telemetry_frame response;
+    uint8_t payload[TELEMETRY_FRAME_PAYLOAD_MAX];
+    uint32_t frames = DEFAULT_FRAMES;
+    uint32_t size = DEFAULT_SIZE;
+    uint32_t window = DEFAULT_WINDOW;
+    uint32_t sent = 0;
+    uint32_t received = 0;
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    uint32_t in_flight_bytes = 0;
+    uint16_t encoded_size = 0;
+    uint64_t start_ns = 0;
+    uint64_t elapsed_ns = 0;
+    uint64_t rtt_ns = 0;
+    uint64_t rtt_min_ns = UINT64_MAX;
+    uint64_t rtt_max_ns = 0;
+    uint64_t rtt_sum_ns = 0;
+
+    for (int i = 0; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--frames=", 9) == 0)
+        {
+            frames = (uint32_t)strtoul(&argv[i][9], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--size=", 7) == 0)
+        {
+            size = (uint32_t)strtoul(&argv[i][7], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--window=", 9) == 0)
+        {
+            window = (uint32_t)strtoul(&argv[i][9], (char **)0, 0);
+        }
+        else
+        {
+            fprintf(stderr, "telemetry_client: bench [--frames=N] [--size=N] [--window=N]\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    encoded_size = (uint16_t)TELEMETRY_FRAME_ENCODED_SIZE(size);
+    if ((frames == 0) || (size > TELEMETRY_FRAME_PAYLOAD_MAX) || (window < encoded_size))
+    {
+        fprintf(stderr, "telemetry_client: need --frames > 0, --size <= %u and --window >= %u\n",
+                TELEMETRY_FRAME_PAYLOAD_MAX, (unsigned)encoded_size);
+        return EXIT_FAILURE;
+    }
+
+    start_ns = monotonic_ns();
+    while (received < frames)
+    {
+        /* Fill the window, then wait for the oldest echo. */
+        while ((sent < frames) && ((in_flight_bytes + encoded_size) <= window) && ((head - tail) < IN_FLIGHT_MAX))
+        {
+            for (uint32_t i = 0; i < size; i++)
+            {
+                payload[i] = (uint8_t)(sent + i);
+            }
+
+            queue[head % IN_FLIGHT_MAX].seq = next_seq;
+            queue[head % IN_FLIGHT_MAX].encoded_size = encoded_size;
+            queue[head % IN_FLIGHT_MAX].sent_ns = monotonic_ns();
+            if (!frame_send(fd, TELEMETRY_FRAME_ECHO, next_seq++, payload, (uint16_t)size))
+            {
+                return EXIT_FAILURE;
+            }
+            in_flight_bytes += encoded_size;
+            head++;
+            sent++;
+        }
+
+        if (!frame_receive(fd, &response))
+        {
+            fprintf(stderr, "telemetry_client: %" PRIu32 " of %" PRIu32 " echoes received\n", received, frames);
+            return EXIT_FAILURE;
+        }
+
+        if ((response.type != (TELEMETRY_FRAME_ECHO | TELEMETRY_FRAME_RESPONSE)) ||
+            (response.seq != queue[tail % IN_FLIGHT_MAX].seq) || (response.len != size))
+        {
+            fprintf(stderr, "telemetry_client: echo %" PRIu32 " out of order or wrong size\n", received);
+            return EXIT_FAILURE;
+        }
+
+        for (uint32_t i = 0; i < size; i++)
+        {
+            if (response.payload[i] != (uint8_t)(received + i))
+            {
+                fprintf(stderr, "telemetry_client: echo %" PRIu32 " corrupted at byte %" PRIu32 "\n", received, i);
+                return EXIT_FAILURE;
+            }
+        }
+
+        rtt_ns = monotonic_ns() - queue[tail % IN_FLIGHT_MAX].sent_ns;
+        rtt_min_ns = (rtt_ns < rtt_min_ns) ? rtt_ns : rtt_min_ns;
+        rtt_max_ns = (rtt_ns > rtt_max_ns) ? rtt_ns : rtt_max_ns;
+        rtt_sum_ns += rtt_ns;
+
+        in_flight_bytes -= queue[tail % IN_FLIGHT_MAX].encoded_size;
+        tail++;
+        received++;
+    }
+    elapsed_ns = monotonic_ns() - start_ns;
+
+    printf("%" PRIu32 " echoes of %" PRIu32 " bytes (%u encoded), window %" PRIu32 " bytes\n",
+           frames, size, (unsigned)encoded_size, window);
+    printf("round trip us: min %.1f, avg %.1f, max %.1f\n", (double)rtt_min_ns / 1e3,
+           ((double)rtt_sum_ns / (double)frames) / 1e3, (double)rtt_max_ns / 1e3);
+    printf("frames/s %.0f, payload bytes/s each way %.0f, line bytes/s each way %.0f\n",
+           ((double)frames * 1e9) / (double)elapsed_ns,
+           ((double)frames * (double)size * 1e9) / (double)elapsed_ns,
+           ((double)frames * (double)encoded_size * 1e9) / (double)elapsed_ns);
+    return EXIT_SUCCESS;
+}
+
+
+
+static int log_command(int fd, int argc, char *argv[])
+{
+    struct telemetry_frame response;
+    uint64_t seconds = 0;
+    uint64_t end_ns = 0;
+
+    for (int i = 0; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--seconds=", 10) == 0)
+        {
+            seconds = strtoull(&argv[i][10], (char **)0, 0);
+        }
+        else
+        {
+            fprintf(stderr, "telemetry_client: log [--seconds=N]\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    end_ns = monotonic_ns() + (seconds * 1000000000U);
+    while (true)
+    {
+        if (!request(fd, TELEMETRY_FRAME_LOG_READ, (const uint8_t *)0, 0, &response))
+        {
+            return EXIT_FAILURE;
+        }
+
+        if (response.len > 0)
+        {
+            if (fwrite(response.payload, 1, response.len, stdout) != response.len)
+            {
+                perror("stdout");
+                return EXIT_FAILURE;
+            }
+            fflush(stdout);
+            continue;
+        }
+
+        if (monotonic_ns() >= end_ns)
+        {
+            return EXIT_SUCCESS;
+        }
+        (void)poll((struct pollfd *)0, 0, LOG_POLL_MS);
+    }
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC FUNCTIONS ---------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    int fd = -1;
+    int status = EXIT_FAILURE;
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s <port> stats | hist iteration|wait | led <n> [<hold ms> <toggle ms>] | "
+                        "bench [--frames=N] [--size=N] [--window=N] | log [--seconds=N]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    fd = port_open(argv[1]);
+    if (fd < 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (strcmp(argv[2], "stats") == 0)
+    {
+        status = stats_command(fd);
+    }
+    else if ((strcmp(argv[2], "hist") == 0) && (argc == 4))
+    {
+        status = histogram_command(fd, argv[3]);
+    }
+    else if ((strcmp(argv[2], "led") == 0) && (argc > 3))
+    {
+        status = led_command(fd, argc - 3, &argv[3]);
+    }
+    else if (strcmp(argv[2], "bench") == 0)
+    {
+        status = bench_command(fd, argc - 3, &argv[3]);
+    }
+    else if (strcmp(argv[2], "log") == 0)
+    {
+        status = log_command(fd, argc - 3, &argv[3]);
+    }
+    else
+    {
+        fprintf(stderr, "telemetry_client: unknown command %s\n", argv[2]);
+    }
+
+    close(fd);
+    return status;
+}
@@ -0,0 +1,349 @@
+/**
+ * @file
+ * @brief Simulates a main loop with random latency spikes for a number of
+ * hours of virtual time and measures the phase error of two periodic
+ * LED toggle timers armed on the same tick. Two schemes run side by side
+ * on the same clock:
+ *
+ *     rearm       The timeout callback re-arms a one-shot timer counted
+ *                 from when it ran. What the held down state did before
+ *                 led_fsm_periodic_timer_set().
+ *     deadline    deadline_timer periodic timer. Every deadline is the
+ *                 previous deadline plus the period.
+ *
+ * Drift is how far the next scheduled expiry is from the ideal period
+ * grid. Skew is how far apart the two LEDs' next expiries are. Usage:
+ *
+ *     timer_drift [--seed=N] [--hours=N] [--period-ms=N]
+ *                 [--spike-percent=N] [--spike-max-ms=N]
+ *                 [--policy=once|catch-up] [--max-catch-up=N]
+ *
+ * Exits with a non-zero status if the deadline timers drifted or skewed.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Deadline timers. */
+#include "app/deadline_timer.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define DEFAULT_SEED                            (1U)
+#define DEFAULT_HOURS                           (24U)
+#define DEFAULT_PERIOD_MS                       (500U)
+#define DEFAULT_SPIKE_PERCENT                   (1U)
+#define DEFAULT_SPIKE_MAX_MS                    (20U)
+#define DEFAULT_MAX_CATCH_UP                    (4U)
+
+/**
+ * @brief Percent of timeout callbacks that take a whole extra tick. Makes
+ * the two LEDs see different times when they re-arm.
+ */
+#define CALLBACK_SLOW_PERCENT                   (10U)
+
+/**
+ * @brief Virtual clock starts just before the 32-bit tick counter wraps
+ * so every run also crosses the wrap.
+ */
+#define START_TICKS                             (0xFFFF0000U)
+
+#define LED_COUNT                               (2U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct rearm_led
+{
+    uint32_t deadline;
+    uint64_t fires;
+    uint32_t max_late;
+};
+
+
+struct deadline_led
+{
+    struct deadline_timer timer;
+    uint64_t fires;
+    uint32_t max_late;
+};
+
+
+struct result
+{
+    uint64_t fires;
+    uint64_t missed;
+    uint32_t max_late;
+    int64_t drift;
+    int64_t skew;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void);
+static void advance(uint64_t ticks);
+static uint32_t get_ticks(void *obj);
+static void deadline_callback(void *obj);
+static void rearm_tick(void);
+static void print_result(const char *name, const struct result *r);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_state;
+
+/* Absolute virtual time in ticks (ms) since the start of the run. */
+static uint64_t elapsed;
+static uint32_t period = DEFAULT_PERIOD_MS;
+
+static struct rearm_led rearm_leds[LED_COUNT];
+static struct deadline_led deadline_leds[LED_COUNT];
+static struct deadline_timer_collection collection;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static uint64_t rand_next(void)
+{
+    /* xorshift64*. Deterministic for a given seed on every host. */
+    rand_state ^= rand_state >> 12;
+    rand_state ^= rand_state << 25;
+    rand_state ^= rand_state >> 27;
+    return rand_state * 0x2545F4914F6CDD1DULL;
+}
+
+
+static void advance(uint64_t ticks)
+{
+    elapsed += ticks;
+}
+
+
+static uint32_t get_ticks(void *obj)
+{
+    (void)obj;
+    return START_TICKS + (uint32_t)elapsed;
+}
+
+
+static void deadline_callback(void *obj)
+{
+    struct deadline_led *me = (struct deadline_led *)obj;
+
+    /* The newest deadline that passed is one period before the next one. */
+    uint32_t late = get_ticks((void *)0) - (me->timer.deadline - period);
+    if (late > me->max_late)
+    {
+        me->max_late = late;
+    }
+
+    me->fires++;
+    if ((rand_next() % 100U) < CALLBACK_SLOW_PERCENT)
+    {
+        advance(1);
+    }
+}
+
+
+static void rearm_tick(void)
+{
+    for (size_t i = 0; i < LED_COUNT; i++)
+    {
+        struct rearm_led *me = &rearm_leds[i];
+        uint32_t late = get_ticks((void *)0) - me->deadline;
+
+        if ((int32_t)late >= 0)
+        {
+            if (late > me->max_late)
+            {
+                me->max_late = late;
+            }
+
+            me->fires++;
+            if ((rand_next() % 100U) < CALLBACK_SLOW_PERCENT)
+            {
+                advance(1);
+            }
+
+            /* Counted from now, like ecu_timer_arm() from the callback. */
+            me->deadline = get_ticks((void *)0) + period;
+        }
+    }
+}
+
+
+static void print_result(const char *name, const struct result *r)
+{
+    printf("  %-10s %14" PRIu64 " %10" PRIu64 " %12" PRIu32 " %14" PRId64 " %12" PRId64 "\n",
+           name, r->fires, r->missed, r->max_late, r->drift, r->skew);
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- MAIN ----------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    uint64_t seed = DEFAULT_SEED;
+    uint64_t hours = DEFAULT_HOURS;
+    uint32_t spike_percent = DEFAULT_SPIKE_PERCENT;
+    uint32_t spike_max_ms = DEFAULT_SPIKE_MAX_MS;
+    uint32_t max_catch_up = DEFAULT_MAX_CATCH_UP;
+    enum deadline_timer_late_policy policy = DEADLINE_TIMER_CATCH_UP;
+    uint64_t duration = 0;
+    struct result rearm = {0};
+    struct result deadline = {0};
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+        {
+            seed = strtoull(&argv[i][7], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--hours=", 8) == 0)
+        {
+            hours = strtoull(&argv[i][8], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--period-ms=", 12) == 0)
+        {
+            period = (uint32_t)strtoul(&argv[i][12], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--spike-percent=", 16) == 0)
+        {
+            spike_percent = (uint32_t)strtoul(&argv[i][16], (char **)0, 0);
+        }
+        else if (strncmp(argv[i], "--spike-max-ms=", 15) == 0)
+        {
+            spike_max_ms = (uint32_t)strtoul(&argv[i][15], (char **)0, 0);
+        }
+        else if (strcmp(argv[i], "--policy=once") == 0)
+        {
+            policy = DEADLINE_TIMER_FIRE_ONCE;
+        }
+        else if (strcmp(argv[i], "--policy=catch-up") == 0)
+        {
+            policy = DEADLINE_TIMER_CATCH_UP;
+        }
+        else if (strncmp(argv[i], "--max-catch-up=", 15) == 0)
+        {
+            max_catch_up = (uint32_t)strtoul(&argv[i][15], (char **)0, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--seed=N] [--hours=N] [--period-ms=N] [--spike-percent=N] "
+                            "[--spike-max-ms=N] [--policy=once|catch-up] [--max-catch-up=N]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((period == 0) || (spike_max_ms == 0) || (max_catch_up == 0))
+    {
+        fprintf(stderr, "timer_drift: --period-ms, --spike-max-ms and --max-catch-up must be greater than 0\n");
+        return EXIT_FAILURE;
+    }
+
+    /* xorshift state must never be 0. */
+    rand_state = seed ^ 0x9E3779B97F4A7C15ULL;
+    if (rand_state == 0)
+    {
+        rand_state = 1;
+    }
+
+    /* Step 1: Arm every LED on the same tick. */
+    duration = hours * 3600U * 1000U;
+    deadline_timer_collection_ctor(&collection, (void *)0, &get_ticks);
+    for (size_t i = 0; i < LED_COUNT; i++)
+    {
+        rearm_leds[i].deadline = get_ticks((void *)0) + period;
+        deadline_timer_ctor(&deadline_leds[i].timer, (void *)&deadline_leds[i], &deadline_callback);
+        deadline_timer_arm_periodic(&collection, &deadline_leds[i].timer, period, policy, max_catch_up);
+    }
+
+    /* Step 2: Run the loop. Every iteration takes a tick, sometimes a lot more. */
+    while (elapsed < duration)
+    {
+        rearm_tick();
+        deadline_timer_collection_tick(&collection);
+
+        advance(1);
+        if ((rand_next() % 100U) < spike_percent)
+        {
+            advance((rand_next() % spike_max_ms) + 1U);
+        }
+    }
+
+    /* Step 3: Ideal next expiry of a LED is on the grid start + k * period
+    after all the expiries it consumed, whether they fired or were dropped. */
+    for (size_t i = 0; i < LED_COUNT; i++)
+    {
+        const struct rearm_led *r = &rearm_leds[i];
+        const struct deadline_led *d = &deadline_leds[i];
+        uint32_t r_ideal = START_TICKS + (uint32_t)((r->fires + 1U) * period);
+        uint32_t d_ideal = START_TICKS + (uint32_t)((d->fires + d->timer.missed + 1U) * period);
+        int64_t r_drift = (int32_t)(r->deadline - r_ideal);
+        int64_t d_drift = (int32_t)(d->timer.deadline - d_ideal);
+
+        rearm.fires += r->fires;
+        rearm.max_late = (r->max_late > rearm.max_late) ? r->max_late : rearm.max_late;
+        rearm.drift = (llabs(r_drift) > llabs(rearm.drift)) ? r_drift : rearm.drift;
+
+        deadline.fires += d->fires;
+        deadline.missed += d->timer.missed;
+        deadline.max_late = (d->max_late > deadline.max_late) ? d->max_late : deadline.max_late;
+        deadline.drift = (llabs(d_drift) > llabs(deadline.drift)) ? d_drift : deadline.drift;
+    }
+    rearm.skew = (int32_t)(rearm_leds[1].deadline - rearm_leds[0].deadline);
+    deadline.skew = (int32_t)(deadline_leds[1].timer.deadline - deadline_leds[0].timer.deadline);
+
+    printf("timer_drift: seed=%" PRIu64 " hours=%" PRIu64 " period=%" PRIu32 " ms spikes=%" PRIu32
+           "%% up to %" PRIu32 " ms policy=%s max_catch_up=%" PRIu32 "\n",
+           seed, hours, period, spike_percent, spike_max_ms,
+           (policy == DEADLINE_TIMER_CATCH_UP) ? "catch-up" : "once", max_catch_up);
+    printf("  ideal expiries per LED: %" PRIu64 "\n", duration / period);
+    printf("  %-10s %14s %10s %12s %14s %12s\n", "scheme", "callbacks", "missed", "max late ms", "drift ms", "skew ms");
+    print_result("rearm", &rearm);
+    print_result("deadline", &deadline);
+
+    if ((deadline.drift != 0) || (deadline.skew != 0))
+    {
+        fprintf(stderr, "timer_drift: FAIL deadline timers drifted off the period grid\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,305 @@
+/**
+ * @file
+ * @brief Runs the toggle timer driver against mocked TIM2, GPIO and RCC
+ * registers and checks the values it leaves behind:
+ *
+ *     1. PSC, ARR and CCR give a 10 kHz count and the requested period for
+ *        every kernel clock and period in the tables, up to the longest
+ *        period the driver takes. UG loads them and the counter runs.
+ *     2. toggle_timer_clock_set() reloads PSC while toggling and leaves it
+ *        alone while stopped.
+ *     3. Start hands the pin over. ODR holds the start level, AFR selects
+ *        the alternate function, MODER is alternate and the channel is an
+ *        enabled, active high output in toggle mode. No other channel's
+ *        bits change.
+ *     4. Stop freezes the counter, latches the level on the pin (IDR) into
+ *        ODR whatever ODR held before, hands the pin back as an output,
+ *        disables the channel and returns that level.
+ *
+ * Every channel is run, on the TIM2 pins of the L432. Mocked registers
+ * are plain memory, so only the values left at the end of each call are
+ * seen, not the order they were written in. gpio_write() goes through
+ * BSRR, so that is where the ODR latch is checked. Exits with a non-zero
+ * status on any wrong value.
+ *
+ * @author Ian Ress
+ * @version 0.1
+ * @date 2026-10-18
+ * @copyright Copyright (c) 2024
+ */
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------------- INCLUDES --------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/* STDLib. */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Drivers. */
+#include "gpio/gpio.h"
+#include "registers/registers.h"
+#include "toggle_timer/toggle_timer.h"
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE DEFINES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+#define COUNTS_PER_MS                           (10U)
+
+/**
+ * @brief Longest period toggle_timer_start() takes.
+ */
+#define PERIOD_MS_MAX                           (UINT32_MAX / COUNTS_PER_MS)
+
+/**
+ * @brief Left in registers the driver must not touch.
+ */
+#define SENTINEL                                (0xA5A5A5A5U)
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*----------------------------------- FILE SCOPE TYPES --------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+struct channel_pin
+{
+    uint8_t channel;
+    struct gpio_pin pin;
+};
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DECLARATIONS -------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void expect(const char *what, uint32_t actual, uint32_t expected);
+static uint32_t bsrr_for(const struct gpio_pin *pin, bool level);
+static uint32_t ccmr_byte(uint8_t channel);
+static uint32_t ccer_bits(uint8_t channel);
+static void check_timing(void);
+static void check_clock_set(void);
+static void check_handoff(const struct channel_pin *cp, bool level);
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------- FILE SCOPE VARIABLES ------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+/**
+ * @brief APB1 timer clocks from the board's 80 MHz down to the slowest
+ * the driver takes.
+ */
+static const uint32_t clocks_hz[] =
+{
+    80000000U, 40000000U, 24000000U, 16000000U, 12000000U, 4000000U, 100000U, 10000U
+};
+
+
+static const uint32_t periods_ms[] =
+{
+    1U, 2U, 50U, 250U, 1000U, 86400000U, PERIOD_MS_MAX
+};
+
+
+/**
+ * @brief TIM2 channels on AF1. Channel 2 is the board's LED0.
+ */
+static const struct channel_pin channel_pins[] =
+{
+    { 1U, { GPIOA, 0U } },
+    { 2U, { GPIOB, 3U } },
+    { 3U, { GPIOA, 2U } },
+    { 4U, { GPIOA, 3U } }
+};
+
+
+static uint32_t failures;
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*------------------------------ STATIC FUNCTION DEFINITIONS --------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+static void expect(const char *what, uint32_t actual, uint32_t expected)
+{
+    if (actual != expected)
+    {
+        failures++;
+        printf("    %s is 0x%08" PRIX32 ", expected 0x%08" PRIX32 "\n", what, actual, expected);
+    }
+}
+
+
+static uint32_t bsrr_for(const struct gpio_pin *pin, bool level)
+{
+    return (level) ? (1U << pin->pin) : (1U << (pin->pin + 16U));
+}
+
+
+static uint32_t ccmr_byte(uint8_t channel)
+{
+    return 0xFFU << (((channel - 1U) % 2U) * 8U);
+}
+
+
+static uint32_t ccer_bits(uint8_t channel)
+{
+    return (TIM_CCER_CCE | TIM_CCER_CCP) << ((channel - 1U) * 4U);
+}
+
+
+static void check_timing(void)
+{
+    struct toggle_timer timer;
+    const struct channel_pin *cp = &channel_pins[1];
+    uint32_t before = failures;
+    uint32_t runs = 0;
+
+    printf("toggle_timer_check: PSC, ARR and CCR\n");
+    for (size_t c = 0; c < (sizeof(clocks_hz) / sizeof(clocks_hz[0])); c++)
+    {
+        for (size_t p = 0; p < (sizeof(periods_ms) / sizeof(periods_ms[0])); p++)
+        {
+            stm32l432_mock_registers_reset();
+            gpio_output_init(&cp->pin, false);
+            toggle_timer_ctor(&timer, TIM2, cp->channel, &cp->pin, 1U, clocks_hz[c]);
+            toggle_timer_start(&timer, false, periods_ms[p]);
+
+            expect("TIM2 PSC", TIM2->PSC, (clocks_hz[c] / 10000U) - 1U);
+            expect("TIM2 ARR", TIM2->ARR, (periods_ms[p] * COUNTS_PER_MS) - 1U);
+            expect("TIM2 CCR", TIM2->CCR[cp->channel - 1U], (periods_ms[p] * COUNTS_PER_MS) - 1U);
+            expect("TIM2 EGR", TIM2->EGR, TIM_EGR_UG);
+            expect("TIM2 CR1 CEN", TIM2->CR1 & TIM_CR1_CEN, TIM_CR1_CEN);
+            expect("TIM2 CR1 ARPE", TIM2->CR1 & TIM_CR1_ARPE, 0);
+            expect("RCC APB1ENR1 TIM2EN", RCC->APB1ENR1 & RCC_APB1ENR1_TIM2EN, RCC_APB1ENR1_TIM2EN);
+            runs++;
+        }
+    }
+
+    printf("    %s, %" PRIu32 " clock and period pairs\n", (failures == before) ? "ok" : "FAIL", runs);
+}
+
+
+static void check_clock_set(void)
+{
+    struct toggle_timer timer;
+    const struct channel_pin *cp = &channel_pins[1];
+    uint32_t before = failures;
+
+    printf("toggle_timer_check: toggle_timer_clock_set\n");
+    stm32l432_mock_registers_reset();
+    gpio_output_init(&cp->pin, false);
+    toggle_timer_ctor(&timer, TIM2, cp->channel, &cp->pin, 1U, 80000000U);
+
+    /* Stopped. The next start programs PSC. */
+    TIM2->PSC = SENTINEL;
+    toggle_timer_clock_set(&timer, 16000000U);
+    expect("TIM2 PSC set while stopped", TIM2->PSC, SENTINEL);
+    toggle_timer_start(&timer, false, 500U);
+    expect("TIM2 PSC after start", TIM2->PSC, 1599U);
+
+    /* Toggling. Preloaded, so the period in progress keeps its ARR. */
+    toggle_timer_clock_set(&timer, 80000000U);
+    expect("TIM2 PSC set while toggling", TIM2->PSC, 7999U);
+    expect("TIM2 ARR set while toggling", TIM2->ARR, 4999U);
+    expect("TIM2 CR1 CEN", TIM2->CR1 & TIM_CR1_CEN, TIM_CR1_CEN);
+
+    printf("    %s\n", (failures == before) ? "ok" : "FAIL");
+}
+
+
+static void check_handoff(const struct channel_pin *cp, bool level)
+{
+    struct toggle_timer timer;
+    const uint8_t ch = cp->channel;
+    const uint32_t moder_shift = cp->pin.pin * 2U;
+    const uint32_t afr_shift = (cp->pin.pin % 8U) * 4U;
+    const uint32_t ccmr = (uint32_t)(ch - 1U) / 2U;
+    uint32_t idr_bit = 1U << cp->pin.pin;
+    bool stopped_level = false;
+    uint32_t before = failures;
+
+    printf("toggle_timer_check: channel %" PRIu32 " on GPIO%c%" PRIu32 ", starting %s\n",
+           (uint32_t)ch, (cp->pin.port == GPIOA) ? 'A' : 'B', (uint32_t)cp->pin.pin, (level) ? "high" : "low");
+
+    stm32l432_mock_registers_reset();
+    gpio_output_init(&cp->pin, level);
+    toggle_timer_ctor(&timer, TIM2, ch, &cp->pin, 1U, 80000000U);
+
+    /* Bits of the other channels must survive. */
+    TIM2->CCMR[ccmr] = SENTINEL & ~ccmr_byte(ch);
+    TIM2->CCMR[1U - ccmr] = SENTINEL;
+    TIM2->CCER = 0x1111U & ~ccer_bits(ch);
+
+    /* Start. */
+    cp->pin.port->BSRR = bsrr_for(&cp->pin, !level);
+    toggle_timer_start(&timer, level, 100U);
+    expect("BSRR, start level latched", cp->pin.port->BSRR, bsrr_for(&cp->pin, level));
+    expect("AFR", (cp->pin.port->AFR[cp->pin.pin / 8U] >> afr_shift) & 0xFU, 1U);
+    expect("MODER", (cp->pin.port->MODER >> moder_shift) & 0x3U, GPIO_MODER_ALTERNATE);
+    expect("CCMR OCM", (TIM2->CCMR[ccmr] & ccmr_byte(ch)) >> (((ch - 1U) % 2U) * 8U),
+           TIM_OCM_TOGGLE << TIM_OCM_OFFSET);
+    expect("CCMR of other channels", TIM2->CCMR[ccmr] & ~ccmr_byte(ch), SENTINEL & ~ccmr_byte(ch));
+    expect("other CCMR", TIM2->CCMR[1U - ccmr], SENTINEL);
+    expect("CCER CCE, active high", TIM2->CCER & ccer_bits(ch), TIM_CCER_CCE << ((ch - 1U) * 4U));
+    expect("CCER of other channels", TIM2->CCER & ~ccer_bits(ch), 0x1111U & ~ccer_bits(ch));
+    expect("TIM2 CR1 CEN", TIM2->CR1 & TIM_CR1_CEN, TIM_CR1_CEN);
+
+    /* Stop on both pin levels, with ODR still holding the other one. */
+    for (uint32_t pin_level = 0; pin_level < 2U; pin_level++)
+    {
+        TIM2->CR1 |= TIM_CR1_CEN;
+        TIM2->CCER |= TIM_CCER_CCE << ((ch - 1U) * 4U);
+        gpio_mode_set(&cp->pin, GPIO_MODER_ALTERNATE);
+        cp->pin.port->IDR = (pin_level) ? (cp->pin.port->IDR | idr_bit) : (cp->pin.port->IDR & ~idr_bit);
+        cp->pin.port->BSRR = bsrr_for(&cp->pin, !pin_level);
+
+        stopped_level = toggle_timer_stop(&timer);
+        expect("level returned", (uint32_t)stopped_level, pin_level);
+        expect("BSRR, IDR latched into ODR", cp->pin.port->BSRR, bsrr_for(&cp->pin, (pin_level != 0)));
+        expect("MODER after stop", (cp->pin.port->MODER >> moder_shift) & 0x3U, GPIO_MODER_OUTPUT);
+        expect("CCER CCE after stop", TIM2->CCER & (TIM_CCER_CCE << ((ch - 1U) * 4U)), 0);
+        expect("CCER of other channels after stop", TIM2->CCER & ~ccer_bits(ch), 0x1111U & ~ccer_bits(ch));
+        expect("TIM2 CR1 CEN after stop", TIM2->CR1 & TIM_CR1_CEN, 0);
+    }
+
+    printf("    %s\n", (failures == before) ? "ok" : "FAIL");
+}
+
+
+
+/*-------------------------------------------------------------------------------------*/
+/*--------------------------------------- MAIN ----------------------------------------*/
+/*-------------------------------------------------------------------------------------*/
+
+int main(void)
+{
+    check_timing();
+    check_clock_set();
+    for (size_t i = 0; i < (sizeof(channel_pins) / sizeof(channel_pins[0])); i++)
+    {
+        check_handoff(&channel_pins[i], false);
+        check_handoff(&channel_pins[i], true);
+    }
+
+    if (failures > 0)
+    {
+        fprintf(stderr, "toggle_timer_check: FAIL %" PRIu32 " wrong register values\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("toggle_timer_check: ok\n");
+    return EXIT_SUCCESS;
+}